@@ -0,0 +1,57 @@
+require 'benchmark'
+require 'cumo/narray'
+
+# Compares host loops split by ndloop (sort, median, cumsum, minmax) on 1
+# thread, which is the serial path, and on Cumo.host_threads threads. Set
+# CUMO_HOST_THREADS to change the latter; run on a many-core host to see
+# the scaling. Contiguous rows are split into static ranges, and rows
+# picked by an index array are split with work stealing.
+
+num_iteration = 10
+num_threads = Cumo.host_threads
+x = Cumo::SFloat.new(1000, 1000).rand
+idx = Cumo::Int32.new(1000).rand(1000)
+y = x[idx, true]
+Cumo::CUDA::Runtime.cudaDeviceSynchronize
+
+Benchmark.bm 40 do |r|
+  [1, num_threads].uniq.each do |n|
+    Cumo.host_threads = n
+
+    r.report "x.sort(axis: 1) (threads: #{n})" do
+      num_iteration.times do
+        x.sort(axis: 1)
+      end
+      Cumo::CUDA::Runtime.cudaDeviceSynchronize
+    end
+
+    r.report "x.median(axis: 1) (threads: #{n})" do
+      num_iteration.times do
+        x.median(axis: 1)
+      end
+      Cumo::CUDA::Runtime.cudaDeviceSynchronize
+    end
+
+    r.report "x.cumsum(axis: 1) (threads: #{n})" do
+      num_iteration.times do
+        x.cumsum(axis: 1)
+      end
+      Cumo::CUDA::Runtime.cudaDeviceSynchronize
+    end
+
+    r.report "x.minmax(axis: 1) (threads: #{n})" do
+      num_iteration.times do
+        x.minmax(axis: 1)
+      end
+      Cumo::CUDA::Runtime.cudaDeviceSynchronize
+    end
+
+    r.report "x[idx, true].minmax(axis: 1) (threads: #{n})" do
+      num_iteration.times do
+        y.minmax(axis: 1)
+      end
+      Cumo::CUDA::Runtime.cudaDeviceSynchronize
+    end
+  end
+end
+Cumo.host_threads = num_threads
@@ -100,6 +100,34 @@ Benchmark.bm 30 do |r|
     end
     Cumo::CUDA::Runtime.cudaDeviceSynchronize
   end
+
+  x = Cumo::SFloat.ones([100000,128])
+  %w[mean var stddev rms].each do |op|
+    r.report "x.#{op}(axis: 1) of 100000x128" do
+      num_iteration.times do
+        x.send(op, axis: 1)
+      end
+      Cumo::CUDA::Runtime.cudaDeviceSynchronize
+    end
+  end
+
+  x = Cumo::SFloat.ones([100000,128])
+  y = Cumo::SFloat.ones([128])
+  r.report "x.mulsum(y, axis: 1) of 100000x128" do
+    num_iteration.times do
+      x.mulsum(y, axis: 1)
+    end
+    Cumo::CUDA::Runtime.cudaDeviceSynchronize
+  end
+
+  x = Cumo::Int32.ones([200,300])
+  y = Cumo::Int32.ones([300,200])
+  r.report "Int32 x.dot(y) of 200x300x200" do
+    num_iteration.times do
+      x.dot(y)
+    end
+    Cumo::CUDA::Runtime.cudaDeviceSynchronize
+  end
 end
 
 #                                      user     system      total        real
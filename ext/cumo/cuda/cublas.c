@@ -4,7 +4,9 @@
 #include <ruby.h>
 #include "cumo/narray.h"
 #include "cumo/template.h"
+#include "cumo/cuda/memory_pool.h"
 #include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
 
 VALUE cumo_cuda_eCublasError;
 VALUE cumo_cuda_mCublas;
@@ -42,25 +44,227 @@ cumo_cuda_cublas_check_status(cublasStatus_t status)
     }
 }
 
-// Lazily initialize cublas handle, and cache it
+// cuBLAS handles are pooled per (device, stream) so that BLAS calls on
+// different streams do not share a handle and can run concurrently.
+// Each handle is bound to its stream once, and has a workspace drawn from
+// the memory pool so that cuBLAS does not allocate one on each call.
+typedef struct {
+    cublasHandle_t handle;
+    cudaStream_t stream;
+    char *workspace;
+    size_t workspace_size;
+    cublasMath_t math_mode;
+} cublas_handle_entry_t;
+
+#define CUMO_CUDA_CUBLAS_DEFAULT_WORKSPACE_SIZE (4 * 1024 * 1024)
+
+static st_table **handle_tables = 0;  // per device, cudaStream_t => cublas_handle_entry_t*
+static int handle_tables_size = 0;
+static cublasMath_t cublas_math_mode = CUBLAS_DEFAULT_MATH;
+static size_t cublas_workspace_size = CUMO_CUDA_CUBLAS_DEFAULT_WORKSPACE_SIZE;
+
+static st_table*
+get_handle_table(int device)
+{
+    if (handle_tables == 0) {
+        int i;
+        handle_tables_size = cumo_cuda_runtime_get_device_count();
+        handle_tables = ALLOC_N(st_table*, handle_tables_size);
+        for (i = 0; i < handle_tables_size; ++i) {
+            handle_tables[i] = st_init_numtable();
+        }
+    }
+    return handle_tables[device];
+}
+
+static void
+update_workspace(cublas_handle_entry_t *e)
+{
+#if CUDART_VERSION >= 11000
+    if (e->workspace_size == cublas_workspace_size) {
+        return;
+    }
+    // The memory pool does not order a free after work queued on the
+    // stream, so wait for cuBLAS calls which may still use the old
+    // workspace. The workspace size rarely changes.
+    if (e->workspace) {
+        cumo_cuda_runtime_check_status(cudaStreamSynchronize(e->stream));
+        cumo_cuda_runtime_free(e->workspace);
+        e->workspace = 0;
+    }
+    e->workspace_size = 0;
+    if (cublas_workspace_size > 0) {
+        e->workspace = cumo_cuda_runtime_malloc(cublas_workspace_size);
+    }
+    cumo_cuda_cublas_check_status(cublasSetWorkspace(e->handle, e->workspace, cublas_workspace_size));
+    e->workspace_size = cublas_workspace_size;
+#endif
+}
+
+static void
+update_math_mode(cublas_handle_entry_t *e)
+{
+    if (e->math_mode == cublas_math_mode) {
+        return;
+    }
+    cumo_cuda_cublas_check_status(cublasSetMathMode(e->handle, cublas_math_mode));
+    e->math_mode = cublas_math_mode;
+}
+
+// Returns the cuBLAS handle for the current device and stream.
+// The handle is created on first use, and reflects the math mode and the
+// workspace size at the time of each call.
 cublasHandle_t
 cumo_cuda_cublas_handle()
 {
-    static cublasHandle_t *handles = 0;  // handle is never destroyed
-    int device;
-    if (handles == 0) {
-        int i;
-        int device_count = cumo_cuda_runtime_get_device_count();
-        handles = malloc(sizeof(cublasHandle_t) * device_count);
-        for (i = 0; i < device_count; ++i) {
-            handles[i] = 0;
+    int device = cumo_cuda_runtime_get_device();
+    cudaStream_t stream = cumo_cuda_stream_current();
+    st_table *table = get_handle_table(device);
+    st_data_t value;
+    cublas_handle_entry_t *e;
+
+    if (st_lookup(table, (st_data_t)stream, &value)) {
+        e = (cublas_handle_entry_t*)value;
+    } else {
+        cublasHandle_t handle;
+        cumo_cuda_cublas_check_status(cublasCreate(&handle));
+        e = ALLOC(cublas_handle_entry_t);
+        e->handle = handle;
+        e->stream = stream;
+        e->workspace = 0;
+        e->workspace_size = 0;
+        e->math_mode = CUBLAS_DEFAULT_MATH;
+        st_insert(table, (st_data_t)stream, (st_data_t)e);
+        cumo_cuda_cublas_check_status(cublasSetStream(handle, stream));
+    }
+    update_workspace(e);
+    update_math_mode(e);
+    return e->handle;
+}
+
+// Destroys handles bound to stream. Called before the stream is destroyed.
+void
+cumo_cuda_cublas_release_stream(cudaStream_t stream)
+{
+    int device, current_device;
+    st_data_t key = (st_data_t)stream, value;
+
+    if (handle_tables == 0) {
+        return;
+    }
+    for (device = 0; device < handle_tables_size; ++device) {
+        cublas_handle_entry_t *e;
+        if (!st_delete(handle_tables[device], &key, &value)) {
+            continue;
+        }
+        e = (cublas_handle_entry_t*)value;
+        // The handle and the workspace belong to the device they were created on.
+        // Wait for cuBLAS calls queued on the stream before the workspace
+        // is returned to the memory pool, which may hand it to other work.
+        cudaGetDevice(&current_device);
+        cudaSetDevice(device);
+        cudaStreamSynchronize(stream);
+        cublasDestroy(e->handle);
+        if (e->workspace) {
+            cumo_cuda_runtime_free_on_stream_release(e->workspace, stream);
         }
+        cudaSetDevice(current_device);
+        xfree(e);
     }
-    device = cumo_cuda_runtime_get_device();
-    if (handles[device] == 0) {
-        cublasCreate(&handles[device]);
+}
+
+static cublasMath_t
+sym_to_math_mode(VALUE sym)
+{
+    ID id = SYM2ID(sym);
+    if (id == rb_intern("default")) return CUBLAS_DEFAULT_MATH;
+    if (id == rb_intern("tensor_op")) return CUBLAS_TENSOR_OP_MATH;
+#if CUDART_VERSION >= 11000
+    if (id == rb_intern("tf32")) return CUBLAS_TF32_TENSOR_OP_MATH;
+    if (id == rb_intern("pedantic")) return CUBLAS_PEDANTIC_MATH;
+#endif
+    rb_raise(rb_eArgError, "unsupported math mode: %"PRIsVALUE, sym);
+    return CUBLAS_DEFAULT_MATH;  // never reach
+}
+
+static VALUE
+math_mode_to_sym(cublasMath_t mode)
+{
+    switch (mode) {
+    case CUBLAS_TENSOR_OP_MATH:
+        return ID2SYM(rb_intern("tensor_op"));
+#if CUDART_VERSION >= 11000
+    case CUBLAS_TF32_TENSOR_OP_MATH:
+        return ID2SYM(rb_intern("tf32"));
+    case CUBLAS_PEDANTIC_MATH:
+        return ID2SYM(rb_intern("pedantic"));
+#endif
+    default:
+        return ID2SYM(rb_intern("default"));
     }
-    return handles[device];
+}
+
+/*
+  Returns the math mode of cuBLAS handles.
+  @return [Symbol] :default, :tensor_op, :tf32 or :pedantic
+*/
+static VALUE
+rb_cublas_s_math_mode(VALUE self)
+{
+    return math_mode_to_sym(cublas_math_mode);
+}
+
+/*
+  Sets the math mode of cuBLAS handles, which is applied to handles of all
+  streams on their next use.
+
+  :tensor_op allows Tensor Cores with reduced precision, e.g., FP16
+  accumulation, and :tf32 allows TF32 Tensor Cores for single precision.
+  :tf32 and :pedantic require CUDA 11 or later.
+  @param [Symbol] mode :default, :tensor_op, :tf32 or :pedantic
+  @return [Symbol] mode
+*/
+static VALUE
+rb_cublas_s_set_math_mode(VALUE self, VALUE mode)
+{
+    cublas_math_mode = sym_to_math_mode(mode);
+    return mode;
+}
+
+/*
+  Returns the workspace size of cuBLAS handles in bytes.
+  @return [Integer]
+*/
+static VALUE
+rb_cublas_s_workspace_size(VALUE self)
+{
+    return SIZET2NUM(cublas_workspace_size);
+}
+
+/*
+  Sets the workspace size of cuBLAS handles in bytes, which is applied to
+  handles of all streams on their next use. Workspaces are allocated from
+  the memory pool. 0 makes cuBLAS allocate workspaces by itself.
+  This has no effect before CUDA 11.
+  @param [Integer] size
+  @return [Integer] size
+*/
+static VALUE
+rb_cublas_s_set_workspace_size(VALUE self, VALUE size)
+{
+    cublas_workspace_size = NUM2SIZET(size);
+    return size;
+}
+
+/*
+  Returns the number of cuBLAS handles of the current device, i.e., the
+  number of streams BLAS functions have been called on.
+  @return [Integer]
+*/
+static VALUE
+rb_cublas_s_handle_count(VALUE self)
+{
+    return SIZET2NUM(get_handle_table(cumo_cuda_runtime_get_device())->num_entries);
 }
 
 VALUE
@@ -126,4 +330,10 @@ Init_cumo_cuda_cublas(void)
     */
     mCublas = rb_define_module_under(mCUDA, "Cublas");
     eCublasError = rb_define_class_under(mCUDA, "CublasError", rb_eStandardError);
+
+    rb_define_singleton_method(mCublas, "math_mode", rb_cublas_s_math_mode, 0);
+    rb_define_singleton_method(mCublas, "math_mode=", rb_cublas_s_set_math_mode, 1);
+    rb_define_singleton_method(mCublas, "workspace_size", rb_cublas_s_workspace_size, 0);
+    rb_define_singleton_method(mCublas, "workspace_size=", rb_cublas_s_set_workspace_size, 1);
+    rb_define_singleton_method(mCublas, "handle_count", rb_cublas_s_handle_count, 0);
 }
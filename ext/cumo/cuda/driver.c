@@ -9,8 +9,10 @@ VALUE cumo_cuda_mDriver;
 #define eDriverError cumo_cuda_eDriverError
 #define mDriver cumo_cuda_mDriver
 
-static void
-check_status(CUresult status)
+#define check_status(status) (cumo_cuda_driver_check_status((status)))
+
+void
+cumo_cuda_driver_check_status(CUresult status)
 {
     if (status != 0) {
         const char *errname = NULL;
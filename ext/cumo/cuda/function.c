@@ -0,0 +1,231 @@
+#include <assert.h>
+#include <ruby.h>
+#include <cuda.h>
+#include "cumo/narray.h"
+#include "cumo/indexer.h"
+#include "cumo/cuda/driver.h"
+#include "cumo/cuda/function.h"
+#include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
+
+VALUE cumo_cuda_cFunction;
+#define cFunction cumo_cuda_cFunction
+
+#define check_status(status) (cumo_cuda_driver_check_status((status)))
+
+#define CUMO_FUNCTION_BLOCK_DIM 128
+#define CUMO_FUNCTION_REDUCTION_BLOCK_DIM 512 // must match _MAX_BLOCK_SIZE of reduction kernels in lib/cumo/cuda/kernel_source.rb
+#define CUMO_FUNCTION_MAX_GRID_DIM 2147483647
+
+static int64_t
+round_up_to_power_of_2(int64_t x)
+{
+    --x;
+    x |= x >> 1;
+    x |= x >> 2;
+    x |= x >> 4;
+    x |= x >> 8;
+    x |= x >> 16;
+    x |= x >> 32;
+    return x + 1;
+}
+
+static void
+iter_launch_elementwise(cumo_na_loop_t *const lp)
+{
+    cumo_na_indexer_t indexer = cumo_na_make_indexer(&lp->args[0]);
+    cumo_na_iarray_t *iarrays = ALLOCA_N(cumo_na_iarray_t, lp->narg);
+    void **params = ALLOCA_N(void*, lp->narg + 1);
+    CUfunction func;
+    size_t grid_dim, block_dim;
+    int j;
+
+    if (indexer.total_size == 0) {
+        return;
+    }
+    func = (CUfunction)NUM2SIZET(rb_yield(INT2FIX(indexer.ndim)));
+
+    params[0] = &indexer;
+    for (j = 0; j < lp->narg; ++j) {
+        iarrays[j] = cumo_na_make_iarray(&lp->args[j]);
+        params[j + 1] = &iarrays[j];
+    }
+
+    grid_dim = (indexer.total_size + CUMO_FUNCTION_BLOCK_DIM - 1) / CUMO_FUNCTION_BLOCK_DIM;
+    if (grid_dim > CUMO_FUNCTION_MAX_GRID_DIM) grid_dim = CUMO_FUNCTION_MAX_GRID_DIM;
+    block_dim = (indexer.total_size > CUMO_FUNCTION_BLOCK_DIM) ? CUMO_FUNCTION_BLOCK_DIM : indexer.total_size;
+
+    check_status(cuLaunchKernel(func, grid_dim, 1, 1, block_dim, 1, 1, 0, (CUstream)cumo_cuda_stream_current(), params, NULL));
+}
+
+/*
+  Launch an elementwise kernel over NArrays broadcast by ndloop.
+
+  The kernel receives a cumo_na_indexer_t followed by one cumo_na_iarray_t
+  for each argument. Output arrays must already have the broadcast shape.
+  @overload launch_elementwise(args, nin) {|ndim| ... }
+  @param [Array<Cumo::NArray>] args  input arrays followed by output arrays.
+  @param [Integer] nin  number of input arrays.
+  @yieldparam [Integer] ndim  number of dimensions after ndloop compacted contiguous axes.
+  @yieldreturn [Integer] CUfunction handle of the kernel specialized for ndim.
+  @return [nil]
+*/
+static VALUE
+cumo_cuda_function_s_launch_elementwise(VALUE klass, VALUE args, VALUE vnin)
+{
+    long i, narg;
+    int nin = NUM2INT(vnin);
+    cumo_ndfunc_arg_in_t *ain;
+    cumo_ndfunc_t ndf = {iter_launch_elementwise, CUMO_STRIDE_LOOP_NIP|CUMO_NDF_INDEXER_LOOP, 0, 0, 0, 0};
+
+    rb_need_block();
+    Check_Type(args, T_ARRAY);
+    narg = RARRAY_LEN(args);
+    if (nin < 0 || nin > narg) {
+        rb_raise(rb_eArgError, "invalid number of inputs: %d", nin);
+    }
+    ain = ALLOCA_N(cumo_ndfunc_arg_in_t, narg);
+    for (i = 0; i < narg; ++i) {
+        VALUE v = RARRAY_AREF(args, i);
+        if (!CumoIsNArray(v)) {
+            rb_raise(rb_eTypeError, "arguments must be NArray");
+        }
+        ain[i].type = (i < nin) ? rb_obj_class(v) : CUMO_OVERWRITE;
+        ain[i].dim = 0;
+    }
+    ndf.nin = (int)narg;
+    ndf.ain = ain;
+
+    cumo_na_ndloop2(&ndf, args);
+    return Qnil;
+}
+
+static void
+iter_launch_reduction(cumo_na_loop_t *const lp)
+{
+    cumo_na_reduction_arg_t arg = cumo_na_make_reduction_arg(lp);
+    size_t reduce_type_size = *(size_t*)(lp->opt_ptr);
+    int64_t reduce_total_size_pow2, out_block_num;
+    int out_block_size, reduce_block_size;
+    size_t grid_dim;
+    void *params[3];
+    CUfunction func;
+
+    if (arg.out_indexer.total_size == 0) {
+        return;
+    }
+    func = (CUfunction)NUM2SIZET(rb_yield_values(2, INT2FIX(arg.in_indexer.ndim), INT2FIX(arg.out_indexer.ndim)));
+
+    // Same partitioning as cumo_reduce in reduce_kernel.h
+    reduce_total_size_pow2 = round_up_to_power_of_2(
+            arg.in_indexer.total_size > arg.out_indexer.total_size ? arg.in_indexer.total_size / arg.out_indexer.total_size : 1);
+    reduce_block_size = (int)(reduce_total_size_pow2 < CUMO_FUNCTION_REDUCTION_BLOCK_DIM ? reduce_total_size_pow2 : CUMO_FUNCTION_REDUCTION_BLOCK_DIM);
+    out_block_size = CUMO_FUNCTION_REDUCTION_BLOCK_DIM / reduce_block_size;
+    out_block_num = (arg.out_indexer.total_size + out_block_size - 1) / out_block_size;
+    grid_dim = out_block_num < CUMO_FUNCTION_MAX_GRID_DIM ? out_block_num : CUMO_FUNCTION_MAX_GRID_DIM;
+
+    params[0] = &arg;
+    params[1] = &out_block_size;
+    params[2] = &reduce_block_size;
+    check_status(cuLaunchKernel(func, grid_dim, 1, 1, CUMO_FUNCTION_REDUCTION_BLOCK_DIM, 1, 1,
+                                reduce_type_size * CUMO_FUNCTION_REDUCTION_BLOCK_DIM, (CUstream)cumo_cuda_stream_current(), params, NULL));
+}
+
+/*
+  Launch a reduction kernel through ndloop.
+
+  The kernel receives a cumo_na_reduction_arg_t, the number of outputs
+  handled by a block and the number of threads reducing each output.
+  @overload launch_reduction(input, out_class, reduce_type_size, axis: nil, keepdims: false) {|in_ndim, out_ndim| ... }
+  @param [Cumo::NArray] input  array to reduce.
+  @param [Class] out_class  class of the result.
+  @param [Integer] reduce_type_size  byte size of the accumulator type, used for shared memory.
+  @param [Numeric,Array,Range] axis (keyword) Affected dimensions.
+  @param [TrueClass] keepdims (keyword) If true, the reduced axes are left in the result array as dimensions with size one.
+  @yieldparam [Integer] in_ndim  number of dimensions of the input indexer.
+  @yieldparam [Integer] out_ndim  number of dimensions of the output indexer.
+  @yieldreturn [Integer] CUfunction handle of the kernel specialized for in_ndim and out_ndim.
+  @return [Cumo::NArray] result of reduction.
+*/
+static VALUE
+cumo_cuda_function_s_launch_reduction(int argc, VALUE *argv, VALUE klass)
+{
+    VALUE input, reduce, v;
+    size_t reduce_type_size;
+    cumo_ndfunc_arg_in_t ain[2] = {{Qnil,0},{cumo_sym_reduce,0}};
+    cumo_ndfunc_arg_out_t aout[1] = {{Qnil,0}};
+    cumo_ndfunc_t ndf = {iter_launch_reduction, CUMO_STRIDE_LOOP_NIP|CUMO_NDF_FLAT_REDUCE|CUMO_NDF_INDEXER_LOOP, 2, 1, ain, aout};
+
+    rb_need_block();
+    rb_check_arity(argc, 3, UNLIMITED_ARGUMENTS);
+    input = argv[0];
+    if (!CumoIsNArray(input)) {
+        rb_raise(rb_eTypeError, "input must be NArray");
+    }
+    ain[0].type = rb_obj_class(input);
+    aout[0].type = argv[1];
+    reduce_type_size = NUM2SIZET(argv[2]);
+
+    reduce = cumo_na_reduce_dimension(argc-3, argv+3, 1, &input, &ndf, 0);
+    if (cumo_na_has_idx_p(input)) {
+        input = cumo_na_copy(input); // reduction does not support idx, make contiguous
+    }
+    v = cumo_na_ndloop3(&ndf, &reduce_type_size, 2, input, reduce);
+    return rb_funcall(v, rb_intern("extract"), 0);
+}
+
+static VALUE
+jit_binary(VALUE args)
+{
+    VALUE mJIT = rb_path2class("Cumo::CUDA::JIT");
+    return rb_funcallv(mJIT, rb_intern("binary"), 3, RARRAY_CONST_PTR(args));
+}
+
+/*
+  Launches the kernel of binary op of type_name specialized for ndim, which
+  is compiled by Cumo::CUDA::JIT.binary on first use on the current device
+  and cached in cache. Returns 0 without launching if the kernel is not
+  available, i.e., JIT is disabled or compilation failed, in which case the
+  caller launches the kernel for any ndim. Other exceptions are propagated,
+  and compilation is tried again on the next launch.
+*/
+int
+cumo_cuda_function_launch_jit_binary(cumo_cuda_jit_cache_t *cache, const char *type_name, const char *op, int ndim, size_t grid_dim, size_t block_dim, void **params)
+{
+    cumo_cuda_jit_function_t *jit;
+
+    assert(0 <= ndim && ndim <= CUMO_NA_INDEXER_OPTIMIZED_NDIM);
+    if (cache->functions == NULL) {
+        cache->functions = ZALLOC_N(cumo_cuda_jit_function_t, cumo_cuda_runtime_get_device_count() * (CUMO_NA_INDEXER_OPTIMIZED_NDIM + 1));
+    }
+    jit = &cache->functions[cumo_cuda_runtime_get_device() * (CUMO_NA_INDEXER_OPTIMIZED_NDIM + 1) + ndim];
+    if (!jit->compiled) {
+        VALUE args = rb_ary_new3(3, rb_str_new_cstr(type_name), rb_str_new_cstr(op), INT2FIX(ndim));
+        VALUE func;
+        int state = 0;
+
+        func = rb_protect(jit_binary, args, &state);
+        if (state) {
+            rb_jump_tag(state);
+        }
+        jit->func = NIL_P(func) ? NULL : (CUfunction)NUM2SIZET(func);
+        jit->compiled = 1;
+        RB_GC_GUARD(args);
+    }
+    if (jit->func == NULL) {
+        return 0;
+    }
+    check_status(cuLaunchKernel(jit->func, grid_dim, 1, 1, block_dim, 1, 1, 0, (CUstream)cumo_cuda_stream_current(), params, NULL));
+    return 1;
+}
+
+void
+Init_cumo_cuda_function()
+{
+    VALUE mCumo = rb_define_module("Cumo");
+    VALUE mCUDA = rb_define_module_under(mCumo, "CUDA");
+    cFunction = rb_define_class_under(mCUDA, "Function", rb_cObject);
+
+    rb_define_singleton_method(cFunction, "launch_elementwise", cumo_cuda_function_s_launch_elementwise, 2);
+    rb_define_singleton_method(cFunction, "launch_reduction", cumo_cuda_function_s_launch_reduction, -1);
+}
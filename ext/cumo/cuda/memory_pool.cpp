@@ -1,10 +1,14 @@
 #include <ruby.h>
 #include <cuda_runtime.h>
 #include "memory_pool_impl.hpp"
+#include "pinned_memory_pool_impl.hpp"
 #include "cumo/cuda/memory_pool.h"
 #include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
 
+#include <cstdio>
 #include <cstdlib>
+#include <new>
 #include <string>
 
 #if defined(__cplusplus)
@@ -17,6 +21,24 @@ extern "C" {
 static cumo::internal::MemoryPool pool{};
 static bool memory_pool_enabled;
 
+class CUDAPinnedAllocator : public cumo::internal::PinnedAllocator {
+public:
+    void* Malloc(size_t size) override {
+        void* ptr = nullptr;
+        if (cudaHostAlloc(&ptr, size, cudaHostAllocDefault) != cudaSuccess) {
+            cudaGetLastError(); // reset the error
+            return nullptr;
+        }
+        return ptr;
+    }
+
+    void Free(void* ptr) override {
+        cudaFreeHost(ptr);
+    }
+};
+
+static cumo::internal::PinnedMemoryPool pinned_pool{std::unique_ptr<cumo::internal::PinnedAllocator>(new CUDAPinnedAllocator())};
+
 VALUE cumo_cuda_eOutOfMemoryError;
 
 char*
@@ -24,8 +46,7 @@ cumo_cuda_runtime_malloc(size_t size)
 {
     if (memory_pool_enabled) {
         try {
-            // TODO(sonots): Get current CUDA stream and pass it
-            return reinterpret_cast<char*>(pool.Malloc(size));
+            return reinterpret_cast<char*>(pool.Malloc(size, cumo_cuda_stream_current()));
         } catch (const cumo::internal::CUDARuntimeError& e) {
             cumo_cuda_runtime_check_status(e.status());
         } catch (const cumo::internal::OutOfMemoryError& e) {
@@ -44,7 +65,6 @@ cumo_cuda_runtime_free(char *ptr)
 {
     if (memory_pool_enabled) {
         try {
-            // TODO(sonots): Get current CUDA stream and pass it
             pool.Free(reinterpret_cast<intptr_t>(ptr));
         } catch (const cumo::internal::CUDARuntimeError& e) {
             cumo_cuda_runtime_check_status(e.status());
@@ -54,6 +74,57 @@ cumo_cuda_runtime_free(char *ptr)
     }
 }
 
+void
+cumo_cuda_runtime_free_on_stream_release(char *ptr, cudaStream_t stream)
+{
+    cudaError_t status = cudaSuccess;
+
+    if (memory_pool_enabled) {
+        try {
+            pool.Free(reinterpret_cast<intptr_t>(ptr));
+            // No other stream reuses the blocks in the arena of stream.
+            pool.FreeAllBlocks(stream);
+        } catch (const cumo::internal::CUDARuntimeError& e) {
+            status = e.status();
+        }
+    } else {
+        status = cudaFree((void*)ptr);
+    }
+    if (status != cudaSuccess) {
+        // Called from finalizers, which must not raise.
+        fprintf(stderr, "cumo: failed to free memory of a released stream: %s\n", cudaGetErrorString(status));
+        cudaGetLastError(); // reset the error
+    }
+}
+
+char*
+cumo_cuda_runtime_malloc_pinned(size_t size)
+{
+    try {
+        return reinterpret_cast<char*>(pinned_pool.Malloc(size));
+    } catch (const std::bad_alloc& e) {
+        rb_raise(cumo_cuda_eOutOfMemoryError, "out of pinned host memory to allocate %" PRIuSIZE " bytes", size);
+    }
+    return 0; // should not reach here
+}
+
+static void CUDART_CB
+cumo_cuda_runtime_free_pinned_callback(cudaStream_t stream, cudaError_t status, void *data)
+{
+    // CUDA APIs must not be called in stream callbacks. This only updates lists.
+    pinned_pool.Free(data);
+}
+
+void
+cumo_cuda_runtime_free_pinned(char *ptr)
+{
+    cudaError_t status = cudaStreamAddCallback(cumo_cuda_stream_current(), cumo_cuda_runtime_free_pinned_callback, ptr, 0);
+    if (status != cudaSuccess) {
+        // The block may be referred by pending copies, so do not reuse it.
+        cumo_cuda_runtime_check_status(status);
+    }
+}
+
 /*
   Enable memory pool.
 
@@ -155,6 +226,61 @@ rb_memory_pool_total_bytes(VALUE self)
     return SIZET2NUM(pool.GetTotalBytes());
 }
 
+/*
+  Free all free blocks of the pinned host memory pool.
+ */
+static VALUE
+rb_pinned_memory_pool_free_all_blocks(VALUE self)
+{
+    pinned_pool.FreeAllBlocks();
+    return Qnil;
+}
+
+/*
+  Count the total number of free blocks of the pinned host memory pool.
+
+  @return [Integer] The total number of free blocks.
+ */
+static VALUE
+rb_pinned_memory_pool_n_free_blocks(VALUE self)
+{
+    return SIZET2NUM(pinned_pool.GetNumFreeBlocks());
+}
+
+/*
+  Get the total number of bytes of pinned host memory used, including
+  blocks waiting for copies to finish.
+
+  @return [Integer] The total number of bytes used.
+ */
+static VALUE
+rb_pinned_memory_pool_used_bytes(VALUE self)
+{
+    return SIZET2NUM(pinned_pool.GetUsedBytes());
+}
+
+/*
+  Get the total number of bytes of pinned host memory acquired but not used in the pool.
+
+  @return [Integer] The total number of bytes acquired but not used in the pool.
+ */
+static VALUE
+rb_pinned_memory_pool_free_bytes(VALUE self)
+{
+    return SIZET2NUM(pinned_pool.GetFreeBytes());
+}
+
+/*
+  Get the total number of bytes of pinned host memory acquired in the pool.
+
+  @return [Integer] The total number of bytes acquired in the pool.
+ */
+static VALUE
+rb_pinned_memory_pool_total_bytes(VALUE self)
+{
+    return SIZET2NUM(pinned_pool.GetTotalBytes());
+}
+
 void
 Init_cumo_cuda_memory_pool()
 {
@@ -172,6 +298,13 @@ Init_cumo_cuda_memory_pool()
     rb_define_singleton_method(mMemoryPool, "free_bytes", RUBY_METHOD_FUNC(rb_memory_pool_free_bytes), 0);
     rb_define_singleton_method(mMemoryPool, "total_bytes", RUBY_METHOD_FUNC(rb_memory_pool_total_bytes), 0);
 
+    VALUE mPinnedMemoryPool = rb_define_module_under(mCUDA, "PinnedMemoryPool");
+    rb_define_singleton_method(mPinnedMemoryPool, "free_all_blocks", RUBY_METHOD_FUNC(rb_pinned_memory_pool_free_all_blocks), 0);
+    rb_define_singleton_method(mPinnedMemoryPool, "n_free_blocks", RUBY_METHOD_FUNC(rb_pinned_memory_pool_n_free_blocks), 0);
+    rb_define_singleton_method(mPinnedMemoryPool, "used_bytes", RUBY_METHOD_FUNC(rb_pinned_memory_pool_used_bytes), 0);
+    rb_define_singleton_method(mPinnedMemoryPool, "free_bytes", RUBY_METHOD_FUNC(rb_pinned_memory_pool_free_bytes), 0);
+    rb_define_singleton_method(mPinnedMemoryPool, "total_bytes", RUBY_METHOD_FUNC(rb_pinned_memory_pool_total_bytes), 0);
+
     // default is true
     const char* env = std::getenv("CUMO_MEMORY_POOL");
     memory_pool_enabled = env == nullptr || (std::string(env) != "OFF" && std::string(env) != "0" && std::string(env) != "NO");
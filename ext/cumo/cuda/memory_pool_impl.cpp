@@ -177,7 +177,7 @@ intptr_t SingleDeviceMemoryPool::Malloc(size_t size, cudaStream_t stream_ptr) {
     return chunk->ptr();
 }
 
-void SingleDeviceMemoryPool::Free(intptr_t ptr, cudaStream_t stream_ptr) {
+void SingleDeviceMemoryPool::Free(intptr_t ptr) {
     std::shared_ptr<Chunk> chunk = nullptr;
 
     {
@@ -189,6 +189,8 @@ void SingleDeviceMemoryPool::Free(intptr_t ptr, cudaStream_t stream_ptr) {
         chunk->set_in_use(false);
         in_use_.erase(ptr);
     }
+    // Work queued on the stream may still use the memory, so only the stream can reuse it
+    cudaStream_t stream_ptr = chunk->stream_ptr();
 
     if (chunk->next() != nullptr && !chunk->next()->in_use()) {
         if (RemoveFromFreeList(chunk->next()->size(), chunk->next(), stream_ptr)) {
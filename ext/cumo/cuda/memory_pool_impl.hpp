@@ -167,7 +167,8 @@ public:
 
     intptr_t Malloc(size_t size, cudaStream_t stream_ptr = 0);
 
-    void Free(intptr_t ptr, cudaStream_t stream_ptr = 0);
+    // Returns the memory to the arena of the stream it was allocated on
+    void Free(intptr_t ptr);
 
     // Free all **non-split** chunks in all arenas
     void FreeAllBlocks();
@@ -306,11 +307,11 @@ public:
     // Frees the memory, to the pool
     //
     // Args:
-    //     ptr (intptr_t): Pointer of the memory buffer
-    //     stream_ptr (cudaStream_t): Return the memory to the arena of given stream
-    void Free(intptr_t ptr, cudaStream_t stream_ptr = 0) {
+    //     ptr (intptr_t): Pointer of the memory buffer, which returns to
+    //         the arena of the stream it was allocated on
+    void Free(intptr_t ptr) {
         auto& mp = pools_[device_id()];
-        mp.Free(ptr, stream_ptr);
+        mp.Free(ptr);
     }
 
     // Free all **non-split** chunks in all arenas
@@ -140,6 +140,7 @@ public:
         TearDown(); SetUp(); TestMallocWithZero();
         TearDown(); SetUp(); TestFree();
         TearDown(); SetUp(); TestFreeDoubly();
+        TearDown(); SetUp(); TestFreeToAllocatedStream();
         TearDown(); SetUp(); TestMallocSplit();
         TearDown(); SetUp(); TestFreeMerge();
         TearDown(); SetUp(); TestFreeDifferentSize();
@@ -308,6 +309,17 @@ public:
         // pool_->Free(p1); // will abort
     }
 
+    void TestFreeToAllocatedStream() {
+        // arenas are keyed by the stream pointer, which is not dereferenced
+        cudaStream_t stream_ptr = reinterpret_cast<cudaStream_t>(1);
+        intptr_t p1 = pool_->Malloc(kRoundSize * 4, stream_ptr);
+        pool_->Free(p1);
+        intptr_t p2 = pool_->Malloc(kRoundSize * 4);
+        assert(p1 != p2);
+        intptr_t p3 = pool_->Malloc(kRoundSize * 4, stream_ptr);
+        assert(p1 == p3);
+    }
+
     void TestMallocSplit() {
         intptr_t p = pool_->Malloc(kRoundSize * 4);
         pool_->Free(p);
@@ -0,0 +1,97 @@
+#include "pinned_memory_pool_impl.hpp"
+
+#include <cassert>
+#include <new>
+
+namespace cumo {
+namespace internal {
+
+PinnedMemoryPool::~PinnedMemoryPool() {
+    FreeAllBlocks();
+}
+
+void* PinnedMemoryPool::Malloc(size_t size) {
+    int index = GetBinIndex(size);
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (static_cast<size_t>(index) < free_.size() && !free_[index].empty()) {
+            void* ptr = free_[index].back();
+            free_[index].pop_back();
+            in_use_[ptr] = index;
+            return ptr;
+        }
+    }
+
+    void* ptr = allocator_->Malloc(GetBinSize(index));
+    if (ptr == nullptr) {
+        // Retry after releasing cached blocks
+        FreeAllBlocks();
+        ptr = allocator_->Malloc(GetBinSize(index));
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    in_use_[ptr] = index;
+    return ptr;
+}
+
+void PinnedMemoryPool::Free(void* ptr) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto it = in_use_.find(ptr);
+    assert(it != in_use_.end());
+    if (it == in_use_.end()) {
+        return;
+    }
+    size_t index = it->second;
+    in_use_.erase(it);
+    if (free_.size() <= index) {
+        free_.resize(index + 1);
+    }
+    free_[index].emplace_back(ptr);
+}
+
+void PinnedMemoryPool::FreeAllBlocks() {
+    std::vector<void*> blocks;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        for (auto& free_list : free_) {
+            blocks.insert(blocks.end(), free_list.begin(), free_list.end());
+            free_list.clear();
+        }
+    }
+    for (void* ptr : blocks) {
+        allocator_->Free(ptr);
+    }
+}
+
+size_t PinnedMemoryPool::GetNumFreeBlocks() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    size_t n = 0;
+    for (auto& free_list : free_) {
+        n += free_list.size();
+    }
+    return n;
+}
+
+size_t PinnedMemoryPool::GetUsedBytes() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    size_t size = 0;
+    for (auto& kv : in_use_) {
+        size += GetBinSize(static_cast<int>(kv.second));
+    }
+    return size;
+}
+
+size_t PinnedMemoryPool::GetFreeBytes() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    size_t size = 0;
+    for (size_t index = 0; index < free_.size(); ++index) {
+        size += free_[index].size() * GetBinSize(static_cast<int>(index));
+    }
+    return size;
+}
+
+} // namespace internal
+} // namespace cumo
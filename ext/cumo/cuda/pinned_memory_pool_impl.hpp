@@ -0,0 +1,93 @@
+#ifndef CUMO_CUDA_PINNED_MEMORY_POOL_IMPL_H
+#define CUMO_CUDA_PINNED_MEMORY_POOL_IMPL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Pinned (page-locked) host memory pool to stage host to device copies.
+//
+// This header does not depend on CUDA so that the pool logic can be tested
+// with a host-only allocator.
+
+namespace cumo {
+namespace internal {
+
+// The smallest bin, cudaHostAlloc() allocates pages anyway
+constexpr size_t kPinnedMinBinSize = 4096; // bytes
+
+// Allocator of pinned host memory used by PinnedMemoryPool.
+class PinnedAllocator {
+public:
+    virtual ~PinnedAllocator() {}
+
+    // Returns nullptr if allocation fails.
+    virtual void* Malloc(size_t size) = 0;
+
+    virtual void Free(void* ptr) = 0;
+};
+
+// Memory pool of pinned host memory.
+//
+// - Sizes are rounded up to power-of-two bins. A freed block is reused for
+//   the same bin only, so blocks are never split nor merged.
+// - A block given to asynchronous copies must not be reused until the copies
+//   finish. The caller returns it by Free() from a stream callback, so Free()
+//   only updates lists and never calls the allocator.
+// - If the allocator fails, all free blocks are released and it retries once.
+class PinnedMemoryPool {
+private:
+    std::unique_ptr<PinnedAllocator> allocator_;
+    std::unordered_map<void*, size_t> in_use_; // ptr => bin index
+    std::vector<std::vector<void*>> free_; // bin index => free blocks
+    std::mutex mutex_;
+
+public:
+    explicit PinnedMemoryPool(std::unique_ptr<PinnedAllocator> allocator) : allocator_(std::move(allocator)) {}
+
+    ~PinnedMemoryPool();
+
+    // Allocates a block of at least size bytes, from the pool if possible.
+    //
+    // Throws std::bad_alloc if the allocator fails even after releasing free blocks.
+    void* Malloc(size_t size);
+
+    // Returns a block to the pool. Safe to call from a CUDA stream callback.
+    void Free(void* ptr);
+
+    // Releases all free blocks to the allocator.
+    void FreeAllBlocks();
+
+    size_t GetNumFreeBlocks();
+
+    size_t GetUsedBytes();
+
+    size_t GetFreeBytes();
+
+    size_t GetTotalBytes() {
+        return GetUsedBytes() + GetFreeBytes();
+    }
+
+// private:
+
+    static int GetBinIndex(size_t size) {
+        int index = 0;
+        size_t bin_size = kPinnedMinBinSize;
+        while (bin_size < size) {
+            bin_size <<= 1;
+            ++index;
+        }
+        return index;
+    }
+
+    static size_t GetBinSize(int index) {
+        return kPinnedMinBinSize << index;
+    }
+};
+
+} // namespace internal
+} // namespace cumo
+
+#endif /* ifndef CUMO_CUDA_PINNED_MEMORY_POOL_IMPL_H */
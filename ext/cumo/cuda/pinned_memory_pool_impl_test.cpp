@@ -0,0 +1,198 @@
+#include "pinned_memory_pool_impl.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <set>
+#include <thread>
+#include <vector>
+
+// Host-only tests. The fake allocator uses malloc instead of cudaHostAlloc.
+
+namespace cumo {
+namespace internal {
+
+class FakePinnedAllocator : public PinnedAllocator {
+public:
+    struct Stats {
+        size_t n_malloc = 0;
+        size_t n_free = 0;
+        size_t fail_after = static_cast<size_t>(-1); // fail mallocs after this many live blocks
+        std::set<void*> live;
+    };
+
+    explicit FakePinnedAllocator(Stats* stats) : stats_(stats) {}
+
+    void* Malloc(size_t size) override {
+        if (stats_->live.size() >= stats_->fail_after) {
+            return nullptr;
+        }
+        void* ptr = std::malloc(size);
+        ++stats_->n_malloc;
+        stats_->live.insert(ptr);
+        return ptr;
+    }
+
+    void Free(void* ptr) override {
+        assert(stats_->live.count(ptr) == 1);
+        ++stats_->n_free;
+        stats_->live.erase(ptr);
+        std::free(ptr);
+    }
+
+private:
+    Stats* stats_;
+};
+
+class TestPinnedMemoryPool {
+private:
+    FakePinnedAllocator::Stats stats_;
+    std::unique_ptr<PinnedMemoryPool> pool_;
+
+    void SetUp() {
+        pool_.reset();
+        stats_ = FakePinnedAllocator::Stats{};
+        pool_.reset(new PinnedMemoryPool(std::unique_ptr<PinnedAllocator>(new FakePinnedAllocator(&stats_))));
+    }
+
+public:
+    void Run() {
+        SetUp(); TestBinIndex();
+        SetUp(); TestReuse();
+        SetUp(); TestInUseIsNotReused();
+        SetUp(); TestBinsAreSeparated();
+        SetUp(); TestFreeAllBlocks();
+        SetUp(); TestRetryAfterFreeAllBlocks();
+        SetUp(); TestOutOfMemory();
+        SetUp(); TestFreeFromAnotherThread();
+        SetUp(); TestDestructor();
+    }
+
+    void TestBinIndex() {
+        assert(PinnedMemoryPool::GetBinIndex(0) == 0);
+        assert(PinnedMemoryPool::GetBinIndex(1) == 0);
+        assert(PinnedMemoryPool::GetBinIndex(kPinnedMinBinSize) == 0);
+        assert(PinnedMemoryPool::GetBinIndex(kPinnedMinBinSize + 1) == 1);
+        assert(PinnedMemoryPool::GetBinIndex(kPinnedMinBinSize * 2) == 1);
+        assert(PinnedMemoryPool::GetBinIndex(kPinnedMinBinSize * 3) == 2);
+        assert(PinnedMemoryPool::GetBinSize(2) == kPinnedMinBinSize * 4);
+    }
+
+    void TestReuse() {
+        void* p1 = pool_->Malloc(100);
+        assert(pool_->GetUsedBytes() == kPinnedMinBinSize);
+        pool_->Free(p1);
+        assert(pool_->GetUsedBytes() == 0);
+        assert(pool_->GetFreeBytes() == kPinnedMinBinSize);
+        assert(pool_->GetNumFreeBlocks() == 1);
+
+        // same bin reuses the block
+        void* p2 = pool_->Malloc(kPinnedMinBinSize);
+        assert(p2 == p1);
+        assert(stats_.n_malloc == 1);
+        assert(pool_->GetNumFreeBlocks() == 0);
+        pool_->Free(p2);
+    }
+
+    void TestInUseIsNotReused() {
+        // blocks waiting for a completion callback are still in use
+        void* p1 = pool_->Malloc(100);
+        void* p2 = pool_->Malloc(100);
+        assert(p1 != p2);
+        assert(stats_.n_malloc == 2);
+        pool_->Free(p2);
+        void* p3 = pool_->Malloc(100);
+        assert(p3 == p2);
+        pool_->Free(p1);
+        pool_->Free(p3);
+        assert(pool_->GetNumFreeBlocks() == 2);
+    }
+
+    void TestBinsAreSeparated() {
+        void* small = pool_->Malloc(kPinnedMinBinSize);
+        pool_->Free(small);
+        void* large = pool_->Malloc(kPinnedMinBinSize * 2);
+        assert(large != small);
+        assert(stats_.n_malloc == 2);
+        assert(pool_->GetUsedBytes() == kPinnedMinBinSize * 2);
+        assert(pool_->GetFreeBytes() == kPinnedMinBinSize);
+        assert(pool_->GetTotalBytes() == kPinnedMinBinSize * 3);
+        pool_->Free(large);
+    }
+
+    void TestFreeAllBlocks() {
+        void* p1 = pool_->Malloc(100);
+        void* p2 = pool_->Malloc(100000);
+        void* p3 = pool_->Malloc(100);
+        pool_->Free(p1);
+        pool_->Free(p2);
+        pool_->FreeAllBlocks();
+        assert(stats_.n_free == 2);
+        assert(pool_->GetNumFreeBlocks() == 0);
+        assert(pool_->GetFreeBytes() == 0);
+        // in-use blocks are kept
+        assert(stats_.live.count(p3) == 1);
+        pool_->Free(p3);
+    }
+
+    void TestRetryAfterFreeAllBlocks() {
+        void* p1 = pool_->Malloc(kPinnedMinBinSize * 2);
+        pool_->Free(p1);
+        stats_.fail_after = 1;
+        // a free block of another bin is released to make room
+        void* p2 = pool_->Malloc(kPinnedMinBinSize);
+        assert(stats_.n_free == 1);
+        assert(stats_.live.size() == 1);
+        assert(stats_.live.count(p2) == 1);
+        pool_->Free(p2);
+    }
+
+    void TestOutOfMemory() {
+        void* p1 = pool_->Malloc(100);
+        stats_.fail_after = 1;
+        bool thrown = false;
+        try {
+            pool_->Malloc(100);
+        } catch (const std::bad_alloc&) {
+            thrown = true;
+        }
+        assert(thrown);
+        pool_->Free(p1);
+    }
+
+    void TestFreeFromAnotherThread() {
+        // Free is called from stream callbacks on a CUDA driver thread
+        const int n = 64;
+        std::vector<void*> ptrs;
+        for (int i = 0; i < n; ++i) {
+            ptrs.push_back(pool_->Malloc(100 * (i % 4 + 1) * 1000));
+        }
+        std::thread th([&] {
+            for (int i = 0; i < n; i += 2) pool_->Free(ptrs[i]);
+        });
+        for (int i = 1; i < n; i += 2) pool_->Free(ptrs[i]);
+        th.join();
+        assert(pool_->GetUsedBytes() == 0);
+        assert(pool_->GetNumFreeBlocks() == static_cast<size_t>(n));
+    }
+
+    void TestDestructor() {
+        void* p1 = pool_->Malloc(100);
+        pool_->Malloc(100);
+        pool_->Free(p1);
+        pool_.reset();
+        // free blocks are released, in-use blocks may still be referred by copies
+        assert(stats_.n_free == 1);
+        assert(stats_.live.size() == 1);
+        std::free(*stats_.live.begin());
+    }
+};
+
+}  // namespace internal
+}  // namespace cumo
+
+int main() {
+    cumo::internal::TestPinnedMemoryPool{}.Run();
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <ruby.h>
+#include <cuda_runtime.h>
+#include "cumo/narray.h"
+#include "cumo/cuda/cublas.h"
+#include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
+
+VALUE cumo_cuda_cStream;
+#define cStream cumo_cuda_cStream
+
+#define check_status(status) (cumo_cuda_runtime_check_status((status)))
+
+// Thread local variable holding the pointer of the current stream as Integer.
+// Maintained by Cumo::CUDA::StreamScope in lib/cumo/cuda/stream.rb.
+static ID id_current_stream;
+
+cudaStream_t
+cumo_cuda_stream_current(void)
+{
+    VALUE ptr = rb_thread_local_aref(rb_thread_current(), id_current_stream);
+    if (NIL_P(ptr)) {
+        return 0;
+    }
+    return (cudaStream_t)NUM2SIZET(ptr);
+}
+
+typedef struct {
+    cudaStream_t stream;
+} cumo_cuda_stream_t;
+
+static void
+stream_free(void *ptr)
+{
+    cumo_cuda_stream_t *s = (cumo_cuda_stream_t*)ptr;
+    if (s->stream) {
+        cumo_cuda_cublas_release_stream(s->stream);
+        // Destroying a stream with pending work is fine, resources are released when it completes.
+        cudaStreamDestroy(s->stream);
+    }
+    xfree(s);
+}
+
+static size_t
+stream_memsize(const void *ptr)
+{
+    return sizeof(cumo_cuda_stream_t);
+}
+
+static const rb_data_type_t stream_data_type = {
+    "Cumo::CUDA::Stream",
+    {NULL, stream_free, stream_memsize,},
+    0, 0, RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+static VALUE
+stream_s_alloc(VALUE klass)
+{
+    cumo_cuda_stream_t *s;
+    return TypedData_Make_Struct(klass, cumo_cuda_stream_t, &stream_data_type, s);
+}
+
+static cudaStream_t
+get_stream(VALUE self)
+{
+    cumo_cuda_stream_t *s;
+    TypedData_Get_Struct(self, cumo_cuda_stream_t, &stream_data_type, s);
+    return s->stream;
+}
+
+/*
+  Creates a CUDA stream.
+  @overload initialize(non_blocking: false)
+  @param [Boolean] non_blocking (keyword) If true, the stream does not synchronize with the default stream.
+*/
+static VALUE
+stream_initialize(int argc, VALUE *argv, VALUE self)
+{
+    VALUE opts;
+    VALUE kw_values[1] = {Qundef};
+    ID kw_table[1];
+    unsigned int flags = cudaStreamDefault;
+    cumo_cuda_stream_t *s;
+
+    kw_table[0] = rb_intern("non_blocking");
+    rb_scan_args(argc, argv, ":", &opts);
+    rb_get_kwargs(opts, kw_table, 0, 1, kw_values);
+    if (kw_values[0] != Qundef && RTEST(kw_values[0])) {
+        flags = cudaStreamNonBlocking;
+    }
+
+    TypedData_Get_Struct(self, cumo_cuda_stream_t, &stream_data_type, s);
+    check_status(cudaStreamCreateWithFlags(&s->stream, flags));
+    return self;
+}
+
+/*
+  Raw pointer of the stream.
+  @return [Integer] cudaStream_t as an integer, 0 for the default stream.
+*/
+static VALUE
+stream_ptr(VALUE self)
+{
+    return SIZET2NUM((size_t)get_stream(self));
+}
+
+/*
+  Waits until all work queued on the stream completes.
+  @return [nil]
+*/
+static VALUE
+stream_synchronize(VALUE self)
+{
+    check_status(cudaStreamSynchronize(get_stream(self)));
+    return Qnil;
+}
+
+/*
+  Returns whether all work queued on the stream has completed.
+  @return [Boolean]
+*/
+static VALUE
+stream_done_p(VALUE self)
+{
+    cudaError_t status = cudaStreamQuery(get_stream(self));
+    if (status == cudaErrorNotReady) {
+        cudaGetLastError(); // reset last error to success
+        return Qfalse;
+    }
+    check_status(status);
+    return Qtrue;
+}
+
+/*
+  Makes work queued on the stream after this call wait for work queued on
+  other so far.
+  @param [Cumo::CUDA::Stream] other
+  @return [nil]
+*/
+static VALUE
+stream_wait(VALUE self, VALUE other)
+{
+    cudaEvent_t event;
+    check_status(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    check_status(cudaEventRecord(event, get_stream(other)));
+    check_status(cudaStreamWaitEvent(get_stream(self), event, 0));
+    check_status(cudaEventDestroy(event)); // released after the wait completes
+    return Qnil;
+}
+
+void
+Init_cumo_cuda_stream()
+{
+    VALUE mCumo = rb_define_module("Cumo");
+    VALUE mCUDA = rb_define_module_under(mCumo, "CUDA");
+
+    id_current_stream = rb_intern("__cumo_cuda_current_stream__");
+
+    cStream = rb_define_class_under(mCUDA, "Stream", rb_cObject);
+    rb_define_alloc_func(cStream, stream_s_alloc);
+    rb_define_method(cStream, "initialize", stream_initialize, -1);
+    rb_define_method(cStream, "ptr", stream_ptr, 0);
+    rb_define_method(cStream, "synchronize", stream_synchronize, 0);
+    rb_define_method(cStream, "done?", stream_done_p, 0);
+    rb_define_method(cStream, "wait", stream_wait, 1);
+    /* The default stream. */
+    rb_define_const(cStream, "NULL", rb_obj_freeze(stream_s_alloc(cStream)));
+}
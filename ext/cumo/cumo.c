@@ -2,13 +2,17 @@
 #include <ruby.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <cuda_runtime.h>
 #include "cumo.h"
 #include "cumo/narray.h"
+#include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
 
 void Init_cumo();
 void Init_cumo_narray();
 void Init_cumo_na_data();
 void Init_cumo_na_ndloop();
+void Init_cumo_na_thread_pool();
 void Init_cumo_na_step();
 void Init_cumo_na_index();
 void Init_cumo_bit();
@@ -21,6 +25,8 @@ void Init_cumo_uint16();
 void Init_cumo_uint32();
 void Init_cumo_uint64();
 void Init_cumo_sfloat();
+void Init_cumo_hfloat();
+void Init_cumo_bfloat16();
 void Init_cumo_scomplex();
 void Init_cumo_dfloat();
 void Init_cumo_dcomplex();
@@ -30,8 +36,10 @@ void Init_cumo_na_rand();
 void Init_cumo_na_array();
 void Init_cumo_na_struct();
 void Init_cumo_cuda_driver();
+void Init_cumo_cuda_function();
 void Init_cumo_cuda_memory_pool();
 void Init_cumo_cuda_runtime();
+void Init_cumo_cuda_stream();
 void Init_cumo_cuda_nvrtc();
 
 void
@@ -105,6 +113,72 @@ rb_compatible_mode_enabled_p(VALUE self)
     return (cumo_compatible_mode_enabled ? Qtrue : Qfalse);
 }
 
+// func_name => number of synchronizations, keys are string literals
+static st_table *cumo_sync_stats;
+
+/*
+  Waits for kernels before host code accesses device memory, and counts it
+  for Cumo.sync_stats. Called with the GVL held.
+
+  Without concurrent managed access, the host must not touch managed memory
+  while any kernel runs on the device, so the whole device is synchronized.
+  Otherwise waiting for the current stream, on which kernels are launched,
+  is enough.
+*/
+void
+cumo_synchronize_for_host(const char *func_name)
+{
+    st_data_t count = 0;
+    int device = 0;
+    int concurrent = 0;
+
+    st_lookup(cumo_sync_stats, (st_data_t)func_name, &count);
+    st_insert(cumo_sync_stats, (st_data_t)func_name, (st_data_t)(count + 1));
+    cumo_cuda_runtime_check_status(cudaGetDevice(&device));
+    cumo_cuda_runtime_check_status(cudaDeviceGetAttribute(&concurrent, cudaDevAttrConcurrentManagedAccess, device));
+    if (concurrent) {
+        cumo_cuda_runtime_check_status(cudaStreamSynchronize(cumo_cuda_stream_current()));
+    } else {
+        cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    }
+}
+
+static int
+sync_stats_i(st_data_t key, st_data_t value, st_data_t arg)
+{
+    rb_hash_aset((VALUE)arg, rb_str_new_cstr((const char*)key), SIZET2NUM((size_t)value));
+    return ST_CONTINUE;
+}
+
+/*
+  Returns the number of implicit synchronizations between CPU and GPU
+  triggered by each method since start or Cumo.clear_sync_stats.
+
+  @return [Hash{String=>Integer}] method name => number of synchronizations
+  @example
+    Cumo::DFloat.new(3).seq.sort
+    Cumo.sync_stats  # => {"sort"=>1}
+ */
+static VALUE
+rb_sync_stats(VALUE self)
+{
+    VALUE hash = rb_hash_new();
+    st_foreach(cumo_sync_stats, sync_stats_i, (st_data_t)hash);
+    return hash;
+}
+
+/*
+  Clears counters of Cumo.sync_stats.
+
+  @return [nil]
+ */
+static VALUE
+rb_clear_sync_stats(VALUE self)
+{
+    st_clear(cumo_sync_stats);
+    return Qnil;
+}
+
 /* initialization of Cumo Module */
 void
 Init_cumo()
@@ -119,6 +193,10 @@ Init_cumo()
     rb_define_singleton_method(mCumo, "enable_compatible_mode", RUBY_METHOD_FUNC(rb_enable_compatible_mode), 0);
     rb_define_singleton_method(mCumo, "disable_compatible_mode", RUBY_METHOD_FUNC(rb_disable_compatible_mode), 0);
     rb_define_singleton_method(mCumo, "compatible_mode_enabled?", RUBY_METHOD_FUNC(rb_compatible_mode_enabled_p), 0);
+    rb_define_singleton_method(mCumo, "sync_stats", RUBY_METHOD_FUNC(rb_sync_stats), 0);
+    rb_define_singleton_method(mCumo, "clear_sync_stats", RUBY_METHOD_FUNC(rb_clear_sync_stats), 0);
+
+    cumo_sync_stats = st_init_strtable();
 
     // default is false
     env = getenv("CUMO_COMPATIBLE_MODE");
@@ -139,11 +217,14 @@ Init_cumo()
 
     Init_cumo_na_data();
     Init_cumo_na_ndloop();
+    Init_cumo_na_thread_pool();
 
     Init_cumo_dcomplex();
     Init_cumo_dfloat();
     Init_cumo_scomplex();
     Init_cumo_sfloat();
+    Init_cumo_hfloat();
+    Init_cumo_bfloat16();
 
     Init_cumo_int64();
     Init_cumo_uint64();
@@ -164,7 +245,9 @@ Init_cumo()
     Init_cumo_na_struct();
 
     Init_cumo_cuda_driver();
+    Init_cumo_cuda_function();
     Init_cumo_cuda_memory_pool();
     Init_cumo_cuda_runtime();
+    Init_cumo_cuda_stream();
     Init_cumo_cuda_nvrtc();
 }
@@ -68,6 +68,8 @@ narray/step
 narray/index
 narray/index_kernel
 narray/ndloop
+narray/thread_pool
+narray/thread_pool_impl
 narray/data
 narray/data_kernel
 narray/types/bit
@@ -81,6 +83,8 @@ narray/types/uint32
 narray/types/uint64
 narray/types/sfloat
 narray/types/dfloat
+narray/types/hfloat
+narray/types/bfloat16
 narray/types/scomplex
 narray/types/dcomplex
 narray/types/robject
@@ -95,18 +99,25 @@ narray/types/uint32_kernel
 narray/types/uint64_kernel
 narray/types/sfloat_kernel
 narray/types/dfloat_kernel
+narray/types/hfloat_kernel
+narray/types/bfloat16_kernel
 narray/types/scomplex_kernel
 narray/types/dcomplex_kernel
 narray/types/robject_kernel
 narray/math
-narray/SFMT
 narray/struct
 narray/rand
+narray/rand_kernel
+narray/histogram
+narray/select
 cuda/cublas
 cuda/driver
+cuda/function
 cuda/memory_pool
 cuda/memory_pool_impl
+cuda/pinned_memory_pool_impl
 cuda/runtime
+cuda/stream
 cuda/nvrtc
 )
 
@@ -115,6 +126,15 @@ if RUBY_VERSION[0..3] == "2.1."
   srcs << "kwargs"
 end
 
+# Each generated type source is split into this many parts by its generator,
+# so that they are compiled in parallel and an edit of a template rebuilds
+# only the parts that use it.
+CUMO_SPLIT_PARTS = (ENV['CUMO_SPLIT_PARTS'] || 8).to_i
+srcs = srcs.flat_map do |src|
+  next [src] unless %r{\Anarray/types/(\w+?)(_kernel)?\z} =~ src
+  [src] + (1...CUMO_SPLIT_PARTS).map {|i| "narray/types/#{$1}_p#{i}#{$2}" }
+end
+
 $objs = srcs.map {|src| "#{src}.o" }
 
 dir_config("narray")
@@ -38,6 +38,24 @@ bool cumo_warning_once_enabled_p();
 #define CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE( func_name, type_name ) \
     CUMO_SHOW_WARNING_ONCE("Warning: Method \"" func_name "\" for dtype \"" type_name "\" synchronizes with CPU.\n")
 
+void cumo_synchronize_for_host(const char *func_name);
+
+/*
+  Host code reading or writing device memory waits for kernels queued on the
+  stream (not the whole device) and counts it in Cumo.sync_stats.
+*/
+#define CUMO_SYNCHRONIZE_FIXME( func_name, type_name ) \
+    { \
+        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE( func_name, type_name ); \
+        cumo_synchronize_for_host( func_name ); \
+    }
+
+#define CUMO_SYNCHRONIZE( func_name, type_name ) \
+    { \
+        CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE( func_name, type_name ); \
+        cumo_synchronize_for_host( func_name ); \
+    }
+
 #if defined(__cplusplus)
 #if 0
 { /* satisfy cc-mode */
@@ -0,0 +1,165 @@
+#ifndef CUMO_BIT_WORD_H
+#define CUMO_BIT_WORD_H
+
+/* Shared by Bit kernels and their host implementations.
+ *
+ * Contiguous bit arrays are processed a CUMO_BIT_DIGIT word at a time. The
+ * bits of an input are shift-merged from two words if its offset differs
+ * from that of the output. Each output word is written by one thread, so
+ * partial words at both ends need no atomics. Strided and indexed arrays
+ * are processed a bit at a time, and the device stores bits atomically.
+ */
+
+#ifdef __CUDACC__
+
+/* Returns len (<= CUMO_NB) bits of a from bit position pos in the low bits.
+ * Bits above len are undefined. */
+__device__ static inline CUMO_BIT_DIGIT
+cumo_bit_load_word(const CUMO_BIT_DIGIT *a, size_t pos, size_t len)
+{
+    size_t o = pos % CUMO_NB;
+    CUMO_BIT_DIGIT x;
+
+    a += pos / CUMO_NB;
+    x = a[0] >> o;
+    if (o > 0 && o + len > CUMO_NB) {
+        x |= a[1] << (CUMO_NB - o);
+    }
+    return x;
+}
+
+__device__ static inline CUMO_BIT_DIGIT
+cumo_bit_load_step(const CUMO_BIT_DIGIT *a, size_t p, ssize_t s, const size_t *idx, uint64_t i)
+{
+    size_t pos = idx ? p + idx[i] : p + i * s;
+    return (a[pos / CUMO_NB] >> (pos % CUMO_NB)) & 1u;
+}
+
+__device__ static inline void
+cumo_bit_store_step(CUMO_BIT_DIGIT *a, size_t p, ssize_t s, const size_t *idx, uint64_t i, CUMO_BIT_DIGIT x)
+{
+    size_t pos = idx ? p + idx[i] : p + i * s;
+    CUMO_STORE_BIT(a, pos, x & 1u);
+}
+
+/* Word k of a3 is op of the words of a1 and a2 at the same elements.
+ * a2 is NULL for unary ops, and its first bit is broadcasted if s2 is 0. */
+template <typename Op>
+__global__ void
+cumo_bit_map_word_kernel(Op op, const CUMO_BIT_DIGIT *a1, size_t p1, const CUMO_BIT_DIGIT *a2, size_t p2, ssize_t s2, CUMO_BIT_DIGIT *a3, size_t p3, uint64_t n, uint64_t n_words)
+{
+    for (uint64_t k = blockIdx.x * blockDim.x + threadIdx.x; k < n_words; k += blockDim.x * gridDim.x) {
+        size_t lo = (k == 0) ? p3 : k * CUMO_NB;
+        size_t hi = ((k + 1) * CUMO_NB < p3 + n) ? (k + 1) * CUMO_NB : p3 + n;
+        size_t e = lo - p3;
+        int sh = lo - k * CUMO_NB;
+        CUMO_BIT_DIGIT mask = CUMO_SLB(hi - lo) << sh;
+        CUMO_BIT_DIGIT x = cumo_bit_load_word(a1, p1 + e, hi - lo);
+        CUMO_BIT_DIGIT y = 0;
+        CUMO_BIT_DIGIT z;
+
+        if (a2) {
+            if (s2 == 0) {
+                y = -((a2[p2 / CUMO_NB] >> (p2 % CUMO_NB)) & 1u);
+            } else {
+                y = cumo_bit_load_word(a2, p2 + e, hi - lo);
+            }
+        }
+        z = op(x, y) << sh;
+        if (mask == CUMO_BALL) {
+            a3[k] = z;
+        } else {
+            a3[k] = (z & mask) | (a3[k] & ~mask);
+        }
+    }
+}
+
+template <typename Op>
+__global__ void
+cumo_bit_map_step_kernel(Op op, const CUMO_BIT_DIGIT *a1, size_t p1, ssize_t s1, const size_t *idx1, const CUMO_BIT_DIGIT *a2, size_t p2, ssize_t s2, const size_t *idx2, CUMO_BIT_DIGIT *a3, size_t p3, ssize_t s3, const size_t *idx3, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        CUMO_BIT_DIGIT x = cumo_bit_load_step(a1, p1, s1, idx1, i);
+        CUMO_BIT_DIGIT y = a2 ? cumo_bit_load_step(a2, p2, s2, idx2, i) : 0;
+        cumo_bit_store_step(a3, p3, s3, idx3, i, op(x, y));
+    }
+}
+
+/* Stores op(x, y) of n bits to a3, where y is 0 if a2 is NULL.
+ * Positions p1, p2, p3 are bit offsets from a1, a2, a3. */
+template <typename Op>
+static inline void
+cumo_bit_map_launch(Op op, const CUMO_BIT_DIGIT *a1, size_t p1, ssize_t s1, const size_t *idx1, const CUMO_BIT_DIGIT *a2, size_t p2, ssize_t s2, const size_t *idx2, CUMO_BIT_DIGIT *a3, size_t p3, ssize_t s3, const size_t *idx3, uint64_t n)
+{
+    if (n == 0) {
+        return;
+    }
+    a1 += p1 / CUMO_NB; p1 %= CUMO_NB;
+    a3 += p3 / CUMO_NB; p3 %= CUMO_NB;
+    if (a2) {
+        a2 += p2 / CUMO_NB; p2 %= CUMO_NB;
+    }
+    if (s1 == 1 && s3 == 1 && !idx1 && !idx3 && (!a2 || ((s2 == 1 || s2 == 0) && !idx2))) {
+        uint64_t n_words = (p3 + n + CUMO_NB - 1) / CUMO_NB;
+        size_t grid_dim = cumo_get_grid_dim(n_words);
+        size_t block_dim = cumo_get_block_dim(n_words);
+        cumo_bit_map_word_kernel<<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(op, a1, p1, a2, p2, s2, a3, p3, n, n_words);
+    } else {
+        size_t grid_dim = cumo_get_grid_dim(n);
+        size_t block_dim = cumo_get_block_dim(n);
+        cumo_bit_map_step_kernel<<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(op, a1, p1, s1, idx1, a2, p2, s2, idx2, a3, p3, s3, idx3, n);
+    }
+}
+
+#else // __CUDACC__
+
+#include "cumo/thread_pool.h"
+
+// Words of the output per chunk of host threads.
+#define CUMO_BIT_WORD_GRAIN_SIZE 4096
+
+/* Runs func(begin, end, data) for element ranges of n bits written from bit
+ * position p (< CUMO_NB) of the output. The ranges start at word boundaries
+ * of the output except the first one, so that threads write separate words.
+ * Called with the GVL, which is released while func runs. */
+typedef void (*cumo_bit_word_func_t)(size_t begin, size_t end, void *data);
+
+typedef struct {
+    size_t p;
+    size_t n;
+    cumo_bit_word_func_t func;
+    void *data;
+} cumo_bit_word_parallel_t;
+
+static inline void
+cumo_bit_word_parallel_run(size_t begin, size_t end, size_t tid, void *ptr)
+{
+    cumo_bit_word_parallel_t *w = (cumo_bit_word_parallel_t*)ptr;
+    size_t b = begin * CUMO_NB;
+    size_t e = end * CUMO_NB - w->p;
+
+    b = (b > w->p) ? b - w->p : 0;
+    if (e > w->n) {
+        e = w->n;
+    }
+    if (b < e) {
+        w->func(b, e, w->data);
+    }
+}
+
+static inline void
+cumo_bit_word_parallel(size_t p, size_t n, cumo_bit_word_func_t func, void *data)
+{
+    cumo_bit_word_parallel_t w = {p, n, func, data};
+    size_t n_words = (p + n + CUMO_NB - 1) / CUMO_NB;
+
+    if (n_words <= CUMO_BIT_WORD_GRAIN_SIZE) {
+        func(0, n, data);
+        return;
+    }
+    cumo_thread_pool_parallel_for(n_words, CUMO_BIT_WORD_GRAIN_SIZE, 0, cumo_thread_pool_get_num_threads(), cumo_bit_word_parallel_run, &w);
+}
+
+#endif // __CUDACC__
+
+#endif // CUMO_BIT_WORD_H
@@ -17,6 +17,9 @@ cumo_cuda_cublas_check_status(cublasStatus_t status);
 cublasHandle_t
 cumo_cuda_cublas_handle();
 
+void
+cumo_cuda_cublas_release_stream(cudaStream_t stream);
+
 VALUE
 cumo_cuda_cublas_option_value(VALUE value, VALUE default_value);
 
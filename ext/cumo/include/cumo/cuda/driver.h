@@ -12,6 +12,8 @@ extern "C" {
 extern VALUE cumo_cuda_eDriverError;
 extern VALUE cumo_cuda_mDriver;
 
+void cumo_cuda_driver_check_status(CUresult status);
+
 #if defined(__cplusplus)
 #if 0
 { /* satisfy cc-mode */
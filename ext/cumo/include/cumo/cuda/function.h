@@ -0,0 +1,34 @@
+#ifndef CUMO_CUDA_FUNCTION_H
+#define CUMO_CUDA_FUNCTION_H
+#include <cuda.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#if 0
+} /* satisfy cc-mode */
+#endif
+#endif
+
+// A kernel compiled by NVRTC on first use.
+typedef struct {
+    CUfunction func; // NULL if not available
+    int compiled;    // nonzero once compilation was tried
+} cumo_cuda_jit_function_t;
+
+// Kernels of a launcher compiled by NVRTC, which is a static variable of
+// each launcher. Kernels are loaded into the context of each device, so
+// they are cached per device and per ndim.
+typedef struct {
+    cumo_cuda_jit_function_t *functions; // allocated on first use
+} cumo_cuda_jit_cache_t;
+
+int cumo_cuda_function_launch_jit_binary(cumo_cuda_jit_cache_t *cache, const char *type_name, const char *op, int ndim, size_t grid_dim, size_t block_dim, void **params);
+
+#if defined(__cplusplus)
+#if 0
+{ /* satisfy cc-mode */
+#endif
+}  /* extern "C" { */
+#endif
+
+#endif /* ifndef CUMO_CUDA_FUNCTION_H */
@@ -1,6 +1,7 @@
 #ifndef CUMO_CUDA_MEMORY_POOL_H
 #define CUMO_CUDA_MEMORY_POOL_H
 
+#include <cuda_runtime.h>
 #include "cumo/narray.h"
 
 #if defined(__cplusplus)
@@ -18,6 +19,19 @@ cumo_cuda_runtime_malloc(size_t size);
 void
 cumo_cuda_runtime_free(char *ptr);
 
+// Frees ptr allocated on stream, which is about to be destroyed, and the
+// free blocks of its arena. Never raises, so finalizers can call it.
+void
+cumo_cuda_runtime_free_on_stream_release(char *ptr, cudaStream_t stream);
+
+// Pinned host memory to stage host to device copies
+char*
+cumo_cuda_runtime_malloc_pinned(size_t size);
+
+// Returns a pinned block to the pool after copies enqueued so far finish
+void
+cumo_cuda_runtime_free_pinned(char *ptr);
+
 #if defined(__cplusplus)
 #if 0
 { /* satisfy cc-mode */
@@ -0,0 +1,27 @@
+#ifndef CUMO_CUDA_STREAM_H
+#define CUMO_CUDA_STREAM_H
+#include <cuda_runtime.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#if 0
+} /* satisfy cc-mode */
+#endif
+#endif
+
+/*
+  Returns the stream selected by Cumo::CUDA.with_stream on the current
+  thread, or the default stream (0) outside of it.
+  Kernel launches, cuBLAS calls and memory pool allocations use this stream.
+  Must be called with the GVL held.
+*/
+cudaStream_t cumo_cuda_stream_current(void);
+
+#if defined(__cplusplus)
+#if 0
+{ /* satisfy cc-mode */
+#endif
+}  /* extern "C" { */
+#endif
+
+#endif /* ifndef CUMO_CUDA_STREAM_H */
@@ -0,0 +1,237 @@
+#ifndef CUMO_FLOAT16_H
+#define CUMO_FLOAT16_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+/* 16-bit floating point numbers stored as bits.
+ *
+ * cumo_hfloat is IEEE 754 binary16 (1 sign, 5 exponent, 10 fraction bits)
+ * and cumo_bfloat16 is the upper half of binary32 (1 sign, 8 exponent,
+ * 7 fraction bits). Arithmetic is done in float.
+ *
+ * Conversions are done with integer operations so that host and device
+ * give bit-identical results. Narrowing rounds to nearest even. NaNs stay
+ * quiet NaNs with the sign and the upper payload bits kept.
+ * Narrowing from double first rounds to float with round-to-odd, which
+ * has enough extra bits to make the second rounding exact, i.e., there is
+ * no double rounding.
+ */
+
+#ifdef __CUDACC__
+#define CUMO_FLOAT16_FUNC __host__ __device__ static inline
+#define CUMO_FLOAT16_MEMBER __host__ __device__
+#else
+#define CUMO_FLOAT16_FUNC static inline
+#define CUMO_FLOAT16_MEMBER
+#endif
+
+CUMO_FLOAT16_FUNC uint32_t
+cumo_float_to_bits(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+CUMO_FLOAT16_FUNC float
+cumo_bits_to_float(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/* Rounds x to float with round-to-odd, i.e., truncates and sets the lowest
+   bit if inexact. */
+CUMO_FLOAT16_FUNC float
+cumo_double_to_float_round_to_odd(double x)
+{
+    float f = (float)x;
+    uint32_t u;
+    if (x != x || (double)f == x) {
+        return f;
+    }
+    u = cumo_float_to_bits(f);
+    if (fabs((double)f) > fabs(x)) {
+        --u; // toward zero; also turns an overflowed infinity into FLT_MAX
+    }
+    return cumo_bits_to_float(u | 1);
+}
+
+/* --------- binary16 --------- */
+
+CUMO_FLOAT16_FUNC uint16_t
+cumo_float_to_hfloat_bits(float f)
+{
+    uint32_t u = cumo_float_to_bits(f);
+    uint32_t sign = (u >> 16) & 0x8000;
+    uint32_t exponent = (u >> 23) & 0xff;
+    uint32_t mantissa = u & 0x7fffff;
+    int e = (int)exponent - 127 + 15;
+    uint32_t r, rest, half;
+    int shift;
+
+    if (exponent == 0xff) {
+        if (mantissa == 0) {
+            return (uint16_t)(sign | 0x7c00); // infinity
+        }
+        return (uint16_t)(sign | 0x7e00 | (mantissa >> 13)); // quiet NaN
+    }
+    if (e >= 31) {
+        return (uint16_t)(sign | 0x7c00); // overflow
+    }
+    if (e <= 0) {
+        // subnormal or zero: value = m * 2^-24
+        if (e < -10) {
+            return (uint16_t)sign; // less than half of the smallest subnormal
+        }
+        mantissa |= 0x800000;
+        shift = 14 - e;
+        r = mantissa >> shift;
+        rest = mantissa & ((1U << shift) - 1);
+        half = 1U << (shift - 1);
+    } else {
+        r = ((uint32_t)e << 10) | (mantissa >> 13);
+        rest = mantissa & 0x1fff;
+        half = 0x1000;
+    }
+    // a carry propagates to the exponent, up to infinity
+    if (rest > half || (rest == half && (r & 1))) {
+        ++r;
+    }
+    return (uint16_t)(sign | r);
+}
+
+CUMO_FLOAT16_FUNC float
+cumo_hfloat_bits_to_float(uint16_t h)
+{
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    int e;
+
+    if (exponent == 0x1f) {
+        return cumo_bits_to_float(sign | 0x7f800000 | (mantissa << 13));
+    }
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            return cumo_bits_to_float(sign);
+        }
+        // normalize subnormal
+        e = -14;
+        while (!(mantissa & 0x400)) {
+            mantissa <<= 1;
+            --e;
+        }
+        return cumo_bits_to_float(sign | ((uint32_t)(e + 127) << 23) | ((mantissa & 0x3ff) << 13));
+    }
+    return cumo_bits_to_float(sign | ((exponent - 15 + 127) << 23) | (mantissa << 13));
+}
+
+CUMO_FLOAT16_FUNC uint16_t
+cumo_double_to_hfloat_bits(double x)
+{
+    return cumo_float_to_hfloat_bits(cumo_double_to_float_round_to_odd(x));
+}
+
+/* --------- bfloat16 --------- */
+
+CUMO_FLOAT16_FUNC uint16_t
+cumo_float_to_bfloat16_bits(float f)
+{
+    uint32_t u = cumo_float_to_bits(f);
+    if ((u & 0x7fffffff) > 0x7f800000) {
+        return (uint16_t)((u >> 16) | 0x0040); // quiet NaN
+    }
+    // a carry propagates to the exponent, up to infinity
+    u += 0x7fff + ((u >> 16) & 1);
+    return (uint16_t)(u >> 16);
+}
+
+CUMO_FLOAT16_FUNC float
+cumo_bfloat16_bits_to_float(uint16_t h)
+{
+    return cumo_bits_to_float((uint32_t)h << 16);
+}
+
+CUMO_FLOAT16_FUNC uint16_t
+cumo_double_to_bfloat16_bits(double x)
+{
+    return cumo_float_to_bfloat16_bits(cumo_double_to_float_round_to_odd(x));
+}
+
+/* --------- types --------- */
+
+/* In C++ (kernels), the types convert implicitly from and to float so that
+   templates written for float work, while arithmetic is done in float. */
+#ifdef __cplusplus
+#define CUMO_FLOAT16_TYPE(name, to_bits, from_bits, double_to_bits)        \
+    struct name {                                                        \
+        uint16_t bits;                                                   \
+        name() = default;                                                \
+        CUMO_FLOAT16_MEMBER name(float x) : bits(to_bits(x)) {}          \
+        template <typename T>                                            \
+        CUMO_FLOAT16_MEMBER name(T x) : bits(double_to_bits((double)x)) {} \
+        CUMO_FLOAT16_MEMBER operator float() const { return from_bits(bits); } \
+        CUMO_FLOAT16_MEMBER name& operator+=(float x) { return *this = (float)*this + x; } \
+        CUMO_FLOAT16_MEMBER name& operator-=(float x) { return *this = (float)*this - x; } \
+        CUMO_FLOAT16_MEMBER name& operator*=(float x) { return *this = (float)*this * x; } \
+        CUMO_FLOAT16_MEMBER name& operator/=(float x) { return *this = (float)*this / x; } \
+    }
+#else
+#define CUMO_FLOAT16_TYPE(name, to_bits, from_bits, double_to_bits)        \
+    struct name {                                                        \
+        uint16_t bits;                                                   \
+    }
+#endif
+
+#ifdef __cplusplus
+extern "C++" {  // may be included in extern "C"
+#endif
+typedef CUMO_FLOAT16_TYPE(cumo_hfloat, cumo_float_to_hfloat_bits, cumo_hfloat_bits_to_float, cumo_double_to_hfloat_bits) cumo_hfloat;
+typedef CUMO_FLOAT16_TYPE(cumo_bfloat16, cumo_float_to_bfloat16_bits, cumo_bfloat16_bits_to_float, cumo_double_to_bfloat16_bits) cumo_bfloat16;
+#ifdef __cplusplus
+
+/* Type in which reductions accumulate T. 16-bit floats are accumulated
+   in float. */
+template <typename T> struct cumo_accum { typedef T type; };
+template <> struct cumo_accum<cumo_hfloat> { typedef float type; };
+template <> struct cumo_accum<cumo_bfloat16> { typedef float type; };
+}
+#endif
+
+CUMO_FLOAT16_FUNC float
+cumo_hfloat_to_float(cumo_hfloat x)
+{
+    return cumo_hfloat_bits_to_float(x.bits);
+}
+
+CUMO_FLOAT16_FUNC cumo_hfloat
+cumo_hfloat_from_double(double x)
+{
+    cumo_hfloat h;
+    h.bits = cumo_double_to_hfloat_bits(x);
+    return h;
+}
+
+CUMO_FLOAT16_FUNC float
+cumo_bfloat16_to_float(cumo_bfloat16 x)
+{
+    return cumo_bfloat16_bits_to_float(x.bits);
+}
+
+CUMO_FLOAT16_FUNC cumo_bfloat16
+cumo_bfloat16_from_double(double x)
+{
+    cumo_bfloat16 h;
+    h.bits = cumo_double_to_bfloat16_bits(x);
+    return h;
+}
+
+/* Used by store_from of other types, which define m_from_real. */
+#define m_from_hfloat(x)   m_from_real(cumo_hfloat_to_float(x))
+#define m_from_bfloat16(x) m_from_real(cumo_bfloat16_to_float(x))
+
+#endif /* ifndef CUMO_FLOAT16_H */
@@ -0,0 +1,157 @@
+#ifndef CUMO_HISTOGRAM_H
+#define CUMO_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/* Shared by bincount and histogram kernels and their host implementations.
+ *
+ * Both count into privatized sub-histograms, per block in shared memory on
+ * the device and per thread on the host, and add them into the output at the
+ * end, so that most increments do not contend on the same bins.
+ */
+
+#ifdef __CUDACC__
+#define CUMO_HISTOGRAM_FUNC __host__ __device__ static inline
+#else
+#define CUMO_HISTOGRAM_FUNC static inline
+#endif
+
+// Bins are privatized per block if they fit in this many bytes of shared memory.
+#define CUMO_HISTOGRAM_SHARED_BYTES 32768
+
+/* Lower edge of bin i of nbins equal bins on [lo, hi]. Edge nbins is hi. */
+CUMO_HISTOGRAM_FUNC double
+cumo_histogram_edge(double lo, double hi, int64_t nbins, int64_t i)
+{
+    return (i == nbins) ? hi : lo + (hi - lo) * ((double)i / (double)nbins);
+}
+
+/* Returns the bin of x, or -1 if x is out of [lo, hi] or NaN.
+ * Bin i is [edge(i), edge(i+1)), except that the last bin includes hi. */
+CUMO_HISTOGRAM_FUNC int64_t
+cumo_histogram_bin(double x, double lo, double hi, int64_t nbins)
+{
+    int64_t i;
+    if (!(x >= lo && x <= hi)) {
+        return -1;
+    }
+    i = (int64_t)((x - lo) * ((double)nbins / (hi - lo)));
+    if (i >= nbins) {
+        i = nbins - 1;
+    }
+    // agree with the edges, which may differ by rounding
+    if (i > 0 && x < cumo_histogram_edge(lo, hi, nbins, i)) {
+        i--;
+    } else if (i + 1 < nbins && x >= cumo_histogram_edge(lo, hi, nbins, i + 1)) {
+        i++;
+    }
+    return i;
+}
+
+#ifdef __CUDACC__
+__device__ static inline void
+cumo_histogram_atomic_add(unsigned int *p, unsigned int v) { atomicAdd(p, v); }
+
+__device__ static inline void
+cumo_histogram_atomic_add(unsigned long long *p, unsigned long long v) { atomicAdd(p, v); }
+
+__device__ static inline void
+cumo_histogram_atomic_add(float *p, float v) { atomicAdd(p, v); }
+
+__device__ static inline void
+cumo_histogram_atomic_add(double *p, double v)
+{
+#if __CUDA_ARCH__ >= 600
+    atomicAdd(p, v);
+#else
+    unsigned long long *q = (unsigned long long*)p;
+    unsigned long long old = *q, assumed;
+    do {
+        assumed = old;
+        old = atomicCAS(q, assumed, (unsigned long long)__double_as_longlong(v + __longlong_as_double((long long)assumed)));
+    } while (assumed != old);
+#endif
+}
+
+template <typename T>
+__global__ void
+cumo_histogram_zero_kernel(char *p, ssize_t s, uint64_t length)
+{
+    for (uint64_t j = blockIdx.x * blockDim.x + threadIdx.x; j < length; j += blockDim.x * gridDim.x) {
+        *(T*)(p + j * s) = 0;
+    }
+}
+
+/* Adds weight(i) to bin(i) of the output for i in [0, n), skipping negative
+ * bins. If privatize, each block counts into length bins of T in dynamic
+ * shared memory and adds non-zero bins to the output at the end. */
+template <typename T, typename BinFunc, typename WeightFunc>
+__device__ void
+cumo_histogram_count(BinFunc bin, WeightFunc weight, char *p3, ssize_t s3, uint64_t n, uint64_t length, bool privatize)
+{
+    extern __shared__ unsigned long long cumo_histogram_shared[];
+    T *shared = (T*)cumo_histogram_shared;
+
+    if (privatize) {
+        for (uint64_t j = threadIdx.x; j < length; j += blockDim.x) {
+            shared[j] = 0;
+        }
+        __syncthreads();
+    }
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        int64_t b = bin(i);
+        if (b < 0) {
+            continue;
+        }
+        if (privatize) {
+            cumo_histogram_atomic_add(&shared[b], (T)weight(i));
+        } else {
+            cumo_histogram_atomic_add((T*)(p3 + b * s3), (T)weight(i));
+        }
+    }
+    if (privatize) {
+        __syncthreads();
+        for (uint64_t j = threadIdx.x; j < length; j += blockDim.x) {
+            if (shared[j] != 0) {
+                cumo_histogram_atomic_add((T*)(p3 + j * s3), shared[j]);
+            }
+        }
+    }
+}
+
+/* Zeroes the output and returns whether bins fit in shared memory.
+ * Privatized launches use fewer blocks to bound the merge. */
+template <typename T>
+static inline bool
+cumo_histogram_prepare(char *p3, ssize_t s3, uint64_t n, uint64_t length, size_t *grid_dim, size_t *block_dim, size_t *shared_bytes)
+{
+    bool privatize = length * sizeof(T) <= CUMO_HISTOGRAM_SHARED_BYTES;
+
+    cumo_histogram_zero_kernel<T><<<cumo_get_grid_dim(length), cumo_get_block_dim(length), 0, cumo_cuda_stream_current()>>>(p3, s3, length);
+    *grid_dim = cumo_get_grid_dim(n);
+    *block_dim = cumo_get_block_dim(n);
+    *shared_bytes = 0;
+    if (privatize) {
+        if (*grid_dim > 1024) {
+            *grid_dim = 1024;
+        }
+        *shared_bytes = length * sizeof(T);
+    }
+    return privatize;
+}
+#endif // __CUDACC__
+
+#ifndef __CUDACC__
+// histogram.c
+
+/* Counts elements [begin, end) into bins, which are uint64_t[length], or
+ * double[length] if weighted. Runs without the GVL. */
+typedef void (*cumo_na_host_histogram_func_t)(size_t begin, size_t end, void *bins, void *data);
+
+void*
+cumo_na_host_histogram(size_t n, size_t length, int weighted, cumo_na_host_histogram_func_t func, void *data);
+#endif
+
+#endif // CUMO_HISTOGRAM_H
@@ -37,6 +37,18 @@ typedef struct {
     cumo_na_indexer_t out_indexer;
 } cumo_na_reduction_arg_t;
 
+/* A reduction of an element-wise function of two inputs, e.g., mulsum.
+ *
+ * in2 is broadcasted to the shape of in, and is indexed by in_indexer.
+ */
+typedef struct {
+    cumo_na_iarray_t in;
+    cumo_na_iarray_t in2;
+    cumo_na_iarray_t out;
+    cumo_na_indexer_t in_indexer;
+    cumo_na_indexer_t out_indexer;
+} cumo_na_binary_reduction_arg_t;
+
 #ifndef __CUDACC__
 extern int cumo_na_debug_flag;  // narray.c
 
@@ -111,30 +123,36 @@ cumo_na_make_iarray(cumo_na_loop_args_t* arg)
     return cumo_na_make_iarray_given_ndim(arg, arg->ndim);
 }
 
+// in shape = (2, 3, 4, 5, 6)
+// axis = (1, 3)
+// out shape = (2, 4, 6)
+// reduce shape = (3, 5)
+static cumo_na_indexer_t
+cumo_na_make_reduction_out_indexer(cumo_na_loop_t* lp_user, cumo_na_indexer_t* in_indexer)
+{
+    cumo_na_indexer_t out_indexer;
+    int i;
+
+    out_indexer.ndim = 0;
+    out_indexer.total_size = 1;
+    for (i = 0; i < in_indexer->ndim; ++i) {
+        if (!cumo_na_test_reduce(lp_user->reduce, i)) {
+            out_indexer.shape[out_indexer.ndim] = in_indexer->shape[i];
+            out_indexer.total_size *= in_indexer->shape[i];
+            ++out_indexer.ndim;
+        }
+    }
+    return out_indexer;
+}
+
 static cumo_na_reduction_arg_t
 cumo_na_make_reduction_arg(cumo_na_loop_t* lp_user)
 {
     cumo_na_reduction_arg_t arg;
-    int i;
-    int in_ndim = lp_user->args[0].ndim;
-
-    // in shape = (2, 3, 4, 5, 6)
-    // axis = (1, 3)
-    // out shape = (2, 4, 6)
-    // reduce shape = (3, 5)
 
     arg.in = cumo_na_make_iarray(&lp_user->args[0]);
     arg.in_indexer = cumo_na_make_indexer(&lp_user->args[0]);
-
-    arg.out_indexer.ndim = 0;
-    arg.out_indexer.total_size = 1;
-    for (i = 0; i < in_ndim; ++i) {
-        if (!cumo_na_test_reduce(lp_user->reduce, i)) {
-            arg.out_indexer.shape[arg.out_indexer.ndim] = arg.in_indexer.shape[i];
-            arg.out_indexer.total_size *= arg.in_indexer.shape[i];
-            ++arg.out_indexer.ndim;
-        }
-    }
+    arg.out_indexer = cumo_na_make_reduction_out_indexer(lp_user, &arg.in_indexer);
     arg.out = cumo_na_make_iarray_given_ndim(&lp_user->args[1], arg.out_indexer.ndim);
 
     if (cumo_na_debug_flag) {
@@ -144,6 +162,40 @@ cumo_na_make_reduction_arg(cumo_na_loop_t* lp_user)
     return arg;
 }
 
+// args[0] and args[1] are inputs, and args[2] is output.
+static cumo_na_binary_reduction_arg_t
+cumo_na_make_binary_reduction_arg(cumo_na_loop_t* lp_user)
+{
+    cumo_na_binary_reduction_arg_t arg;
+    int in_ndim = lp_user->args[0].ndim;
+
+    arg.in = cumo_na_make_iarray(&lp_user->args[0]);
+    arg.in2 = cumo_na_make_iarray_given_ndim(&lp_user->args[1], in_ndim);
+    arg.in_indexer = cumo_na_make_indexer(&lp_user->args[0]);
+    arg.out_indexer = cumo_na_make_reduction_out_indexer(lp_user, &arg.in_indexer);
+    arg.out = cumo_na_make_iarray_given_ndim(&lp_user->args[2], arg.out_indexer.ndim);
+
+    if (cumo_na_debug_flag) {
+        printf("--in2--\n");
+        print_cumo_na_iarray_t(&arg.in2, in_ndim);
+    }
+
+    return arg;
+}
+
+// Host counterpart of cumo_na_indexer_set_dim and cumo_na_iarray_at_dim,
+// e.g., for host implementations of reductions in compatible mode.
+static inline char*
+cumo_na_host_iarray_at(cumo_na_iarray_t* iarray, cumo_na_indexer_t* indexer, uint64_t i)
+{
+    char* ptr = iarray->ptr;
+    for (int idim = indexer->ndim; --idim >= 0;) {
+        ptr += iarray->step[idim] * (ssize_t)(i % indexer->shape[idim]);
+        i /= indexer->shape[idim];
+    }
+    return ptr;
+}
+
 #endif  // #ifndef __CUDACC__
 
 #define CUMO_NA_INDEXER_OPTIMIZED_NDIM 4
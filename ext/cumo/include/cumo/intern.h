@@ -61,6 +61,7 @@ VALUE cumo_na_ndloop_cast_narray_to_rarray(cumo_ndfunc_t *nf, VALUE nary, VALUE
 VALUE cumo_na_ndloop_store_rarray(cumo_ndfunc_t *nf, VALUE nary, VALUE rary);
 VALUE cumo_na_ndloop_store_rarray2(cumo_ndfunc_t *nf, VALUE nary, VALUE rary, VALUE opt);
 VALUE cumo_na_ndloop_inspect(VALUE nary, cumo_na_text_func_t func, VALUE opt);
+VALUE cumo_na_ndloop_inspect_host_copy(VALUE nary, cumo_na_text_func_t func, VALUE opt);
 VALUE cumo_na_ndloop_with_index(cumo_ndfunc_t *nf, int argc, ...);
 
 VALUE cumo_na_info_str(VALUE);
@@ -77,6 +78,11 @@ VALUE cumo_na_aref_main(int nidx, VALUE *idx, VALUE self, int keep_dim, int resu
 // defined in array, used in math
 VALUE cumo_na_ary_composition_dtype(VALUE ary);
 
+// defined in rand, used in rand methods
+#include "cumo/philox.h"
+cumo_philox_state_t cumo_na_rand_reserve(uint64_t n);
+double* cumo_na_rand_make_cdf(VALUE probs, uint64_t *k);
+
 #include "ruby/version.h"
 
 #if RUBY_API_VERSION_CODE == 20100 // 2.1.0
@@ -0,0 +1,62 @@
+#ifndef CUMO_KAHAN_H
+#define CUMO_KAHAN_H
+
+#include <math.h>
+
+/* Kahan-Babuska (Neumaier) compensated summation.
+ *
+ * A partial sum carries the rounding errors of its additions in c. Partial
+ * sums of any split of the input, e.g., per thread of a reduction tree, are
+ * merged by adding one sum into the other and adding the compensations, so
+ * that the error does not grow with the number of elements.
+ *
+ * The same functions are compiled for host and device.
+ */
+
+#ifdef __CUDACC__
+#define CUMO_KAHAN_FUNC __host__ __device__ static inline
+#else
+#define CUMO_KAHAN_FUNC static inline
+#endif
+
+typedef struct {
+    double sum;
+    double c; // compensation
+} cumo_kahan_t;
+
+CUMO_KAHAN_FUNC cumo_kahan_t
+cumo_kahan_new(double x)
+{
+    cumo_kahan_t a;
+    a.sum = x;
+    a.c = 0;
+    return a;
+}
+
+CUMO_KAHAN_FUNC void
+cumo_kahan_add(cumo_kahan_t *a, double x)
+{
+    double t = a->sum + x;
+    if (fabs(a->sum) >= fabs(x)) {
+        a->c += (a->sum - t) + x;
+    } else {
+        a->c += (x - t) + a->sum;
+    }
+    a->sum = t;
+}
+
+CUMO_KAHAN_FUNC void
+cumo_kahan_merge(cumo_kahan_t *a, cumo_kahan_t b)
+{
+    cumo_kahan_add(a, b.sum);
+    a->c += b.c;
+}
+
+/* Compensations are NaN once the sum overflows; keep the infinity. */
+CUMO_KAHAN_FUNC double
+cumo_kahan_result(cumo_kahan_t a)
+{
+    return isinf(a.sum) ? a.sum : a.sum + a.c;
+}
+
+#endif // CUMO_KAHAN_H
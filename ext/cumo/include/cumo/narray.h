@@ -164,6 +164,8 @@ typedef struct { double dat[2]; } cumo_dcomplex;
 #define CUMO_REAL(x) ((x).dat[0])
 #define CUMO_IMAG(x) ((x).dat[1])
 
+#include "cumo/float16.h"
+
 extern int cumo_na_debug_flag;
 
 #define mCumo rb_mCumo
@@ -187,6 +189,8 @@ extern VALUE cumo_cDFloat;
 extern VALUE cumo_cSFloat;
 extern VALUE cumo_cDComplex;
 extern VALUE cumo_cSComplex;
+extern VALUE cumo_cHFloat;
+extern VALUE cumo_cBFloat16;
 extern VALUE cumo_cInt64;
 extern VALUE cumo_cInt32;
 extern VALUE cumo_cInt16;
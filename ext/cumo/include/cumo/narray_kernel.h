@@ -1,6 +1,8 @@
 #ifndef CUMO_NARRAY_KERNEL_H
 #define CUMO_NARRAY_KERNEL_H
 
+#include "cumo/cuda/stream.h"
+
 #if defined(__cplusplus)
 extern "C" {
 #if 0
@@ -149,6 +151,8 @@ typedef struct { double dat[2]; } cumo_dcomplex;
 #define CUMO_REAL(x) ((x).dat[0])
 #define CUMO_IMAG(x) ((x).dat[1])
 
+#include "cumo/float16.h"
+
 extern int cumo_na_debug_flag;
 
 #define CUMO_NARRAY_DATA_T     0x1
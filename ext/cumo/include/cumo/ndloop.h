@@ -48,6 +48,8 @@ typedef struct {
 #define CUMO_NDF_CUM                 (1<<8)
 
 #define CUMO_NDF_INDEXER_LOOP        (1<<9) // Cumo custom. Use cumo own indexer.
+#define CUMO_NDF_HOST_COPY           (1<<10) // Cumo custom. Read the input from a host copy made with one transfer.
+#define CUMO_NDF_PARALLEL            (1<<11) // Cumo custom. Host iterator free of Ruby calls. May run on host threads.
 
 #define CUMO_FULL_LOOP       (CUMO_NDF_HAS_LOOP|CUMO_NDF_STRIDE_LOOP|CUMO_NDF_INDEX_LOOP|CUMO_NDF_INPLACE)
 #define CUMO_FULL_LOOP_NIP   (CUMO_NDF_HAS_LOOP|CUMO_NDF_STRIDE_LOOP|CUMO_NDF_INDEX_LOOP)
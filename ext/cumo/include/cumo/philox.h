@@ -0,0 +1,288 @@
+#ifndef CUMO_PHILOX_H
+#define CUMO_PHILOX_H
+
+#include <stdint.h>
+#include <math.h>
+
+/* Counter-based random number generator Philox4x32-10.
+ *
+ * Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11.
+ *
+ * Each element of an output array draws from its own counter, so results do
+ * not depend on how work is split into threads, blocks or ndloop iterations.
+ * The same functions are compiled for host and device.
+ *
+ * Counter layout (4 x 32 bits):
+ *   ctr[0], ctr[1] : offset + element index (64 bits)
+ *   ctr[2]         : substream
+ *   ctr[3]         : round, incremented by samplers which need more than 4 words
+ * Key layout (2 x 32 bits):
+ *   key[0], key[1] : seed (64 bits)
+ */
+
+#ifdef __CUDACC__
+#define CUMO_PHILOX_FUNC __host__ __device__ static inline
+#else
+#define CUMO_PHILOX_FUNC static inline
+#endif
+
+#define CUMO_PHILOX_M0 0xD2511F53U
+#define CUMO_PHILOX_M1 0xCD9E8D57U
+#define CUMO_PHILOX_W0 0x9E3779B9U
+#define CUMO_PHILOX_W1 0xBB67AE85U
+#define CUMO_PHILOX_ROUNDS 10
+
+typedef struct {
+    uint64_t seed;      // key
+    uint64_t offset;    // counter of the first element
+    uint32_t substream; // independent stream id, e.g., for data-parallel workers
+} cumo_philox_state_t;
+
+/* parameters of a distribution, passed to rand kernels by value */
+typedef struct {
+    double param[6];
+} cumo_rand_dist_param_t;
+
+CUMO_PHILOX_FUNC uint32_t
+cumo_philox_mulhilo32(uint32_t a, uint32_t b, uint32_t *hi)
+{
+#ifdef __CUDA_ARCH__
+    *hi = __umulhi(a, b);
+    return a * b;
+#else
+    uint64_t p = (uint64_t)a * (uint64_t)b;
+    *hi = (uint32_t)(p >> 32);
+    return (uint32_t)p;
+#endif
+}
+
+CUMO_PHILOX_FUNC void
+cumo_philox4x32_10(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4])
+{
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    uint32_t hi0, hi1, lo0, lo1;
+    int r;
+
+    for (r = 0; r < CUMO_PHILOX_ROUNDS; ++r) {
+        if (r > 0) {
+            k0 += CUMO_PHILOX_W0;
+            k1 += CUMO_PHILOX_W1;
+        }
+        lo0 = cumo_philox_mulhilo32(CUMO_PHILOX_M0, c0, &hi0);
+        lo1 = cumo_philox_mulhilo32(CUMO_PHILOX_M1, c2, &hi1);
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+/* Generates 4 random words for the i-th element of the current draw. */
+CUMO_PHILOX_FUNC void
+cumo_philox_generate(cumo_philox_state_t st, uint64_t i, uint32_t round, uint32_t out[4])
+{
+    uint64_t c = st.offset + i;
+    uint32_t ctr[4], key[2];
+
+    ctr[0] = (uint32_t)c;
+    ctr[1] = (uint32_t)(c >> 32);
+    ctr[2] = st.substream;
+    ctr[3] = round;
+    key[0] = (uint32_t)st.seed;
+    key[1] = (uint32_t)(st.seed >> 32);
+    cumo_philox4x32_10(ctr, key, out);
+}
+
+/* generates a random number on [0,1)-real-interval with 24-bit resolution */
+CUMO_PHILOX_FUNC float
+cumo_philox_to_float(uint32_t a)
+{
+    return (float)(a >> 8) * (1.0f / 16777216.0f);
+}
+
+/* generates a random number on [0,1)-real-interval with 53-bit resolution */
+CUMO_PHILOX_FUNC double
+cumo_philox_to_double(uint32_t a, uint32_t b)
+{
+    return ((double)(a >> 5) * 67108864.0 + (double)(b >> 6)) * (1.0 / 9007199254740992.0);
+}
+
+/* generates a random number on (0,1)-real-interval with 32-bit resolution */
+CUMO_PHILOX_FUNC double
+cumo_philox_to_open_double(uint32_t a)
+{
+    return ((double)a + 0.5) * (1.0 / 4294967296.0);
+}
+
+/* Samplers
+ *
+ * Samplers take the state and the element index and draw as many rounds as
+ * they need, so rejection methods stay reproducible for each element.
+ */
+
+/* standard normal by Box-Muller transformation of two words */
+CUMO_PHILOX_FUNC double
+cumo_philox_normal(uint32_t a, uint32_t b)
+{
+    double r = sqrt(-2.0 * log(cumo_philox_to_open_double(a)));
+    return r * cos(6.28318530717958648 * cumo_philox_to_double(b, 0));
+}
+
+/* exponential distribution with scale 1 */
+CUMO_PHILOX_FUNC double
+cumo_philox_exponential(cumo_philox_state_t st, uint64_t i)
+{
+    uint32_t w[4];
+    cumo_philox_generate(st, i, 0, w);
+    return -log1p(-cumo_philox_to_double(w[0], w[1]));
+}
+
+/* gamma distribution with scale 1 by Marsaglia and Tsang's method.
+ *
+ * Marsaglia and Tsang, "A simple method for generating gamma variables",
+ * ACM TOMS 26(3), 2000.
+ */
+CUMO_PHILOX_FUNC double
+cumo_philox_gamma(cumo_philox_state_t st, uint64_t i, double shape)
+{
+    uint32_t w[4];
+    uint32_t round = 0;
+    double boost = 1.0;
+    double d, c, x, v, u;
+
+    if (shape <= 0.0) {
+        return 0.0;
+    }
+    if (shape < 1.0) {
+        // gamma(a) = gamma(a+1) * U^(1/a)
+        cumo_philox_generate(st, i, round++, w);
+        boost = pow(cumo_philox_to_open_double(w[0]), 1.0 / shape);
+        shape += 1.0;
+    }
+    d = shape - 1.0 / 3.0;
+    c = 1.0 / sqrt(9.0 * d);
+    for (;;) {
+        cumo_philox_generate(st, i, round++, w);
+        x = cumo_philox_normal(w[0], w[1]);
+        v = 1.0 + c * x;
+        if (v <= 0.0) {
+            continue;
+        }
+        v = v * v * v;
+        u = cumo_philox_to_open_double(w[2]);
+        if (u < 1.0 - 0.0331 * (x * x) * (x * x) ||
+            log(u) < 0.5 * x * x + d * (1.0 - v + log(v))) {
+            return d * v * boost;
+        }
+    }
+}
+
+/* poisson distribution.
+ *
+ * Multiplication of uniforms for small lambda, and the transformed rejection
+ * with squeeze (PTRS) for large lambda:
+ * Hormann, "The transformed rejection method for generating Poisson random
+ * variables", Insurance: Mathematics and Economics 12(1), 1993.
+ */
+#define CUMO_PHILOX_POISSON_PTRS_LAMBDA 10.0
+
+CUMO_PHILOX_FUNC double
+cumo_philox_poisson(cumo_philox_state_t st, uint64_t i, double lam)
+{
+    uint32_t w[4];
+    uint32_t round = 0;
+    int k;
+
+    if (lam <= 0.0) {
+        return 0.0;
+    }
+    if (lam < CUMO_PHILOX_POISSON_PTRS_LAMBDA) {
+        double limit = exp(-lam);
+        double prod = 1.0;
+        double n = 0.0;
+        for (;;) {
+            cumo_philox_generate(st, i, round++, w);
+            for (k = 0; k < 4; ++k) {
+                prod *= cumo_philox_to_open_double(w[k]);
+                if (prod <= limit) {
+                    return n;
+                }
+                n += 1.0;
+            }
+        }
+    } else {
+        double slam = sqrt(lam);
+        double loglam = log(lam);
+        double b = 0.931 + 2.53 * slam;
+        double a = -0.059 + 0.02483 * b;
+        double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+        double vr = 0.9277 - 3.6224 / (b - 2.0);
+        double u, v, us, n;
+        for (;;) {
+            cumo_philox_generate(st, i, round++, w);
+            for (k = 0; k < 4; k += 2) {
+                u = cumo_philox_to_open_double(w[k]) - 0.5;
+                v = cumo_philox_to_open_double(w[k+1]);
+                us = 0.5 - fabs(u);
+                n = floor((2.0 * a / us + b) * u + lam + 0.43);
+                if (us >= 0.07 && v <= vr) {
+                    return n;
+                }
+                if (n < 0.0 || (us < 0.013 && v > us)) {
+                    continue;
+                }
+                if (log(v) + log(invalpha) - log(a / (us * us) + b) <=
+                    -lam + n * loglam - lgamma(n + 1.0)) {
+                    return n;
+                }
+            }
+        }
+    }
+}
+
+/* Bernoulli draws share one counter between 4 consecutive elements, so that a
+ * word of Cumo::Bit is filled by 8 counters. Returns a threshold for words. */
+CUMO_PHILOX_FUNC uint64_t
+cumo_philox_bernoulli_threshold(double p)
+{
+    if (!(p > 0.0)) {
+        return 0;
+    }
+    if (p >= 1.0) {
+        return (uint64_t)1 << 32;
+    }
+    return (uint64_t)(p * 4294967296.0);
+}
+
+CUMO_PHILOX_FUNC int
+cumo_philox_bernoulli(cumo_philox_state_t st, uint64_t i, uint64_t threshold)
+{
+    uint32_t w[4];
+    cumo_philox_generate(st, i / 4, 0, w);
+    return (uint64_t)w[i % 4] < threshold;
+}
+
+/* Returns the smallest k such that u < cdf[k], where cdf is non-decreasing.
+ * u is scaled by the total, cdf[n-1], so that cdf need not be normalized. */
+CUMO_PHILOX_FUNC uint64_t
+cumo_philox_search_cdf(const double *cdf, uint64_t n, double u)
+{
+    uint64_t lo = 0, hi = n - 1, mid;
+    u *= cdf[n - 1];
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (u < cdf[mid]) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+#endif // CUMO_PHILOX_H
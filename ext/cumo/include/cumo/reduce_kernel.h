@@ -6,6 +6,7 @@
 #include <type_traits>
 
 #include "cumo/indexer.h"
+#include "cumo/cuda/stream.h"
 
 namespace cumo_detail {
 
@@ -26,8 +27,30 @@ static inline int64_t round_up_to_power_of_2(int64_t x) {
 // Reference: cupy reduction kernel
 // Note that reduction and out axis are inverse with cupy. Former axes are out axes, latters are reduce axes.
 
-template <typename TypeIn, typename TypeOut, typename ReductionImpl>
-__global__ static void reduction_kernel(cumo_na_reduction_arg_t arg, int out_block_size, int reduce_block_size, ReductionImpl impl) {
+// Index passed to Identity and MapIn. It is the element offset in the
+// (first) input, or i_reduce, the position along the reduction axes, if
+// ReduceIndex.
+template <bool ReduceIndex, typename TypeIn>
+__device__ static inline int64_t reduce_index(TypeIn* in_ptr, cumo_na_iarray_t& in, int64_t i_reduce) {
+    return ReduceIndex ? i_reduce : in_ptr - reinterpret_cast<TypeIn*>(in.ptr);
+}
+
+// MapIn of the element at in_indexer.
+template <typename TypeIn, bool ReduceIndex, typename ReductionImpl>
+__device__ static inline auto map_in(ReductionImpl& impl, cumo_na_reduction_arg_t& arg, int64_t i_reduce) {
+    TypeIn* in_ptr = reinterpret_cast<TypeIn*>(cumo_na_iarray_at_dim(&arg.in, &arg.in_indexer));
+    return impl.MapIn(*in_ptr, reduce_index<ReduceIndex>(in_ptr, arg.in, i_reduce));
+}
+
+template <typename TypeIn, bool ReduceIndex, typename ReductionImpl>
+__device__ static inline auto map_in(ReductionImpl& impl, cumo_na_binary_reduction_arg_t& arg, int64_t i_reduce) {
+    TypeIn* in_ptr = reinterpret_cast<TypeIn*>(cumo_na_iarray_at_dim(&arg.in, &arg.in_indexer));
+    TypeIn* in2_ptr = reinterpret_cast<TypeIn*>(cumo_na_iarray_at_dim(&arg.in2, &arg.in_indexer));
+    return impl.MapIn(*in_ptr, *in2_ptr, reduce_index<ReduceIndex>(in_ptr, arg.in, i_reduce));
+}
+
+template <typename TypeIn, typename TypeOut, bool ReduceIndex, typename ReductionImpl, typename ReductionArg>
+__global__ static void reduction_kernel(ReductionArg arg, int out_block_size, int reduce_block_size, ReductionImpl impl) {
     cumo_na_iarray_t& in_iarray = arg.in;
     cumo_na_iarray_t& out_iarray = arg.out;
     cumo_na_indexer_t& in_indexer = arg.in_indexer;
@@ -50,16 +73,15 @@ __global__ static void reduction_kernel(cumo_na_reduction_arg_t arg, int out_blo
         cumo_na_indexer_set_dim(&out_indexer, i_out);
         int64_t i_in = i_out * reduce_indexer_total_size + reduce_offset;
 
-        // Note that spec of (min|max)_index of cumo is different with arg(min|max) of cupy.
-        // Cumo returns index of input elements, CuPy returns index of reduction axis.
+        // Note that (min|max)_index of cumo returns index of input elements, and
+        // arg(min|max) returns index of reduction axis as CuPy with ReduceIndex.
         cumo_na_indexer_set_dim(&in_indexer, i_in);
         TypeIn* in_ptr = reinterpret_cast<TypeIn*>(cumo_na_iarray_at_dim(&in_iarray, &in_indexer));
-        TypeReduce accum = impl.Identity(in_ptr - reinterpret_cast<TypeIn*>(in_iarray.ptr));
+        TypeReduce accum = impl.Identity(reduce_index<ReduceIndex>(in_ptr, in_iarray, reduce_offset));
 
         for (int64_t i_reduce = reduce_offset; i_reduce < reduce_indexer_total_size; i_reduce += reduce_block_size, i_in += reduce_block_size) {
             cumo_na_indexer_set_dim(&in_indexer, i_in);
-            in_ptr = reinterpret_cast<TypeIn*>(cumo_na_iarray_at_dim(&in_iarray, &in_indexer));
-            impl.Reduce(impl.MapIn(*in_ptr, in_ptr - reinterpret_cast<TypeIn*>(in_iarray.ptr)), accum);
+            impl.Reduce(map_in<TypeIn, ReduceIndex>(impl, arg, i_reduce), accum);
             //printf("threadId.x:%d blockIdx.x:%d blockDim.x:%d gridDim.x:%d accum:%d i_in:%ld i_reduce:%ld i_out:%ld in:%p(%d)\n", threadIdx.x, blockIdx.x, blockDim.x, gridDim.x, accum, i_in, i_reduce, i_out, in_ptr, *in_ptr);
         }
 
@@ -86,11 +108,8 @@ __global__ static void reduction_kernel(cumo_na_reduction_arg_t arg, int out_blo
     }
 }
 
-}  // cumo_detail
-
-// TODO(sonots): Optimize indexer by squashing (or reducing) dimensions
-template <typename TypeIn, typename TypeOut, typename ReductionImpl>
-void cumo_reduce(cumo_na_reduction_arg_t arg, ReductionImpl&& impl) {
+template <typename TypeIn, typename TypeOut, bool ReduceIndex = false, typename ReductionImpl, typename ReductionArg>
+void launch_reduction(ReductionArg& arg, ReductionImpl& impl) {
     cumo_na_indexer_t& in_indexer = arg.in_indexer;
     cumo_na_indexer_t& out_indexer = arg.out_indexer;
 
@@ -98,16 +117,38 @@ void cumo_reduce(cumo_na_reduction_arg_t arg, ReductionImpl&& impl) {
         return;
     }
 
-    int64_t reduce_total_size_pow2 = cumo_detail::round_up_to_power_of_2(std::max(size_t{1}, in_indexer.total_size / out_indexer.total_size));
-    int64_t reduce_block_size = std::min(cumo_detail::max_block_size, reduce_total_size_pow2);
-    int64_t out_block_size = cumo_detail::max_block_size / reduce_block_size;
+    int64_t reduce_total_size_pow2 = round_up_to_power_of_2(std::max(size_t{1}, in_indexer.total_size / out_indexer.total_size));
+    int64_t reduce_block_size = std::min(max_block_size, reduce_total_size_pow2);
+    int64_t out_block_size = max_block_size / reduce_block_size;
     int64_t out_block_num = (out_indexer.total_size + out_block_size - 1) / out_block_size;
 
-    int64_t block_size = cumo_detail::max_block_size;
-    int64_t grid_size = std::min(cumo_detail::max_grid_size, out_block_num);
+    int64_t block_size = max_block_size;
+    int64_t grid_size = std::min(max_grid_size, out_block_num);
     int64_t shared_mem_size = sizeof(decltype(impl.Identity(0))) * block_size;
 
-    cumo_detail::reduction_kernel<TypeIn,TypeOut,ReductionImpl><<<grid_size, block_size, shared_mem_size>>>(arg, out_block_size, reduce_block_size, impl);
+    reduction_kernel<TypeIn,TypeOut,ReduceIndex,ReductionImpl,ReductionArg><<<grid_size, block_size, shared_mem_size, cumo_cuda_stream_current()>>>(arg, out_block_size, reduce_block_size, impl);
+}
+
+}  // cumo_detail
+
+// TODO(sonots): Optimize indexer by squashing (or reducing) dimensions
+template <typename TypeIn, typename TypeOut, typename ReductionImpl>
+void cumo_reduce(cumo_na_reduction_arg_t arg, ReductionImpl&& impl) {
+    cumo_detail::launch_reduction<TypeIn, TypeOut>(arg, impl);
+}
+
+// Passes positions along the reduction axes as index instead of element
+// offsets in the input, e.g., for argmax.
+template <typename TypeIn, typename TypeOut, typename ReductionImpl>
+void cumo_arg_reduce(cumo_na_reduction_arg_t arg, ReductionImpl&& impl) {
+    cumo_detail::launch_reduction<TypeIn, TypeOut, true>(arg, impl);
+}
+
+// Reduces impl.MapIn(in, in2, index) of two inputs in one launch, e.g., the
+// sum of products in mulsum, without a temporary array of the products.
+template <typename TypeIn, typename TypeOut, typename ReductionImpl>
+void cumo_binary_reduce(cumo_na_binary_reduction_arg_t arg, ReductionImpl&& impl) {
+    cumo_detail::launch_reduction<TypeIn, TypeOut>(arg, impl);
 }
 
 #endif // CUMO_REDUCE_KERNEL_H
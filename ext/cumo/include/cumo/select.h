@@ -0,0 +1,262 @@
+#ifndef CUMO_SELECT_H
+#define CUMO_SELECT_H
+
+#include <stdint.h>
+
+/* Shared by selection kernels, e.g., max_k, and their host implementations.
+ *
+ * Selection works on rows, which are contiguous copies or views of self
+ * whose last axis is the axis selected along. Each row is selected from
+ * independently, by a block on the device and by a thread on the host.
+ */
+
+/* Whether x at index i precedes y at index j in descending order, where NaN
+ * is larger than any number and ties are broken by the smaller index, so
+ * that no two elements of a row are equivalent. Uses m_isnan and m_gt of
+ * the type. */
+#define CUMO_SELECT_PRECEDES(x,i,y,j)                                   \
+    (m_isnan(x) ? (!m_isnan(y) || (i) < (j)) :                          \
+     (!m_isnan(y) && (m_gt(x,y) || (!m_gt(y,x) && (i) < (j)))))
+
+/* Whether x < y in ascending order, where NaN is larger than any number.
+ * Uses m_isnan and m_lt of the type. */
+#define CUMO_SELECT_LT(x,y)                                             \
+    (m_isnan(x) ? 0 : (m_isnan(y) || m_lt(x,y)))
+
+// Threads per block of selection kernels, a power of 2.
+#define CUMO_SELECT_BLOCK_DIM 256
+
+#ifdef __CUDACC__
+#define CUMO_SELECT_FUNC __host__ __device__ static inline
+#else
+#define CUMO_SELECT_FUNC static inline
+#endif
+
+// Interpolation of quantiles between two elements.
+#define CUMO_SELECT_LINEAR   0
+#define CUMO_SELECT_LOWER    1
+#define CUMO_SELECT_HIGHER   2
+#define CUMO_SELECT_MIDPOINT 3
+#define CUMO_SELECT_NEAREST  4
+
+/* Sets *lo to the index in ascending order of the element of quantile q
+ * (0 <= q <= 1) of m > 0 elements, and *frac to the fraction of the way to
+ * the next element, which is 0 unless interp is linear or midpoint. */
+CUMO_SELECT_FUNC void
+cumo_select_quantile_index(double q, uint64_t m, int interp, uint64_t *lo, double *frac)
+{
+    double h = q * (double)(m - 1);
+    uint64_t i = (uint64_t)h;
+    double f;
+
+    if (i >= m - 1) {
+        i = m - 1;
+    }
+    f = h - (double)i;
+    switch (interp) {
+    case CUMO_SELECT_LOWER:
+        f = 0;
+        break;
+    case CUMO_SELECT_HIGHER:
+        if (f > 0) {
+            i++;
+        }
+        f = 0;
+        break;
+    case CUMO_SELECT_NEAREST:
+        // round half to even
+        if (f > 0.5 || (f == 0.5 && i % 2 == 1)) {
+            i++;
+        }
+        f = 0;
+        break;
+    case CUMO_SELECT_MIDPOINT:
+        if (f > 0) {
+            f = 0.5;
+        }
+        break;
+    }
+    *lo = i;
+    *frac = f;
+}
+
+#ifdef __CUDACC__
+
+/* Keys of values in unsigned integers of the same order as
+ * CUMO_SELECT_PRECEDES without index, i.e., NaN is the largest key and -0 is
+ * equal to 0. Half types are selected by keys of float. */
+__device__ static inline uint32_t
+cumo_select_key(float x)
+{
+    uint32_t b;
+    if (x != x) {
+        return 0xffffffffu;
+    }
+    b = __float_as_uint(x == 0 ? 0.0f : x);
+    return (b & 0x80000000u) ? ~b : (b | 0x80000000u);
+}
+
+__device__ static inline uint64_t
+cumo_select_key(double x)
+{
+    uint64_t b;
+    if (x != x) {
+        return 0xffffffffffffffffull;
+    }
+    b = (uint64_t)__double_as_longlong(x == 0 ? 0.0 : x);
+    return (b & 0x8000000000000000ull) ? ~b : (b | 0x8000000000000000ull);
+}
+
+__device__ static inline uint32_t cumo_select_key(int8_t x) { return (uint32_t)(int32_t)x ^ 0x80000000u; }
+__device__ static inline uint32_t cumo_select_key(int16_t x) { return (uint32_t)(int32_t)x ^ 0x80000000u; }
+__device__ static inline uint32_t cumo_select_key(int32_t x) { return (uint32_t)x ^ 0x80000000u; }
+__device__ static inline uint64_t cumo_select_key(int64_t x) { return (uint64_t)x ^ 0x8000000000000000ull; }
+__device__ static inline uint32_t cumo_select_key(uint8_t x) { return x; }
+__device__ static inline uint32_t cumo_select_key(uint16_t x) { return x; }
+__device__ static inline uint32_t cumo_select_key(uint32_t x) { return x; }
+__device__ static inline uint64_t cumo_select_key(uint64_t x) { return x; }
+
+/* Inverse of cumo_select_key, which sets *x to the value of key k. */
+__device__ static inline void
+cumo_select_unkey(uint32_t k, float *x)
+{
+    *x = __uint_as_float((k & 0x80000000u) ? (k ^ 0x80000000u) : ~k);
+}
+
+__device__ static inline void
+cumo_select_unkey(uint64_t k, double *x)
+{
+    *x = __longlong_as_double((long long)((k & 0x8000000000000000ull) ? (k ^ 0x8000000000000000ull) : ~k));
+}
+
+__device__ static inline void cumo_select_unkey(uint32_t k, int8_t *x) { *x = (int8_t)(int32_t)(k ^ 0x80000000u); }
+__device__ static inline void cumo_select_unkey(uint32_t k, int16_t *x) { *x = (int16_t)(int32_t)(k ^ 0x80000000u); }
+__device__ static inline void cumo_select_unkey(uint32_t k, int32_t *x) { *x = (int32_t)(k ^ 0x80000000u); }
+__device__ static inline void cumo_select_unkey(uint64_t k, int64_t *x) { *x = (int64_t)(k ^ 0x8000000000000000ull); }
+__device__ static inline void cumo_select_unkey(uint32_t k, uint8_t *x) { *x = (uint8_t)k; }
+__device__ static inline void cumo_select_unkey(uint32_t k, uint16_t *x) { *x = (uint16_t)k; }
+__device__ static inline void cumo_select_unkey(uint32_t k, uint32_t *x) { *x = k; }
+__device__ static inline void cumo_select_unkey(uint64_t k, uint64_t *x) { *x = k; }
+
+/* Radix select in a block of CUMO_SELECT_BLOCK_DIM threads. Returns the
+ * k-th (1-based, k <= n) largest of keys key_at(i) for i < n, by one pass
+ * over the keys per 8 bits of Key, and sets *take_eq to the number of
+ * elements equal to it among the k largest, which are the first ones of
+ * them in index order. */
+template <typename Key, typename KeyAt>
+__device__ Key
+cumo_select_radix(KeyAt key_at, uint64_t n, uint64_t k, uint64_t *take_eq)
+{
+    __shared__ unsigned long long hist[256];
+    __shared__ Key s_prefix;
+    __shared__ uint64_t s_k;
+    unsigned int tid = threadIdx.x;
+    Key prefix = 0;
+    Key mask = 0;
+    uint64_t kk = k;
+
+    for (int shift = sizeof(Key) * 8 - 8; shift >= 0; shift -= 8) {
+        for (unsigned int d = tid; d < 256; d += blockDim.x) {
+            hist[d] = 0;
+        }
+        __syncthreads();
+        for (uint64_t i = tid; i < n; i += blockDim.x) {
+            Key x = key_at(i);
+            if ((x & mask) == prefix) {
+                atomicAdd(&hist[(x >> shift) & 0xff], 1ull);
+            }
+        }
+        __syncthreads();
+        if (tid == 0) {
+            int d = 255;
+            for (; d > 0 && hist[d] < kk; d--) {
+                kk -= hist[d];
+            }
+            s_prefix = prefix | ((Key)d << shift);
+            s_k = kk;
+        }
+        __syncthreads();
+        prefix = s_prefix;
+        kk = s_k;
+        mask |= (Key)0xff << shift;
+    }
+    *take_eq = kk;
+    return prefix;
+}
+
+/* Calls emit(i, slot) for the k largest elements in the order of keys and
+ * then indices, where t and take_eq are from cumo_select_radix. Slots of the
+ * k elements are unique and less than k, and the k-th element is at slot
+ * k-1, but the others are not in order. If all, also calls emit(i, slot)
+ * for the rest with slots from k. */
+template <typename Key, typename KeyAt, typename Emit>
+__device__ void
+cumo_select_compact(KeyAt key_at, uint64_t n, uint64_t k, Key t, uint64_t take_eq, bool all, Emit emit)
+{
+    __shared__ unsigned int scan[CUMO_SELECT_BLOCK_DIM];
+    __shared__ unsigned long long n_gt, n_rest;
+    __shared__ uint64_t eq_base;
+    unsigned int tid = threadIdx.x;
+
+    if (tid == 0) {
+        n_gt = 0;
+        n_rest = k;
+        eq_base = 0;
+    }
+    __syncthreads();
+    // tiles in index order rank the equal elements
+    for (uint64_t base = 0; base < n; base += blockDim.x) {
+        uint64_t i = base + tid;
+        Key x = (i < n) ? key_at(i) : 0;
+        unsigned int eq = (i < n && x == t) ? 1 : 0;
+        uint64_t rank;
+
+        scan[tid] = eq;
+        __syncthreads();
+        for (unsigned int off = 1; off < blockDim.x; off <<= 1) {
+            unsigned int v = (tid >= off) ? scan[tid - off] : 0;
+            __syncthreads();
+            scan[tid] += v;
+            __syncthreads();
+        }
+        rank = eq_base + scan[tid] - eq;
+        if (i < n) {
+            if (x > t) {
+                emit(i, (uint64_t)atomicAdd(&n_gt, 1ull));
+            } else if (eq && rank < take_eq) {
+                emit(i, k - take_eq + rank);
+            } else if (all) {
+                emit(i, (uint64_t)atomicAdd(&n_rest, 1ull));
+            }
+        }
+        __syncthreads();
+        if (tid == 0) {
+            eq_base += scan[blockDim.x - 1];
+        }
+        __syncthreads();
+    }
+}
+
+#else // __CUDACC__
+// select.c
+
+VALUE
+cumo_na_select_rows(VALUE self, VALUE axis, int *ax);
+
+char*
+cumo_na_select_rows_pointer(VALUE rows);
+
+VALUE
+cumo_na_select_new(VALUE type, VALUE rows, size_t k);
+
+VALUE
+cumo_na_select_restore(VALUE result, int ax);
+
+VALUE
+cumo_na_select_reduce_rows(VALUE self, VALUE reduce, int keepdims, size_t *n, int *ndim, size_t *shape);
+
+int
+cumo_na_select_interpolation(VALUE interp);
+#endif // __CUDACC__
+
+#endif // CUMO_SELECT_H
@@ -0,0 +1,38 @@
+#ifndef CUMO_THREAD_POOL_H
+#define CUMO_THREAD_POOL_H
+
+#include <ruby.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#if 0
+} /* satisfy cc-mode */
+#endif
+#endif
+
+// Host thread pool to run host iterators in parallel.
+
+typedef void (*cumo_thread_pool_func_t)(size_t begin, size_t end, size_t tid, void *data);
+
+// Number of threads including the caller, set by Cumo.host_threads=
+size_t
+cumo_thread_pool_get_num_threads(void);
+
+// Calls func(begin, end, tid, data) for chunks of [0, n) on at most
+// max_threads threads (tid < max_threads), and returns when all finish.
+// Chunks are static ranges, or grain iterations taken with work stealing.
+//
+// Must be called with the GVL, which is released while func runs, so func
+// must not call Ruby APIs. If the Ruby thread is interrupted, chunks not
+// started yet are skipped and the interrupt is raised once Ruby checks it.
+void
+cumo_thread_pool_parallel_for(size_t n, size_t grain, int work_stealing, size_t max_threads, cumo_thread_pool_func_t func, void *data);
+
+#if defined(__cplusplus)
+#if 0
+{ /* satisfy cc-mode */
+#endif
+}  /* extern "C" { */
+#endif
+
+#endif /* ifndef CUMO_THREAD_POOL_H */
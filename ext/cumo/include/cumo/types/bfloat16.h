@@ -0,0 +1,25 @@
+typedef cumo_bfloat16 dtype;
+typedef cumo_bfloat16 rtype;
+#define cT  cumo_cBFloat16
+#define cRT cumo_cBFloat16
+#define mTM cumo_mBFloat16Math
+
+#define m_to_float(x)   cumo_bfloat16_to_float(x)
+#define m_from_float(x) cumo_bfloat16_from_double(x)
+
+#include "half_macro.h"
+#include "cublas_v2.h"
+#include "cumo/cuda/cublas.h"
+
+#define m_min_init cumo_bfloat16_new_dim0(m_from_float(0.0/0.0))
+#define m_max_init cumo_bfloat16_new_dim0(m_from_float(0.0/0.0))
+
+#define m_extract(x) rb_float_new(m_to_float(*(dtype*)x))
+#define m_nearly_eq(x,y) (fabsf(m_to_float(x)-m_to_float(y))<=(fabsf(m_to_float(x))+fabsf(m_to_float(y)))*7.8125e-03*2)
+
+#define M_EPSILON rb_float_new(7.8125e-03)
+#define M_MIN     rb_float_new(1.1754943508222875e-38)
+#define M_MAX     rb_float_new(3.3895313892515355e+38)
+
+#define DATA_MIN 1.1754943508222875e-38f
+#define DATA_MAX 3.3895313892515355e+38f
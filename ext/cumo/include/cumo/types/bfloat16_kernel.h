@@ -0,0 +1,38 @@
+#ifndef CUMO_BFLOAT16_KERNEL_H
+#define CUMO_BFLOAT16_KERNEL_H
+
+typedef cumo_bfloat16 dtype;
+typedef cumo_bfloat16 rtype;
+
+#include "half_macro_kernel.h"
+
+#define m_nearly_eq(x,y) (fabsf((float)(x)-(float)(y))<=(fabsf(x)+fabsf(y))*7.8125e-03f*2)
+
+#define DATA_MIN 1.1754943508222875e-38f
+#define DATA_MAX 3.3895313892515355e+38f
+
+#ifdef CUMO_PHILOX_H
+/* generates a random number on [0,max)-real-interval */
+__host__ __device__ static inline dtype m_rand(dtype max, const uint32_t *w)
+{
+    dtype x = cumo_philox_to_float(w[0]) * (float)max;
+    // The product is rounded to bfloat16, which may give max. Decrementing the
+    // bits takes the next value toward zero for either sign.
+    if ((float)x == (float)max && (float)max != 0) {
+        x.bits -= 1;
+    }
+    return x;
+}
+
+/* generates a random number from the normal distribution
+   using Box-Muller Transformation.
+ */
+__host__ __device__ static inline dtype m_rand_norm(dtype mu, rtype sigma, const uint32_t *w)
+{
+    float r = sqrtf(-2 * logf(1 - cumo_philox_to_float(w[0])));
+    float t = 6.28318530717958648f * cumo_philox_to_float(w[1]);
+    return r * cosf(t) * sigma + mu;
+}
+#endif
+
+#endif // CUMO_BFLOAT16_KERNEL_H
@@ -31,4 +31,7 @@ typedef CUMO_BIT_DIGIT rtype;
 #define m_count_false(x) ((x)==0)
 #define m_count_false_cpu(x) m_count_false(x)
 
+/* --------- thrust ----------------- */
+#include "cumo/cuda/cumo_thrust.hpp"
+
 #endif // CUMO_BIT_KERNEL_H
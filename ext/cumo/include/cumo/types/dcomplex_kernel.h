@@ -10,4 +10,24 @@ __device__ static inline bool c_nearly_eq(dtype x, dtype y) {
     return c_abs(c_sub(x,y)) <= (c_abs(x)+c_abs(y))*DBL_EPSILON*2;
 }
 
+#ifdef CUMO_PHILOX_H
+/* generates a random number on [0,1)-real-interval */
+__host__ __device__ static inline dtype m_rand(dtype max, const uint32_t *w)
+{
+    return c_new(cumo_philox_to_double(w[0],w[1]) * CUMO_REAL(max),
+                 cumo_philox_to_double(w[2],w[3]) * CUMO_IMAG(max));
+}
+
+/* generates a random number from the normal distribution
+   using Box-Muller Transformation.
+ */
+__host__ __device__ static inline dtype m_rand_norm(dtype mu, rtype sigma, const uint32_t *w)
+{
+    double r = sqrt(-2 * log(1 - cumo_philox_to_double(w[0],w[1])));
+    double t = 6.28318530717958648 * cumo_philox_to_double(w[2],w[3]);
+    return c_new(r * cos(t) * sigma + CUMO_REAL(mu),
+                 r * sin(t) * sigma + CUMO_IMAG(mu));
+}
+#endif
+
 #endif // CUMO_DCOMPLEX_KERNEL_H
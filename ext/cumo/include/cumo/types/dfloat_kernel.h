@@ -11,4 +11,22 @@ typedef double rtype;
 #define DATA_MIN DBL_MIN
 #define DATA_MAX DBL_MAX
 
+#ifdef CUMO_PHILOX_H
+/* generates a random number on [0,1)-real-interval */
+__host__ __device__ static inline dtype m_rand(dtype max, const uint32_t *w)
+{
+    return cumo_philox_to_double(w[0],w[1]) * max;
+}
+
+/* generates a random number from the normal distribution
+   using Box-Muller Transformation.
+ */
+__host__ __device__ static inline dtype m_rand_norm(dtype mu, rtype sigma, const uint32_t *w)
+{
+    double r = sqrt(-2 * log(1 - cumo_philox_to_double(w[0],w[1])));
+    double t = 6.28318530717958648 * cumo_philox_to_double(w[2],w[3]);
+    return r * cos(t) * sigma + mu;
+}
+#endif
+
 #endif // CUMO_DFLOAT_KERNEL_H
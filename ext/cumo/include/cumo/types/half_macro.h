@@ -0,0 +1,186 @@
+#include "float_def.h"
+
+/* Macros for HFloat and BFloat16 on host.
+
+   dtype is a struct of 16 bits, so every operation converts to float with
+   m_to_float, computes in float, and rounds back with m_from_float.
+   float has more than twice as many fraction bits as the 16-bit types,
+   so +, -, *, / and sqrt are rounded correctly.
+ */
+
+extern double round(double);
+extern double log2(double);
+extern double exp2(double);
+#ifdef HAVE_EXP10
+extern double exp10(double);
+#else
+extern double pow(double, double);
+#endif
+
+#define m_zero m_from_float(0.0)
+#define m_one  m_from_float(1.0)
+
+#define m_num_to_data(x) m_from_float(NUM2DBL(x))
+#define m_data_to_num(x) rb_float_new(m_to_float(x))
+
+#define m_from_double(x) m_from_float(x)
+#define m_from_real(x) m_from_float(x)
+#define m_from_sint(x) m_from_float(x)
+#define m_from_int32(x) m_from_float(x)
+#define m_from_int64(x) m_from_float(x)
+#define m_from_uint32(x) m_from_float(x)
+#define m_from_uint64(x) m_from_float(x)
+
+#define m_f1(f,x)   m_from_float(f(m_to_float(x)))
+#define m_f2(f,x,y) m_from_float(f(m_to_float(x),m_to_float(y)))
+
+#define m_add(x,y) m_from_float(m_to_float(x)+m_to_float(y))
+#define m_sub(x,y) m_from_float(m_to_float(x)-m_to_float(y))
+#define m_mul(x,y) m_from_float(m_to_float(x)*m_to_float(y))
+#define m_div(x,y) m_from_float(m_to_float(x)/m_to_float(y))
+#define m_div_check(x,y) (m_to_float(y)==0)
+#define m_mod(x,y) m_f2(fmodf,x,y)
+#define m_divmod(x,y,a,b) {a=m_div(x,y); b=m_mod(x,y);}
+#define m_pow(x,y) m_f2(powf,x,y)
+#define m_pow_int(x,y) m_from_float(pow(m_to_float(x),y))
+
+#define m_abs(x)     m_f1(fabsf,x)
+#define m_minus(x)   m_from_float(-m_to_float(x))
+#define m_reciprocal(x) m_from_float(1/m_to_float(x))
+#define m_square(x)  m_from_float(m_to_float(x)*m_to_float(x))
+#define m_floor(x)   m_f1(floorf,x)
+#define m_round(x)   m_f1(roundf,x)
+#define m_ceil(x)    m_f1(ceilf,x)
+#define m_trunc(x)   m_f1(truncf,x)
+#define m_rint(x)    m_f1(rintf,x)
+#define m_sign(x)    m_from_float(f_sign(m_to_float(x)))
+#define m_copysign(x,y) m_f2(copysignf,x,y)
+#define m_signbit(x) signbit(m_to_float(x))
+#define m_modf(x,y,z) {float f; y=m_from_float(modff(m_to_float(x),&f)); z=m_from_float(f);}
+
+#define m_eq(x,y) (m_to_float(x)==m_to_float(y))
+#define m_ne(x,y) (m_to_float(x)!=m_to_float(y))
+#define m_gt(x,y) (m_to_float(x)>m_to_float(y))
+#define m_ge(x,y) (m_to_float(x)>=m_to_float(y))
+#define m_lt(x,y) (m_to_float(x)<m_to_float(y))
+#define m_le(x,y) (m_to_float(x)<=m_to_float(y))
+
+#define m_isnan(x) isnan(m_to_float(x))
+#define m_isinf(x) isinf(m_to_float(x))
+#define m_isposinf(x) (isinf(m_to_float(x)) && signbit(m_to_float(x))==0)
+#define m_isneginf(x) (isinf(m_to_float(x)) && signbit(m_to_float(x)))
+#define m_isfinite(x) isfinite(m_to_float(x))
+
+#define not_nan(x) (!m_isnan(x))
+
+#define m_mulsum_init INT2FIX(0)
+
+#define m_sprintf(s,x) sprintf(s,"%g",m_to_float(x))
+
+#define cmp_prnan(a,b)                                             \
+    ((m_to_float(qsort_cast(a))==m_to_float(qsort_cast(b))) ? 0 :  \
+     (m_to_float(qsort_cast(a)) > m_to_float(qsort_cast(b))) ? 1 : -1)
+
+#define cmp_ignan(a,b)                                                  \
+    (m_isnan(qsort_cast(a)) ? (m_isnan(qsort_cast(b)) ? 0 : 1) :        \
+     (m_isnan(qsort_cast(b)) ? -1 :                                     \
+      ((m_to_float(qsort_cast(a))==m_to_float(qsort_cast(b))) ? 0 :     \
+       (m_to_float(qsort_cast(a)) > m_to_float(qsort_cast(b))) ? 1 : -1)))
+
+#define cmpgt_prnan(a,b)                                        \
+    (m_to_float(qsort_cast(a)) > m_to_float(qsort_cast(b)))
+
+#define cmpgt_ignan(a,b)                                        \
+    ((m_isnan(qsort_cast(a)) && !m_isnan(qsort_cast(b))) ||     \
+     (m_to_float(qsort_cast(a)) > m_to_float(qsort_cast(b))))
+
+#define m_sqrt(x)    m_f1(sqrtf,x)
+#define m_cbrt(x)    m_f1(cbrtf,x)
+#define m_log(x)     m_f1(logf,x)
+#define m_log2(x)    m_f1(log2f,x)
+#define m_log10(x)   m_f1(log10f,x)
+#define m_exp(x)     m_f1(expf,x)
+#define m_exp2(x)    m_f1(exp2f,x)
+#define m_exp10(x)   m_from_float(powf(10,m_to_float(x)))
+#define m_expm1(x)   m_f1(expm1f,x)
+#define m_log1p(x)   m_f1(log1pf,x)
+
+#define m_sin(x)     m_f1(sinf,x)
+#define m_cos(x)     m_f1(cosf,x)
+#define m_tan(x)     m_f1(tanf,x)
+#define m_asin(x)    m_f1(asinf,x)
+#define m_acos(x)    m_f1(acosf,x)
+#define m_atan(x)    m_f1(atanf,x)
+#define m_sinh(x)    m_f1(sinhf,x)
+#define m_cosh(x)    m_f1(coshf,x)
+#define m_tanh(x)    m_f1(tanhf,x)
+#define m_asinh(x)   m_f1(asinhf,x)
+#define m_acosh(x)   m_f1(acoshf,x)
+#define m_atanh(x)   m_f1(atanhf,x)
+#define m_atan2(x,y) m_f2(atan2f,x,y)
+#define m_hypot(x,y) m_f2(hypotf,x,y)
+#define m_sinc(x)    m_from_float(sinf(m_to_float(x))/m_to_float(x))
+
+#define m_erf(x)     m_f1(erff,x)
+#define m_erfc(x)    m_f1(erfcf,x)
+#define m_ldexp(x,y) m_from_float(ldexpf(m_to_float(x),y))
+#define m_frexp(x,exp) m_from_float(frexpf(m_to_float(x),exp))
+
+static inline float f_sign(float x)
+{
+    return (x==0) ? 0.0f : ((x>0) ? 1.0f : ((x<0) ? -1.0f : x));
+}
+
+static inline dtype f_seq(dtype x, dtype y, double c)
+{
+    return m_from_float(m_to_float(x) + m_to_float(y) * c);
+}
+
+/* Accumulates in float. */
+static inline dtype f_kahan_sum(size_t n, char *p, ssize_t stride)
+{
+    size_t i=n;
+    float x;
+    volatile float y=0;
+    volatile float t,r=0;
+
+    for (; i--;) {
+        x = m_to_float(*(dtype*)p);
+        p += stride;
+        if (fabsf(x) > fabsf(y)) {
+            float z=x; x=y; y=z;
+        }
+        r += x;
+        t = y;
+        y += r;
+        t = y-t;
+        r -= t;
+    }
+    return m_from_float(y);
+}
+
+static inline dtype f_kahan_sum_nan(size_t n, char *p, ssize_t stride)
+{
+    size_t i=n;
+    float x;
+    volatile float y=0;
+    volatile float t,r=0;
+
+    for (; i--;) {
+        x = m_to_float(*(dtype*)p);
+        p += stride;
+        if (!isnan(x)) {
+            if (fabsf(x) > fabsf(y)) {
+                float z=x; x=y; y=z;
+            }
+            r += x;
+            t = y;
+            y += r;
+            t = y-t;
+            r -= t;
+        }
+    }
+    return m_from_float(y);
+}
+
+#include "real_accum.h"
@@ -0,0 +1,18 @@
+#ifndef CUMO_HALF_MACRO_KERNEL_H
+#define CUMO_HALF_MACRO_KERNEL_H
+
+/* dtype of HFloat and BFloat16 converts implicitly from and to float (see
+   cumo/float16.h), so the macros for float are used as is and arithmetic
+   is done in float. Macros whose conditional expressions mix dtype and
+   double are redefined because the conversion would be ambiguous. */
+#include "float_macro_kernel.h"
+
+#undef m_zero
+#undef m_one
+#define m_zero dtype(0.0f)
+#define m_one  dtype(1.0f)
+
+#undef m_sign
+#define m_sign(x)    (((float)(x)==0) ? 0.0f:(((float)(x)>0) ? 1.0f:(((float)(x)<0) ? -1.0f:(float)(x))))
+
+#endif // CUMO_HALF_MACRO_KERNEL_H
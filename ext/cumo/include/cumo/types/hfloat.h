@@ -0,0 +1,25 @@
+typedef cumo_hfloat dtype;
+typedef cumo_hfloat rtype;
+#define cT  cumo_cHFloat
+#define cRT cumo_cHFloat
+#define mTM cumo_mHFloatMath
+
+#define m_to_float(x)   cumo_hfloat_to_float(x)
+#define m_from_float(x) cumo_hfloat_from_double(x)
+
+#include "half_macro.h"
+#include "cublas_v2.h"
+#include "cumo/cuda/cublas.h"
+
+#define m_min_init cumo_hfloat_new_dim0(m_from_float(0.0/0.0))
+#define m_max_init cumo_hfloat_new_dim0(m_from_float(0.0/0.0))
+
+#define m_extract(x) rb_float_new(m_to_float(*(dtype*)x))
+#define m_nearly_eq(x,y) (fabsf(m_to_float(x)-m_to_float(y))<=(fabsf(m_to_float(x))+fabsf(m_to_float(y)))*9.765625e-04*2)
+
+#define M_EPSILON rb_float_new(9.765625e-04)
+#define M_MIN     rb_float_new(6.103515625e-05)
+#define M_MAX     rb_float_new(65504.0)
+
+#define DATA_MIN 6.103515625e-05f
+#define DATA_MAX 65504.0f
@@ -72,19 +72,20 @@ __host__ __device__ static inline dtype f_minimum_nan(dtype x, dtype y)
 /* --------- thrust ----------------- */
 #include "cumo/cuda/cumo_thrust.hpp"
 
-struct cumo_thrust_plus : public thrust::binary_function<dtype, dtype, dtype>
+/* Products and sums are in the accumulation type (float for HFloat and BFloat16). */
+struct cumo_thrust_plus : public thrust::binary_function<cumo_accum<dtype>::type, cumo_accum<dtype>::type, cumo_accum<dtype>::type>
 {
-    __host__ __device__ dtype operator()(dtype x, dtype y) { return m_add(x,y); }
+    __host__ __device__ cumo_accum<dtype>::type operator()(cumo_accum<dtype>::type x, cumo_accum<dtype>::type y) { return x + y; }
 };
 
-struct cumo_thrust_multiplies : public thrust::binary_function<dtype, dtype, dtype>
+struct cumo_thrust_multiplies : public thrust::binary_function<dtype, dtype, cumo_accum<dtype>::type>
 {
-    __host__ __device__ dtype operator()(dtype x, dtype y) { return m_mul(x,y); }
+    __host__ __device__ cumo_accum<dtype>::type operator()(dtype x, dtype y) { return m_mul(x,y); }
 };
 
-struct cumo_thrust_multiplies_mulsum_nan : public thrust::binary_function<dtype, dtype, dtype>
+struct cumo_thrust_multiplies_mulsum_nan : public thrust::binary_function<dtype, dtype, cumo_accum<dtype>::type>
 {
-    __host__ __device__ dtype operator()(dtype x, dtype y) {
+    __host__ __device__ cumo_accum<dtype>::type operator()(dtype x, dtype y) {
         if (not_nan(x) && not_nan(y)) {
             return m_mul(x, y);
         } else {
@@ -93,9 +94,9 @@ struct cumo_thrust_multiplies_mulsum_nan : public thrust::binary_function<dtype,
     }
 };
 
-struct cumo_thrust_square : public thrust::unary_function<dtype, dtype>
+struct cumo_thrust_square : public thrust::unary_function<dtype, cumo_accum<dtype>::type>
 {
-    __host__ __device__ rtype operator()(const dtype& x) const { return m_square(x); }
+    __host__ __device__ cumo_accum<dtype>::type operator()(const dtype& x) const { return m_square(x); }
 };
 
 #endif // CUMO_REAL_ACCUM_KERNEL_H
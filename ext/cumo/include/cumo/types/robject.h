@@ -20,8 +20,10 @@ inline static int robj_nearly_eq(VALUE vx, VALUE vy)
     return (fabs(x-y)<=(fabs(x)+fabs(y))*DBL_EPSILON*2);
 }
 
+#ifdef CUMO_PHILOX_H
 /* generates a random number on [0,1)-real-interval */
-inline static dtype m_rand(dtype max)
+inline static dtype m_rand(dtype max, const uint32_t *w)
 {
-    return DBL2NUM(genrand_res53_mix() * max);
+    return m_mul(DBL2NUM(cumo_philox_to_double(w[0],w[1])), max);
 }
+#endif
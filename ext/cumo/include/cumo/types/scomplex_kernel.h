@@ -10,4 +10,24 @@ __device__ static inline bool c_nearly_eq(dtype x, dtype y) {
     return c_abs(c_sub(x,y)) <= (c_abs(x)+c_abs(y))*FLT_EPSILON*2;
 }
 
+#ifdef CUMO_PHILOX_H
+/* generates a random number on [0,1)-real-interval */
+__host__ __device__ static inline dtype m_rand(dtype max, const uint32_t *w)
+{
+    return c_new(cumo_philox_to_float(w[0]) * CUMO_REAL(max),
+                 cumo_philox_to_float(w[1]) * CUMO_IMAG(max));
+}
+
+/* generates a random number from the normal distribution
+   using Box-Muller Transformation.
+ */
+__host__ __device__ static inline dtype m_rand_norm(dtype mu, rtype sigma, const uint32_t *w)
+{
+    float r = sqrtf(-2 * logf(1 - cumo_philox_to_float(w[0])));
+    float t = 6.28318530717958648f * cumo_philox_to_float(w[1]);
+    return c_new(r * cosf(t) * sigma + CUMO_REAL(mu),
+                 r * sinf(t) * sigma + CUMO_IMAG(mu));
+}
+#endif
+
 #endif // CUMO_SCOMPLEX_KERNEL_H
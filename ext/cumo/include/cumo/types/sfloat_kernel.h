@@ -11,4 +11,22 @@ typedef float rtype;
 #define DATA_MIN FLT_MIN
 #define DATA_MAX FLT_MAX
 
+#ifdef CUMO_PHILOX_H
+/* generates a random number on [0,1)-real-interval */
+__host__ __device__ static inline dtype m_rand(dtype max, const uint32_t *w)
+{
+    return cumo_philox_to_float(w[0]) * max;
+}
+
+/* generates a random number from the normal distribution
+   using Box-Muller Transformation.
+ */
+__host__ __device__ static inline dtype m_rand_norm(dtype mu, rtype sigma, const uint32_t *w)
+{
+    float r = sqrtf(-2 * logf(1 - cumo_philox_to_float(w[0])));
+    float t = 6.28318530717958648f * cumo_philox_to_float(w[1]);
+    return r * cosf(t) * sigma + mu;
+}
+#endif
+
 #endif // CUMO_SFLOAT_KERNEL_H
@@ -1,3 +1,6 @@
+#include "cublas_v2.h"
+#include "cumo/cuda/cublas.h"
+
 #define m_zero 0
 #define m_one  1
 
@@ -189,6 +189,11 @@ cumo_na_mdai_investigate(cumo_na_mdai_t *mdai, int ndim)
     for (i=0; i < RARRAY_LEN(val); i++) {
         v = RARRAY_AREF(val,i);
 
+        // fast path for leaves of numeric data, which cannot be Range, Step or NArray
+        if (FIXNUM_P(v) || RB_FLOAT_TYPE_P(v)) {
+            mdai->type = cumo_na_object_type(mdai->type, v);
+            continue;
+        }
         if (TYPE(v) == T_ARRAY) {
             /* check recursive array */
             for (j=0; j<ndim; j++) {
@@ -2,6 +2,7 @@
 #include "cumo.h"
 #include "cumo/cuda/memory_pool.h"
 #include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
 #include "cumo/narray.h"
 #include "cumo/template.h"
 
@@ -111,8 +112,7 @@ iter_swap_byte(cumo_na_loop_t *const lp)
     e = lp->args[0].elmsz;
     b1 = ALLOCA_N(char, e);
     b2 = ALLOCA_N(char, e);
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("iter_swap_bytes", "any");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    CUMO_SYNCHRONIZE_FIXME("iter_swap_bytes", "any");
     LOOP_UNARY_PTR(lp,m_swap_byte);
 }
 
@@ -508,7 +508,7 @@ cumo_na_flatten_dim(VALUE self, int sd)
                 //     idx2[j] = idx1[j];
                 // }
                 idx2 = (size_t*)cumo_cuda_runtime_malloc(sizeof(size_t)*shape[i]);
-                cumo_cuda_runtime_check_status(cudaMemcpyAsync(idx2,idx1,sizeof(size_t)*shape[i],cudaMemcpyDeviceToDevice,0));
+                cumo_cuda_runtime_check_status(cudaMemcpyAsync(idx2,idx1,sizeof(size_t)*shape[i],cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
                 CUMO_SDX_SET_INDEX(na2->stridx[i],idx2);
             } else {
                 na2->stridx[i] = na1->stridx[i];
@@ -531,8 +531,7 @@ cumo_na_flatten_dim(VALUE self, int sd)
             pos = ALLOC_N(size_t, fd+1);
             pos[0] = 0;
             // md-loop
-            CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("na_flatten_dim", "any");
-            cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+            CUMO_SYNCHRONIZE_FIXME("na_flatten_dim", "any");
             for (i=j=0;;) {
                 for (; i<fd; i++) {
                     sdx = na1->stridx[i+sd];
@@ -753,7 +752,7 @@ cumo_na_diagonal(int argc, VALUE *argv, VALUE self)
                     //     idx1[j] = idx0[j];
                     // }
                     idx1 = (size_t*)cumo_cuda_runtime_malloc(sizeof(size_t)*na->shape[i]);
-                    cumo_cuda_runtime_check_status(cudaMemcpyAsync(idx1,idx0,sizeof(size_t)*na->shape[i],cudaMemcpyDeviceToDevice,0));
+                    cumo_cuda_runtime_check_status(cudaMemcpyAsync(idx1,idx0,sizeof(size_t)*na->shape[i],cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
                     CUMO_SDX_SET_INDEX(na2->stridx[k],idx1);
                 } else {
                     na2->stridx[k] = na1->stridx[i];
@@ -0,0 +1,233 @@
+#include "cumo/float16.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Host-only tests for conversions of HFloat and BFloat16.
+// Conversions are compared with a reference which rounds exact values in
+// double to the nearest 16-bit value, ties to even.
+
+namespace cumo {
+namespace internal {
+
+class Format {
+public:
+    // Positive finite values in order of bits from 0 to max_bits.
+    Format(float (*to_float)(uint16_t), uint16_t max_bits, uint16_t inf_bits)
+        : to_float_(to_float), inf_bits_(inf_bits) {
+        for (uint32_t h = 0; h <= max_bits; ++h) {
+            values_.push_back(to_float(static_cast<uint16_t>(h)));
+        }
+        double ulp = values_[max_bits] - values_[max_bits - 1];
+        overflow_ = values_[max_bits] + ulp / 2;
+    }
+
+    uint16_t Round(double x) const {
+        uint16_t sign = std::signbit(x) ? 0x8000 : 0;
+        x = std::fabs(x);
+        if (x >= overflow_) {
+            return sign | inf_bits_;  // the largest value is odd, so a tie goes to infinity
+        }
+        size_t i = std::upper_bound(values_.begin(), values_.end(), x) - values_.begin() - 1;
+        if (i + 1 == values_.size()) {
+            return sign | static_cast<uint16_t>(i);
+        }
+        double mid = (values_[i] + values_[i + 1]) / 2;  // exact
+        if (x > mid || (x == mid && (i & 1))) {
+            ++i;
+        }
+        return sign | static_cast<uint16_t>(i);
+    }
+
+    // Values to check: all values, midpoints, and their neighbors.
+    std::vector<double> Boundaries() const {
+        std::vector<double> xs;
+        for (size_t i = 0; i < values_.size(); ++i) {
+            double v = values_[i];
+            double mid = (i + 1 < values_.size()) ? (v + values_[i + 1]) / 2 : overflow_;
+            for (double x : {v, mid}) {
+                xs.push_back(x);
+                xs.push_back(std::nextafter(x, 0.0));
+                xs.push_back(std::nextafter(x, INFINITY));
+                xs.push_back(std::nextafter(static_cast<float>(x), 0.0f));
+                xs.push_back(std::nextafter(static_cast<float>(x), INFINITY));
+            }
+        }
+        return xs;
+    }
+
+private:
+    float (*to_float_)(uint16_t);
+    uint16_t inf_bits_;
+    std::vector<double> values_;
+    double overflow_;
+};
+
+class TestFloat16 {
+public:
+    TestFloat16()
+        : half_(cumo_hfloat_bits_to_float, 0x7bff, 0x7c00),
+          bfloat_(cumo_bfloat16_bits_to_float, 0x7f7f, 0x7f80) {}
+
+    void Run() {
+        TestHFloatToFloat();
+        TestHFloatRoundTrip();
+        TestFloatToHFloat();
+        TestDoubleToHFloat();
+        TestBFloat16RoundTrip();
+        TestFloatToBFloat16();
+        TestDoubleToBFloat16();
+        TestNaN();
+        TestRoundToOdd();
+    }
+
+    void TestHFloatToFloat() {
+        assert(cumo_hfloat_bits_to_float(0x0000) == 0.0f);
+        assert(std::signbit(cumo_hfloat_bits_to_float(0x8000)));
+        assert(cumo_hfloat_bits_to_float(0x3c00) == 1.0f);
+        assert(cumo_hfloat_bits_to_float(0xc000) == -2.0f);
+        assert(cumo_hfloat_bits_to_float(0x7bff) == 65504.0f);
+        assert(cumo_hfloat_bits_to_float(0x0001) == std::ldexp(1.0f, -24));
+        assert(cumo_hfloat_bits_to_float(0x03ff) == std::ldexp(1023.0f, -24));
+        assert(cumo_hfloat_bits_to_float(0x0400) == std::ldexp(1.0f, -14));
+        assert(cumo_hfloat_bits_to_float(0x7c00) == INFINITY);
+        assert(cumo_hfloat_bits_to_float(0xfc00) == -INFINITY);
+        assert(cumo_bfloat16_bits_to_float(0x3f80) == 1.0f);
+        assert(cumo_bfloat16_bits_to_float(0xc040) == -3.0f);
+    }
+
+    void TestHFloatRoundTrip() {
+        for (uint32_t h = 0; h < 0x10000; ++h) {
+            if (IsHFloatNaN(h)) continue;
+            float f = cumo_hfloat_bits_to_float(static_cast<uint16_t>(h));
+            assert(cumo_float_to_hfloat_bits(f) == h);
+            assert(cumo_double_to_hfloat_bits(f) == h);
+        }
+    }
+
+    void TestFloatToHFloat() {
+        for (double x : half_.Boundaries()) {
+            for (float f : {static_cast<float>(x), -static_cast<float>(x)}) {
+                assert(cumo_float_to_hfloat_bits(f) == half_.Round(f));
+            }
+        }
+        std::mt19937 engine(0);
+        for (int i = 0; i < 1000000; ++i) {
+            uint32_t u = engine();
+            float f = cumo_bits_to_float(u);
+            if (std::isnan(f)) continue;
+            assert(cumo_float_to_hfloat_bits(f) == half_.Round(f));
+        }
+        assert(cumo_float_to_hfloat_bits(1e10f) == 0x7c00);
+        assert(cumo_float_to_hfloat_bits(-1e-10f) == 0x8000);
+    }
+
+    // Double rounding through float would fail just above midpoints.
+    void TestDoubleToHFloat() {
+        for (double x : half_.Boundaries()) {
+            for (double d : {x, -x}) {
+                assert(cumo_double_to_hfloat_bits(d) == half_.Round(d));
+            }
+        }
+        std::mt19937_64 engine(0);
+        for (int i = 0; i < 1000000; ++i) {
+            // doubles in the range of HFloat
+            double d = std::ldexp(static_cast<double>(engine() >> 11), -53) * std::ldexp(1.0, static_cast<int>(engine() % 44) - 28);
+            if (engine() & 1) d = -d;
+            assert(cumo_double_to_hfloat_bits(d) == half_.Round(d));
+        }
+        double above_mid = 1.0 + std::ldexp(1.0, -11) + std::ldexp(1.0, -40);  // 1 + ulp/2 + tiny
+        assert(cumo_double_to_hfloat_bits(above_mid) == 0x3c01);
+        assert(cumo_double_to_hfloat_bits(1e300) == 0x7c00);
+        assert(cumo_double_to_hfloat_bits(1e-300) == 0x0000);
+    }
+
+    void TestBFloat16RoundTrip() {
+        for (uint32_t h = 0; h < 0x10000; ++h) {
+            float f = cumo_bfloat16_bits_to_float(static_cast<uint16_t>(h));
+            if (std::isnan(f)) continue;
+            assert(cumo_float_to_bfloat16_bits(f) == h);
+            assert(cumo_double_to_bfloat16_bits(f) == h);
+        }
+    }
+
+    void TestFloatToBFloat16() {
+        for (double x : bfloat_.Boundaries()) {
+            if (std::fabs(x) > std::numeric_limits<float>::max()) continue;
+            for (float f : {static_cast<float>(x), -static_cast<float>(x)}) {
+                assert(cumo_float_to_bfloat16_bits(f) == bfloat_.Round(f));
+            }
+        }
+        std::mt19937 engine(1);
+        for (int i = 0; i < 1000000; ++i) {
+            float f = cumo_bits_to_float(engine());
+            if (std::isnan(f)) continue;
+            assert(cumo_float_to_bfloat16_bits(f) == bfloat_.Round(f));
+        }
+        assert(cumo_float_to_bfloat16_bits(std::numeric_limits<float>::max()) == 0x7f80);
+    }
+
+    void TestDoubleToBFloat16() {
+        for (double x : bfloat_.Boundaries()) {
+            for (double d : {x, -x}) {
+                assert(cumo_double_to_bfloat16_bits(d) == bfloat_.Round(d));
+            }
+        }
+        double above_mid = 1.0 + std::ldexp(1.0, -8) + std::ldexp(1.0, -40);
+        assert(cumo_double_to_bfloat16_bits(above_mid) == 0x3f81);
+        assert(cumo_double_to_bfloat16_bits(1e300) == 0x7f80);
+        assert(cumo_double_to_bfloat16_bits(-1e-300) == 0x8000);
+    }
+
+    void TestNaN() {
+        float qnan = std::numeric_limits<float>::quiet_NaN();
+        float snan = cumo_bits_to_float(0x7f800001);  // signaling, payload only in low bits
+        for (float f : {qnan, -qnan, snan, -snan}) {
+            uint16_t h = cumo_float_to_hfloat_bits(f);
+            assert(IsHFloatNaN(h) && (h & 0x0200));
+            assert(((h & 0x8000) != 0) == std::signbit(f));
+            uint16_t b = cumo_float_to_bfloat16_bits(f);
+            assert(std::isnan(cumo_bfloat16_bits_to_float(b)) && (b & 0x0040));
+            assert(((b & 0x8000) != 0) == std::signbit(f));
+            assert(IsHFloatNaN(cumo_double_to_hfloat_bits(f)));
+            assert(std::isnan(cumo_bfloat16_bits_to_float(cumo_double_to_bfloat16_bits(f))));
+        }
+        // quiet NaNs keep their payload through float
+        for (uint32_t h = 0x7e00; h < 0x8000; h += 0x17) {
+            assert(cumo_float_to_hfloat_bits(cumo_hfloat_bits_to_float(static_cast<uint16_t>(h))) == h);
+        }
+    }
+
+    void TestRoundToOdd() {
+        assert(cumo_double_to_float_round_to_odd(1.5) == 1.5f);
+        float f = cumo_double_to_float_round_to_odd(1.0 + std::ldexp(1.0, -40));
+        assert(cumo_float_to_bits(f) == (cumo_float_to_bits(1.0f) | 1));
+        f = cumo_double_to_float_round_to_odd(-(1.0 + std::ldexp(1.0, -40)));
+        assert(cumo_float_to_bits(f) == (cumo_float_to_bits(-1.0f) | 1));
+        f = cumo_double_to_float_round_to_odd(1e300);
+        assert(f == std::numeric_limits<float>::max());
+        f = cumo_double_to_float_round_to_odd(1e-300);
+        assert(cumo_float_to_bits(f) == 1);
+    }
+
+private:
+    static bool IsHFloatNaN(uint32_t h) {
+        return (h & 0x7c00) == 0x7c00 && (h & 0x03ff) != 0;
+    }
+
+    Format half_;
+    Format bfloat_;
+};
+
+}  // namespace internal
+}  // namespace cumo
+
+int main() {
+    cumo::internal::TestFloat16{}.Run();
+    return 0;
+}
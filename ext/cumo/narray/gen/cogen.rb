@@ -7,6 +7,7 @@ $LOAD_PATH.unshift libpath
 require_relative "narray_def"
 
 $line_number = false
+$parts = 1
 
 while true
   if ARGV[0] == "-l"
@@ -15,15 +16,16 @@ while true
   elsif ARGV[0] == "-o"
     ARGV.shift
     $output = ARGV.shift
-    require "fileutils"
-    FileUtils.rm_f($output)
+  elsif ARGV[0] == "-s"
+    ARGV.shift
+    $parts = ARGV.shift.to_i
   else
     break
   end
 end
 
 if ARGV.size != 1
-  puts "usage:\n  ruby #{$0} [-l] erb_base [type_file]"
+  puts "usage:\n  ruby #{$0} [-l] [-s parts] [-o output] type_file"
   exit 1
 end
 
@@ -34,7 +36,7 @@ erb_dir = ["tmpl"]
 erb_dir.unshift("tmpl_bit") if (type_name == "bit")
 erb_dir.map!{|d| File.join(thisdir,d)}
 
-code = DefLib.new do
+lib = DefLib.new do
   set line_number: $line_number
   set erb_dir: erb_dir
   set erb_suffix: ".c"
@@ -50,10 +52,22 @@ code = DefLib.new do
     eval File.read(type_file), binding, type_file
     eval File.read(File.join(thisdir,"spec.rb")), binding, "spec.rb"
   end
-end.result
+end
+lib.split($parts)
+
+# Parts are written only if changed, so that make rebuilds only the parts
+# affected by an edit of a template.
+def write_part(path, code)
+  return if File.exist?(path) && File.read(path) == code
+  File.open(path, "w") {|f| f.write(code) }
+end
 
 if $output
-  open($output,"w").write(code)
+  (0...lib.parts).each do |i|
+    path = (i == 0) ? $output : $output.sub(/(_kernel)?(\.\w+)\z/) { "_p#{i}#{$1}#{$2}" }
+    lib.set part: i, file_name: path
+    write_part(path, lib.result)
+  end
 else
-  $stdout.write(code)
+  $stdout.write(lib.result)
 end
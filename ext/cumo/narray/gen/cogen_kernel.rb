@@ -5,8 +5,10 @@ libpath = File.absolute_path(File.dirname(__FILE__))+"/../../../../lib"
 $LOAD_PATH.unshift libpath
 
 require_relative "narray_def"
+require "cumo/cuda/jit_source"
 
 $line_number = false
+$parts = 1
 
 while true
   if ARGV[0] == "-l"
@@ -15,15 +17,16 @@ while true
   elsif ARGV[0] == "-o"
     ARGV.shift
     $output = ARGV.shift
-    require "fileutils"
-    FileUtils.rm_f($output)
+  elsif ARGV[0] == "-s"
+    ARGV.shift
+    $parts = ARGV.shift.to_i
   else
     break
   end
 end
 
 if ARGV.size != 1
-  puts "usage:\n  ruby #{$0} [-l] erb_base [type_file]"
+  puts "usage:\n  ruby #{$0} [-l] [-s parts] [-o output] type_file"
   exit 1
 end
 
@@ -34,7 +37,7 @@ erb_dir = ["tmpl"]
 erb_dir.unshift("tmpl_bit") if (type_name == "bit")
 erb_dir.map!{|d| File.join(thisdir,d)}
 
-code = DefLib.new do
+lib = DefLib.new do
   set line_number: $line_number
   set erb_dir: erb_dir
   set erb_suffix: "_kernel.cu"
@@ -44,6 +47,7 @@ code = DefLib.new do
   set type_name: type_name
   set lib_name: "cumo_"+type_name
 
+  set aot_kernels: Cumo::CUDA::JITSource.load_allowlist(ENV["CUMO_AOT_KERNELS"] || File.join(thisdir,"aot_kernels.txt"))
   set opt_indexer_ndim: File.read(File.expand_path("../../../include/cumo/indexer.h", __FILE__)).match(/CUMO_NA_INDEXER_OPTIMIZED_NDIM (\d+)/)[1].to_i
 
   def_class do
@@ -52,10 +56,22 @@ code = DefLib.new do
     eval File.read(type_file), binding, type_file
     eval File.read(File.join(thisdir,"spec.rb")), binding, "spec.rb"
   end
-end.result
+end
+lib.split($parts)
+
+# Parts are written only if changed, so that make rebuilds only the parts
+# affected by an edit of a template.
+def write_part(path, code)
+  return if File.exist?(path) && File.read(path) == code
+  File.open(path, "w") {|f| f.write(code) }
+end
 
 if $output
-  open($output,"w").write(code)
+  (0...lib.parts).each do |i|
+    path = (i == 0) ? $output : $output.sub(/(_kernel)?(\.\w+)\z/) { "_p#{i}#{$1}#{$2}" }
+    lib.set part: i, file_name: path
+    write_part(path, lib.result)
+  end
 else
-  $stdout.write(code)
+  $stdout.write(lib.result)
 end
@@ -0,0 +1,39 @@
+set name:                "bfloat16"
+set type_name:           "bfloat16"
+set full_class_name:     "Cumo::BFloat16"
+set class_name:          "BFloat16"
+set class_var:           "cT"
+set ctype:               "cumo_bfloat16"
+
+set has_math:            true
+set is_bit:              false
+set is_int:              false
+set is_unsigned:         false
+set is_float:            true
+set is_complex:          false
+set is_object:           false
+set is_real:             true
+set is_comparable:       true
+set is_double_precision: false
+set is_half:             true
+set need_align:          true
+
+upcast_rb "Integer"
+upcast_rb "Float"
+upcast_rb "Complex", "SComplex"
+
+upcast "RObject",  "RObject"
+upcast "DComplex", "DComplex"
+upcast "SComplex", "SComplex"
+upcast "DFloat",   "DFloat"
+upcast "SFloat",   "SFloat"
+upcast "BFloat16", "BFloat16"
+upcast "HFloat",   "SFloat"
+upcast "Int64",    "BFloat16"
+upcast "Int32",    "BFloat16"
+upcast "Int16",    "BFloat16"
+upcast "Int8",     "BFloat16"
+upcast "UInt64",   "BFloat16"
+upcast "UInt32",   "BFloat16"
+upcast "UInt16",   "BFloat16"
+upcast "UInt8",    "BFloat16"
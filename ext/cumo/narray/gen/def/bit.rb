@@ -16,6 +16,7 @@ set is_object:     false
 set is_real:       false
 set is_comparable: false
 set is_double_precision: false
+set is_half:             false
 set need_align:    false
 
 upcast_rb "Integer"
@@ -27,6 +28,8 @@ upcast "DComplex", "DComplex"
 upcast "SComplex", "SComplex"
 upcast "DFloat", "DFloat"
 upcast "SFloat", "SFloat"
+upcast "HFloat", "HFloat"
+upcast "BFloat16", "BFloat16"
 upcast "Int64",  "Int64"
 upcast "Int32",  "Int32"
 upcast "Int16",  "Int16"
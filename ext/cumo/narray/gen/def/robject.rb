@@ -17,6 +17,7 @@ set is_complex:          false
 set is_object:           true
 set is_comparable:       true
 set is_double_precision: false
+set is_half:             false
 set need_align:          false
 
 upcast_rb "Integer"
@@ -27,6 +28,8 @@ upcast "DComplex", "RObject"
 upcast "SComplex", "RObject"
 upcast "DFloat",   "RObject"
 upcast "SFloat",   "RObject"
+upcast "HFloat",   "RObject"
+upcast "BFloat16", "RObject"
 upcast "Int64",    "RObject"
 upcast "Int32",    "RObject"
 upcast "Int16",    "RObject"
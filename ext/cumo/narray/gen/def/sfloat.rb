@@ -16,6 +16,7 @@ set is_object:           false
 set is_real:             true
 set is_comparable:       true
 set is_double_precision: false
+set is_half:             false
 set need_align:          true
 
 upcast_rb "Integer"
@@ -27,6 +28,8 @@ upcast "DComplex", "DComplex"
 upcast "SComplex", "SComplex"
 upcast "DFloat",   "DFloat"
 upcast "SFloat",   "SFloat"
+upcast "HFloat",   "SFloat"
+upcast "BFloat16", "SFloat"
 upcast "Int64",    "SFloat"
 upcast "Int32",    "SFloat"
 upcast "Int16",    "SFloat"
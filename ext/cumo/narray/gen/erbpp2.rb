@@ -1,4 +1,6 @@
 require "erb"
+require "set"
+require "zlib"
 require_relative "erbln"
 
 class ErbPP
@@ -140,6 +142,64 @@ class DefLib < ErbPP
   def def_module(**opts, &block)
     DefModule.new(self, **opts, &block)
   end
+
+  # Part of the output being generated. Part 0 is the main file, which
+  # defines the modules and the Init function.
+  def part
+    @opts[:part] || 0
+  end
+
+  def parts
+    @opts[:parts] || 1
+  end
+
+  # Assigns methods of the modules to n parts of the output, which are
+  # compiled as separate translation units, so that they build in parallel
+  # and an edit of a template rebuilds only the part which uses it.
+  #
+  # Methods of a template stay together, and so do templates whose code
+  # refers to functions, macros or types defined by each other, e.g.,
+  # <type>_extract. Such a group of templates goes to the part given by
+  # the hash of their names, so that the parts do not change as templates
+  # are edited. Groups which the modules refer to, e.g., cast and store,
+  # stay in the main file.
+  def split(n)
+    set parts: n
+    return if n <= 1
+    methods = @children.flat_map{|m| m.children.select{|c| c.kind_of?(DefMethod)} }
+    groups = methods.group_by{|c| c.get(:erb_base)}
+    code = {}
+    groups.each{|t,cs| code[t] = cs.map{|c| c.result.to_s}.join("\n") }
+
+    owner = {}
+    code.each do |t,src|
+      src.each_line do |line|
+        case line
+        when /^\s*#\s*define\s+(\w+)/, /^\}\s*(\w+)\s*;/, /^typedef\b.*\b(\w+)\s*;/,
+             /^(?:typedef\s+)?(?:struct|union|enum)\s+(\w+)/, /^(?:[A-Za-z_][^(;=]*?[\s*])?([A-Za-z_]\w*)\s*\(/
+          owner[$1] ||= t
+        end
+      end
+    end
+
+    root = {}
+    code.each_key{|t| root[t] = t }
+    find = lambda{|t| root[t] == t ? t : (root[t] = find.(root[t])) }
+    code.each do |t,src|
+      src.scan(/\b[A-Za-z_]\w*/).to_set.each do |w|
+        if (u = owner[w]) && u != t
+          root[find.(u)] = find.(t)
+        end
+      end
+    end
+
+    pinned = @children.flat_map{|m| m.split_pinned.map{|c| find.(c.get(:erb_base))} }
+    comps = code.keys.group_by{|t| find.(t) }
+    comps.each do |r,ts|
+      k = pinned.include?(r) ? 0 : Zlib.crc32(ts.sort.join(",")) % n
+      ts.each{|t| groups[t].each{|c| c.set part_of: k } }
+    end
+  end
 end
 
 module DeclMethod
@@ -192,7 +252,23 @@ class DefModule < ErbPP
     @opts[:init_erb] || "init_module"
   end
   def method_code
-    @children.map{|c| c.result}.join("\n")
+    part_children.map{|c| c.result}.join("\n")
+  end
+  # Children in the part of the output being generated.
+  def part_children
+    @children.select{|c| (c.get(:part_of) || 0) == get(:part) }
+  end
+  # Methods which the module itself refers to.
+  def split_pinned
+    []
+  end
+  # Name of the function which defines the methods of the module in part i.
+  def split_init(i=get(:part))
+    "#{get(:lib_name)}_p#{i}_#{name}_init"
+  end
+  # Functions which define the methods of the module in other parts.
+  def split_inits
+    (1...get(:parts)).select{|i| @children.any?{|c| c.get(:part_of) == i } }.map{|i| split_init(i) }
   end
   def _mod_var
     @opts[:module_var]
@@ -216,6 +292,9 @@ class DefClass < DefModule
   def free_func
     @opts[:free_func] || "gsl_"+get(:name)+"_free"
   end
+  def split_pinned
+    [find("store"), find("cast")].compact
+  end
 end
 
 class DefMethod < ErbPP
@@ -27,7 +27,7 @@ module NArrayMethod
 
   def set2(meth, dtype, result_class)
     h = {dtype:dtype, result_class:result_class}
-    def_method(meth, "set2", h)
+    def_method(meth, "set2", **h)
   end
 
   def cond_binary(meth,op=nil)
@@ -70,6 +70,10 @@ module NArrayMethod
     def_method(meth, "accum_binary", op:ope)
   end
 
+  def rand_dist(meth)
+    def_method(meth, "rand_dist")
+  end
+
   def qsort(type_name, dtype, dcast, suffix="")
     h = {type_name:type_name, dtype:dtype, dcast:dcast, suffix:suffix}
     def_method("qsort", **h)
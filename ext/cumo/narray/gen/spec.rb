@@ -50,13 +50,23 @@ if is_object
   def_id "<=","le"
   def_id "<=>","ufo"
 end
-if (is_float || is_complex) && !is_object
+if (is_float || is_complex || is_int) && !is_object
   def_id "gemm"
 end
 
 if is_int && !is_object
   def_id "minlength" # for bincount
 end
+if is_real && !is_object
+  def_id "bins" # for histogram
+  def_id "range"
+end
+if is_comparable && !is_object
+  def_id "axis" # for max_k, topk, partition and quantile
+  def_id "largest"
+  def_id "keepdims"
+  def_id "interpolation"
+end
 
 # Constatnts
 
@@ -113,6 +123,8 @@ def_method "store" do
   end
   store_from "DFloat","double",   "m_from_real"
   store_from "SFloat","float",    "m_from_real"
+  store_from "HFloat","cumo_hfloat","m_from_hfloat"
+  store_from "BFloat16","cumo_bfloat16","m_from_bfloat16"
   store_from "Int64", "int64_t",  "m_from_int64"
   store_from "Int32", "int32_t",  "m_from_int32"
   store_from "Int16", "int16_t",  "m_from_sint"
@@ -171,6 +183,7 @@ if is_bit
   def_method "where"
   def_method "where2"
   def_method "mask"
+  def_method "rand_bernoulli"
 else
 
 def_method "map_with_index"
@@ -313,11 +326,19 @@ if is_comparable
   accum "ptp","dtype","cT"
   accum_index "max_index"
   accum_index "min_index"
+  accum_index "argmax"
+  accum_index "argmin"
   def_method "minmax"
   def_module_function "maximum", "ewcomp", n_arg:2
   def_module_function "minimum", "ewcomp", n_arg:2
 end
 
+if is_comparable && !is_object
+  def_method "max_k"
+  def_method "topk"
+  def_method "partition"
+end
+
 if is_int && !is_object
   def_method "bincount"
 end
@@ -328,14 +349,23 @@ cum "cumprod","mul"
 # dot
 accum_binary "mulsum"
 if (is_float || is_complex) && !is_object
-  def_method "gemm"
+  def_method "gemm", acc_class:false
+elsif is_int && !is_object
+  # products are accumulated in 32 bits for 8 and 16-bit integers, otherwise in 64 bits
+  bits = ctype[/\d+/].to_i
+  u = is_unsigned ? "U" : ""
+  def_method "gemm",
+    acc_type:"#{u.downcase}#{'_' if is_unsigned}int#{bits <= 16 ? 32 : 64}_t",
+    acc_class:(bits <= 16 && "cumo_c#{u}Int32")
 end
 
 # rmsdev
 # prod
 
 # shuffle
-# histogram
+if is_real && !is_object
+  def_method "histogram"
+end
 
 def_method "seq"
 if is_float
@@ -348,6 +378,21 @@ def_method "rand"
 if is_float && !is_object
   def_method "rand_norm"
 end
+if is_real && !is_object
+  rand_dist "rand_bernoulli"
+  rand_dist "rand_poisson"
+end
+if is_float && is_real && !is_object
+  rand_dist "rand_exponential"
+  rand_dist "rand_gamma"
+  rand_dist "rand_trunc_norm"
+end
+if is_int && !is_object
+  def_method "rand_categorical"
+  if /^U?Int(32|64)$/ =~ class_name
+    def_method "rand_multinomial"
+  end
+end
 
 # y = a[0] + a[1]*x + a[2]*x^2 + a[3]*x^3 + ... + a[n]*x^n
 def_method "poly"
@@ -367,6 +412,8 @@ if is_comparable && !is_object
     qsort type_name+"_index","dtype*","**(dtype**)"
   end
   def_method "sort_index"
+  def_method "quantile"
+  def_method "percentile"
   def_method "median"
 end
 
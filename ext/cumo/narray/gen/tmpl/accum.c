@@ -1,18 +1,13 @@
-<% indexer_ops = %w[sum prod min max ptp] %>
 <% (is_float ? ["","_nan"] : [""]).each do |nan| %>
 
 <% unless type_name == 'robject' %>
-//<% unless indexer_ops.include?(name) %>
-void cumo_<%=type_name%>_<%=name%><%=nan%>_kernel_launch(size_t n, char *p1, ssize_t s1, char *p2);
-<% else %>
 void cumo_<%=type_name%>_<%=name%><%=nan%>_kernel_launch(cumo_na_reduction_arg_t* arg);
 <% end %>
-<% end %>
 
 static void
 <%=c_iter%><%=nan%>(cumo_na_loop_t *const lp)
 {
-    <% if type_name == 'robject' || name == 'kahan_sum' || nan == '_nan' %>
+    <% if type_name == 'robject' %>
     {
         size_t   n;
         char    *p1, *p2;
@@ -22,25 +17,11 @@ static void
         CUMO_INIT_PTR(lp, 0, p1, s1);
         p2 = lp->args[1].ptr + lp->args[1].iter[0].pos;
 
-        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%><%=nan%>", "<%=type_name%>");
+        CUMO_SYNCHRONIZE_FIXME("<%=name%><%=nan%>", "<%=type_name%>");
         *(<%=dtype%>*)p2 = f_<%=name%><%=nan%>(n,p1,s1);
     }
-    //<% elsif !indexer_ops.include?(name) %>
-    {
-        size_t   n;
-        char    *p1, *p2;
-        ssize_t  s1;
-
-        CUMO_INIT_COUNTER(lp, n);
-        CUMO_INIT_PTR(lp, 0, p1, s1);
-        p2 = lp->args[1].ptr + lp->args[1].iter[0].pos;
-
-        cumo_<%=type_name%>_<%=name%><%=nan%>_kernel_launch(n,p1,s1,p2);
-    }
     <% else %>
     {
-        // TODO(sonots): How to compute Kahan summation algorithm in parallel?
-        // TODO(sonots): Implement nan CUDA version
         cumo_na_reduction_arg_t arg = cumo_na_make_reduction_arg(lp);
         cumo_<%=type_name%>_<%=name%><%=nan%>_kernel_launch(&arg);
     }
@@ -66,7 +47,7 @@ static VALUE
     VALUE v, reduce;
     cumo_ndfunc_arg_in_t ain[2] = {{cT,0},{cumo_sym_reduce,0}};
     cumo_ndfunc_arg_out_t aout[1] = {{<%=result_class%>,0}};
-    //<% if type_name == 'robject' || !indexer_ops.include?(name) %>
+    <% if type_name == 'robject' %>
     cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_STRIDE_LOOP_NIP|CUMO_NDF_FLAT_REDUCE, 2, 1, ain, aout };
     <% else %>
     cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_STRIDE_LOOP_NIP|CUMO_NDF_FLAT_REDUCE|CUMO_NDF_INDEXER_LOOP, 2, 1, ain, aout };
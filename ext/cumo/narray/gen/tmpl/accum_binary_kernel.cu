@@ -2,7 +2,6 @@
 <% $cumo_narray_gen_tmpl_accum_binary_kernel_included = 1 %>
 
 <% unless type_name == 'robject' %>
-//<% (is_float ? ["","_nan"] : [""]).each do |nan| %>
 
 #if defined(__cplusplus)
 #if 0
@@ -11,19 +10,21 @@
 }  /* extern "C" { */
 #endif
 
-template<typename Iterator1, typename Iterator2>
-__global__ void <%="cumo_#{type_name}_mulsum#{nan}_reduce_kernel"%>(Iterator1 p1_begin, Iterator1 p1_end, Iterator2 p2_begin, dtype* p3)
-{
-    dtype init = m_zero;
-    *p3 = thrust::inner_product(thrust::cuda::par, p1_begin, p1_end, p2_begin, init, cumo_thrust_plus(), cumo_thrust_multiplies<%= "_mulsum#{nan}" unless nan.empty? %>());
-}
+// Products are summed in the accumulation type (float for HFloat and BFloat16).
+struct cumo_<%=type_name%>_mulsum_impl {
+    typedef cumo_accum<dtype>::type accum_t;
+    __device__ accum_t Identity(int64_t /*index*/) { return m_zero; }
+    __device__ accum_t MapIn(dtype in, dtype in2, int64_t /*index*/) { return cumo_thrust_multiplies()(in, in2); }
+    __device__ void Reduce(accum_t next, accum_t& accum) { accum = cumo_thrust_plus()(next, accum); }
+    __device__ dtype MapOut(accum_t accum) { return accum; }
+};
+<% if is_float %>
 
-__global__ void <%="cumo_#{type_name}_mulsum#{nan}_kernel"%>(char *p1, char *p2, char *p3, ssize_t s1, ssize_t s2, ssize_t s3, uint64_t n)
-{
-    for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
-        m_<%=name%><%=nan%>(*(dtype*)(p1+(i*s1)), *(dtype*)(p2+(i*s2)), *(dtype*)(p3+(i*s3)));
-    }
-}
+// Products with NaN are skipped.
+struct cumo_<%=type_name%>_mulsum_nan_impl : cumo_<%=type_name%>_mulsum_impl {
+    __device__ accum_t MapIn(dtype in, dtype in2, int64_t /*index*/) { return cumo_thrust_multiplies_mulsum_nan()(in, in2); }
+};
+<% end %>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -32,30 +33,12 @@ extern "C" {
 #endif
 #endif
 
-void <%="cumo_#{type_name}_mulsum#{nan}_reduce_kernel_launch"%>(char *p1, char *p2, char *p3, ssize_t s1, ssize_t s2, uint64_t n)
+<% (is_float ? ["","_nan"] : [""]).each do |nan| %>
+void <%="cumo_#{type_name}_mulsum#{nan}_kernel_launch"%>(cumo_na_binary_reduction_arg_t* arg)
 {
-    ssize_t s1_idx = s1 / sizeof(dtype);
-    ssize_t s2_idx = s2 / sizeof(dtype);
-    thrust::device_ptr<dtype> p1_begin = thrust::device_pointer_cast((dtype*)p1);
-    thrust::device_ptr<dtype> p1_end   = thrust::device_pointer_cast(((dtype*)p1) + n * s1_idx);
-    thrust::device_ptr<dtype> p2_begin = thrust::device_pointer_cast((dtype*)p2);
-    thrust::device_ptr<dtype> p2_end   = thrust::device_pointer_cast(((dtype*)p2) + n * s2_idx);
-    if (s1_idx > 1 || s2_idx > 1) {
-        cumo_thrust_strided_range<thrust::device_vector<dtype>::iterator> r1(p1_begin, p1_end, s1_idx);
-        cumo_thrust_strided_range<thrust::device_vector<dtype>::iterator> r2(p2_begin, p2_end, s2_idx);
-        <%="cumo_#{type_name}_mulsum#{nan}_reduce_kernel"%><<<1,1>>>(r1.begin(), r1.end(), r2.begin(), (dtype*)p3);
-    } else {
-        // ref. https://github.com/thrust/thrust/blob/master/examples/cuda/async_reduce.cu
-        <%="cumo_#{type_name}_mulsum#{nan}_reduce_kernel"%><<<1,1>>>(p1_begin, p1_end, p2_begin, (dtype*)p3);
-    }
+    cumo_binary_reduce<dtype, dtype, cumo_<%=type_name%>_mulsum<%=nan%>_impl>(*arg, cumo_<%=type_name%>_mulsum<%=nan%>_impl{});
 }
 
-void <%="cumo_#{type_name}_mulsum#{nan}_kernel_launch"%>(char *p1, char *p2, char *p3, ssize_t s1, ssize_t s2, ssize_t s3, uint64_t n)
-{
-    size_t grid_dim = cumo_get_grid_dim(n);
-    size_t block_dim = cumo_get_block_dim(n);
-    <%="cumo_#{type_name}_mulsum#{nan}_kernel"%><<<grid_dim, block_dim>>>(p1,p2,p3,s1,s2,s3,n);
-}
-//<% end %>
+<% end %>
 <% end %>
 <% end %>
@@ -1,3 +1,5 @@
+<% is_arg = name.start_with?("arg")
+   base = is_arg ? name.sub("arg","")+"_index" : name %>
 <% (is_float ? ["","_nan"] : [""]).each do |nan| %>
 
 <%   [64,32].each do |i| %>
@@ -9,8 +11,73 @@ void cumo_<%=type_name%>_<%=name%><%=nan%>_int<%=i%>_kernel_launch(cumo_na_reduc
 static void
 <%=c_iter%>_index<%=i%><%=nan%>(cumo_na_loop_t *const lp)
 {
-    // TODO(sonots): Support nan in CUDA
-    <% if type_name == 'robject' || nan == '_nan' %>
+    <% if is_arg && type_name == 'robject' %>
+    {
+        size_t   n;
+        char    *d_ptr, *o_ptr;
+        ssize_t  d_step;
+
+        CUMO_INIT_COUNTER(lp, n);
+        CUMO_INIT_PTR(lp, 0, d_ptr, d_step);
+        o_ptr = CUMO_NDL_PTR(lp,1);
+
+        CUMO_SYNCHRONIZE_FIXME("<%=name%><%=nan%>", "<%=type_name%>");
+        *(idx_t*)o_ptr = f_<%=base%><%=nan%>(n,d_ptr,d_step);
+    }
+    <% elsif is_arg %>
+    cumo_na_reduction_arg_t arg = cumo_na_make_reduction_arg(lp);
+
+    if (!cumo_compatible_mode_enabled_p()) {
+        cumo_<%=type_name%>_<%=name%><%=nan%>_int<%=i%>_kernel_launch(&arg);
+        return;
+    }
+    CUMO_SYNCHRONIZE("<%=name%><%=nan%>", "<%=type_name%>");
+    {
+        // the same order as f_<%=base%><%=nan%>, over rows of several axes
+        size_t   i_out, i_reduce, j, n_out, n_reduce;
+        dtype    x, y;
+
+        n_out = arg.out_indexer.total_size;
+        if (n_out == 0 || arg.in_indexer.total_size == 0) {
+            return;
+        }
+        n_reduce = arg.in_indexer.total_size / n_out;
+        for (i_out = 0; i_out < n_out; i_out++) {
+            char *i_ptr = cumo_na_host_iarray_at(&arg.in, &arg.in_indexer, i_out * n_reduce);
+            j = 0;
+            y = *(dtype*)i_ptr;
+            for (i_reduce = 1; i_reduce < n_reduce; i_reduce++) {
+                x = *(dtype*)cumo_na_host_iarray_at(&arg.in, &arg.in_indexer, i_out * n_reduce + i_reduce);
+              <% if is_float %>
+                <% if nan != "" %>
+                if (!not_nan(y)) {
+                    break;
+                }
+                if (!not_nan(x)) {
+                    y = x;
+                    j = i_reduce;
+                    break;
+                }
+                <% else %>
+                if (!not_nan(x)) {
+                    continue;
+                }
+                if (!not_nan(y)) {
+                    y = x;
+                    j = i_reduce;
+                    continue;
+                }
+                <% end %>
+              <% end %>
+                if (<%= base == "min_index" ? "m_lt(x,y)" : "m_gt(x,y)" %>) {
+                    y = x;
+                    j = i_reduce;
+                }
+            }
+            *(idx_t*)cumo_na_host_iarray_at(&arg.out, &arg.out_indexer, i_out) = (idx_t)j;
+        }
+    }
+    <% elsif type_name == 'robject' %>
     {
         size_t   n, idx;
         char    *d_ptr, *i_ptr, *o_ptr;
@@ -21,7 +88,7 @@ static void
         CUMO_INIT_PTR(lp, 1, i_ptr, i_step);
         o_ptr = CUMO_NDL_PTR(lp,2);
 
-        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%><%=nan%>", "<%=type_name%>");
+        CUMO_SYNCHRONIZE_FIXME("<%=name%><%=nan%>", "<%=type_name%>");
         idx = f_<%=name%><%=nan%>(n,d_ptr,d_step);
         *(idx_t*)o_ptr = *(idx_t*)(i_ptr + i_step * idx);
     }
@@ -35,6 +102,67 @@ static void
 #undef idx_t
 <% end;end %>
 
+<% if is_arg %>
+/*
+  <%=name%>. Return indices of the result along the reduction axes.
+  Unlike <%=base%>, which returns indices of the flattened self, the index
+  is the position in each row reduced, e.g., the column for axis: 1. If
+  axis has several dimensions, the index is the position in the row-major
+  order of those dimensions. Ties are resolved by the first position.
+<% if is_float %>
+  @overload <%=name%>(axis:nil, nan:false)
+  @param [TrueClass] nan  If true, apply NaN-aware algorithm (return NaN posision if exist).
+<% else %>
+  @overload <%=name%>(axis:nil)
+<% end %>
+  @param [Numeric,Array,Range] axis  Affected dimensions.
+  @return [Integer,Cumo::Int] returns result index of <%=name%>.
+  @example
+      Cumo::NArray[[3,4,1],[2,0,5]].<%=name%>(axis:1) => Cumo::Int32[<%= base == "min_index" ? "2,1" : "1,2" %>]
+ */
+static VALUE
+<%=c_func(-1)%>(int argc, VALUE *argv, VALUE self)
+{
+    cumo_narray_t *na;
+    VALUE reduce;
+    cumo_ndfunc_arg_in_t ain[2] = {{Qnil,0},{cumo_sym_reduce,0}};
+    cumo_ndfunc_arg_out_t aout[1] = {{0,0,0}};
+  <% if type_name == 'robject' %>
+    cumo_ndfunc_t ndf = {0, CUMO_STRIDE_LOOP_NIP|CUMO_NDF_FLAT_REDUCE|CUMO_NDF_EXTRACT, 2,1, ain,aout};
+  <% else %>
+    cumo_ndfunc_t ndf = {0, CUMO_STRIDE_LOOP_NIP|CUMO_NDF_FLAT_REDUCE|CUMO_NDF_EXTRACT|CUMO_NDF_INDEXER_LOOP, 2,1, ain,aout};
+  <% end %>
+
+    CumoGetNArray(self,na);
+    if (na->ndim==0) {
+        return INT2FIX(0);
+    }
+    if (na->size > (~(u_int32_t)0)) {
+        aout[0].type = cumo_cInt64;
+        ndf.func = <%=c_iter%>_index64;
+        <% if is_float %>
+        reduce = cumo_na_reduce_dimension(argc, argv, 1, &self, &ndf, <%=c_iter%>_index64_nan);
+        <% else %>
+        reduce = cumo_na_reduce_dimension(argc, argv, 1, &self, &ndf, 0);
+        <% end %>
+    } else {
+        aout[0].type = cumo_cInt32;
+        ndf.func = <%=c_iter%>_index32;
+        <% if is_float %>
+        reduce = cumo_na_reduce_dimension(argc, argv, 1, &self, &ndf, <%=c_iter%>_index32_nan);
+        <% else %>
+        reduce = cumo_na_reduce_dimension(argc, argv, 1, &self, &ndf, 0);
+        <% end %>
+    }
+
+    if (cumo_na_has_idx_p(self)) {
+        VALUE copy = cumo_na_copy(self); // reduction does not support idx, make conttiguous
+        return cumo_na_ndloop(&ndf, 2, copy, reduce);
+    } else {
+        return cumo_na_ndloop(&ndf, 2, self, reduce);
+    }
+}
+<% else %>
 /*
   <%=name%>. Return an index of result.
 <% if is_float %>
@@ -122,3 +250,4 @@ static VALUE
     }
     <% end %>
 }
+<% end %>
@@ -12,6 +12,74 @@
 }  /* extern "C" { */
 #endif
 
+<% if is_float %>
+// Ties are broken by the smaller index, so that the first position is
+// returned as on the host. NaN is skipped unless all elements are NaN.
+// The _nan variants return the position of the first NaN if any.
+struct cumo_<%=type_name%>_min_index_int<%=i%>_impl {
+    struct MinAndArgMin {
+        dtype min;
+        idx_t argmin;
+    };
+    __device__ MinAndArgMin Identity(idx_t index) { return {(dtype)NAN, index}; }
+    __device__ MinAndArgMin MapIn(dtype in, idx_t index) { return {in, index}; }
+    __device__ void Reduce(MinAndArgMin next, MinAndArgMin& accum) {
+        if (m_isnan(next.min)) {
+            if (m_isnan(accum.min) && next.argmin < accum.argmin) {
+                accum = next;
+            }
+        } else if (m_isnan(accum.min) || next.min < accum.min || (next.min == accum.min && next.argmin < accum.argmin)) {
+            accum = next;
+        }
+    }
+    __device__ idx_t MapOut(MinAndArgMin accum) { return accum.argmin; }
+};
+
+struct cumo_<%=type_name%>_max_index_int<%=i%>_impl {
+    struct MaxAndArgMax {
+        dtype max;
+        idx_t argmax;
+    };
+    __device__ MaxAndArgMax Identity(idx_t index) { return {(dtype)NAN, index}; }
+    __device__ MaxAndArgMax MapIn(dtype in, idx_t index) { return {in, index}; }
+    __device__ void Reduce(MaxAndArgMax next, MaxAndArgMax& accum) {
+        if (m_isnan(next.max)) {
+            if (m_isnan(accum.max) && next.argmax < accum.argmax) {
+                accum = next;
+            }
+        } else if (m_isnan(accum.max) || next.max > accum.max || (next.max == accum.max && next.argmax < accum.argmax)) {
+            accum = next;
+        }
+    }
+    __device__ idx_t MapOut(MaxAndArgMax accum) { return accum.argmax; }
+};
+
+struct cumo_<%=type_name%>_min_index_nan_int<%=i%>_impl : cumo_<%=type_name%>_min_index_int<%=i%>_impl {
+    __device__ MinAndArgMin Identity(idx_t index) { return {(dtype)INFINITY, index}; }
+    __device__ void Reduce(MinAndArgMin next, MinAndArgMin& accum) {
+        if (m_isnan(accum.min)) {
+            if (m_isnan(next.min) && next.argmin < accum.argmin) {
+                accum = next;
+            }
+        } else if (m_isnan(next.min) || next.min < accum.min || (next.min == accum.min && next.argmin < accum.argmin)) {
+            accum = next;
+        }
+    }
+};
+
+struct cumo_<%=type_name%>_max_index_nan_int<%=i%>_impl : cumo_<%=type_name%>_max_index_int<%=i%>_impl {
+    __device__ MaxAndArgMax Identity(idx_t index) { return {(dtype)(-INFINITY), index}; }
+    __device__ void Reduce(MaxAndArgMax next, MaxAndArgMax& accum) {
+        if (m_isnan(accum.max)) {
+            if (m_isnan(next.max) && next.argmax < accum.argmax) {
+                accum = next;
+            }
+        } else if (m_isnan(next.max) || next.max > accum.max || (next.max == accum.max && next.argmax < accum.argmax)) {
+            accum = next;
+        }
+    }
+};
+<% else %>
 struct cumo_<%=type_name%>_min_index_int<%=i%>_impl {
     struct MinAndArgMin {
         dtype min;
@@ -42,6 +110,8 @@ struct cumo_<%=type_name%>_max_index_int<%=i%>_impl {
     __device__ idx_t MapOut(MaxAndArgMax accum) { return accum.argmax; }
 };
 
+<% end %>
+
 #if defined(__cplusplus)
 extern "C" {
 #if 0
@@ -58,6 +128,29 @@ void cumo_<%=type_name%>_max_index_int<%=i%>_kernel_launch(cumo_na_reduction_arg
 {
     cumo_reduce<dtype, idx_t, cumo_<%=type_name%>_max_index_int<%=i%>_impl>(*arg, cumo_<%=type_name%>_max_index_int<%=i%>_impl{});
 }
+<% if is_float %>
+
+void cumo_<%=type_name%>_min_index_nan_int<%=i%>_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, idx_t, cumo_<%=type_name%>_min_index_nan_int<%=i%>_impl>(*arg, cumo_<%=type_name%>_min_index_nan_int<%=i%>_impl{});
+}
+
+void cumo_<%=type_name%>_max_index_nan_int<%=i%>_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, idx_t, cumo_<%=type_name%>_max_index_nan_int<%=i%>_impl>(*arg, cumo_<%=type_name%>_max_index_nan_int<%=i%>_impl{});
+}
+<% end %>
+
+// arg(min|max) pass positions along the reduction axes to the same impls.
+<% (is_float ? ["","_nan"] : [""]).each do |nan| %>
+<%   ["min","max"].each do |m| %>
+
+void cumo_<%=type_name%>_arg<%=m%><%=nan%>_int<%=i%>_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_arg_reduce<dtype, idx_t, cumo_<%=type_name%>_<%=m%>_index<%=nan%>_int<%=i%>_impl>(*arg, cumo_<%=type_name%>_<%=m%>_index<%=nan%>_int<%=i%>_impl{});
+}
+<%   end %>
+<% end %>
 
 #undef idx_t
 <% end %>
@@ -29,7 +29,7 @@ static void
         CUMO_INIT_PTR(lp, 1, p2, s2);
         CUMO_INIT_PTR(lp, 2, p3, s3);
 
-        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+        CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
         //<% if need_align %>
         if (cumo_is_aligned(p1,sizeof(dtype)) &&
             cumo_is_aligned(p2,sizeof(dtype)) &&
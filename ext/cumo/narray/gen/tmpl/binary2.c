@@ -17,7 +17,7 @@ static void
         <% if type_name == 'robject' %>
         {
             dtype    x, y, a, b;
-            CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+            CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
             CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
             CUMO_GET_DATA_STRIDE(p2,s2,dtype,y);
 <% if is_int and %w[divmod].include? name %>
@@ -1,6 +1,7 @@
 <% unless type_name == 'robject' %>
+<% jit_ndims = (0..opt_indexer_ndim).reject {|idim| Cumo::CUDA::JITSource.aot?(aot_kernels, type_name, name, idim) } %>
 
-<% ((0..opt_indexer_ndim).to_a << '').each do |idim| %>
+<% (((0..opt_indexer_ndim).to_a - jit_ndims) << '').each do |idim| %>
 __global__ void <%="cumo_#{c_iter}_kernel_dim#{idim}"%>(cumo_na_iarray_t a1, cumo_na_iarray_t a2, cumo_na_iarray_t a3, cumo_na_indexer_t indexer)
 {
     for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < indexer.total_size; i += blockDim.x * gridDim.x) {
@@ -17,14 +18,28 @@ void <%="cumo_#{c_iter}_kernel_launch"%>(cumo_na_iarray_t* a1, cumo_na_iarray_t*
 {
     size_t grid_dim = cumo_get_grid_dim(indexer->total_size);
     size_t block_dim = cumo_get_block_dim(indexer->total_size);
+  <% if jit_ndims.any? %>
+    // Specializations not in narray/gen/aot_kernels.txt are compiled by NVRTC on first use.
+    static cumo_cuda_jit_cache_t jit;
+    void *params[] = {a1, a2, a3, indexer};
+  <% end %>
     switch (indexer->ndim) {
-    <% (0..opt_indexer_ndim).each do |idim| %>
+    <% ((0..opt_indexer_ndim).to_a - jit_ndims).each do |idim| %>
     case <%=idim%>:
-        <%="cumo_#{c_iter}_kernel_dim#{idim}"%><<<grid_dim, block_dim>>>(*a1,*a2,*a3,*indexer);
+        <%="cumo_#{c_iter}_kernel_dim#{idim}"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(*a1,*a2,*a3,*indexer);
         break;
     <% end %>
+    <% jit_ndims.each do |idim| %>
+    case <%=idim%>:
+    <% end %>
+    <% if jit_ndims.any? %>
+        if (cumo_cuda_function_launch_jit_binary(&jit, "<%=type_name%>", "<%=name%>", indexer->ndim, grid_dim, block_dim, params)) {
+            break;
+        }
+        // fall through to the kernel for any ndim
+    <% end %>
     default:
-        <%="cumo_#{c_iter}_kernel_dim"%><<<grid_dim, block_dim>>>(*a1,*a2,*a3,*indexer);
+        <%="cumo_#{c_iter}_kernel_dim"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(*a1,*a2,*a3,*indexer);
         break;
     }
 }
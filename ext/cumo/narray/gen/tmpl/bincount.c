@@ -1,9 +1,41 @@
+typedef struct {
+    char    *p1;
+    ssize_t  s1;
+    size_t  *idx1;
+    char    *p2;
+    ssize_t  s2;
+} <%=c_iter%>_host_t;
+
+static void
+<%=c_iter%>_host(size_t begin, size_t end, void *bins, void *data)
+{
+    <%=c_iter%>_host_t *h = (<%=c_iter%>_host_t*)data;
+    uint64_t *b = (uint64_t*)bins;
+    size_t i;
+    dtype x;
+
+    if (h->idx1) {
+        for (i = begin; i < end; i++) {
+            x = *(dtype*)(h->p1 + h->idx1[i]);
+            b[x]++;
+        }
+    } else {
+        for (i = begin; i < end; i++) {
+            x = *(dtype*)(h->p1 + h->s1 * i);
+            b[x]++;
+        }
+    }
+}
+
 // ------- Integer count without weights -------
 <%
 [32,64].each do |bits|
    cnt_cT = "cumo_cUInt#{bits}"
    cnt_type = "u_int#{bits}_t"
 %>
+void <%="cumo_#{c_iter}_#{bits}_index_kernel_launch"%>(char *p1, size_t *idx1, char *p2, ssize_t s2, uint64_t n, uint64_t length);
+void <%="cumo_#{c_iter}_#{bits}_stride_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, uint64_t n, uint64_t length);
+
 static void
 <%=c_iter%>_<%=bits%>(cumo_na_loop_t *const lp)
 {
@@ -17,22 +49,23 @@ static void
     i = lp->args[0].shape[0];
     n = lp->args[1].shape[0];
 
-    // initialize
-    for (x=0; x < n; x++) {
-        *(<%=cnt_type%>*)(p2 + s2*x) = 0;
+    if (cumo_compatible_mode_enabled_p()) {
+        <%=c_iter%>_host_t h = {p1, s1, idx1, NULL, 0};
+        uint64_t *bins;
+
+        CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+        bins = (uint64_t*)cumo_na_host_histogram(i, n, 0, <%=c_iter%>_host, &h);
+        for (x=0; x < n; x++) {
+            *(<%=cnt_type%>*)(p2 + s2*x) = (<%=cnt_type%>)bins[x];
+        }
+        xfree(bins);
+        return;
     }
 
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>_<%=bits%>", "<%=type_name%>");
     if (idx1) {
-        for (; i--;) {
-            CUMO_GET_DATA_INDEX(p1,idx1,dtype,x);
-            (*(<%=cnt_type%>*)(p2 + s2*x))++;
-        }
+        <%="cumo_#{c_iter}_#{bits}_index_kernel_launch"%>(p1,idx1,p2,s2,i,n);
     } else {
-        for (; i--;) {
-            CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
-            (*(<%=cnt_type%>*)(p2 + s2*x))++;
-        }
+        <%="cumo_#{c_iter}_#{bits}_stride_kernel_launch"%>(p1,s1,p2,s2,i,n);
     }
 }
 
@@ -57,10 +90,25 @@ static VALUE
   cnt_cT = "cumo_c#{fn}loat"
   fn = fn.downcase
 %>
+static void
+<%=c_iter%>_host_<%=fn%>(size_t begin, size_t end, void *bins, void *data)
+{
+    <%=c_iter%>_host_t *h = (<%=c_iter%>_host_t*)data;
+    double *b = (double*)bins;
+    size_t i;
+    dtype x;
+
+    for (i = begin; i < end; i++) {
+        x = *(dtype*)(h->p1 + h->s1 * i);
+        b[x] += *(<%=cnt_type%>*)(h->p2 + h->s2 * i);
+    }
+}
+
+void <%="cumo_#{c_iter}_#{fn}_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, uint64_t n, uint64_t length);
+
 static void
 <%=c_iter%>_<%=fn%>(cumo_na_loop_t *const lp)
 {
-    <%=cnt_type%> w;
     size_t   i, x, n, m;
     char    *p1, *p2, *p3;
     ssize_t  s1, s2, s3;
@@ -77,15 +125,21 @@ static void
                  "size mismatch along last axis between self and weight");
     }
 
-    // initialize
-    for (x=0; x < n; x++) {
-        *(<%=cnt_type%>*)(p3 + s3*x) = 0;
-    }
-    for (; i--;) {
-        CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
-        CUMO_GET_DATA_STRIDE(p2,s2,<%=cnt_type%>,w);
-        (*(<%=cnt_type%>*)(p3 + s3*x)) += w;
+    if (cumo_compatible_mode_enabled_p()) {
+        <%=c_iter%>_host_t h = {p1, s1, NULL, p2, s2};
+        double *bins;
+
+        CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+        // sub-histograms are summed in double
+        bins = (double*)cumo_na_host_histogram(i, n, 1, <%=c_iter%>_host_<%=fn%>, &h);
+        for (x=0; x < n; x++) {
+            *(<%=cnt_type%>*)(p3 + s3*x) = (<%=cnt_type%>)bins[x];
+        }
+        xfree(bins);
+        return;
     }
+
+    <%="cumo_#{c_iter}_#{fn}_kernel_launch"%>(p1,s1,p2,s2,p3,s3,i,n);
 }
 
 static VALUE
@@ -106,6 +160,10 @@ static VALUE
   Count the number of occurrences of each non-negative integer value.
   Only Integer-types has this method.
 
+  Each block of the kernel counts into its own bins in shared memory, which
+  are added to the output at the end. In compatible mode, host threads count
+  into their own bins in the same way.
+
   @overload <%=name%>([weight], minlength:nil)
   @param [SFloat or DFloat or Array] weight (optional) Array of
     float values. Its size along last axis should be same as that of self.
@@ -0,0 +1,56 @@
+<% [32,64].each do |bits|
+     cnt_type = bits == 32 ? "unsigned int" : "unsigned long long"
+%>
+__global__ void <%="cumo_#{c_iter}_#{bits}_index_kernel"%>(char *p1, size_t *idx1, char *p2, ssize_t s2, uint64_t n, uint64_t length, bool privatize)
+{
+    cumo_histogram_count<<%=cnt_type%>>(
+            [=](uint64_t i) { return (int64_t)*(dtype*)(p1 + idx1[i]); },
+            [=](uint64_t i) { return 1; },
+            p2, s2, n, length, privatize);
+}
+
+__global__ void <%="cumo_#{c_iter}_#{bits}_stride_kernel"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, uint64_t n, uint64_t length, bool privatize)
+{
+    cumo_histogram_count<<%=cnt_type%>>(
+            [=](uint64_t i) { return (int64_t)*(dtype*)(p1 + i * s1); },
+            [=](uint64_t i) { return 1; },
+            p2, s2, n, length, privatize);
+}
+
+void <%="cumo_#{c_iter}_#{bits}_index_kernel_launch"%>(char *p1, size_t *idx1, char *p2, ssize_t s2, uint64_t n, uint64_t length)
+{
+    size_t grid_dim, block_dim, shared_bytes;
+    bool privatize = cumo_histogram_prepare<<%=cnt_type%>>(p2, s2, n, length, &grid_dim, &block_dim, &shared_bytes);
+    if (n > 0) {
+        <%="cumo_#{c_iter}_#{bits}_index_kernel"%><<<grid_dim, block_dim, shared_bytes, cumo_cuda_stream_current()>>>(p1,idx1,p2,s2,n,length,privatize);
+    }
+}
+
+void <%="cumo_#{c_iter}_#{bits}_stride_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, uint64_t n, uint64_t length)
+{
+    size_t grid_dim, block_dim, shared_bytes;
+    bool privatize = cumo_histogram_prepare<<%=cnt_type%>>(p2, s2, n, length, &grid_dim, &block_dim, &shared_bytes);
+    if (n > 0) {
+        <%="cumo_#{c_iter}_#{bits}_stride_kernel"%><<<grid_dim, block_dim, shared_bytes, cumo_cuda_stream_current()>>>(p1,s1,p2,s2,n,length,privatize);
+    }
+}
+<% end %>
+
+<% [["sf","float"],["df","double"]].each do |fn,cnt_type| %>
+__global__ void <%="cumo_#{c_iter}_#{fn}_kernel"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, uint64_t n, uint64_t length, bool privatize)
+{
+    cumo_histogram_count<<%=cnt_type%>>(
+            [=](uint64_t i) { return (int64_t)*(dtype*)(p1 + i * s1); },
+            [=](uint64_t i) { return *(<%=cnt_type%>*)(p2 + i * s2); },
+            p3, s3, n, length, privatize);
+}
+
+void <%="cumo_#{c_iter}_#{fn}_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, uint64_t n, uint64_t length)
+{
+    size_t grid_dim, block_dim, shared_bytes;
+    bool privatize = cumo_histogram_prepare<<%=cnt_type%>>(p3, s3, n, length, &grid_dim, &block_dim, &shared_bytes);
+    if (n > 0) {
+        <%="cumo_#{c_iter}_#{fn}_kernel"%><<<grid_dim, block_dim, shared_bytes, cumo_cuda_stream_current()>>>(p1,s1,p2,s2,p3,s3,n,length,privatize);
+    }
+}
+<% end %>
@@ -1,9 +1,43 @@
+<% unless is_object || is_bit %>
+/*
+  Reads the shape of rary from its first elements, so that a rectangular
+  nested Array of numbers is stored in a single walk by store_bulk, which
+  checks the length of every row. Returns Qnil if rary is empty or has
+  non-Array elements above the last dimension.
+*/
+static VALUE
+<%=c_iter%>_bulk(VALUE rary)
+{
+    VALUE nary, v;
+    int ndim = 0;
+    size_t shape[CUMO_NA_MAX_DIMENSION];
+
+    for (v = rary; TYPE(v) == T_ARRAY; v = RARRAY_AREF(v,0)) {
+        if (ndim == CUMO_NA_MAX_DIMENSION || RARRAY_LEN(v) == 0) {
+            return Qnil;
+        }
+        shape[ndim++] = RARRAY_LEN(v);
+    }
+    nary = cumo_na_new(cT, ndim, shape);
+    if (!<%=find_tmpl("store").find("array").c_iter%>_store_bulk(nary, rary)) {
+        return Qnil;
+    }
+    return nary;
+}
+<% end %>
+
 static VALUE
 <%=c_func(:nodef)%>(VALUE rary)
 {
     VALUE nary;
     cumo_narray_t *na;
 
+    <% unless is_object || is_bit %>
+    nary = <%=c_iter%>_bulk(rary);
+    if (!NIL_P(nary)) {
+        return nary;
+    }
+    <% end %>
     nary = cumo_na_s_new_like(cT, rary);
     CumoGetNArray(nary,na);
     if (na->size > 0) {
@@ -2,8 +2,10 @@
   class definition: <%= full_class_name %>
 */
 
+<% if part == 0 %>
 VALUE <%=class_var%>;
 
 static VALUE <%= find('store').c_func %>(VALUE,VALUE);
+<% end %>
 
 <%= method_code %>
@@ -1,3 +1,4 @@
+<% if is_object %>
 static void
 <%=c_iter%>(cumo_na_loop_t *const lp)
 {
@@ -10,12 +11,11 @@ static void
     CUMO_INIT_PTR(lp, 1, p2, s2);
     CUMO_INIT_PTR(lp, 2, p3, s3);
     CUMO_INIT_PTR(lp, 3, p4, s4);
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+    CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
     for (; i--;) {
         CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
         CUMO_GET_DATA_STRIDE(p2,s2,dtype,min);
         CUMO_GET_DATA_STRIDE(p3,s3,dtype,max);
-        if (m_gt(min,max)) {rb_raise(cumo_na_eOperationError,"min is greater than max");}
         if (m_lt(x,min)) {x=min;}
         if (m_gt(x,max)) {x=max;}
         CUMO_SET_DATA_STRIDE(p4,s4,dtype,x);
@@ -33,7 +33,7 @@ static void
     CUMO_INIT_PTR(lp, 0, p1, s1);
     CUMO_INIT_PTR(lp, 1, p2, s2);
     CUMO_INIT_PTR(lp, 2, p3, s3);
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>_min", "<%=type_name%>");
+    CUMO_SYNCHRONIZE_FIXME("<%=name%>_min", "<%=type_name%>");
     for (; i--;) {
         CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
         CUMO_GET_DATA_STRIDE(p2,s2,dtype,min);
@@ -53,7 +53,7 @@ static void
     CUMO_INIT_PTR(lp, 0, p1, s1);
     CUMO_INIT_PTR(lp, 1, p2, s2);
     CUMO_INIT_PTR(lp, 2, p3, s3);
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>_max", "<%=type_name%>");
+    CUMO_SYNCHRONIZE_FIXME("<%=name%>_max", "<%=type_name%>");
     for (; i--;) {
         CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
         CUMO_GET_DATA_STRIDE(p2,s2,dtype,max);
@@ -62,9 +62,56 @@ static void
     }
 }
 
+<% else %>
+void <%="cumo_#{c_iter}_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, char *p4, ssize_t s4, uint64_t n);
+void <%="cumo_#{c_iter}_min_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, uint64_t n);
+void <%="cumo_#{c_iter}_max_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, uint64_t n);
+
+static void
+<%=c_iter%>(cumo_na_loop_t *const lp)
+{
+    size_t  i;
+    char   *p1, *p2, *p3, *p4;
+    ssize_t s1, s2, s3, s4;
+    CUMO_INIT_COUNTER(lp, i);
+    CUMO_INIT_PTR(lp, 0, p1, s1);
+    CUMO_INIT_PTR(lp, 1, p2, s2);
+    CUMO_INIT_PTR(lp, 2, p3, s3);
+    CUMO_INIT_PTR(lp, 3, p4, s4);
+    <%="cumo_#{c_iter}_kernel_launch"%>(p1,s1,p2,s2,p3,s3,p4,s4,i);
+}
+
+static void
+<%=c_iter%>_min(cumo_na_loop_t *const lp)
+{
+    size_t  i;
+    char   *p1, *p2, *p3;
+    ssize_t s1, s2, s3;
+    CUMO_INIT_COUNTER(lp, i);
+    CUMO_INIT_PTR(lp, 0, p1, s1);
+    CUMO_INIT_PTR(lp, 1, p2, s2);
+    CUMO_INIT_PTR(lp, 2, p3, s3);
+    <%="cumo_#{c_iter}_min_kernel_launch"%>(p1,s1,p2,s2,p3,s3,i);
+}
+
+static void
+<%=c_iter%>_max(cumo_na_loop_t *const lp)
+{
+    size_t  i;
+    char   *p1, *p2, *p3;
+    ssize_t s1, s2, s3;
+    CUMO_INIT_COUNTER(lp, i);
+    CUMO_INIT_PTR(lp, 0, p1, s1);
+    CUMO_INIT_PTR(lp, 1, p2, s2);
+    CUMO_INIT_PTR(lp, 2, p3, s3);
+    <%="cumo_#{c_iter}_max_kernel_launch"%>(p1,s1,p2,s2,p3,s3,i);
+}
+<% end %>
+
 /*
   Clip array elements by [min,max].
   If either of min or max is nil, one side is clipped.
+  Elements whose min is greater than max are set to max.
   @overload <%=name%>(min,max)
   @param [Cumo::NArray,Numeric] min
   @param [Cumo::NArray,Numeric] max
@@ -0,0 +1,54 @@
+<% unless is_object %>
+__global__ void <%="cumo_#{c_iter}_kernel"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, char *p4, ssize_t s4, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        dtype x = *(dtype*)(p1 + (i * s1));
+        dtype min = *(dtype*)(p2 + (i * s2));
+        dtype max = *(dtype*)(p3 + (i * s3));
+        if (m_lt(x,min)) {x=min;}
+        if (m_gt(x,max)) {x=max;}
+        *(dtype*)(p4 + (i * s4)) = x;
+    }
+}
+
+__global__ void <%="cumo_#{c_iter}_min_kernel"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        dtype x = *(dtype*)(p1 + (i * s1));
+        dtype min = *(dtype*)(p2 + (i * s2));
+        if (m_lt(x,min)) {x=min;}
+        *(dtype*)(p3 + (i * s3)) = x;
+    }
+}
+
+__global__ void <%="cumo_#{c_iter}_max_kernel"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        dtype x = *(dtype*)(p1 + (i * s1));
+        dtype max = *(dtype*)(p2 + (i * s2));
+        if (m_gt(x,max)) {x=max;}
+        *(dtype*)(p3 + (i * s3)) = x;
+    }
+}
+
+void <%="cumo_#{c_iter}_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, char *p4, ssize_t s4, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,s1,p2,s2,p3,s3,p4,s4,n);
+}
+
+void <%="cumo_#{c_iter}_min_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_min_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,s1,p2,s2,p3,s3,n);
+}
+
+void <%="cumo_#{c_iter}_max_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, char *p3, ssize_t s3, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_max_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,s1,p2,s2,p3,s3,n);
+}
+<% end %>
@@ -19,44 +19,107 @@ struct cumo_<%=type_name%>_prod_impl {
     __device__ <%=dtype%> MapOut(<%=dtype%> accum) { return accum; }
 };
 
-template<typename Iterator1>
-__global__ void cumo_<%=type_name%>_mean_kernel(Iterator1 p1_begin, Iterator1 p1_end, <%=dtype%>* p2, uint64_t n)
-{
-    dtype init = m_zero;
-    dtype sum = thrust::reduce(thrust::cuda::par, p1_begin, p1_end, init, cumo_thrust_plus());
-    *p2 = c_div_r(sum, n);
-}
+// n is the number of reduced elements per output element.
+struct cumo_<%=type_name%>_mean_impl {
+    int64_t n;
+    __device__ dtype Identity(int64_t /*index*/) { return m_zero; }
+    __device__ dtype MapIn(dtype in, int64_t /*index*/) { return in; }
+    __device__ void Reduce(dtype next, dtype& accum) { accum = m_add(next, accum); }
+    __device__ dtype MapOut(dtype accum) { return c_div_r(accum, (rtype)n); }
+};
 
-template<typename Iterator1>
-__global__ void cumo_<%=type_name%>_var_kernel(Iterator1 p1_begin, Iterator1 p1_end, rtype* p2)
-{
-    cumo_thrust_complex_variance_unary_op<dtype, rtype>  unary_op;
-    cumo_thrust_complex_variance_binary_op<dtype, rtype> binary_op;
-    cumo_thrust_complex_variance_data<dtype, rtype> init = {};
-    cumo_thrust_complex_variance_data<dtype, rtype> result;
-    result = thrust::transform_reduce(thrust::cuda::par, p1_begin, p1_end, unary_op, init, binary_op);
-    *p2 = result.variance();
-}
+// Partial (count, mean, M2) are merged pairwise (Chan et al.), so that
+// the result does not depend on how elements are split into threads.
+struct cumo_<%=type_name%>_var_impl {
+    typedef cumo_thrust_complex_variance_data<dtype, rtype> data_t;
+    __device__ data_t Identity(int64_t /*index*/) { return data_t{0, m_zero, 0}; }
+    __device__ data_t MapIn(dtype in, int64_t /*index*/) { return data_t{1, in, 0}; }
+    __device__ void Reduce(data_t next, data_t& accum) {
+        if (next.n == 0) {
+            return;
+        }
+        if (accum.n == 0) {
+            accum = next;
+            return;
+        }
+        accum = cumo_thrust_complex_variance_binary_op<dtype, rtype>()(accum, next);
+    }
+    __device__ rtype MapOut(data_t accum) { return accum.variance(); }
+};
 
-template<typename Iterator1>
-__global__ void cumo_<%=type_name%>_stddev_kernel(Iterator1 p1_begin, Iterator1 p1_end, rtype* p2)
-{
-    cumo_thrust_complex_variance_unary_op<dtype, rtype>  unary_op;
-    cumo_thrust_complex_variance_binary_op<dtype, rtype> binary_op;
-    cumo_thrust_complex_variance_data<dtype, rtype> init = {};
-    cumo_thrust_complex_variance_data<dtype, rtype> result;
-    result = thrust::transform_reduce(thrust::cuda::par, p1_begin, p1_end, unary_op, init, binary_op);
-    *p2 = r_sqrt(result.variance());
-}
+struct cumo_<%=type_name%>_stddev_impl : cumo_<%=type_name%>_var_impl {
+    __device__ rtype MapOut(data_t accum) { return r_sqrt(accum.variance()); }
+};
 
-template<typename Iterator1>
-__global__ void cumo_<%=type_name%>_rms_kernel(Iterator1 p1_begin, Iterator1 p1_end, rtype* p2, uint64_t n)
-{
-    rtype init = 0;
-    rtype result;
-    result = thrust::transform_reduce(thrust::cuda::par, p1_begin, p1_end, cumo_thrust_square(), init, thrust::plus<rtype>());
-    *p2 = r_sqrt(result/n);
-}
+struct cumo_<%=type_name%>_rms_impl {
+    int64_t n;
+    __device__ rtype Identity(int64_t /*index*/) { return 0; }
+    __device__ rtype MapIn(dtype in, int64_t /*index*/) { return c_abs_square(in); }
+    __device__ void Reduce(rtype next, rtype& accum) { accum += next; }
+    __device__ rtype MapOut(rtype accum) { return r_sqrt(accum / n); }
+};
+
+// nan: true variants skip elements whose real or imaginary part is NaN.
+struct cumo_<%=type_name%>_sum_nan_impl : cumo_<%=type_name%>_sum_impl {
+    __device__ dtype MapIn(dtype in, int64_t /*index*/) { return not_nan(in) ? in : m_zero; }
+};
+
+struct cumo_<%=type_name%>_prod_nan_impl : cumo_<%=type_name%>_prod_impl {
+    __device__ dtype MapIn(dtype in, int64_t /*index*/) { return not_nan(in) ? in : m_one; }
+};
+
+struct cumo_<%=type_name%>_mean_nan_impl {
+    struct SumAndCount {
+        dtype sum;
+        int64_t n;
+    };
+    __device__ SumAndCount Identity(int64_t /*index*/) { return {m_zero, 0}; }
+    __device__ SumAndCount MapIn(dtype in, int64_t /*index*/) { return not_nan(in) ? SumAndCount{in, 1} : SumAndCount{m_zero, 0}; }
+    __device__ void Reduce(SumAndCount next, SumAndCount& accum) { accum.sum = m_add(next.sum, accum.sum); accum.n += next.n; }
+    __device__ dtype MapOut(SumAndCount accum) { return c_div_r(accum.sum, (rtype)accum.n); }
+};
+
+struct cumo_<%=type_name%>_var_nan_impl : cumo_<%=type_name%>_var_impl {
+    __device__ data_t MapIn(dtype in, int64_t /*index*/) { return not_nan(in) ? data_t{1, in, 0} : data_t{0, m_zero, 0}; }
+};
+
+struct cumo_<%=type_name%>_stddev_nan_impl : cumo_<%=type_name%>_stddev_impl {
+    __device__ data_t MapIn(dtype in, int64_t /*index*/) { return not_nan(in) ? data_t{1, in, 0} : data_t{0, m_zero, 0}; }
+};
+
+struct cumo_<%=type_name%>_rms_nan_impl {
+    struct SumAndCount {
+        rtype sum;
+        int64_t n;
+    };
+    __device__ SumAndCount Identity(int64_t /*index*/) { return {0, 0}; }
+    __device__ SumAndCount MapIn(dtype in, int64_t /*index*/) { return not_nan(in) ? SumAndCount{c_abs_square(in), 1} : SumAndCount{0, 0}; }
+    __device__ void Reduce(SumAndCount next, SumAndCount& accum) { accum.sum += next.sum; accum.n += next.n; }
+    __device__ rtype MapOut(SumAndCount accum) { return r_sqrt(accum.sum / accum.n); }
+};
+<% if is_double_precision %>
+
+// Real and imaginary parts are compensated sums (see cumo/kahan.h).
+struct cumo_<%=type_name%>_kahan_sum_impl {
+    struct KahanComplex {
+        cumo_kahan_t re;
+        cumo_kahan_t im;
+    };
+    __device__ KahanComplex Identity(int64_t /*index*/) { return {cumo_kahan_new(0), cumo_kahan_new(0)}; }
+    __device__ KahanComplex MapIn(dtype in, int64_t /*index*/) { return {cumo_kahan_new(CUMO_REAL(in)), cumo_kahan_new(CUMO_IMAG(in))}; }
+    __device__ void Reduce(KahanComplex next, KahanComplex& accum) {
+        cumo_kahan_merge(&accum.re, next.re);
+        cumo_kahan_merge(&accum.im, next.im);
+    }
+    __device__ dtype MapOut(KahanComplex accum) { return c_new(cumo_kahan_result(accum.re), cumo_kahan_result(accum.im)); }
+};
+
+struct cumo_<%=type_name%>_kahan_sum_nan_impl : cumo_<%=type_name%>_kahan_sum_impl {
+    __device__ KahanComplex MapIn(dtype in, int64_t index) {
+        return not_nan(in) ? cumo_<%=type_name%>_kahan_sum_impl::MapIn(in, index) : Identity(index);
+    }
+};
+<% end %>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -75,55 +138,66 @@ void cumo_<%=type_name%>_prod_kernel_launch(cumo_na_reduction_arg_t* arg)
     cumo_reduce<dtype, <%=dtype%>, cumo_<%=type_name%>_prod_impl>(*arg, cumo_<%=type_name%>_prod_impl{});
 }
 
-void cumo_<%=type_name%>_mean_kernel_launch(uint64_t n, char *p1, ssize_t s1, char *p2)
+void cumo_<%=type_name%>_mean_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    ssize_t s1_idx = s1 / sizeof(dtype);
-    thrust::device_ptr<dtype> data_begin = thrust::device_pointer_cast((dtype*)p1);
-    thrust::device_ptr<dtype> data_end   = thrust::device_pointer_cast(((dtype*)p1) + n * s1_idx);
-    if (s1_idx == 1) {
-        cumo_<%=type_name%>_mean_kernel<<<1,1>>>(data_begin, data_end, (dtype*)p2, n);
-    } else {
-        cumo_thrust_strided_range<thrust::device_vector<dtype>::iterator> range(data_begin, data_end, s1_idx);
-        cumo_<%=type_name%>_mean_kernel<<<1,1>>>(range.begin(), range.end(), (dtype*)p2, n);
-    }
+    int64_t n = arg->in_indexer.total_size / std::max(size_t{1}, arg->out_indexer.total_size);
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_mean_impl>(*arg, cumo_<%=type_name%>_mean_impl{n});
 }
 
-void cumo_<%=type_name%>_var_kernel_launch(uint64_t n, char *p1, ssize_t s1, char *p2)
+void cumo_<%=type_name%>_var_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    ssize_t s1_idx = s1 / sizeof(dtype);
-    thrust::device_ptr<dtype> data_begin = thrust::device_pointer_cast((dtype*)p1);
-    thrust::device_ptr<dtype> data_end   = thrust::device_pointer_cast(((dtype*)p1) + n * s1_idx);
-    if (s1_idx == 1) {
-        cumo_<%=type_name%>_var_kernel<<<1,1>>>(data_begin, data_end, (rtype*)p2);
-    } else {
-        cumo_thrust_strided_range<thrust::device_vector<dtype>::iterator> range(data_begin, data_end, s1_idx);
-        cumo_<%=type_name%>_var_kernel<<<1,1>>>(range.begin(), range.end(), (rtype*)p2);
-    }
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_var_impl>(*arg, cumo_<%=type_name%>_var_impl{});
 }
 
-void cumo_<%=type_name%>_stddev_kernel_launch(uint64_t n, char *p1, ssize_t s1, char *p2)
+void cumo_<%=type_name%>_stddev_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    ssize_t s1_idx = s1 / sizeof(dtype);
-    thrust::device_ptr<dtype> data_begin = thrust::device_pointer_cast((dtype*)p1);
-    thrust::device_ptr<dtype> data_end   = thrust::device_pointer_cast(((dtype*)p1) + n * s1_idx);
-    if (s1_idx == 1) {
-        cumo_<%=type_name%>_stddev_kernel<<<1,1>>>(data_begin, data_end, (rtype*)p2);
-    } else {
-        cumo_thrust_strided_range<thrust::device_vector<dtype>::iterator> range(data_begin, data_end, s1_idx);
-        cumo_<%=type_name%>_stddev_kernel<<<1,1>>>(range.begin(), range.end(), (rtype*)p2);
-    }
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_stddev_impl>(*arg, cumo_<%=type_name%>_stddev_impl{});
 }
 
-void cumo_<%=type_name%>_rms_kernel_launch(uint64_t n, char *p1, ssize_t s1, char *p2)
+void cumo_<%=type_name%>_rms_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    ssize_t s1_idx = s1 / sizeof(dtype);
-    thrust::device_ptr<dtype> data_begin = thrust::device_pointer_cast((dtype*)p1);
-    thrust::device_ptr<dtype> data_end   = thrust::device_pointer_cast(((dtype*)p1) + n * s1_idx);
-    if (s1_idx == 1) {
-        cumo_<%=type_name%>_rms_kernel<<<1,1>>>(data_begin, data_end, (rtype*)p2, n);
-    } else {
-        cumo_thrust_strided_range<thrust::device_vector<dtype>::iterator> range(data_begin, data_end, s1_idx);
-        cumo_<%=type_name%>_rms_kernel<<<1,1>>>(range.begin(), range.end(), (rtype*)p2, n);
-    }
+    int64_t n = arg->in_indexer.total_size / std::max(size_t{1}, arg->out_indexer.total_size);
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_rms_impl>(*arg, cumo_<%=type_name%>_rms_impl{n});
+}
+
+void cumo_<%=type_name%>_sum_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, <%=dtype%>, cumo_<%=type_name%>_sum_nan_impl>(*arg, cumo_<%=type_name%>_sum_nan_impl{});
+}
+
+void cumo_<%=type_name%>_prod_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, <%=dtype%>, cumo_<%=type_name%>_prod_nan_impl>(*arg, cumo_<%=type_name%>_prod_nan_impl{});
+}
+
+void cumo_<%=type_name%>_mean_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_mean_nan_impl>(*arg, cumo_<%=type_name%>_mean_nan_impl{});
 }
 
+void cumo_<%=type_name%>_var_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_var_nan_impl>(*arg, cumo_<%=type_name%>_var_nan_impl{});
+}
+
+void cumo_<%=type_name%>_stddev_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_stddev_nan_impl>(*arg, cumo_<%=type_name%>_stddev_nan_impl{});
+}
+
+void cumo_<%=type_name%>_rms_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_rms_nan_impl>(*arg, cumo_<%=type_name%>_rms_nan_impl{});
+}
+<% if is_double_precision %>
+
+void cumo_<%=type_name%>_kahan_sum_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_kahan_sum_impl>(*arg, cumo_<%=type_name%>_kahan_sum_impl{});
+}
+
+void cumo_<%=type_name%>_kahan_sum_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_kahan_sum_nan_impl>(*arg, cumo_<%=type_name%>_kahan_sum_nan_impl{});
+}
+<% end %>
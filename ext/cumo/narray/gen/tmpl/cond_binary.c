@@ -18,7 +18,7 @@ static void
     {
         dtype x, y;
         CUMO_BIT_DIGIT b;
-        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+        CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
         for (; i--;) {
             CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
             CUMO_GET_DATA_STRIDE(p2,s2,dtype,y);
@@ -15,7 +15,9 @@ static void
     CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
     CUMO_SET_DATA_STRIDE(p2,s2,dtype,x);
     //printf("i=%lu x=%f\n",i,x);
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%><%=j%>", "<%=type_name%>");
+  <% if is_object %>
+    CUMO_SYNCHRONIZE_FIXME("<%=name%><%=j%>", "<%=type_name%>");
+  <% end %>
     for (i--; i--;) {
         CUMO_GET_DATA_STRIDE(p1,s1,dtype,y);
         m_<%=name%><%=j%>(x,y);
@@ -38,13 +40,21 @@ static VALUE
     VALUE reduce;
     cumo_ndfunc_arg_in_t ain[2] = {{cT,0},{cumo_sym_reduce,0}};
     cumo_ndfunc_arg_out_t aout[1] = {{cT,0}};
+  <% if is_object %>
     cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_STRIDE_LOOP|CUMO_NDF_FLAT_REDUCE|CUMO_NDF_CUM,
                      2, 1, ain, aout };
+  <% else %>
+    cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_STRIDE_LOOP|CUMO_NDF_FLAT_REDUCE|CUMO_NDF_CUM|CUMO_NDF_PARALLEL,
+                     2, 1, ain, aout };
+  <% end %>
 
   <% if is_float %>
     reduce = cumo_na_reduce_dimension(argc, argv, 1, &self, &ndf, <%=c_iter%>_nan);
   <% else %>
     reduce = cumo_na_reduce_dimension(argc, argv, 1, &self, &ndf, 0);
+  <% end %>
+  <% if !is_object %>
+    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
   <% end %>
     return cumo_na_ndloop(&ndf, 2, self, reduce);
 }
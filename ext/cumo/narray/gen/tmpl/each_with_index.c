@@ -32,8 +32,7 @@ static void
     CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
     c[nd] = 0;
 
-    CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
 
     if (idx1) {
         for (; i--;) {
@@ -43,7 +42,7 @@ static void
         }
     } else {
         for (; i--;) {
-            cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+            cumo_synchronize_for_host("<%=name%>");
             CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
             yield_each_with_index(x,c,a,nd,md);
             c[nd]++;
@@ -34,7 +34,7 @@ static void
     <% if type_name == 'robject' %>
     {
         size_t i;
-        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%><%=nan%>", "<%=type_name%>");
+        CUMO_SYNCHRONIZE_FIXME("<%=name%><%=nan%>", "<%=type_name%>");
         for (i=0; i<n; i++) {
             dtype x, y, z;
             CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
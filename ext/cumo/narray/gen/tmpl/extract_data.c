@@ -11,8 +11,7 @@ static dtype
     size_t pos;
     VALUE  r, klass;
 
-    CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
 
     if (CumoIsNArray(obj)) {
         CumoGetNArray(obj,na);
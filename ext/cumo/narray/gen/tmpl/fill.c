@@ -16,7 +16,7 @@ static void
     CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
     y = m_num_to_data(x);
     <% if type_name == 'robject' %>
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+    CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
     if (idx1) {
         for (; i--;) {
             CUMO_SET_DATA_INDEX(p1,idx1,dtype,y);
@@ -7,100 +7,203 @@
 }  /* extern "C" { */
 #endif
 
-template<typename Iterator1>
-__global__ void cumo_<%=type_name%>_mean_kernel(Iterator1 p1_begin, Iterator1 p1_end, <%=dtype%>* p2, uint64_t n)
+// n is the number of reduced elements per output element.
+struct cumo_<%=type_name%>_mean_impl {
+    typedef cumo_accum<dtype>::type accum_t;
+    int64_t n;
+    __device__ accum_t Identity(int64_t /*index*/) { return m_zero; }
+    __device__ accum_t MapIn(dtype in, int64_t /*index*/) { return in; }
+    __device__ void Reduce(accum_t next, accum_t& accum) { accum += next; }
+    __device__ dtype MapOut(accum_t accum) { return accum / (accum_t)n; }
+};
+
+// Partial (count, mean, M2) are merged pairwise (Chan et al.), so that
+// the result does not depend on how elements are split into threads.
+struct cumo_<%=type_name%>_var_impl {
+    typedef cumo_accum<dtype>::type accum_t;
+    typedef cumo_thrust_variance_data<accum_t> data_t;
+    __device__ data_t Identity(int64_t /*index*/) { return data_t{0, 0, 0}; }
+    __device__ data_t MapIn(dtype in, int64_t /*index*/) { return data_t{1, (accum_t)in, 0}; }
+    __device__ void Reduce(data_t next, data_t& accum) {
+        if (next.n == 0) {
+            return;
+        }
+        if (accum.n == 0) {
+            accum = next;
+            return;
+        }
+        accum = cumo_thrust_variance_binary_op<accum_t>()(accum, next);
+    }
+    __device__ rtype MapOut(data_t accum) { return accum.variance(); }
+};
+
+struct cumo_<%=type_name%>_stddev_impl : cumo_<%=type_name%>_var_impl {
+    __device__ rtype MapOut(data_t accum) { return (accum_t)m_sqrt(accum.variance()); }
+};
+
+struct cumo_<%=type_name%>_rms_impl {
+    typedef cumo_accum<dtype>::type accum_t;
+    int64_t n;
+    __device__ accum_t Identity(int64_t /*index*/) { return m_zero; }
+    __device__ accum_t MapIn(dtype in, int64_t /*index*/) { accum_t x = in; return x * x; }
+    __device__ void Reduce(accum_t next, accum_t& accum) { accum += next; }
+    __device__ rtype MapOut(accum_t accum) { return (accum_t)m_sqrt(accum / (accum_t)n); }
+};
+
+// nan: true variants. NaN is skipped by sum, prod, mean, var, stddev, rms
+// and kahan_sum, and propagated by min, max and ptp.
+struct cumo_<%=type_name%>_sum_nan_impl : cumo_<%=type_name%>_sum_impl {
+    __device__ accum_t MapIn(dtype in, int64_t /*index*/) { return m_isnan(in) ? (accum_t)0 : (accum_t)in; }
+};
+
+struct cumo_<%=type_name%>_prod_nan_impl : cumo_<%=type_name%>_prod_impl {
+    __device__ accum_t MapIn(dtype in, int64_t /*index*/) { return m_isnan(in) ? (accum_t)1 : (accum_t)in; }
+};
+
+struct cumo_<%=type_name%>_mean_nan_impl {
+    typedef cumo_accum<dtype>::type accum_t;
+    struct SumAndCount {
+        accum_t sum;
+        int64_t n;
+    };
+    __device__ SumAndCount Identity(int64_t /*index*/) { return {0, 0}; }
+    __device__ SumAndCount MapIn(dtype in, int64_t /*index*/) { return m_isnan(in) ? SumAndCount{0, 0} : SumAndCount{(accum_t)in, 1}; }
+    __device__ void Reduce(SumAndCount next, SumAndCount& accum) { accum.sum += next.sum; accum.n += next.n; }
+    __device__ dtype MapOut(SumAndCount accum) { return accum.sum / (accum_t)accum.n; }
+};
+
+struct cumo_<%=type_name%>_var_nan_impl : cumo_<%=type_name%>_var_impl {
+    __device__ data_t MapIn(dtype in, int64_t /*index*/) { return m_isnan(in) ? data_t{0, 0, 0} : data_t{1, (accum_t)in, 0}; }
+};
+
+struct cumo_<%=type_name%>_stddev_nan_impl : cumo_<%=type_name%>_stddev_impl {
+    __device__ data_t MapIn(dtype in, int64_t /*index*/) { return m_isnan(in) ? data_t{0, 0, 0} : data_t{1, (accum_t)in, 0}; }
+};
+
+struct cumo_<%=type_name%>_rms_nan_impl : cumo_<%=type_name%>_mean_nan_impl {
+    __device__ SumAndCount MapIn(dtype in, int64_t /*index*/) { accum_t x = in; return m_isnan(in) ? SumAndCount{0, 0} : SumAndCount{x * x, 1}; }
+    __device__ rtype MapOut(SumAndCount accum) { return (accum_t)m_sqrt(accum.sum / (accum_t)accum.n); }
+};
+
+struct cumo_<%=type_name%>_min_nan_impl {
+    __device__ dtype Identity(int64_t /*index*/) { return (dtype)INFINITY; }
+    __device__ dtype MapIn(dtype in, int64_t /*index*/) { return in; }
+    __device__ void Reduce(dtype next, dtype& accum) { accum = (m_isnan(next) || next < accum) ? next : accum; }
+    __device__ dtype MapOut(dtype accum) { return accum; }
+};
+
+struct cumo_<%=type_name%>_max_nan_impl {
+    __device__ dtype Identity(int64_t /*index*/) { return (dtype)(-INFINITY); }
+    __device__ dtype MapIn(dtype in, int64_t /*index*/) { return in; }
+    __device__ void Reduce(dtype next, dtype& accum) { accum = (m_isnan(next) || next > accum) ? next : accum; }
+    __device__ dtype MapOut(dtype accum) { return accum; }
+};
+
+struct cumo_<%=type_name%>_ptp_nan_impl : cumo_<%=type_name%>_ptp_impl {
+    __device__ MinAndMax Identity(int64_t /*index*/) { return {(dtype)INFINITY, (dtype)(-INFINITY)}; }
+    __device__ void Reduce(MinAndMax next, MinAndMax& accum) {
+        accum.min = (m_isnan(next.min) || next.min < accum.min) ? next.min : accum.min;
+        accum.max = (m_isnan(next.max) || next.max > accum.max) ? next.max : accum.max;
+    }
+};
+<% if is_double_precision %>
+
+// Partial sums of threads are compensated sums, which are merged with their
+// compensations (see cumo/kahan.h).
+struct cumo_<%=type_name%>_kahan_sum_impl {
+    __device__ cumo_kahan_t Identity(int64_t /*index*/) { return cumo_kahan_new(0); }
+    __device__ cumo_kahan_t MapIn(dtype in, int64_t /*index*/) { return cumo_kahan_new(in); }
+    __device__ void Reduce(cumo_kahan_t next, cumo_kahan_t& accum) { cumo_kahan_merge(&accum, next); }
+    __device__ dtype MapOut(cumo_kahan_t accum) { return cumo_kahan_result(accum); }
+};
+
+struct cumo_<%=type_name%>_kahan_sum_nan_impl : cumo_<%=type_name%>_kahan_sum_impl {
+    __device__ cumo_kahan_t MapIn(dtype in, int64_t /*index*/) { return cumo_kahan_new(m_isnan(in) ? 0 : in); }
+};
+<% end %>
+
+#if defined(__cplusplus)
+extern "C" {
+#if 0
+} /* satisfy cc-mode */
+#endif
+#endif
+
+void cumo_<%=type_name%>_mean_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    dtype init = m_zero;
-    *p2 = thrust::reduce(thrust::cuda::par, p1_begin, p1_end, init, thrust::plus<dtype>());
-    *p2 /= (dtype)n;
+    int64_t n = arg->in_indexer.total_size / std::max(size_t{1}, arg->out_indexer.total_size);
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_mean_impl>(*arg, cumo_<%=type_name%>_mean_impl{n});
 }
 
-template<typename Iterator1>
-__global__ void cumo_<%=type_name%>_var_kernel(Iterator1 p1_begin, Iterator1 p1_end, <%=dtype%>* p2)
+void cumo_<%=type_name%>_var_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    cumo_thrust_variance_unary_op<dtype>  unary_op;
-    cumo_thrust_variance_binary_op<dtype> binary_op;
-    cumo_thrust_variance_data<dtype> init = {};
-    cumo_thrust_variance_data<dtype> result;
-    result = thrust::transform_reduce(thrust::cuda::par, p1_begin, p1_end, unary_op, init, binary_op);
-    *p2 = result.variance();
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_var_impl>(*arg, cumo_<%=type_name%>_var_impl{});
 }
 
-template<typename Iterator1>
-__global__ void cumo_<%=type_name%>_stddev_kernel(Iterator1 p1_begin, Iterator1 p1_end, <%=dtype%>* p2)
+void cumo_<%=type_name%>_stddev_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    cumo_thrust_variance_unary_op<dtype>  unary_op;
-    cumo_thrust_variance_binary_op<dtype> binary_op;
-    cumo_thrust_variance_data<dtype> init = {};
-    cumo_thrust_variance_data<dtype> result;
-    result = thrust::transform_reduce(thrust::cuda::par, p1_begin, p1_end, unary_op, init, binary_op);
-    *p2 = m_sqrt(result.variance());
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_stddev_impl>(*arg, cumo_<%=type_name%>_stddev_impl{});
 }
 
-template<typename Iterator1>
-__global__ void cumo_<%=type_name%>_rms_kernel(Iterator1 p1_begin, Iterator1 p1_end, <%=dtype%>* p2, uint64_t n)
+void cumo_<%=type_name%>_rms_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    dtype init = m_zero;
-    dtype result;
-    result = thrust::transform_reduce(thrust::cuda::par, p1_begin, p1_end, cumo_thrust_square(), init, thrust::plus<dtype>());
-    *p2 = m_sqrt(m_div(result,n));
+    int64_t n = arg->in_indexer.total_size / std::max(size_t{1}, arg->out_indexer.total_size);
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_rms_impl>(*arg, cumo_<%=type_name%>_rms_impl{n});
 }
 
-#if defined(__cplusplus)
-extern "C" {
-#if 0
-} /* satisfy cc-mode */
-#endif
-#endif
+void cumo_<%=type_name%>_sum_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_sum_nan_impl>(*arg, cumo_<%=type_name%>_sum_nan_impl{});
+}
 
-void cumo_<%=type_name%>_mean_kernel_launch(uint64_t n, char *p1, ssize_t s1, char *p2)
+void cumo_<%=type_name%>_prod_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    ssize_t s1_idx = s1 / sizeof(dtype);
-    thrust::device_ptr<dtype> data_begin = thrust::device_pointer_cast((dtype*)p1);
-    thrust::device_ptr<dtype> data_end   = thrust::device_pointer_cast(((dtype*)p1) + n * s1_idx);
-    if (s1_idx == 1) {
-        cumo_<%=type_name%>_mean_kernel<<<1,1>>>(data_begin, data_end, (<%=dtype%>*)p2, n);
-    } else {
-        cumo_thrust_strided_range<thrust::device_vector<dtype>::iterator> range(data_begin, data_end, s1_idx);
-        cumo_<%=type_name%>_mean_kernel<<<1,1>>>(range.begin(), range.end(), (<%=dtype%>*)p2, n);
-    }
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_prod_nan_impl>(*arg, cumo_<%=type_name%>_prod_nan_impl{});
 }
 
-void cumo_<%=type_name%>_var_kernel_launch(uint64_t n, char *p1, ssize_t s1, char *p2)
+void cumo_<%=type_name%>_mean_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    ssize_t s1_idx = s1 / sizeof(dtype);
-    thrust::device_ptr<dtype> data_begin = thrust::device_pointer_cast((dtype*)p1);
-    thrust::device_ptr<dtype> data_end   = thrust::device_pointer_cast(((dtype*)p1) + n * s1_idx);
-    if (s1_idx == 1) {
-        cumo_<%=type_name%>_var_kernel<<<1,1>>>(data_begin, data_end, (<%=dtype%>*)p2);
-    } else {
-        cumo_thrust_strided_range<thrust::device_vector<dtype>::iterator> range(data_begin, data_end, s1_idx);
-        cumo_<%=type_name%>_var_kernel<<<1,1>>>(range.begin(), range.end(), (<%=dtype%>*)p2);
-    }
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_mean_nan_impl>(*arg, cumo_<%=type_name%>_mean_nan_impl{});
 }
 
-void cumo_<%=type_name%>_stddev_kernel_launch(uint64_t n, char *p1, ssize_t s1, char *p2)
+void cumo_<%=type_name%>_var_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    ssize_t s1_idx = s1 / sizeof(dtype);
-    thrust::device_ptr<dtype> data_begin = thrust::device_pointer_cast((dtype*)p1);
-    thrust::device_ptr<dtype> data_end   = thrust::device_pointer_cast(((dtype*)p1) + n * s1_idx);
-    if (s1_idx == 1) {
-        cumo_<%=type_name%>_stddev_kernel<<<1,1>>>(data_begin, data_end, (<%=dtype%>*)p2);
-    } else {
-        cumo_thrust_strided_range<thrust::device_vector<dtype>::iterator> range(data_begin, data_end, s1_idx);
-        cumo_<%=type_name%>_stddev_kernel<<<1,1>>>(range.begin(), range.end(), (<%=dtype%>*)p2);
-    }
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_var_nan_impl>(*arg, cumo_<%=type_name%>_var_nan_impl{});
 }
 
-void cumo_<%=type_name%>_rms_kernel_launch(uint64_t n, char *p1, ssize_t s1, char *p2)
+void cumo_<%=type_name%>_stddev_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    ssize_t s1_idx = s1 / sizeof(dtype);
-    thrust::device_ptr<dtype> data_begin = thrust::device_pointer_cast((dtype*)p1);
-    thrust::device_ptr<dtype> data_end   = thrust::device_pointer_cast(((dtype*)p1) + n * s1_idx);
-    if (s1_idx == 1) {
-        cumo_<%=type_name%>_rms_kernel<<<1,1>>>(data_begin, data_end, (<%=dtype%>*)p2, n);
-    } else {
-        cumo_thrust_strided_range<thrust::device_vector<dtype>::iterator> range(data_begin, data_end, s1_idx);
-        cumo_<%=type_name%>_rms_kernel<<<1,1>>>(range.begin(), range.end(), (<%=dtype%>*)p2, n);
-    }
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_stddev_nan_impl>(*arg, cumo_<%=type_name%>_stddev_nan_impl{});
+}
+
+void cumo_<%=type_name%>_rms_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, rtype, cumo_<%=type_name%>_rms_nan_impl>(*arg, cumo_<%=type_name%>_rms_nan_impl{});
+}
+
+void cumo_<%=type_name%>_min_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_min_nan_impl>(*arg, cumo_<%=type_name%>_min_nan_impl{});
+}
+
+void cumo_<%=type_name%>_max_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_max_nan_impl>(*arg, cumo_<%=type_name%>_max_nan_impl{});
+}
+
+void cumo_<%=type_name%>_ptp_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_ptp_nan_impl>(*arg, cumo_<%=type_name%>_ptp_nan_impl{});
+}
+<% if is_double_precision %>
+
+void cumo_<%=type_name%>_kahan_sum_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_kahan_sum_impl>(*arg, cumo_<%=type_name%>_kahan_sum_impl{});
+}
+
+void cumo_<%=type_name%>_kahan_sum_nan_kernel_launch(cumo_na_reduction_arg_t* arg)
+{
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_kahan_sum_nan_impl>(*arg, cumo_<%=type_name%>_kahan_sum_nan_impl{});
 }
+<% end %>
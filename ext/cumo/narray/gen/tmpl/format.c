@@ -57,6 +57,6 @@ static VALUE
     cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_FULL_LOOP_NIP, 2, 1, ain, aout };
 
     rb_scan_args(argc, argv, "01", &fmt);
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    cumo_synchronize_for_host("<%=name%>");
     return cumo_na_ndloop(&ndf, 2, self, fmt);
 }
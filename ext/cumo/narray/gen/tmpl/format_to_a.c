@@ -41,9 +41,15 @@ static VALUE
     VALUE fmt=Qnil;
     cumo_ndfunc_arg_in_t ain[3] = {{Qnil,0},{cumo_sym_loop_opt},{cumo_sym_option}};
     cumo_ndfunc_arg_out_t aout[1] = {{rb_cArray,0}}; // dummy?
+<% if is_object %>
     cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_FULL_LOOP_NIP, 3, 1, ain, aout };
 
     rb_scan_args(argc, argv, "01", &fmt);
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    cumo_synchronize_for_host("<%=name%>");
+<% else %>
+    cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_FULL_LOOP_NIP|CUMO_NDF_HOST_COPY, 3, 1, ain, aout };
+
+    rb_scan_args(argc, argv, "01", &fmt);
+<% end %>
     return cumo_na_ndloop_cast_narray_to_rarray(&ndf, self, fmt);
 }
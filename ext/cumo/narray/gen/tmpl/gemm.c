@@ -20,6 +20,15 @@
       'cuComplex'
     when 'dcomplex'
       'cuDoubleComplex'
+    else
+      ctype
+    end
+  cuda_data_type =
+    case type_name
+    when 'hfloat'
+      'CUDA_R_16F'
+    when 'bfloat16'
+      'CUDA_R_16BF'
     end
 %>
 
@@ -109,11 +118,21 @@ typedef struct {
 
 typedef struct {
     int ld;
-    int stride; // in element count
     cublasOperation_t trans;
     VALUE a;
 } gemm_layout_t;
 
+// Batch dimensions of c, broadcast from those of a and b.
+typedef struct {
+    int ndim;
+    size_t shape[CUMO_NA_MAX_DIMENSION];
+    ssize_t stride[3][CUMO_NA_MAX_DIMENSION]; // of a, b and c in element count, 0 if broadcast
+    int inner; // dimensions from inner are merged into one strided batch
+    size_t outer_size;
+    int batch_count;
+    ssize_t batch_stride[3];
+} gemm_batch_t;
+
 static bool
 is_f_contiguous(VALUE a)
 {
@@ -175,16 +194,111 @@ make_gemm_layout(VALUE a)
         // force c-contiguous
         layout.a = is_c_contiguous(a) ? a : rb_funcall(a, rb_intern("dup"), 0);
     }
-    layout.stride = ROW_SIZE(na) * COL_SIZE(na);
     return layout;
 }
 
+// Broadcasts batch dimensions, i.e., all but the last two dimensions, of a and b.
+static void
+gemm_batch_shape(cumo_narray_t *na, cumo_narray_t *nb, int *ndim, size_t *shape)
+{
+    int i, ia, ib;
+    int nda = CUMO_NA_NDIM(na) - 2;
+    int ndb = CUMO_NA_NDIM(nb) - 2;
+
+    *ndim = (nda > ndb) ? nda : ndb;
+    for (i = *ndim - 1, ia = nda - 1, ib = ndb - 1; i >= 0; --i, --ia, --ib) {
+        size_t sa = (ia >= 0) ? CUMO_NA_SHAPE(na)[ia] : 1;
+        size_t sb = (ib >= 0) ? CUMO_NA_SHAPE(nb)[ib] : 1;
+        if (sa != sb && sa != 1 && sb != 1) {
+            rb_raise(cumo_na_eShapeError, "batch shape mismatch at dimension %d: %"SZF"u != %"SZF"u",
+                    i, sa, sb);
+        }
+        shape[i] = (sa == 1) ? sb : sa;
+    }
+}
+
+// x must be c-contiguous if it has batch dimensions.
+static void
+gemm_batch_strides(VALUE x, int ndim, ssize_t *stride)
+{
+    int i, ix;
+    cumo_narray_t *nx;
+    ssize_t s;
+
+    CumoGetNArray(x, nx);
+    s = ROW_SIZE(nx) * COL_SIZE(nx);
+    for (i = ndim - 1, ix = CUMO_NA_NDIM(nx) - 3; i >= 0; --i, --ix) {
+        if (ix < 0 || CUMO_NA_SHAPE(nx)[ix] == 1) {
+            stride[i] = 0;
+        } else {
+            stride[i] = s;
+            s *= CUMO_NA_SHAPE(nx)[ix];
+        }
+    }
+}
+
+// Trailing batch dimensions with uniform strides are done by one strided
+// batched call, and the rest are looped over by gemm_batch_offsets.
+static void
+gemm_batch_init(gemm_batch_t *bt, VALUE a, VALUE b, VALUE c)
+{
+    int i, j;
+    cumo_narray_t *nc;
+
+    CumoGetNArray(c, nc);
+    bt->ndim = CUMO_NA_NDIM(nc) - 2;
+    for (i = 0; i < bt->ndim; ++i) {
+        bt->shape[i] = CUMO_NA_SHAPE(nc)[i];
+    }
+    gemm_batch_strides(a, bt->ndim, bt->stride[0]);
+    gemm_batch_strides(b, bt->ndim, bt->stride[1]);
+    gemm_batch_strides(c, bt->ndim, bt->stride[2]);
+
+    bt->inner = bt->ndim > 0 ? bt->ndim - 1 : 0;
+    while (bt->inner > 0) {
+        i = bt->inner - 1;
+        for (j = 0; j < 3; ++j) {
+            if (bt->stride[j][i] != bt->stride[j][i + 1] * (ssize_t)bt->shape[i + 1]) break;
+        }
+        if (j < 3) break;
+        --bt->inner;
+    }
+
+    bt->outer_size = 1;
+    for (i = 0; i < bt->inner; ++i) {
+        bt->outer_size *= bt->shape[i];
+    }
+    bt->batch_count = 1;
+    for (i = bt->inner; i < bt->ndim; ++i) {
+        bt->batch_count *= (int)bt->shape[i];
+    }
+    for (j = 0; j < 3; ++j) {
+        bt->batch_stride[j] = bt->ndim > 0 ? bt->stride[j][bt->ndim - 1] : 0;
+    }
+}
+
+// Offsets of a, b and c in element count for the index-th strided batch.
+static void
+gemm_batch_offsets(gemm_batch_t *bt, size_t index, ssize_t offset[3])
+{
+    int i, j;
+
+    offset[0] = offset[1] = offset[2] = 0;
+    for (i = bt->inner - 1; i >= 0; --i) {
+        size_t k = index % bt->shape[i];
+        index /= bt->shape[i];
+        for (j = 0; j < 3; ++j) {
+            offset[j] += k * bt->stride[j][i];
+        }
+    }
+}
+
 extern int cumo_na_debug_flag;  // narray.c
 
 static void
-print_gemm_args(gemm_args_t* g, gemm_layout_t* a_layout, gemm_layout_t* b_layout, int stridec, int batch_count)
+print_gemm_args(gemm_args_t* g, gemm_layout_t* a_layout, gemm_layout_t* b_layout, gemm_batch_t* bt)
 {
-    printf("transb=%d transa=%d, n=%d, m=%d, k=%d, ldb=%d, lda=%d, ldc=n=%d, strideb=%d, stridea=%d stridec=%d batch_count=%d\n",
+    printf("transb=%d transa=%d, n=%d, m=%d, k=%d, ldb=%d, lda=%d, ldc=n=%d, strideb=%d, stridea=%d stridec=%d batch_count=%d outer_size=%d\n",
             (int)b_layout->trans,
             (int)a_layout->trans,
             (int)g->n,
@@ -193,21 +307,92 @@ print_gemm_args(gemm_args_t* g, gemm_layout_t* a_layout, gemm_layout_t* b_layout
             (int)b_layout->ld,
             (int)a_layout->ld,
             (int)g->n,
-            (int)b_layout->stride,
-            (int)a_layout->stride,
-            (int)stridec,
-            (int)batch_count);
+            (int)bt->batch_stride[1],
+            (int)bt->batch_stride[0],
+            (int)bt->batch_stride[2],
+            (int)bt->batch_count,
+            (int)bt->outer_size);
+}
+
+<% if is_int %>
+<%   outputs = [["", "dtype"]]
+     outputs << ["_acc", acc_type] if acc_class %>
+<%   outputs.each do |suffix, out_type| %>
+void <%="cumo_#{c_iter}#{suffix}_kernel_launch"%>(const dtype *a, const dtype *b, <%=out_type%> *c, int m, int n, int k, ssize_t a_rs, ssize_t a_cs, ssize_t b_rs, ssize_t b_cs, ssize_t stride_a, ssize_t stride_b, ssize_t stride_c, <%=acc_type%> alpha, <%=acc_type%> beta, int batch_count);
+<%   end %>
+
+// Element (i,j) of a matrix is at i*rs + j*cs.
+static void
+gemm_layout_steps(gemm_layout_t *layout, ssize_t *rs, ssize_t *cs)
+{
+    if (layout->trans == CUBLAS_OP_N) {
+        *rs = layout->ld;
+        *cs = 1;
+    } else {
+        *rs = 1;
+        *cs = layout->ld;
+    }
 }
 
 static void
 <%=c_iter%>(VALUE a, VALUE b, VALUE c, gemm_args_t *g)
 {
     gemm_layout_t a_layout, b_layout;
+    gemm_batch_t bt;
+    ssize_t a_rs, a_cs, b_rs, b_cs;
+    ssize_t offset[3];
+    size_t i;
+    const dtype *pa, *pb;
+    char *pc;
+
+    // Integer types have no BLAS. A tiled kernel accumulates products in
+    // <%=acc_type%> and writes results to c of <%=class_name%>, or of the
+    // accumulation type if it has its own class.
+    a_layout = make_gemm_layout(a);
+    b_layout = make_gemm_layout(b);
+    gemm_layout_steps(&a_layout, &a_rs, &a_cs);
+    gemm_layout_steps(&b_layout, &b_rs, &b_cs);
+    gemm_batch_init(&bt, a_layout.a, b_layout.a, c);
+
+    if (cumo_na_debug_flag) print_gemm_args(g, &a_layout, &b_layout, &bt);
+    pa = (const dtype*)(cumo_na_get_pointer_for_read(a_layout.a) + cumo_na_get_offset(a_layout.a));
+    pb = (const dtype*)(cumo_na_get_pointer_for_read(b_layout.a) + cumo_na_get_offset(b_layout.a));
+    pc = cumo_na_get_pointer_for_write(c) + cumo_na_get_offset(c);
+
+    for (i = 0; i < bt.outer_size; ++i) {
+        gemm_batch_offsets(&bt, i, offset);
+<%   if acc_class %>
+        if (rb_obj_class(c) == <%=acc_class%>) {
+            <%="cumo_#{c_iter}_acc_kernel_launch"%>(
+                    pa + offset[0], pb + offset[1], (<%=acc_type%>*)pc + offset[2],
+                    g->m, g->n, g->k, a_rs, a_cs, b_rs, b_cs,
+                    bt.batch_stride[0], bt.batch_stride[1], bt.batch_stride[2],
+                    (<%=acc_type%>)g->alpha, (<%=acc_type%>)g->beta, bt.batch_count);
+            continue;
+        }
+<%   end %>
+        <%="cumo_#{c_iter}_kernel_launch"%>(
+                pa + offset[0], pb + offset[1], (dtype*)pc + offset[2],
+                g->m, g->n, g->k, a_rs, a_cs, b_rs, b_cs,
+                bt.batch_stride[0], bt.batch_stride[1], bt.batch_stride[2],
+                (<%=acc_type%>)g->alpha, (<%=acc_type%>)g->beta, bt.batch_count);
+    }
+}
+<% else %>
+static void
+<%=c_iter%>(VALUE a, VALUE b, VALUE c, gemm_args_t *g)
+{
+    gemm_layout_t a_layout, b_layout;
+    gemm_batch_t bt;
     cublasHandle_t handle = 0;
     cublasStatus_t status = 0;
-    cumo_narray_t* nc;
-    int stridec = 0;
-    int batch_count = 0;
+    ssize_t offset[3];
+    size_t i;
+    <%=cutype%> *pa, *pb, *pc;
+<% if is_half %>
+    // 16-bit inputs and outputs with products accumulated in float
+    float alpha = m_to_float(g->alpha), beta = m_to_float(g->beta);
+<% end %>
 
     // Note that cuBLAS uses the column major matrix representation.
     // We use technic which following site describes:
@@ -222,34 +407,67 @@ static void
 
     a_layout = make_gemm_layout(a);
     b_layout = make_gemm_layout(b);
+    gemm_batch_init(&bt, a_layout.a, b_layout.a, c);
 
-    CumoGetNArray(c, nc);
-    stridec = ROW_SIZE(nc) * COL_SIZE(nc);
-    batch_count = CUMO_NA_SIZE(nc) / stridec;
+    if (cumo_na_debug_flag) print_gemm_args(g, &a_layout, &b_layout, &bt);
+    pa = (<%=cutype%>*)(cumo_na_get_pointer_for_read(a_layout.a) + cumo_na_get_offset(a_layout.a));
+    pb = (<%=cutype%>*)(cumo_na_get_pointer_for_read(b_layout.a) + cumo_na_get_offset(b_layout.a));
+    pc = (<%=cutype%>*)(cumo_na_get_pointer_for_write(c) + cumo_na_get_offset(c));
 
-    if (cumo_na_debug_flag) print_gemm_args(g, &a_layout, &b_layout, stridec, batch_count);
     handle = cumo_cuda_cublas_handle();
-    status = cublas<%=func_prefix%>gemmStridedBatched(
-            handle,
-            b_layout.trans,
-            a_layout.trans,
-            g->n,
-            g->m,
-            g->k,
-            (<%=cutype%>*)(&g->alpha),
-            (<%=cutype%>*)(cumo_na_get_pointer_for_read(b_layout.a) + cumo_na_get_offset(b_layout.a)),
-            b_layout.ld,
-            b_layout.stride,
-            (<%=cutype%>*)(cumo_na_get_pointer_for_read(a_layout.a) + cumo_na_get_offset(a_layout.a)),
-            a_layout.ld,
-            a_layout.stride,
-            (<%=cutype%>*)(&g->beta),
-            (<%=cutype%>*)(cumo_na_get_pointer_for_write(c) + cumo_na_get_offset(c)),
-            g->n,
-            stridec,
-            batch_count);
-    cumo_cuda_cublas_check_status(status);
+    // Batch dimensions which cannot be merged into one stride, e.g., (2,1,m,k) x (3,k,n), are looped over.
+    for (i = 0; i < bt.outer_size; ++i) {
+        gemm_batch_offsets(&bt, i, offset);
+<% if is_half %>
+        status = cublasGemmStridedBatchedEx(
+                handle,
+                b_layout.trans,
+                a_layout.trans,
+                g->n,
+                g->m,
+                g->k,
+                &alpha,
+                pb + offset[1],
+                <%=cuda_data_type%>,
+                b_layout.ld,
+                bt.batch_stride[1],
+                pa + offset[0],
+                <%=cuda_data_type%>,
+                a_layout.ld,
+                bt.batch_stride[0],
+                &beta,
+                pc + offset[2],
+                <%=cuda_data_type%>,
+                g->n,
+                bt.batch_stride[2],
+                bt.batch_count,
+                CUBLAS_COMPUTE_32F,
+                CUBLAS_GEMM_DEFAULT);
+<% else %>
+        status = cublas<%=func_prefix%>gemmStridedBatched(
+                handle,
+                b_layout.trans,
+                a_layout.trans,
+                g->n,
+                g->m,
+                g->k,
+                (<%=cutype%>*)(&g->alpha),
+                pb + offset[1],
+                b_layout.ld,
+                bt.batch_stride[1],
+                pa + offset[0],
+                a_layout.ld,
+                bt.batch_stride[0],
+                (<%=cutype%>*)(&g->beta),
+                pc + offset[2],
+                g->n,
+                bt.batch_stride[2],
+                bt.batch_count);
+<% end %>
+        cumo_cuda_cublas_check_status(status);
+    }
 }
+<% end %>
 
 /*
 <%
@@ -287,6 +505,10 @@ static void
   @overload <%=name%>(<%=args_v%>)
   <%=params%>
   @return [<%=class_name%>] returns c = alpha\*op( A )\*op( B ) + beta\*C.
+<% if acc_class %>
+  If c is <%=acc_class.sub("cumo_c", "Cumo::")%>, results are stored without being truncated to <%=class_name%>.
+<% end %>
+  Batch dimensions, i.e., all but the last two dimensions, of a and b are broadcast.
 <%=description%>
 */
 static VALUE
@@ -294,6 +516,8 @@ static VALUE
 {
     VALUE a=self, b, c=Qnil, alpha, beta;
     cumo_narray_t *na, *nb;
+    int ndim;
+    size_t shape[CUMO_NA_MAX_DIMENSION];
 
     gemm_args_t g;
     VALUE kw_hash = Qnil;
@@ -321,15 +545,25 @@ static VALUE
     g.k = COL_SIZE(na);
     g.n = COL_SIZE(nb);
 
+    gemm_batch_shape(na, nb, &ndim, shape);
+    shape[ndim] = g.m;
+    shape[ndim + 1] = g.n; // ... x m x n
+    ndim += 2;
+
     if (c == Qnil) { // c is not given.
-        int ndim = CUMO_NA_NDIM(na);
-        size_t *shape = ALLOCA_N(size_t, ndim);
-        memcpy(shape, CUMO_NA_SHAPE(na), sizeof(size_t) * (ndim - 1)); // ... x m x k
-        shape[ndim - 1] = g.n; // ... x m x n
         c = cumo_na_new(cT, ndim, shape);
     } else {
         cumo_narray_t *nc;
+        int i;
+<% if acc_class %>
+        if (rb_obj_class(c) == <%=acc_class%>) {
+            COPY_OR_CAST_TO(c, <%=acc_class%>);
+        } else {
+            COPY_OR_CAST_TO(c, cT);
+        }
+<% else %>
         COPY_OR_CAST_TO(c, cT);
+<% end %>
         CumoGetNArray(c, nc);
         CHECK_DIM_GE(nc, 2);
         if (ROW_SIZE(nc) != ROW_SIZE(na)) {
@@ -340,8 +574,15 @@ static VALUE
             rb_raise(cumo_na_eShapeError,"COL_SIZE(c)=%d must equal to COL_SIZE(b)=%d",
                     (int)COL_SIZE(nc), (int)COL_SIZE(nc));
         }
+        CHECK_DIM_EQ(nc, ndim);
+        for (i = 0; i < ndim - 2; i++) {
+            CHECK_SIZE_EQ(CUMO_NA_SHAPE(nc)[i], shape[i]);
+        }
     }
 
+    if (cumo_na_get_narray_t(c)->size == 0) {
+        return c;
+    }
     <%=c_iter%>(a, b, c, &g);
     return c;
 }
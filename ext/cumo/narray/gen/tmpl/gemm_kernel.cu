@@ -0,0 +1,64 @@
+<% if is_int %>
+#ifndef CUMO_GEMM_TILE
+#define CUMO_GEMM_TILE 16
+#define CUMO_GEMM_MAX_GRID_DIM_YZ 65535
+#endif
+
+<%   outputs = [["", "dtype"]]
+     outputs << ["_acc", acc_type] if acc_class %>
+<%   outputs.each do |suffix, out_type| %>
+// Each block computes a CUMO_GEMM_TILE x CUMO_GEMM_TILE tile of c, staging
+// tiles of a and b in shared memory. Rows of tiles and batches are looped
+// over so that every thread of a block reaches the same __syncthreads.
+__global__ void <%="cumo_#{c_iter}#{suffix}_kernel"%>(const dtype *a, const dtype *b, <%=out_type%> *c, int m, int n, int k, ssize_t a_rs, ssize_t a_cs, ssize_t b_rs, ssize_t b_cs, ssize_t stride_a, ssize_t stride_b, ssize_t stride_c, <%=acc_type%> alpha, <%=acc_type%> beta, int batch_count)
+{
+    __shared__ <%=acc_type%> a_tile[CUMO_GEMM_TILE][CUMO_GEMM_TILE];
+    __shared__ <%=acc_type%> b_tile[CUMO_GEMM_TILE][CUMO_GEMM_TILE + 1];
+    const int tx = threadIdx.x;
+    const int ty = threadIdx.y;
+    const int j = blockIdx.x * CUMO_GEMM_TILE + tx;
+
+    for (int batch = blockIdx.z; batch < batch_count; batch += gridDim.z) {
+        const dtype *pa = a + batch * stride_a;
+        const dtype *pb = b + batch * stride_b;
+        <%=out_type%> *pc = c + batch * stride_c;
+
+        for (int i0 = blockIdx.y * CUMO_GEMM_TILE; i0 < m; i0 += gridDim.y * CUMO_GEMM_TILE) {
+            const int i = i0 + ty;
+            <%=acc_type%> sum = 0;
+
+            for (int p0 = 0; p0 < k; p0 += CUMO_GEMM_TILE) {
+                a_tile[ty][tx] = (i < m && p0 + tx < k) ? (<%=acc_type%>)pa[i * a_rs + (p0 + tx) * a_cs] : 0;
+                b_tile[ty][tx] = (p0 + ty < k && j < n) ? (<%=acc_type%>)pb[(p0 + ty) * b_rs + j * b_cs] : 0;
+                __syncthreads();
+                for (int q = 0; q < CUMO_GEMM_TILE; ++q) {
+                    sum += a_tile[ty][q] * b_tile[q][tx];
+                }
+                __syncthreads();
+            }
+
+            if (i < m && j < n) {
+                <%=out_type%> *pcij = pc + (ssize_t)i * n + j;
+                <%=acc_type%> r = alpha * sum;
+                // c may be uninitialized if beta is 0
+                if (beta != 0) {
+                    r += beta * (<%=acc_type%>)*pcij;
+                }
+                *pcij = (<%=out_type%>)r;
+            }
+        }
+    }
+}
+
+void <%="cumo_#{c_iter}#{suffix}_kernel_launch"%>(const dtype *a, const dtype *b, <%=out_type%> *c, int m, int n, int k, ssize_t a_rs, ssize_t a_cs, ssize_t b_rs, ssize_t b_cs, ssize_t stride_a, ssize_t stride_b, ssize_t stride_c, <%=acc_type%> alpha, <%=acc_type%> beta, int batch_count)
+{
+    int row_tiles = (m + CUMO_GEMM_TILE - 1) / CUMO_GEMM_TILE;
+    dim3 block_dim(CUMO_GEMM_TILE, CUMO_GEMM_TILE);
+    dim3 grid_dim((n + CUMO_GEMM_TILE - 1) / CUMO_GEMM_TILE,
+                  row_tiles < CUMO_GEMM_MAX_GRID_DIM_YZ ? row_tiles : CUMO_GEMM_MAX_GRID_DIM_YZ,
+                  batch_count < CUMO_GEMM_MAX_GRID_DIM_YZ ? batch_count : CUMO_GEMM_MAX_GRID_DIM_YZ);
+    if (m == 0 || n == 0 || batch_count == 0) return;
+    <%="cumo_#{c_iter}#{suffix}_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(a,b,c,m,n,k,a_rs,a_cs,b_rs,b_cs,stride_a,stride_b,stride_c,alpha,beta,batch_count);
+}
+<%   end %>
+<% end %>
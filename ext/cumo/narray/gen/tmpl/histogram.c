@@ -0,0 +1,168 @@
+typedef struct {
+    double   lo;
+    double   hi;
+    int64_t  nbins;
+} <%=c_iter%>_opt_t;
+
+typedef struct {
+    char    *p1;
+    ssize_t  s1;
+    size_t  *idx1;
+    double   lo;
+    double   hi;
+    int64_t  nbins;
+} <%=c_iter%>_host_t;
+
+static void
+<%=c_iter%>_host(size_t begin, size_t end, void *bins, void *data)
+{
+    <%=c_iter%>_host_t *h = (<%=c_iter%>_host_t*)data;
+    uint64_t *b = (uint64_t*)bins;
+    size_t i;
+    int64_t j;
+    dtype x;
+
+    for (i = begin; i < end; i++) {
+        if (h->idx1) {
+            x = *(dtype*)(h->p1 + h->idx1[i]);
+        } else {
+            x = *(dtype*)(h->p1 + h->s1 * i);
+        }
+      <% if is_half %>
+        j = cumo_histogram_bin(m_to_float(x), h->lo, h->hi, h->nbins);
+      <% else %>
+        j = cumo_histogram_bin((double)x, h->lo, h->hi, h->nbins);
+      <% end %>
+        if (j >= 0) {
+            b[j]++;
+        }
+    }
+}
+
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(char *p1, size_t *idx1, char *p2, ssize_t s2, uint64_t n, double lo, double hi, uint64_t nbins);
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, uint64_t n, double lo, double hi, uint64_t nbins);
+
+static void
+<%=c_iter%>(cumo_na_loop_t *const lp)
+{
+    size_t   i, x, n;
+    char    *p1, *p2;
+    ssize_t  s1, s2;
+    size_t  *idx1;
+    <%=c_iter%>_opt_t *g = (<%=c_iter%>_opt_t*)(lp->opt_ptr);
+
+    CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
+    CUMO_INIT_PTR(lp, 1, p2, s2);
+    i = lp->args[0].shape[0];
+    n = lp->args[1].shape[0];
+
+    if (cumo_compatible_mode_enabled_p()) {
+        <%=c_iter%>_host_t h = {p1, s1, idx1, g->lo, g->hi, g->nbins};
+        uint64_t *bins;
+
+        CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+        bins = (uint64_t*)cumo_na_host_histogram(i, n, 0, <%=c_iter%>_host, &h);
+        for (x=0; x < n; x++) {
+            *(int64_t*)(p2 + s2*x) = (int64_t)bins[x];
+        }
+        xfree(bins);
+        return;
+    }
+
+    if (idx1) {
+        <%="cumo_#{c_iter}_index_kernel_launch"%>(p1,idx1,p2,s2,i,g->lo,g->hi,n);
+    } else {
+        <%="cumo_#{c_iter}_stride_kernel_launch"%>(p1,s1,p2,s2,i,g->lo,g->hi,n);
+    }
+}
+
+/*
+  Computes the histogram of all elements with equal-width bins.
+  Each bin is half-open, [edge[i], edge[i+1]), except the last bin, which
+  also includes the upper end of the range. Elements out of range and NaN
+  are not counted.
+
+  Each block of the kernel counts into its own bins in shared memory, which
+  are added to the output at the end. In compatible mode, host threads count
+  into their own bins in the same way.
+
+  @overload <%=name%>(bins:10, range:nil)
+  @param [Integer] bins (keyword) Number of bins.
+  @param [Array] range (keyword) [min, max] of bins.
+    (default: [self.min, self.max])
+  @return [Array] [Cumo::Int64 counts of bins, Cumo::DFloat bins+1 edges]
+  @example
+    Cumo::DFloat[1, 2, 2, 3, 3, 3].histogram(bins: 3)
+    => [Cumo::Int64#shape=[3]
+        [1, 2, 3],
+        Cumo::DFloat#shape=[4]
+        [1, 1.66667, 2.33333, 3]]
+
+    Cumo::Int32[0, 5, 9, 10, 11].histogram(bins: 2, range: [0, 10])
+    => [Cumo::Int64#shape=[2]
+        [1, 3],
+        Cumo::DFloat#shape=[3]
+        [0, 5, 10]]
+*/
+static VALUE
+<%=c_func(-1)%>(int argc, VALUE *argv, VALUE self)
+{
+    VALUE kw=Qnil, range, v, edges, hist;
+    VALUE opts[2] = {Qundef, Qundef};
+    ID table[2] = {cumo_id_bins, cumo_id_range};
+    <%=c_iter%>_opt_t g;
+    cumo_narray_t *na;
+    size_t shape_out[1];
+    int64_t j;
+    cumo_ndfunc_arg_in_t ain[1] = {{cT,1}};
+    cumo_ndfunc_arg_out_t aout[1] = {{cumo_cInt64,1,shape_out}};
+    cumo_ndfunc_t ndf = {<%=c_iter%>, CUMO_NO_LOOP|CUMO_NDF_STRIDE_LOOP|CUMO_NDF_INDEX_LOOP,
+                    1, 1, ain, aout};
+
+    rb_scan_args(argc, argv, "0:", &kw);
+    rb_get_kwargs(kw, table, 0, 2, opts);
+
+    g.nbins = (opts[0] == Qundef) ? 10 : NUM2LONG(opts[0]);
+    if (g.nbins < 1) {
+        rb_raise(rb_eArgError, "bins must be positive: %ld", (long)g.nbins);
+    }
+
+    CumoGetNArray(self, na);
+    range = (opts[1] == Qundef) ? Qnil : opts[1];
+    if (!NIL_P(range)) {
+        range = rb_check_array_type(range);
+        if (NIL_P(range) || RARRAY_LEN(range) != 2) {
+            rb_raise(rb_eArgError, "range must be [min, max]");
+        }
+        g.lo = NUM2DBL(RARRAY_AREF(range, 0));
+        g.hi = NUM2DBL(RARRAY_AREF(range, 1));
+    } else if (CUMO_NA_SIZE(na) == 0) {
+        g.lo = 0;
+        g.hi = 1;
+    } else {
+        v = <%=type_name%>_minmax(0, 0, self);
+        g.lo = NUM2DBL(RARRAY_AREF(v, 0));
+        g.hi = NUM2DBL(RARRAY_AREF(v, 1));
+    }
+    if (!isfinite(g.lo) || !isfinite(g.hi)) {
+        rb_raise(rb_eArgError, "range must be finite: [%g, %g]", g.lo, g.hi);
+    }
+    if (g.lo > g.hi) {
+        rb_raise(rb_eArgError, "max must not be less than min in range: [%g, %g]", g.lo, g.hi);
+    }
+    if (g.lo == g.hi) {
+        g.lo -= 0.5;
+        g.hi += 0.5;
+    }
+
+    shape_out[0] = g.nbins;
+    hist = cumo_na_ndloop3(&ndf, &g, 1, cumo_na_flatten(self));
+
+    edges = rb_ary_new_capa(g.nbins + 1);
+    for (j = 0; j <= g.nbins; j++) {
+        rb_ary_push(edges, DBL2NUM(cumo_histogram_edge(g.lo, g.hi, g.nbins, j)));
+    }
+    edges = rb_funcall(cumo_cDFloat, rb_intern("cast"), 1, edges);
+
+    return rb_assoc_new(hist, edges);
+}
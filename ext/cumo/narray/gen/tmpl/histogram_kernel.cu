@@ -0,0 +1,34 @@
+<% to_double = is_half ? "(double)(float)" : "(double)" %>
+__global__ void <%="cumo_#{c_iter}_index_kernel"%>(char *p1, size_t *idx1, char *p2, ssize_t s2, uint64_t n, double lo, double hi, uint64_t nbins, bool privatize)
+{
+    cumo_histogram_count<unsigned long long>(
+            [=](uint64_t i) { return cumo_histogram_bin(<%=to_double%>(*(dtype*)(p1 + idx1[i])), lo, hi, nbins); },
+            [=](uint64_t i) { return 1; },
+            p2, s2, n, nbins, privatize);
+}
+
+__global__ void <%="cumo_#{c_iter}_stride_kernel"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, uint64_t n, double lo, double hi, uint64_t nbins, bool privatize)
+{
+    cumo_histogram_count<unsigned long long>(
+            [=](uint64_t i) { return cumo_histogram_bin(<%=to_double%>(*(dtype*)(p1 + i * s1)), lo, hi, nbins); },
+            [=](uint64_t i) { return 1; },
+            p2, s2, n, nbins, privatize);
+}
+
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(char *p1, size_t *idx1, char *p2, ssize_t s2, uint64_t n, double lo, double hi, uint64_t nbins)
+{
+    size_t grid_dim, block_dim, shared_bytes;
+    bool privatize = cumo_histogram_prepare<unsigned long long>(p2, s2, n, nbins, &grid_dim, &block_dim, &shared_bytes);
+    if (n > 0) {
+        <%="cumo_#{c_iter}_index_kernel"%><<<grid_dim, block_dim, shared_bytes, cumo_cuda_stream_current()>>>(p1,idx1,p2,s2,n,lo,hi,nbins,privatize);
+    }
+}
+
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, char *p2, ssize_t s2, uint64_t n, double lo, double hi, uint64_t nbins)
+{
+    size_t grid_dim, block_dim, shared_bytes;
+    bool privatize = cumo_histogram_prepare<unsigned long long>(p2, s2, n, nbins, &grid_dim, &block_dim, &shared_bytes);
+    if (n > 0) {
+        <%="cumo_#{c_iter}_stride_kernel"%><<<grid_dim, block_dim, shared_bytes, cumo_cuda_stream_current()>>>(p1,s1,p2,s2,n,lo,hi,nbins,privatize);
+    }
+}
@@ -15,6 +15,8 @@
     <% for x in upcast %>
     <%= x %><% end %>
 
-    <% @children.each do |m| %>
+    <% split_inits.each do |f| %>
+    <%= f %>();<% end %>
+    <% part_children.each do |m| %>
     <%= m.init_def %><% end %>
     rb_define_singleton_method(cT, "[]", <%=find("cast").c_func%>, -2);
@@ -5,7 +5,9 @@
     <%  if module_var != ns_var %>
     <%=module_var%> = rb_define_module_under(<%=ns_var%>, "<%=module_name%>");
     <%  end %>
-    <% @children.each do |m| %>
+    <% split_inits.each do |f| %>
+    <%= f %>();<% end %>
+    <% part_children.each do |m| %>
     <%= m.init_def %><% end %>
 
     //  how to do this?
@@ -16,6 +16,10 @@ static VALUE
 static VALUE
 <%=c_func(0)%>(VALUE ary)
 {
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+<% if is_object %>
+    cumo_synchronize_for_host("<%=name%>");
     return cumo_na_ndloop_inspect(ary, <%=c_iter%>, Qnil);
+<% else %>
+    return cumo_na_ndloop_inspect_host_copy(ary, <%=c_iter%>, Qnil);
+<% end %>
 }
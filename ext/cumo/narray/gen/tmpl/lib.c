@@ -12,9 +12,13 @@
 #include "cumo.h"
 #include "cumo/narray.h"
 #include "cumo/template.h"
-#include "SFMT.h"
+#include "cumo/philox.h"
+#include "cumo/histogram.h"
+#include "cumo/bit_word.h"
+#include "cumo/select.h"
 #include "cumo/cuda/memory_pool.h"
 #include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
 <% unless type_name == 'robject' %>
 #include "cumo/indexer.h"
 <% end %>
@@ -27,12 +31,37 @@
 
 #include <<%="cumo/types/#{type_name}.h"%>>
 
+<% if part == 0 %>
 VALUE cT;
+<% end %>
 extern VALUE cRT;
 
 <% children.each do |c|%>
 <%= c.result+"\n\n" %>
 <% end %>
+<% if part > 0 %>
+<% children.each do |c| %>
+<%   next if !c.respond_to?(:part_children) || c.part_children.empty? %>
+extern VALUE <%=c._mod_var%>;
+
+void
+<%=c.split_init%>(void)
+{
+    <% cumo_id_assign.each do |x| %>
+    <%= x %><% end %>
+
+<% c.part_children.each do |m| %>
+    <%= m.init_def %>
+<% end %>
+}
+<% end %>
+<% else %>
+<% children.each do |c| %>
+<%   next if !c.respond_to?(:split_inits) %>
+<%   c.split_inits.each do |f| %>
+void <%=f%>(void);
+<%   end %>
+<% end %>
 
 void
 Init_<%=lib_name%>(void)
@@ -48,3 +77,4 @@ Init_<%=lib_name%>(void)
 <%= c.init_def %>
 <% end %>
 }
+<% end %>
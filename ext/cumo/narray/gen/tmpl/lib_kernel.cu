@@ -1,4 +1,10 @@
 #include "cumo/narray_kernel.h"
+#include "cumo/cuda/function.h"
+#include "cumo/philox.h"
+#include "cumo/histogram.h"
+#include "cumo/bit_word.h"
+#include "cumo/select.h"
+#include "cumo/kahan.h"
 <% unless type_name == 'robject' %>
 #include "cumo/indexer.h"
 #include "cumo/reduce_kernel.h"
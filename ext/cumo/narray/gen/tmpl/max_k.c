@@ -0,0 +1,113 @@
+void <%="cumo_#{c_iter}_kernel_launch"%>(char *p1, char *p2, int64_t *idx, uint64_t rows, uint64_t n, uint64_t k);
+
+// Rows per chunk of host threads is at least this many elements.
+#define <%=c_iter.upcase%>_GRAIN_SIZE 32768
+
+typedef struct {
+    char    *p1;
+    char    *p2;
+    size_t   n;
+    size_t   k;
+    size_t  *ix; // indices of the buffer, k for each thread
+} <%=c_iter%>_host_t;
+
+/*
+  Keeps the k first elements of each row in the order of
+  CUMO_SELECT_PRECEDES, by insertion into a sorted buffer, the output row.
+*/
+static void
+<%=c_iter%>_host(size_t begin, size_t end, size_t tid, void *data)
+{
+    <%=c_iter%>_host_t *h = (<%=c_iter%>_host_t*)data;
+    size_t   r, i, j, m, k = h->k;
+    size_t  *ix = h->ix + tid * k;
+    dtype   *a, *b, x;
+
+    for (r = begin; r < end; r++) {
+        a = (dtype*)(h->p1 + r * h->n * sizeof(dtype));
+        b = (dtype*)(h->p2 + r * k * sizeof(dtype));
+        m = 0;
+        for (i = 0; i < h->n; i++) {
+            x = a[i];
+            if (m == k && !CUMO_SELECT_PRECEDES(x, i, b[k-1], ix[k-1])) {
+                continue;
+            }
+            j = (m < k) ? m++ : k - 1;
+            for (; j > 0 && CUMO_SELECT_PRECEDES(x, i, b[j-1], ix[j-1]); j--) {
+                b[j] = b[j-1];
+                ix[j] = ix[j-1];
+            }
+            b[j] = x;
+            ix[j] = i;
+        }
+    }
+}
+
+/*
+  Returns the k largest elements along axis in descending order.
+  NaN is larger than any number, and equal elements are taken in the order
+  of their positions.
+
+  Each block of the kernel selects from a row in k rounds, each of which
+  finds the largest element smaller than the previous one by a block-wide
+  reduction, so that no scratch is needed for the row. In compatible mode,
+  host threads keep a sorted buffer of k elements for each row.
+
+  @overload <%=name%>(k, axis:nil)
+  @param [Integer] k  Number of elements to return, at most the size of axis.
+  @param [Integer] axis (keyword) Axis to select along.
+    If nil, select from all elements.
+  @return [Cumo::<%=class_name%>] Array whose size along axis is k.
+  @example
+    Cumo::<%=class_name%>[3, 1, 4, 1, 5, 9, 2, 6].<%=name%>(3)
+    => Cumo::<%=class_name%>#shape=[3]
+       [9, 6, 5]
+
+    Cumo::<%=class_name%>[[3, 1, 4], [1, 5, 9]].<%=name%>(2, axis: 0)
+    => Cumo::<%=class_name%>(view)#shape=[2,3]
+       [[3, 5, 9],
+        [1, 1, 4]]
+*/
+static VALUE
+<%=c_func(-1)%>(int argc, VALUE *argv, VALUE self)
+{
+    VALUE vk, kw=Qnil, rows, result;
+    VALUE opts[1] = {Qundef};
+    ID table[1] = {cumo_id_axis};
+    cumo_narray_t *na;
+    size_t n, k, n_rows;
+    int ax;
+
+    rb_scan_args(argc, argv, "1:", &vk, &kw);
+    rb_get_kwargs(kw, table, 0, 1, opts);
+
+    rows = cumo_na_select_rows(self, (opts[0] == Qundef) ? Qnil : opts[0], &ax);
+    CumoGetNArray(rows, na);
+    n = na->shape[na->ndim - 1];
+    k = NUM2SIZET(vk);
+    if (k > n) {
+        rb_raise(rb_eArgError, "k must not be larger than the size of axis: %"SZF"u > %"SZF"u", k, n);
+    }
+    n_rows = (n > 0) ? na->size / n : 0;
+
+    result = cumo_na_select_new(cT, rows, k);
+    if (k > 0 && n_rows > 0) {
+        char *p1 = cumo_na_select_rows_pointer(rows);
+        char *p2 = cumo_na_get_pointer_for_write(result);
+
+        if (cumo_compatible_mode_enabled_p()) {
+            size_t num_threads = cumo_thread_pool_get_num_threads();
+            <%=c_iter%>_host_t h = {p1, p2, n, k, NULL};
+
+            CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+            h.ix = ALLOC_N(size_t, num_threads * k);
+            cumo_thread_pool_parallel_for(n_rows, <%=c_iter.upcase%>_GRAIN_SIZE / n + 1, 0, num_threads, <%=c_iter%>_host, &h);
+            xfree(h.ix);
+        } else {
+            <%="cumo_#{c_iter}_kernel_launch"%>(p1, p2, NULL, n_rows, n, k);
+        }
+    }
+    RB_GC_GUARD(rows);
+    return cumo_na_select_restore(result, ax);
+}
+#undef <%=c_iter.upcase%>_GRAIN_SIZE
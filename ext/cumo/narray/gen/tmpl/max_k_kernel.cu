@@ -0,0 +1,65 @@
+// Block b selects from rows b, b+gridDim.x, ... of n elements. Round r finds
+// the first element in the order of CUMO_SELECT_PRECEDES among those after
+// the one found in round r-1, so that rounds need no scratch for the row.
+__global__ void <%="cumo_#{c_iter}_kernel"%>(char *p1, char *p2, int64_t *idx, uint64_t rows, uint64_t n, uint64_t k)
+{
+    extern __shared__ unsigned long long <%="cumo_#{c_iter}_shared"%>[];
+    int64_t *si = (int64_t*)<%="cumo_#{c_iter}_shared"%>;
+    dtype *sv = (dtype*)(si + blockDim.x);
+    unsigned int tid = threadIdx.x;
+
+    for (uint64_t row = blockIdx.x; row < rows; row += gridDim.x) {
+        dtype *a = (dtype*)p1 + row * n;
+        dtype *b = (dtype*)p2 + row * k;
+        dtype prev_v = a[0];
+        int64_t prev_i = -1;
+
+        for (uint64_t r = 0; r < k; r++) {
+            dtype bv = a[0];
+            int64_t bi = -1;
+
+            for (uint64_t j = tid; j < n; j += blockDim.x) {
+                dtype x = a[j];
+                if (prev_i >= 0 && !CUMO_SELECT_PRECEDES(prev_v, prev_i, x, (int64_t)j)) {
+                    continue;
+                }
+                if (bi < 0 || CUMO_SELECT_PRECEDES(x, (int64_t)j, bv, bi)) {
+                    bv = x;
+                    bi = j;
+                }
+            }
+            si[tid] = bi;
+            sv[tid] = bv;
+            __syncthreads();
+            for (unsigned int s = blockDim.x / 2; s > 0; s >>= 1) {
+                if (tid < s && si[tid + s] >= 0 &&
+                    (si[tid] < 0 || CUMO_SELECT_PRECEDES(sv[tid + s], si[tid + s], sv[tid], si[tid]))) {
+                    si[tid] = si[tid + s];
+                    sv[tid] = sv[tid + s];
+                }
+                __syncthreads();
+            }
+            prev_v = sv[0];
+            prev_i = si[0];
+            if (tid == 0) {
+                b[r] = prev_v;
+                if (idx) {
+                    idx[row * k + r] = prev_i;
+                }
+            }
+            // shared memory is overwritten in the next round
+            __syncthreads();
+        }
+    }
+}
+
+void <%="cumo_#{c_iter}_kernel_launch"%>(char *p1, char *p2, int64_t *idx, uint64_t rows, uint64_t n, uint64_t k)
+{
+    size_t block_dim = 32;
+    size_t grid_dim = (rows < 65535) ? rows : 65535;
+
+    while (block_dim < CUMO_SELECT_BLOCK_DIM && block_dim < n) {
+        block_dim *= 2;
+    }
+    <%="cumo_#{c_iter}_kernel"%><<<grid_dim, block_dim, block_dim * (sizeof(int64_t) + sizeof(dtype)), cumo_cuda_stream_current()>>>(p1,p2,idx,rows,n,k);
+}
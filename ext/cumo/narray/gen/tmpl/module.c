@@ -2,7 +2,7 @@
   module definition: <%= full_module_name %>
 */
 
-<%  if module_var != ns_var %>
+<%  if part == 0 && module_var != ns_var %>
 VALUE <%=module_var%>;
 <%  end %>
 
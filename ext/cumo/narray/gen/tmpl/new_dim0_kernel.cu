@@ -4,5 +4,5 @@ __global__ void <%="cumo_#{c_func(:nodef)}_kernel"%>(dtype *ptr, dtype x)
 }
 void <%="cumo_#{c_func(:nodef)}_kernel_launch"%>(dtype *ptr, dtype x)
 {
-    <%="cumo_#{c_func(:nodef)}_kernel"%><<<1,1>>>(ptr,x);
+    <%="cumo_#{c_func(:nodef)}_kernel"%><<<1, 1, 0, cumo_cuda_stream_current()>>>(ptr,x);
 }
@@ -0,0 +1,165 @@
+void <%="cumo_#{c_iter}_kernel_launch"%>(char *p1, char *p2, uint64_t rows, uint64_t n, uint64_t kth);
+
+// Rows per chunk of host threads is at least this many elements.
+#define <%=c_iter.upcase%>_GRAIN_SIZE 32768
+
+#define SELECT_SWAP(a,i,j) {dtype t_=(a)[i]; (a)[i]=(a)[j]; (a)[j]=t_;}
+
+/*
+  Moves the element of a[0...n] at kth in ascending order to a[kth], smaller
+  or equal ones before it and larger or equal ones after it. Quickselect
+  with the median of three, which falls back to heap select on the rest if
+  it partitions badly, i.e., introselect.
+*/
+static void
+<%=type_name%>_select_nth(dtype *a, size_t n, size_t kth)
+{
+    ssize_t lo = 0, hi = n - 1, i, j, c, m;
+    int depth = 0;
+    dtype p;
+
+    for (m = n; m > 1; m >>= 1) {
+        depth += 2;
+    }
+    while (hi - lo > 16) {
+        if (depth-- == 0) {
+            // max-heap of a[lo..kth], then take smaller ones of the rest
+            m = kth - lo + 1;
+            for (c = m / 2; c-- > 0;) {
+                for (i = c; (j = 2*i+1) < m; i = j) {
+                    if (j+1 < m && CUMO_SELECT_LT(a[lo+j], a[lo+j+1])) j++;
+                    if (!CUMO_SELECT_LT(a[lo+i], a[lo+j])) break;
+                    SELECT_SWAP(a, lo+i, lo+j);
+                }
+            }
+            for (c = kth + 1; c <= hi; c++) {
+                if (!CUMO_SELECT_LT(a[c], a[lo])) continue;
+                SELECT_SWAP(a, c, lo);
+                for (i = 0; (j = 2*i+1) < m; i = j) {
+                    if (j+1 < m && CUMO_SELECT_LT(a[lo+j], a[lo+j+1])) j++;
+                    if (!CUMO_SELECT_LT(a[lo+i], a[lo+j])) break;
+                    SELECT_SWAP(a, lo+i, lo+j);
+                }
+            }
+            SELECT_SWAP(a, lo, kth);
+            return;
+        }
+        // median of three to a[lo] as the pivot
+        m = lo + (hi - lo) / 2;
+        if (CUMO_SELECT_LT(a[m], a[lo])) SELECT_SWAP(a, m, lo);
+        if (CUMO_SELECT_LT(a[hi], a[m])) {
+            SELECT_SWAP(a, hi, m);
+            if (CUMO_SELECT_LT(a[m], a[lo])) SELECT_SWAP(a, m, lo);
+        }
+        SELECT_SWAP(a, lo, m);
+        p = a[lo];
+        // Hoare partition into a[lo..j] <= p and a[j+1..hi] >= p
+        i = lo - 1;
+        j = hi + 1;
+        for (;;) {
+            do { i++; } while (CUMO_SELECT_LT(a[i], p));
+            do { j--; } while (CUMO_SELECT_LT(p, a[j]));
+            if (i >= j) break;
+            SELECT_SWAP(a, i, j);
+        }
+        if ((ssize_t)kth <= j) {
+            hi = j;
+        } else {
+            lo = j + 1;
+        }
+    }
+    for (i = lo + 1; i <= hi; i++) {
+        p = a[i];
+        for (j = i; j > lo && CUMO_SELECT_LT(p, a[j-1]); j--) {
+            a[j] = a[j-1];
+        }
+        a[j] = p;
+    }
+}
+#undef SELECT_SWAP
+
+typedef struct {
+    char    *p1;
+    char    *p2;
+    size_t   n;
+    size_t   kth;
+} <%=c_iter%>_host_t;
+
+static void
+<%=c_iter%>_host(size_t begin, size_t end, size_t tid, void *data)
+{
+    <%=c_iter%>_host_t *h = (<%=c_iter%>_host_t*)data;
+    size_t   r, sz = h->n * sizeof(dtype);
+
+    for (r = begin; r < end; r++) {
+        memcpy(h->p2 + r * sz, h->p1 + r * sz, sz);
+        <%=type_name%>_select_nth((dtype*)(h->p2 + r * sz), h->n, h->kth);
+    }
+}
+
+/*
+  Returns a copy of self partitioned along axis, in which the element at
+  kth is the one that would be there if sorted in ascending order, and the
+  elements before and after it are smaller or equal and larger or equal,
+  respectively, in no particular order. NaN is larger than any number.
+
+  Each block of the kernel finds the element by radix select, one pass over
+  the row per 8 bits of the elements, then compacts the row around it, so
+  that the partition is O(n) per row. In compatible mode, host threads run
+  introselect on each row.
+
+  @overload <%=name%>(kth, axis:nil)
+  @param [Integer] kth  Index of the element to partition by along axis.
+    Negative values count from the end.
+  @param [Integer] axis (keyword) Axis to partition along.
+    If nil, partition all elements flattened.
+  @return [Cumo::<%=class_name%>] partitioned array.
+  @example
+    Cumo::<%=class_name%>[3, 1, 4, 1, 5, 9, 2, 6].<%=name%>(3)
+    => Cumo::<%=class_name%>#shape=[8]
+       [1, 1, 2, 3, 5, 9, 4, 6]
+*/
+static VALUE
+<%=c_func(-1)%>(int argc, VALUE *argv, VALUE self)
+{
+    VALUE vkth, kw=Qnil, rows, result;
+    VALUE opts[1] = {Qundef};
+    ID table[1] = {cumo_id_axis};
+    cumo_narray_t *na;
+    size_t n, n_rows;
+    ssize_t kth;
+    int ax;
+
+    rb_scan_args(argc, argv, "1:", &vkth, &kw);
+    rb_get_kwargs(kw, table, 0, 1, opts);
+
+    rows = cumo_na_select_rows(self, (opts[0] == Qundef) ? Qnil : opts[0], &ax);
+    CumoGetNArray(rows, na);
+    n = na->shape[na->ndim - 1];
+    kth = NUM2SSIZET(vkth);
+    if (kth < -(ssize_t)n || kth >= (ssize_t)n) {
+        rb_raise(rb_eIndexError, "kth %"SZF"d is out of range for the size of axis %"SZF"u", kth, n);
+    }
+    if (kth < 0) {
+        kth += n;
+    }
+    n_rows = na->size / n;
+
+    result = cumo_na_select_new(cT, rows, n);
+    if (n_rows > 0) {
+        char *p1 = cumo_na_select_rows_pointer(rows);
+        char *p2 = cumo_na_get_pointer_for_write(result);
+
+        if (cumo_compatible_mode_enabled_p()) {
+            <%=c_iter%>_host_t h = {p1, p2, n, kth};
+
+            CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+            cumo_thread_pool_parallel_for(n_rows, <%=c_iter.upcase%>_GRAIN_SIZE / n + 1, 0, cumo_thread_pool_get_num_threads(), <%=c_iter%>_host, &h);
+        } else {
+            <%="cumo_#{c_iter}_kernel_launch"%>(p1, p2, n_rows, n, kth);
+        }
+    }
+    RB_GC_GUARD(rows);
+    return cumo_na_select_restore(result, ax);
+}
+#undef <%=c_iter.upcase%>_GRAIN_SIZE
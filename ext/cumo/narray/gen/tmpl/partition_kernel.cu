@@ -0,0 +1,22 @@
+<% key_in = is_half ? "(float)a[i]" : "a[i]" %>
+// Block b partitions rows b, b+gridDim.x, ... of n elements. The kth+1
+// smallest elements are compacted before the rest with the kth one last.
+__global__ void <%="cumo_#{c_iter}_kernel"%>(char *p1, char *p2, uint64_t rows, uint64_t n, uint64_t kth)
+{
+    for (uint64_t row = blockIdx.x; row < rows; row += gridDim.x) {
+        dtype *a = (dtype*)p1 + row * n;
+        dtype *b = (dtype*)p2 + row * n;
+        typedef decltype(cumo_select_key(<%=key_in.sub("[i]","[0]")%>)) sel_key_t;
+        auto key_at = [=](uint64_t i) { return (sel_key_t)~cumo_select_key(<%=key_in%>); };
+        uint64_t take_eq;
+        sel_key_t t = cumo_select_radix<sel_key_t>(key_at, n, kth + 1, &take_eq);
+
+        cumo_select_compact<sel_key_t>(key_at, n, kth + 1, t, take_eq, true, [=](uint64_t i, uint64_t slot) { b[slot] = a[i]; });
+    }
+}
+
+void <%="cumo_#{c_iter}_kernel_launch"%>(char *p1, char *p2, uint64_t rows, uint64_t n, uint64_t kth)
+{
+    size_t grid_dim = (rows < 65535) ? rows : 65535;
+    <%="cumo_#{c_iter}_kernel"%><<<grid_dim, CUMO_SELECT_BLOCK_DIM, 0, cumo_cuda_stream_current()>>>(p1,p2,rows,n,kth);
+}
@@ -0,0 +1,27 @@
+/*
+  Returns percentiles of self along axes, i.e., quantile(q / 100).
+<% if is_float %>
+  @overload <%=name%>(q, axis:nil, keepdims:false, interpolation: :linear, nan:false)
+  @param [TrueClass] nan (keyword) If true, propagete NaN. If false, ignore NaN.
+<% else %>
+  @overload <%=name%>(q, axis:nil, keepdims:false, interpolation: :linear)
+<% end %>
+  @param [Numeric,Array] q  Percentile or percentiles in [0, 100].
+  @param [Numeric,Array,Range] axis (keyword) Affected dimensions.
+  @param [TrueClass] keepdims (keyword) If true, the reduced axes are left in the result array as dimensions with size one.
+  @param [Symbol] interpolation (keyword) :linear, :lower, :higher,
+    :midpoint or :nearest. See quantile.
+  @return [Cumo::<%=class_name%>] percentiles of self. If q is an Array, the
+    first dimension of the result is that of q.
+*/
+static VALUE
+<%=c_func(-1)%>(int argc, VALUE *argv, VALUE self)
+{
+    VALUE vq, kw=Qnil;
+    VALUE opts[4] = {Qundef, Qundef, Qundef, Qundef};
+    ID table[4] = {cumo_id_axis, cumo_id_keepdims, cumo_id_nan, cumo_id_interpolation};
+
+    rb_scan_args(argc, argv, "1:", &vq, &kw);
+    rb_get_kwargs(kw, table, 0, 4, opts);
+    return <%=type_name%>_quantile_reduce(self, vq, 100, Qnil, opts, CUMO_SELECT_LINEAR);
+}
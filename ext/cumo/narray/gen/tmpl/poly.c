@@ -4,7 +4,9 @@ static void
     size_t  i;
     dtype  x, y, a;
 
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+  <% if is_object %>
+    CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
+  <% end %>
     x = *(dtype*)(lp->args[0].ptr + lp->args[0].iter[0].pos);
     i = lp->narg - 2;
     y = *(dtype*)(lp->args[i].ptr + lp->args[i].iter[0].pos);
@@ -31,7 +33,11 @@ static VALUE
     VALUE *argv;
     volatile VALUE v, a;
     cumo_ndfunc_arg_out_t aout[1] = {{cT,0}};
+  <% if is_object %>
     cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_NO_LOOP, 0, 1, 0, aout };
+  <% else %>
+    cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_NO_LOOP|CUMO_NDF_PARALLEL, 0, 1, 0, aout };
+  <% end %>
 
     argc = RARRAY_LEN(args);
     ndf.nin = argc+1;
@@ -45,6 +51,9 @@ static VALUE
         argv[i+1] = RARRAY_PTR(args)[i];
     }
     a = rb_ary_new4(argc+1, argv);
+  <% if !is_object %>
+    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+  <% end %>
     v = cumo_na_ndloop2(&ndf, a);
     return <%=type_name%>_extract(v);
 }
@@ -130,7 +130,6 @@ static void
         r,
         swaptype,
         presorted;
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
 
  loop:SWAPINIT(a, es);
     if (n < 7)
@@ -0,0 +1,211 @@
+<% frac = is_half ? "(float)frac" : "frac" %>
+void <%="cumo_#{c_iter}_kernel_launch"%>(char *p1, char *p2, double *q, uint64_t nq, uint64_t rows, uint64_t n, int interp, int nan);
+
+// Rows per chunk of host threads is at least this many elements.
+#define <%=c_iter.upcase%>_GRAIN_SIZE 32768
+
+typedef struct {
+    char    *p1;
+    char    *p2;
+    double  *q;
+    size_t   nq;
+    size_t   rows;
+    size_t   n;
+    int      interp;
+    int      nan;
+    dtype   *buf; // rows of n elements, one for each thread
+} <%=c_iter%>_host_t;
+
+/*
+  Returns the element of quantile q of a[0...m], which is reordered.
+  Selects the lower element by introselect, and the next one, if
+  interpolated, as the smallest of those after it.
+*/
+static dtype
+<%=type_name%>_quantile_select(dtype *a, size_t m, double q, int interp)
+{
+    uint64_t lo;
+    double frac;
+    size_t i;
+    dtype x, y;
+
+    cumo_select_quantile_index(q, m, interp, &lo, &frac);
+    <%=type_name%>_select_nth(a, m, lo);
+    x = a[lo];
+    if (frac == 0) {
+        return x;
+    }
+    y = a[lo+1];
+    for (i = lo + 2; i < m; i++) {
+        if (CUMO_SELECT_LT(a[i], y)) {
+            y = a[i];
+        }
+    }
+    if (interp == CUMO_SELECT_MIDPOINT) {
+        return m_div(m_add(x,y),m_from_real(2));
+    }
+  <% if is_float %>
+    return m_add(x,m_mul(m_sub(y,x),m_from_real(<%=frac%>)));
+  <% else %>
+    return x + (dtype)((y - x) * frac);
+  <% end %>
+}
+
+static void
+<%=c_iter%>_host(size_t begin, size_t end, size_t tid, void *data)
+{
+    <%=c_iter%>_host_t *h = (<%=c_iter%>_host_t*)data;
+    dtype   *buf = h->buf + tid * h->n;
+    dtype   *a, *y;
+    size_t   r, i, j, m;
+
+    for (r = begin; r < end; r++) {
+        a = (dtype*)h->p1 + r * h->n;
+        y = (dtype*)h->p2 + r;
+        m = 0;
+        for (i = 0; i < h->n; i++) {
+            if (!m_isnan(a[i])) {
+                buf[m++] = a[i];
+            }
+        }
+        for (j = 0; j < h->nq; j++) {
+            if (m == 0 || (h->nan && m < h->n)) {
+              <% if is_float %>
+                y[j * h->rows] = m_div(m_zero,m_zero); // NaN
+              <% else %>
+                y[j * h->rows] = m_zero;
+              <% end %>
+            } else {
+                y[j * h->rows] = <%=type_name%>_quantile_select(buf, m, h->q[j], h->interp);
+            }
+        }
+    }
+}
+
+/*
+  Reduces self to quantiles vq, scaled by scale, with options opts of axis,
+  keepdims, nan and interpolation, whose default is interp. Shared by
+  quantile, percentile and median.
+*/
+static VALUE
+<%=type_name%>_quantile_reduce(VALUE self, VALUE vq, double scale, VALUE axes, VALUE *opts, int interp)
+{
+    VALUE rows, reduce, result;
+    volatile VALUE tmp_q;
+    cumo_narray_t *na;
+    size_t *shape;
+    size_t i, n, nq, n_rows;
+    double *q;
+    int ndim, nan, scalar;
+
+    if (opts[3] != Qundef) {
+        interp = cumo_na_select_interpolation(opts[3]);
+    }
+    nan = (opts[2] != Qundef) && RTEST(opts[2]);
+    if (rb_obj_is_kind_of(vq, cumo_cNArray)) {
+        vq = rb_funcall(vq, rb_intern("to_a"), 0);
+    }
+    scalar = !RB_TYPE_P(vq, T_ARRAY);
+    if (scalar) {
+        vq = rb_ary_new3(1, vq);
+    }
+    nq = RARRAY_LEN(vq);
+    // q is as long as the Array given, so it is not on the stack. The
+    // buffer is freed by GC if a conversion below raises.
+    q = (double*)rb_alloc_tmp_buffer(&tmp_q, sizeof(double) * nq);
+    for (i = 0; i < nq; i++) {
+        q[i] = NUM2DBL(RARRAY_AREF(vq, i)) / scale;
+        if (!(q[i] >= 0 && q[i] <= 1)) {
+            rb_raise(rb_eArgError, "q must be in [0, %g]: %g", scale, q[i] * scale);
+        }
+    }
+
+    reduce = cumo_na_reduce_options(axes, opts, 1, &self, 0);
+    CumoGetNArray(self, na);
+    shape = ALLOCA_N(size_t, na->ndim + 1);
+    rows = cumo_na_select_reduce_rows(self, reduce, (opts[1] != Qundef) && RTEST(opts[1]), &n, &ndim, shape + 1);
+    CumoGetNArray(rows, na);
+    n_rows = (n > 0) ? na->size / n : 0;
+    if (n == 0) {
+        // the size of the result is that of the dimensions not reduced
+        for (n_rows = 1, i = 0; i < (size_t)ndim; i++) {
+            n_rows *= shape[i+1];
+        }
+    }
+    if (scalar) {
+        result = cumo_na_new(cT, ndim, shape + 1);
+    } else {
+        shape[0] = nq;
+        result = cumo_na_new(cT, ndim + 1, shape);
+    }
+    if (n_rows > 0 && nq > 0) {
+        char *p1 = cumo_na_select_rows_pointer(rows);
+        char *p2 = cumo_na_get_pointer_for_write(result);
+
+        if (cumo_compatible_mode_enabled_p()) {
+            size_t num_threads = cumo_thread_pool_get_num_threads();
+            <%=c_iter%>_host_t h = {p1, p2, q, nq, n_rows, n, interp, nan, NULL};
+
+            CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+            h.buf = ALLOC_N(dtype, num_threads * n);
+            cumo_thread_pool_parallel_for(n_rows, <%=c_iter.upcase%>_GRAIN_SIZE / (n + 1) + 1, 0, num_threads, <%=c_iter%>_host, &h);
+            xfree(h.buf);
+        } else {
+            // make a contiguous pinned memory on host => copy to device => return pinned memory to the pool after copy finished
+            double *host_q = (double*)cumo_cuda_runtime_malloc_pinned(sizeof(double) * nq);
+            double *device_q = (double*)cumo_cuda_runtime_malloc(sizeof(double) * nq);
+            cudaError_t status;
+
+            memcpy(host_q, q, sizeof(double) * nq);
+            status = cudaMemcpyAsync(device_q, host_q, sizeof(double) * nq, cudaMemcpyHostToDevice, cumo_cuda_stream_current());
+            cumo_cuda_runtime_free_pinned((char*)host_q);
+            cumo_cuda_runtime_check_status(status);
+            <%="cumo_#{c_iter}_kernel_launch"%>(p1, p2, device_q, nq, n_rows, n, interp, nan);
+            cumo_cuda_runtime_free((char*)device_q);
+        }
+    }
+    rb_free_tmp_buffer(&tmp_q);
+    RB_GC_GUARD(rows);
+    return <%=type_name%>_extract(result);
+}
+
+/*
+  Returns quantiles of self along axes, computed by selection instead of
+  sorting. Each block of the kernel selects the elements of the quantiles
+  from a row by radix select, one pass over the row per 8 bits of the
+  elements, without moving them. In compatible mode, host threads run
+  introselect on a copy of each row.
+<% if is_float %>
+  @overload <%=name%>(q, axis:nil, keepdims:false, interpolation: :linear, nan:false)
+  @param [TrueClass] nan (keyword) If true, propagete NaN. If false, ignore NaN.
+<% else %>
+  @overload <%=name%>(q, axis:nil, keepdims:false, interpolation: :linear)
+<% end %>
+  @param [Numeric,Array] q  Quantile or quantiles in [0, 1].
+  @param [Numeric,Array,Range] axis (keyword) Affected dimensions.
+  @param [TrueClass] keepdims (keyword) If true, the reduced axes are left in the result array as dimensions with size one.
+  @param [Symbol] interpolation (keyword) How to compute a quantile between
+    two elements i < j: :linear (i + (j - i) * fraction), :lower (i),
+    :higher (j), :midpoint ((i + j) / 2) or :nearest (i or j).
+<% unless is_float %>
+    Interpolated results are truncated to <%=class_name%>.
+<% end %>
+  @return [Cumo::<%=class_name%>] quantiles of self. If q is an Array, the
+    first dimension of the result is that of q.
+  @example
+    Cumo::<%=class_name%>[[10, 7, 4], [3, 2, 1]].<%=name%>(0.5, axis: 1)
+    => Cumo::<%=class_name%>#shape=[2]
+       [7, 2]
+*/
+static VALUE
+<%=c_func(-1)%>(int argc, VALUE *argv, VALUE self)
+{
+    VALUE vq, kw=Qnil;
+    VALUE opts[4] = {Qundef, Qundef, Qundef, Qundef};
+    ID table[4] = {cumo_id_axis, cumo_id_keepdims, cumo_id_nan, cumo_id_interpolation};
+
+    rb_scan_args(argc, argv, "1:", &vq, &kw);
+    rb_get_kwargs(kw, table, 0, 4, opts);
+    return <%=type_name%>_quantile_reduce(self, vq, 1, Qnil, opts, CUMO_SELECT_LINEAR);
+}
+#undef <%=c_iter.upcase%>_GRAIN_SIZE
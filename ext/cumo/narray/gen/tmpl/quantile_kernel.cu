@@ -0,0 +1,85 @@
+<% key_in = is_half ? "(float)a[i]" : "a[i]" %>
+<% frac = is_half ? "(float)frac" : "frac" %>
+// Block b reduces rows b, b+gridDim.x, ... of n elements to the quantiles
+// q[0...nq], which are written with the stride of rows. Each element of a
+// quantile is selected by radix select, ignoring NaN unless nan.
+__global__ void <%="cumo_#{c_iter}_kernel"%>(char *p1, char *p2, const double *q, uint64_t nq, uint64_t rows, uint64_t n, int interp, bool nan)
+{
+    __shared__ unsigned long long n_nan;
+
+    for (uint64_t row = blockIdx.x; row < rows; row += gridDim.x) {
+        dtype *a = (dtype*)p1 + row * n;
+        dtype *y = (dtype*)p2 + row;
+        typedef decltype(cumo_select_key(<%=key_in.sub("[i]","[0]")%>)) sel_key_t;
+        // in ascending order, in which NaN is the last
+        auto key_at = [=](uint64_t i) { return (sel_key_t)~cumo_select_key(<%=key_in%>); };
+        auto select = [=](uint64_t j) {
+            uint64_t take_eq;
+            <%= is_half ? "float" : "dtype" %> x;
+            cumo_select_unkey((sel_key_t)~cumo_select_radix<sel_key_t>(key_at, n, j + 1, &take_eq), &x);
+            return (dtype)x;
+        };
+        uint64_t m = n;
+
+      <% if is_float %>
+        if (threadIdx.x == 0) {
+            n_nan = 0;
+        }
+        __syncthreads();
+        {
+            unsigned long long c = 0;
+            for (uint64_t i = threadIdx.x; i < n; i += blockDim.x) {
+                if (m_isnan(a[i])) {
+                    c++;
+                }
+            }
+            if (c > 0) {
+                atomicAdd(&n_nan, c);
+            }
+        }
+        __syncthreads();
+        m = n - n_nan;
+      <% end %>
+        for (uint64_t j = 0; j < nq; j++) {
+            uint64_t lo;
+            double frac;
+            dtype x, z;
+
+            if (m == 0 || (nan && m < n)) {
+                if (threadIdx.x == 0) {
+                  <% if is_float %>
+                    y[j * rows] = m_div(m_zero,m_zero); // NaN
+                  <% else %>
+                    y[j * rows] = m_zero;
+                  <% end %>
+                }
+                continue;
+            }
+            cumo_select_quantile_index(q[j], m, interp, &lo, &frac);
+            x = select(lo);
+            if (frac != 0) {
+                z = select(lo + 1);
+                if (interp == CUMO_SELECT_MIDPOINT) {
+                    x = m_div(m_add(x,z),m_from_real(2));
+                } else {
+                  <% if is_float %>
+                    x = m_add(x,m_mul(m_sub(z,x),m_from_real(<%=frac%>)));
+                  <% else %>
+                    x = x + (dtype)((z - x) * frac);
+                  <% end %>
+                }
+            }
+            if (threadIdx.x == 0) {
+                y[j * rows] = x;
+            }
+        }
+        // n_nan is reset for the next row
+        __syncthreads();
+    }
+}
+
+void <%="cumo_#{c_iter}_kernel_launch"%>(char *p1, char *p2, double *q, uint64_t nq, uint64_t rows, uint64_t n, int interp, int nan)
+{
+    size_t grid_dim = (rows < 65535) ? rows : 65535;
+    <%="cumo_#{c_iter}_kernel"%><<<grid_dim, CUMO_SELECT_BLOCK_DIM, 0, cumo_cuda_stream_current()>>>(p1,p2,q,nq,rows,n,interp,nan);
+}
@@ -5,9 +5,7 @@ if is_int && !is_object
   else
     rand_bit = 32
   end
-  m_rand = "m_rand(max,shift)"
-  shift_def = "int shift;"
-  shift_set = "shift = #{rand_bit-1} - msb_pos(max);"
+  shift_set = "g.shift = #{rand_bit-1} - msb_pos(g.max);"
   rand_type = "uint#{rand_bit}_t"
 %>
 
@@ -32,36 +30,9 @@ static int msb_pos(<%=rand_type%> a)
     }
     return pos;
 }
-
-/* generates a random number on [0,max) */
-<% if rand_bit == 64 %>
-inline static dtype m_rand(uint64_t max, int shift)
-{
-    uint64_t x;
-    do {
-        x = gen_rand32();
-        x <<= 32;
-        x |= gen_rand32();
-        x >>= shift;
-    } while (x >= max);
-    return x;
-}
-<% else %>
-inline static dtype m_rand(uint32_t max, int shift)
-{
-    uint32_t x;
-    do {
-        x = gen_rand32();
-        x >>= shift;
-    } while (x >= max);
-    return x;
-}
-<% end %>
 <%
 else
-  m_rand = "m_rand(max)"
-  shift_def = ""
-  shift_set = ""
+  shift_set = "g.shift = 0;"
   rand_type = "dtype"
 end
 %>
@@ -69,46 +40,93 @@ end
 typedef struct {
     dtype low;
     <%=rand_type%> max;
+    int shift;
 } rand_opt_t;
 
+<% unless is_object %>
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(char *p1, size_t *idx1, dtype low, <%=rand_type%> max, int shift, cumo_philox_state_t st, uint64_t n);
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, dtype low, <%=rand_type%> max, int shift, cumo_philox_state_t st, uint64_t n);
+void <%="cumo_#{c_iter}_host_range"%>(char *p1, ssize_t s1, size_t *idx1, dtype low, <%=rand_type%> max, int shift, cumo_philox_state_t st, uint64_t begin, uint64_t end);
+
+// Elements per chunk of host threads in compatible mode.
+#define <%=c_iter.upcase%>_GRAIN_SIZE 32768
+
+typedef struct {
+    char    *p1;
+    ssize_t  s1;
+    size_t  *idx1;
+    rand_opt_t *g;
+    cumo_philox_state_t st;
+} <%=c_iter%>_host_t;
+
+static void
+<%=c_iter%>_host(size_t begin, size_t end, size_t tid, void *data)
+{
+    <%=c_iter%>_host_t *h = (<%=c_iter%>_host_t*)data;
+    <%="cumo_#{c_iter}_host_range"%>(h->p1, h->s1, h->idx1, h->g->low, h->g->max, h->g->shift, h->st, begin, end);
+}
+<% end %>
+
 static void
 <%=c_iter%>(cumo_na_loop_t *const lp)
 {
-    size_t   i;
+    size_t   n;
     char    *p1;
     ssize_t  s1;
     size_t  *idx1;
-    dtype    x;
     rand_opt_t *g;
-    dtype    low;
-    <%=rand_type%> max;
-    <%=shift_def%>
+    cumo_philox_state_t st;
 
-    CUMO_INIT_COUNTER(lp, i);
+    CUMO_INIT_COUNTER(lp, n);
     CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
     g = (rand_opt_t*)(lp->opt_ptr);
-    low = g->low;
-    max = g->max;
-    <%=shift_set%>
+    st = cumo_na_rand_reserve(n);
 
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
-    if (idx1) {
-        for (; i--;) {
-            x = m_add(<%=m_rand%>,low);
-            CUMO_SET_DATA_INDEX(p1,idx1,dtype,x);
+    <% if is_object %>
+    {
+        size_t   i;
+        uint32_t w[4];
+        dtype    x;
+        CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
+        if (idx1) {
+            for (i=0; i<n; i++) {
+                cumo_philox_generate(st, i, 0, w);
+                x = m_add(m_rand(g->max, w), g->low);
+                CUMO_SET_DATA_INDEX(p1,idx1,dtype,x);
+            }
+        } else {
+            for (i=0; i<n; i++) {
+                cumo_philox_generate(st, i, 0, w);
+                x = m_add(m_rand(g->max, w), g->low);
+                CUMO_SET_DATA_STRIDE(p1,s1,dtype,x);
+            }
         }
+    }
+    <% else %>
+    if (cumo_compatible_mode_enabled_p()) {
+        // each element draws from its own counter, so any split of threads
+        // gives the same numbers as the kernels.
+        <%=c_iter%>_host_t h = {p1, s1, idx1, g, st};
+        CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+        cumo_thread_pool_parallel_for(n, <%=c_iter.upcase%>_GRAIN_SIZE, 0, cumo_thread_pool_get_num_threads(), <%=c_iter%>_host, &h);
+    } else if (idx1) {
+        <%="cumo_#{c_iter}_index_kernel_launch"%>(p1,idx1,g->low,g->max,g->shift,st,n);
     } else {
-        for (; i--;) {
-            x = m_add(<%=m_rand%>,low);
-            CUMO_SET_DATA_STRIDE(p1,s1,dtype,x);
-        }
+        <%="cumo_#{c_iter}_stride_kernel_launch"%>(p1,s1,g->low,g->max,g->shift,st,n);
     }
+    <% end %>
 }
-
+<% unless is_object %>
+#undef <%=c_iter.upcase%>_GRAIN_SIZE
+<% end %>
 
 /*
   Generate uniformly distributed random numbers on self narray.
+
+  Random numbers are generated by the counter-based Philox4x32-10 generator,
+  so the result depends only on the seed, substream and the number of
+  elements drawn since the last srand. In compatible mode, host threads
+  draw the same numbers as the kernels.
   @overload rand([[low],high])
   @param [Numeric] low  lower inclusive boundary of random numbers. (default=0)
   @param [Numeric] high  upper exclusive boundary of random numbers. (default=1 or 1+1i for complex types)
@@ -162,6 +180,7 @@ static VALUE
         rb_raise(rb_eArgError,"high must be larger than low");
     }
     <% end %>
+    <%=shift_set%>
     cumo_na_ndloop3(&ndf, &g, 1, self);
     return self;
 }
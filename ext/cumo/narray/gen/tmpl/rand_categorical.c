@@ -0,0 +1,54 @@
+typedef struct {
+    double *cdf;
+    uint64_t k;
+} rand_categorical_opt_t;
+
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(char *p1, size_t *idx1, const double *cdf, uint64_t k, cumo_philox_state_t st, uint64_t n);
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, const double *cdf, uint64_t k, cumo_philox_state_t st, uint64_t n);
+
+static void
+<%=c_iter%>(cumo_na_loop_t *const lp)
+{
+    size_t   n;
+    char    *p1;
+    ssize_t  s1;
+    size_t  *idx1;
+    rand_categorical_opt_t *g;
+    cumo_philox_state_t st;
+
+    CUMO_INIT_COUNTER(lp, n);
+    CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
+    g = (rand_categorical_opt_t*)(lp->opt_ptr);
+    st = cumo_na_rand_reserve(n);
+
+    if (idx1) {
+        <%="cumo_#{c_iter}_index_kernel_launch"%>(p1,idx1,g->cdf,g->k,st,n);
+    } else {
+        <%="cumo_#{c_iter}_stride_kernel_launch"%>(p1,s1,g->cdf,g->k,st,n);
+    }
+}
+
+/*
+  Fills self narray with category indices drawn with the given probabilities.
+  Each element is drawn by a binary search on the cdf built on the device.
+  @overload rand_categorical(probs)
+  @param [Cumo::DFloat,Array] probs  1-dimensional non-negative weights of
+    categories. They need not sum to 1.
+  @return [Cumo::<%=class_name%>] self.
+  @example
+    Cumo::Int32.new(6).rand_categorical([0.1, 0.2, 0.7])
+    => Cumo::Int32#shape=[6]
+       [2, 2, 1, 2, 0, 2]
+*/
+static VALUE
+<%=c_func(1)%>(VALUE self, VALUE probs)
+{
+    rand_categorical_opt_t g;
+    cumo_ndfunc_arg_in_t ain[1] = {{CUMO_OVERWRITE,0}};
+    cumo_ndfunc_t ndf = {<%=c_iter%>, CUMO_FULL_LOOP, 1,0, ain,0};
+
+    g.cdf = cumo_na_rand_make_cdf(probs, &g.k);
+    cumo_na_ndloop3(&ndf, &g, 1, self);
+    cumo_cuda_runtime_free((char*)g.cdf);
+    return self;
+}
@@ -0,0 +1,31 @@
+__global__ void <%="cumo_#{c_iter}_index_kernel"%>(char *p1, size_t *idx1, const double *cdf, uint64_t k, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        uint32_t w[4];
+        cumo_philox_generate(st, i, 0, w);
+        *(dtype*)(p1 + idx1[i]) = (dtype)cumo_philox_search_cdf(cdf, k, cumo_philox_to_double(w[0], w[1]));
+    }
+}
+
+__global__ void <%="cumo_#{c_iter}_stride_kernel"%>(char *p1, ssize_t s1, const double *cdf, uint64_t k, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        uint32_t w[4];
+        cumo_philox_generate(st, i, 0, w);
+        *(dtype*)(p1 + (i * s1)) = (dtype)cumo_philox_search_cdf(cdf, k, cumo_philox_to_double(w[0], w[1]));
+    }
+}
+
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(char *p1, size_t *idx1, const double *cdf, uint64_t k, cumo_philox_state_t st, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_index_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,idx1,cdf,k,st,n);
+}
+
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, const double *cdf, uint64_t k, cumo_philox_state_t st, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_stride_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,s1,cdf,k,st,n);
+}
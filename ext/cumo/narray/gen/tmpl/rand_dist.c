@@ -0,0 +1,172 @@
+<%
+  dist = name.sub(/^rand_/,"")
+%>
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(char *p1, size_t *idx1, cumo_rand_dist_param_t g, cumo_philox_state_t st, uint64_t n);
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, cumo_rand_dist_param_t g, cumo_philox_state_t st, uint64_t n);
+
+static void
+<%=c_iter%>(cumo_na_loop_t *const lp)
+{
+    size_t   n;
+    char    *p1;
+    ssize_t  s1;
+    size_t  *idx1;
+    cumo_rand_dist_param_t *g;
+    cumo_philox_state_t st;
+
+    CUMO_INIT_COUNTER(lp, n);
+    CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
+    g = (cumo_rand_dist_param_t*)(lp->opt_ptr);
+    <% if dist == "bernoulli" %>
+    // 4 elements share a counter
+    st = cumo_na_rand_reserve((n + 3) / 4);
+    <% else %>
+    st = cumo_na_rand_reserve(n);
+    <% end %>
+
+    if (idx1) {
+        <%="cumo_#{c_iter}_index_kernel_launch"%>(p1,idx1,*g,st,n);
+    } else {
+        <%="cumo_#{c_iter}_stride_kernel_launch"%>(p1,s1,*g,st,n);
+    }
+}
+
+<% if dist == "exponential" %>
+/*
+  Generates random numbers from the exponential distribution on self narray.
+  @overload rand_exponential([scale])
+  @param [Numeric] scale  scale (inverse of rate) of the distribution. (default=1)
+  @return [Cumo::<%=class_name%>] self.
+  @example
+    Cumo::DFloat.new(5).rand_exponential(2)
+*/
+<% elsif dist == "gamma" %>
+/*
+  Generates random numbers from the gamma distribution on self narray
+  by Marsaglia and Tsang's method.
+  @overload rand_gamma(shape,[scale])
+  @param [Numeric] shape  shape parameter (k) of the distribution.
+  @param [Numeric] scale  scale parameter (theta) of the distribution. (default=1)
+  @return [Cumo::<%=class_name%>] self.
+  @example
+    Cumo::DFloat.new(5).rand_gamma(2.5, 0.5)
+*/
+<% elsif dist == "poisson" %>
+/*
+  Generates random numbers from the poisson distribution on self narray.
+  @overload rand_poisson(lam)
+  @param [Numeric] lam  expected number of occurrences.
+  @return [Cumo::<%=class_name%>] self.
+  @example
+    Cumo::Int32.new(5).rand_poisson(3)
+*/
+<% elsif dist == "bernoulli" %>
+/*
+  Fills self narray with 1 with probability p and 0 otherwise.
+  Draws are compatible with Cumo::Bit#rand_bernoulli: the same seed gives
+  the same mask.
+  @overload rand_bernoulli([p])
+  @param [Numeric] p  probability of 1. (default=0.5)
+  @return [Cumo::<%=class_name%>] self.
+  @example
+    Cumo::SFloat.new(5).rand_bernoulli(0.9)
+*/
+<% elsif dist == "trunc_norm" %>
+/*
+  Generates random numbers from the normal distribution truncated to
+  [low, high] on self narray by the inverse transform.
+  @overload rand_trunc_norm(low,high,[mu,[sigma]])
+  @param [Numeric] low  lower boundary.
+  @param [Numeric] high  upper boundary.
+  @param [Numeric] mu  mean of the untruncated normal distribution. (default=0)
+  @param [Numeric] sigma  standard deviation of the untruncated normal distribution. (default=1)
+  @return [Cumo::<%=class_name%>] self.
+  @example
+    Cumo::DFloat.new(5).rand_trunc_norm(-2, 2)
+*/
+<% end %>
+static VALUE
+<%=c_func(-1)%>(int argc, VALUE *args, VALUE self)
+{
+    cumo_rand_dist_param_t g;
+    cumo_ndfunc_arg_in_t ain[1] = {{CUMO_OVERWRITE,0}};
+    cumo_ndfunc_t ndf = {<%=c_iter%>, CUMO_FULL_LOOP, 1,0, ain,0};
+
+    memset(&g, 0, sizeof(g));
+    <% if dist == "exponential" %>
+    {
+        VALUE v1=Qnil;
+
+        rb_scan_args(argc, args, "01", &v1);
+        g.param[0] = (v1 == Qnil) ? 1.0 : NUM2DBL(v1);
+        if (!(g.param[0] > 0)) {
+            rb_raise(rb_eArgError, "scale must be positive");
+        }
+    }
+    <% elsif dist == "gamma" %>
+    {
+        VALUE v1=Qnil, v2=Qnil;
+
+        rb_scan_args(argc, args, "11", &v1, &v2);
+        g.param[0] = NUM2DBL(v1);
+        g.param[1] = (v2 == Qnil) ? 1.0 : NUM2DBL(v2);
+        if (!(g.param[0] > 0) || !(g.param[1] > 0)) {
+            rb_raise(rb_eArgError, "shape and scale must be positive");
+        }
+    }
+    <% elsif dist == "poisson" %>
+    {
+        VALUE v1=Qnil;
+
+        rb_scan_args(argc, args, "10", &v1);
+        g.param[0] = NUM2DBL(v1);
+        if (!(g.param[0] >= 0)) {
+            rb_raise(rb_eArgError, "lam must be non-negative");
+        }
+    }
+    <% elsif dist == "bernoulli" %>
+    {
+        VALUE v1=Qnil;
+
+        rb_scan_args(argc, args, "01", &v1);
+        g.param[0] = (v1 == Qnil) ? 0.5 : NUM2DBL(v1);
+        if (!(g.param[0] >= 0 && g.param[0] <= 1)) {
+            rb_raise(rb_eArgError, "p must be in [0,1]");
+        }
+    }
+    <% elsif dist == "trunc_norm" %>
+    {
+        VALUE v1=Qnil, v2=Qnil, v3=Qnil, v4=Qnil;
+        double low, high, mu, sigma, a, b;
+
+        rb_scan_args(argc, args, "22", &v1, &v2, &v3, &v4);
+        low = NUM2DBL(v1);
+        high = NUM2DBL(v2);
+        mu = (v3 == Qnil) ? 0.0 : NUM2DBL(v3);
+        sigma = (v4 == Qnil) ? 1.0 : NUM2DBL(v4);
+        if (!(low < high)) {
+            rb_raise(rb_eArgError, "high must be larger than low");
+        }
+        if (!(sigma > 0)) {
+            rb_raise(rb_eArgError, "sigma must be positive");
+        }
+        a = (low - mu) / sigma;
+        b = (high - mu) / sigma;
+        // Sample the lower tail, where the cdf has more precision, and mirror.
+        if (a > 0) {
+            double t = a;
+            a = -b;
+            b = -t;
+            sigma = -sigma;
+        }
+        g.param[0] = 0.5 * erfc(-a / M_SQRT2); // cdf(a)
+        g.param[1] = 0.5 * erfc(-b / M_SQRT2); // cdf(b)
+        g.param[2] = mu;
+        g.param[3] = sigma;
+        g.param[4] = low;
+        g.param[5] = high;
+    }
+    <% end %>
+    cumo_na_ndloop3(&ndf, &g, 1, self);
+    return self;
+}
@@ -0,0 +1,50 @@
+<%
+  dist = name.sub(/^rand_/,"")
+%>
+__device__ static inline dtype <%="cumo_#{c_iter}_sample"%>(const cumo_rand_dist_param_t &g, cumo_philox_state_t st, uint64_t i)
+{
+    <% if dist == "exponential" %>
+    return (dtype)(cumo_philox_exponential(st, i) * g.param[0]);
+    <% elsif dist == "gamma" %>
+    return (dtype)(cumo_philox_gamma(st, i, g.param[0]) * g.param[1]);
+    <% elsif dist == "poisson" %>
+    return (dtype)cumo_philox_poisson(st, i, g.param[0]);
+    <% elsif dist == "bernoulli" %>
+    return (dtype)cumo_philox_bernoulli(st, i, cumo_philox_bernoulli_threshold(g.param[0]));
+    <% elsif dist == "trunc_norm" %>
+    uint32_t w[4];
+    double u, x;
+    cumo_philox_generate(st, i, 0, w);
+    u = g.param[0] + (g.param[1] - g.param[0]) * cumo_philox_to_double(w[0], w[1]);
+    x = normcdfinv(u) * g.param[3] + g.param[2];
+    return (dtype)fmin(fmax(x, g.param[4]), g.param[5]);
+    <% end %>
+}
+
+__global__ void <%="cumo_#{c_iter}_index_kernel"%>(char *p1, size_t *idx1, cumo_rand_dist_param_t g, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        *(dtype*)(p1 + idx1[i]) = <%="cumo_#{c_iter}_sample"%>(g, st, i);
+    }
+}
+
+__global__ void <%="cumo_#{c_iter}_stride_kernel"%>(char *p1, ssize_t s1, cumo_rand_dist_param_t g, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        *(dtype*)(p1 + (i * s1)) = <%="cumo_#{c_iter}_sample"%>(g, st, i);
+    }
+}
+
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(char *p1, size_t *idx1, cumo_rand_dist_param_t g, cumo_philox_state_t st, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_index_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,idx1,g,st,n);
+}
+
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, cumo_rand_dist_param_t g, cumo_philox_state_t st, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_stride_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,s1,g,st,n);
+}
@@ -0,0 +1,86 @@
+<% unless is_object %>
+<%
+if is_int
+  if /Int64$/ =~ class_name
+    rand_bit = 64
+  else
+    rand_bit = 32
+  end
+  rand_type = "uint#{rand_bit}_t"
+%>
+/* generates a random number on [0,max) by rejection of shifted words */
+__host__ __device__ static inline dtype <%="cumo_#{c_iter}_m_rand"%>(<%=rand_type%> max, int shift, cumo_philox_state_t st, uint64_t i)
+{
+    uint32_t w[4];
+    <%=rand_type%> x;
+    for (uint32_t round = 0; ; ++round) {
+        cumo_philox_generate(st, i, round, w);
+        <% if rand_bit == 64 %>
+        for (int k = 0; k < 4; k += 2) {
+            x = (((uint64_t)w[k] << 32) | w[k+1]) >> shift;
+            if (x < max) return x;
+        }
+        <% else %>
+        for (int k = 0; k < 4; ++k) {
+            x = w[k] >> shift;
+            if (x < max) return x;
+        }
+        <% end %>
+    }
+}
+<%
+  m_rand = "m_add(cumo_#{c_iter}_m_rand(max,shift,st,i),low)"
+else
+  rand_type = "dtype"
+  m_rand = "m_add(m_rand(max,w),low)"
+end
+%>
+
+__global__ void <%="cumo_#{c_iter}_index_kernel"%>(char *p1, size_t *idx1, dtype low, <%=rand_type%> max, int shift, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        <% unless is_int %>
+        uint32_t w[4];
+        cumo_philox_generate(st, i, 0, w);
+        <% end %>
+        *(dtype*)(p1 + idx1[i]) = <%=m_rand%>;
+    }
+}
+
+__global__ void <%="cumo_#{c_iter}_stride_kernel"%>(char *p1, ssize_t s1, dtype low, <%=rand_type%> max, int shift, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        <% unless is_int %>
+        uint32_t w[4];
+        cumo_philox_generate(st, i, 0, w);
+        <% end %>
+        *(dtype*)(p1 + (i * s1)) = <%=m_rand%>;
+    }
+}
+
+/* draws elements [begin,end) on the host, the same numbers as the kernels */
+void <%="cumo_#{c_iter}_host_range"%>(char *p1, ssize_t s1, size_t *idx1, dtype low, <%=rand_type%> max, int shift, cumo_philox_state_t st, uint64_t begin, uint64_t end)
+{
+    for (uint64_t i = begin; i < end; ++i) {
+        <% unless is_int %>
+        uint32_t w[4];
+        cumo_philox_generate(st, i, 0, w);
+        <% end %>
+        *(dtype*)(p1 + (idx1 ? idx1[i] : i * s1)) = <%=m_rand%>;
+    }
+}
+
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(char *p1, size_t *idx1, dtype low, <%=rand_type%> max, int shift, cumo_philox_state_t st, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_index_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,idx1,low,max,shift,st,n);
+}
+
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, dtype low, <%=rand_type%> max, int shift, cumo_philox_state_t st, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_stride_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,s1,low,max,shift,st,n);
+}
+<% end %>
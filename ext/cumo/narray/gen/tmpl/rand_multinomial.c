@@ -0,0 +1,62 @@
+void <%="cumo_#{c_iter}_kernel_launch"%>(dtype *p1, const double *cdf, uint64_t k, uint64_t n_trials, uint64_t n_rows, cumo_philox_state_t st);
+
+/*
+  Fills self narray with multinomial counts along the last axis.
+  Each row of the last axis gets the number of times each category is drawn
+  in n trials. All trials of all rows are drawn in one kernel.
+  @overload rand_multinomial(n,probs)
+  @param [Integer] n  number of trials for each row.
+  @param [Cumo::DFloat,Array] probs  1-dimensional non-negative weights of
+    categories. Its size must be equal to the size of the last axis of self.
+  @return [Cumo::<%=class_name%>] self.
+  @example
+    Cumo::Int32.new(2,3).rand_multinomial(10, [0.2, 0.3, 0.5])
+    => Cumo::Int32#shape=[2,3]
+       [[1, 4, 5],
+        [2, 3, 5]]
+*/
+static VALUE
+<%=c_func(2)%>(VALUE self, VALUE trials, VALUE probs)
+{
+    cumo_narray_t *na;
+    VALUE out;
+    dtype *p1;
+    double *cdf;
+    uint64_t k, n_trials, n_rows;
+    cumo_philox_state_t st;
+
+    n_trials = NUM2UINT64(trials);
+    CumoGetNArray(self, na);
+    if (CUMO_NA_NDIM(na) == 0) {
+        rb_raise(cumo_na_eShapeError, "self must have at least one dimension");
+    }
+    if (CUMO_NA_SIZE(na) == 0) {
+        return self;
+    }
+
+    cdf = cumo_na_rand_make_cdf(probs, &k);
+    if (CUMO_NA_SHAPE(na)[CUMO_NA_NDIM(na)-1] != k) {
+        cumo_cuda_runtime_free((char*)cdf);
+        rb_raise(cumo_na_eShapeError, "size of probs must be equal to the size of the last axis");
+    }
+    n_rows = CUMO_NA_SIZE(na) / k;
+
+    // Counts are accumulated by atomics, so write into a contiguous buffer.
+    if (cumo_na_check_contiguous(self) == Qtrue) {
+        out = self;
+    } else {
+        out = cumo_na_new(cT, CUMO_NA_NDIM(na), CUMO_NA_SHAPE(na));
+    }
+    p1 = (dtype*)(cumo_na_get_pointer_for_write(out) + cumo_na_get_offset(out));
+    cumo_cuda_runtime_check_status(cudaMemsetAsync(p1, 0, sizeof(dtype) * CUMO_NA_SIZE(na),cumo_cuda_stream_current()));
+    if (n_trials > 0) {
+        st = cumo_na_rand_reserve(n_rows * n_trials);
+        <%="cumo_#{c_iter}_kernel_launch"%>(p1, cdf, k, n_trials, n_rows, st);
+    }
+    cumo_cuda_runtime_free((char*)cdf);
+
+    if (out != self) {
+        rb_funcall(self, rb_intern("store"), 1, out);
+    }
+    return self;
+}
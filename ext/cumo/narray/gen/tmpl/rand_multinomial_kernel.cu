@@ -0,0 +1,23 @@
+<%
+  atomic_type = {"int32_t"=>"int", "u_int32_t"=>"unsigned int"}[ctype] || "unsigned long long int"
+%>
+// Thread j draws trial (j % n_trials) of row (j / n_trials).
+__global__ void <%="cumo_#{c_iter}_kernel"%>(dtype *p1, const double *cdf, uint64_t k, uint64_t n_trials, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        uint32_t w[4];
+        uint64_t row = i / n_trials;
+        uint64_t c;
+        cumo_philox_generate(st, i, 0, w);
+        c = cumo_philox_search_cdf(cdf, k, cumo_philox_to_double(w[0], w[1]));
+        atomicAdd((<%=atomic_type%>*)(p1 + row * k + c), (<%=atomic_type%>)1);
+    }
+}
+
+void <%="cumo_#{c_iter}_kernel_launch"%>(dtype *p1, const double *cdf, uint64_t k, uint64_t n_trials, uint64_t n_rows, cumo_philox_state_t st)
+{
+    uint64_t n = n_rows * n_trials;
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,cdf,k,n_trials,st,n);
+}
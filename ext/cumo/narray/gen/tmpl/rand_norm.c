@@ -3,74 +3,58 @@ typedef struct {
     rtype sigma;
 } randn_opt_t;
 
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(char *p1, size_t *idx1, dtype mu, rtype sigma, cumo_philox_state_t st, uint64_t n);
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, dtype mu, rtype sigma, cumo_philox_state_t st, uint64_t n);
+void <%="cumo_#{c_iter}_host_range"%>(char *p1, ssize_t s1, size_t *idx1, dtype mu, rtype sigma, cumo_philox_state_t st, uint64_t begin, uint64_t end);
+
+// Elements per chunk of host threads in compatible mode.
+#define <%=c_iter.upcase%>_GRAIN_SIZE 32768
+
+typedef struct {
+    char    *p1;
+    ssize_t  s1;
+    size_t  *idx1;
+    randn_opt_t *g;
+    cumo_philox_state_t st;
+} <%=c_iter%>_host_t;
+
+static void
+<%=c_iter%>_host(size_t begin, size_t end, size_t tid, void *data)
+{
+    <%=c_iter%>_host_t *h = (<%=c_iter%>_host_t*)data;
+    <%="cumo_#{c_iter}_host_range"%>(h->p1, h->s1, h->idx1, h->g->mu, h->g->sigma, h->st, begin, end);
+}
+
 static void
 <%=c_iter%>(cumo_na_loop_t *const lp)
 {
-    size_t   i;
+    size_t   n;
     char    *p1;
     ssize_t  s1;
     size_t  *idx1;
-    <% if is_complex %>
-    dtype   *a0;
-    <% else %>
-    dtype   *a0, *a1;
-    <% end %>
-    dtype    mu;
-    rtype    sigma;
     randn_opt_t *g;
+    cumo_philox_state_t st;
 
-    CUMO_INIT_COUNTER(lp, i);
+    CUMO_INIT_COUNTER(lp, n);
     CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
     g = (randn_opt_t*)(lp->opt_ptr);
-    mu = g->mu;
-    sigma = g->sigma;
+    st = cumo_na_rand_reserve(n);
 
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
-    if (idx1) {
-        <% if is_complex %>
-        for (; i--;) {
-            a0 = (dtype*)(p1+*idx1);
-            m_rand_norm(mu,sigma,a0);
-            idx1 += 1;
-        }
-        <% else %>
-        for (; i>1; i-=2) {
-            a0 = (dtype*)(p1+*idx1);
-            a1 = (dtype*)(p1+*(idx1+1));
-            m_rand_norm(mu,sigma,a0,a1);
-            idx1 += 2;
-        }
-        if (i>0) {
-            a0 = (dtype*)(p1+*idx1);
-            m_rand_norm(mu,sigma,a0,0);
-        }
-        <% end %>
+    if (cumo_compatible_mode_enabled_p()) {
+        <%=c_iter%>_host_t h = {p1, s1, idx1, g, st};
+        CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+        cumo_thread_pool_parallel_for(n, <%=c_iter.upcase%>_GRAIN_SIZE, 0, cumo_thread_pool_get_num_threads(), <%=c_iter%>_host, &h);
+    } else if (idx1) {
+        <%="cumo_#{c_iter}_index_kernel_launch"%>(p1,idx1,g->mu,g->sigma,st,n);
     } else {
-        <% if is_complex %>
-        for (; i--;) {
-            a0 = (dtype*)(p1);
-            m_rand_norm(mu,sigma,a0);
-            p1 += s1;
-        }
-        <% else %>
-        for (; i>1; i-=2) {
-            a0 = (dtype*)(p1);
-            a1 = (dtype*)(p1+s1);
-            m_rand_norm(mu,sigma,a0,a1);
-            p1 += s1*2;
-        }
-        if (i>0) {
-            a0 = (dtype*)(p1);
-            m_rand_norm(mu,sigma,a0,0);
-        }
-        <% end %>
+        <%="cumo_#{c_iter}_stride_kernel_launch"%>(p1,s1,g->mu,g->sigma,st,n);
     }
 }
+#undef <%=c_iter.upcase%>_GRAIN_SIZE
 
 /*
   Generates random numbers from the normal distribution on self narray
-  using Box-Muller Transformation.
+  using Box-Muller Transformation of Philox4x32-10 counter-based random numbers.
   @overload rand_norm([mu,[sigma]])
   @param [Numeric] mu  mean of normal distribution. (default=0)
   @param [Numeric] sigma  standard deviation of normal distribution. (default=1)
@@ -112,9 +96,17 @@ static VALUE
         g.mu = m_num_to_data(v1);
     }
     if (n == 2) {
+<% if is_half %>
+        g.sigma = m_num_to_data(v2);
+<% else %>
         g.sigma = NUM2DBL(v2);
+<% end %>
     } else {
+<% if is_half %>
+        g.sigma = m_one;
+<% else %>
         g.sigma = 1;
+<% end %>
     }
     cumo_na_ndloop3(&ndf, &g, 1, self);
     return self;
@@ -0,0 +1,41 @@
+__global__ void <%="cumo_#{c_iter}_index_kernel"%>(char *p1, size_t *idx1, dtype mu, rtype sigma, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        uint32_t w[4];
+        cumo_philox_generate(st, i, 0, w);
+        *(dtype*)(p1 + idx1[i]) = m_rand_norm(mu,sigma,w);
+    }
+}
+
+__global__ void <%="cumo_#{c_iter}_stride_kernel"%>(char *p1, ssize_t s1, dtype mu, rtype sigma, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        uint32_t w[4];
+        cumo_philox_generate(st, i, 0, w);
+        *(dtype*)(p1 + (i * s1)) = m_rand_norm(mu,sigma,w);
+    }
+}
+
+/* draws elements [begin,end) on the host, the same numbers as the kernels */
+void <%="cumo_#{c_iter}_host_range"%>(char *p1, ssize_t s1, size_t *idx1, dtype mu, rtype sigma, cumo_philox_state_t st, uint64_t begin, uint64_t end)
+{
+    for (uint64_t i = begin; i < end; ++i) {
+        uint32_t w[4];
+        cumo_philox_generate(st, i, 0, w);
+        *(dtype*)(p1 + (idx1 ? idx1[i] : i * s1)) = m_rand_norm(mu,sigma,w);
+    }
+}
+
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(char *p1, size_t *idx1, dtype mu, rtype sigma, cumo_philox_state_t st, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_index_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,idx1,mu,sigma,st,n);
+}
+
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, dtype mu, rtype sigma, cumo_philox_state_t st, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_stride_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,s1,mu,sigma,st,n);
+}
@@ -6,19 +6,52 @@
 #endif
 
 struct cumo_<%=type_name%>_sum_impl {
-    __device__ <%=dtype%> Identity(int64_t /*index*/) { return m_zero; }
-    __device__ dtype MapIn(dtype in, int64_t /*index*/) { return in; }
-    __device__ void Reduce(dtype next, <%=dtype%>& accum) { accum += next; }
-    __device__ <%=dtype%> MapOut(<%=dtype%> accum) { return accum; }
+    typedef cumo_accum<<%=dtype%>>::type accum_t;
+    __device__ accum_t Identity(int64_t /*index*/) { return m_zero; }
+    __device__ accum_t MapIn(dtype in, int64_t /*index*/) { return in; }
+    __device__ void Reduce(accum_t next, accum_t& accum) { accum += next; }
+    __device__ <%=dtype%> MapOut(accum_t accum) { return accum; }
 };
 
 struct cumo_<%=type_name%>_prod_impl {
-    __device__ <%=dtype%> Identity(int64_t /*index*/) { return m_one; }
+    typedef cumo_accum<<%=dtype%>>::type accum_t;
+    __device__ accum_t Identity(int64_t /*index*/) { return m_one; }
+    __device__ accum_t MapIn(dtype in, int64_t /*index*/) { return in; }
+    __device__ void Reduce(accum_t next, accum_t& accum) { accum *= next; }
+    __device__ <%=dtype%> MapOut(accum_t accum) { return accum; }
+};
+
+<% if is_float %>
+// NaN is skipped: the identity NaN is replaced by the first non-NaN element,
+// and NaN is returned only if all elements are NaN.
+struct cumo_<%=type_name%>_min_impl {
+    __device__ dtype Identity(int64_t /*index*/) { return (dtype)NAN; }
+    __device__ dtype MapIn(dtype in, int64_t /*index*/) { return in; }
+    __device__ void Reduce(dtype next, dtype& accum) { accum = (m_isnan(accum) || next < accum) ? next : accum; }
+    __device__ dtype MapOut(dtype accum) { return accum; }
+};
+
+struct cumo_<%=type_name%>_max_impl {
+    __device__ dtype Identity(int64_t /*index*/) { return (dtype)NAN; }
     __device__ dtype MapIn(dtype in, int64_t /*index*/) { return in; }
-    __device__ void Reduce(dtype next, <%=dtype%>& accum) { accum *= next; }
-    __device__ <%=dtype%> MapOut(<%=dtype%> accum) { return accum; }
+    __device__ void Reduce(dtype next, dtype& accum) { accum = (m_isnan(accum) || next > accum) ? next : accum; }
+    __device__ dtype MapOut(dtype accum) { return accum; }
 };
 
+struct cumo_<%=type_name%>_ptp_impl {
+    struct MinAndMax {
+        dtype min;
+        dtype max;
+    };
+    __device__ MinAndMax Identity(int64_t /*index*/) { return {(dtype)NAN, (dtype)NAN}; }
+    __device__ MinAndMax MapIn(dtype in, int64_t /*index*/) { return {in, in}; }
+    __device__ void Reduce(MinAndMax next, MinAndMax& accum) {
+        accum.min = (m_isnan(accum.min) || next.min < accum.min) ? next.min : accum.min;
+        accum.max = (m_isnan(accum.max) || next.max > accum.max) ? next.max : accum.max;
+    }
+    __device__ dtype MapOut(MinAndMax accum) { return m_sub(accum.max, accum.min); }
+};
+<% else %>
 struct cumo_<%=type_name%>_min_impl {
     __device__ dtype Identity(int64_t /*index*/) { return DATA_MAX; }
     __device__ dtype MapIn(dtype in, int64_t /*index*/) { return in; }
@@ -33,14 +66,20 @@ struct cumo_<%=type_name%>_max_impl {
     __device__ dtype MapOut(dtype accum) { return accum; }
 };
 
-// TODO(sonots): Implement minmax
-__global__ void cumo_<%=type_name%>_ptp_kernel(cumo_na_reduction_arg_t arg)
-{
-    dtype min=0,max=1;
-    //<%=type_name%>_minmax_kernel<<<1,1>>>(n,p1,s1,&min,&max);
-    char* p2 = arg.out.ptr;
-    *(dtype*)p2 = m_sub(max,min);
-}
+struct cumo_<%=type_name%>_ptp_impl {
+    struct MinAndMax {
+        dtype min;
+        dtype max;
+    };
+    __device__ MinAndMax Identity(int64_t /*index*/) { return {DATA_MAX, DATA_MIN}; }
+    __device__ MinAndMax MapIn(dtype in, int64_t /*index*/) { return {in, in}; }
+    __device__ void Reduce(MinAndMax next, MinAndMax& accum) {
+        accum.min = next.min < accum.min ? next.min : accum.min;
+        accum.max = next.max < accum.max ? accum.max : next.max;
+    }
+    __device__ dtype MapOut(MinAndMax accum) { return m_sub(accum.max, accum.min); }
+};
+<% end %>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -71,5 +110,5 @@ void cumo_<%=type_name%>_max_kernel_launch(cumo_na_reduction_arg_t* arg)
 
 void cumo_<%=type_name%>_ptp_kernel_launch(cumo_na_reduction_arg_t* arg)
 {
-    cumo_<%=type_name%>_ptp_kernel<<<1,1>>>(*arg);
+    cumo_reduce<dtype, dtype, cumo_<%=type_name%>_ptp_impl>(*arg, cumo_<%=type_name%>_ptp_impl{});
 }
@@ -41,7 +41,7 @@ static void
     <% if is_object %>
     {
         dtype x;
-        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+        CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
         if (idx1) {
             for (; i--;) {
                 x = f_seq(beg,step,c++);
@@ -10,7 +10,7 @@ static void
     CUMO_INIT_COUNTER(lp, i);
     CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
     CUMO_INIT_PTR_IDX(lp, 1, p2, s2, idx2);
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+    CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
     if (idx1) {
         if (idx2) {
             for (; i--;) {
@@ -8,8 +8,6 @@ static void
 
     CUMO_INIT_COUNTER(lp, n);
     CUMO_INIT_PTR(lp, 0, ptr, step);
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
     <%=type_name%>_qsort<%=j%>(ptr, n, step);
 }
 <% end %>
@@ -32,7 +30,7 @@ static VALUE
 {
     VALUE reduce;
     cumo_ndfunc_arg_in_t ain[2] = {{CUMO_OVERWRITE,0},{cumo_sym_reduce,0}};
-    cumo_ndfunc_t ndf = {0, CUMO_STRIDE_LOOP|CUMO_NDF_FLAT_REDUCE, 2,0, ain,0};
+    cumo_ndfunc_t ndf = {0, CUMO_STRIDE_LOOP|CUMO_NDF_FLAT_REDUCE|CUMO_NDF_PARALLEL, 2,0, ain,0};
 
     if (!CUMO_TEST_INPLACE(self)) {
         self = cumo_na_copy(self);
@@ -44,6 +42,7 @@ static VALUE
     ndf.func = <%=c_iter%>;
     reduce = cumo_na_reduce_dimension(argc, argv, 1, &self, &ndf, 0);
   <% end %>
+    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
     cumo_na_ndloop(&ndf, 2, self, reduce);
     return self;
 }
@@ -102,8 +102,7 @@ static VALUE
     size = na->size*sizeof(void*); // max capa
     buf = rb_alloc_tmp_buffer(&tmp, size);
 
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cudaDeviceSynchronize();
+    CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
 
     res = cumo_na_ndloop3(&ndf, buf, 3, self, idx, reduce);
     rb_free_tmp_buffer(&tmp);
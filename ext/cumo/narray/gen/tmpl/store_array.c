@@ -4,10 +4,73 @@ void <%="cumo_#{c_iter}_stride_kernel_launch"%>(char *p1, ssize_t s1, dtype* z,
 void <%="cumo_#{c_iter}_index_scalar_kernel_launch"%>(char *p1, size_t *idx1, dtype z, uint64_t n);
 void <%="cumo_#{c_iter}_stride_scalar_kernel_launch"%>(char *p1, ssize_t s1, dtype z, uint64_t n);
 
-static void CUDART_CB
-<%=c_iter%>_callback(cudaStream_t stream, cudaError_t status, void *data)
+typedef struct {
+    VALUE  *ptr;
+    size_t  n1;
+    size_t  n;
+    char   *p1;
+    ssize_t s1;
+    size_t *idx1;
+    dtype  *host_z;
+    dtype  *device_z;
+    size_t  i;
+    cudaError_t status;
+} <%=c_iter%>_stage_t;
+
+/*
+  Converts the elements of ptr into host_z, and copies them into p1 directly
+  if p1 is contiguous, or through device_z otherwise.
+*/
+static VALUE
+<%=c_iter%>_stage_copy(VALUE arg)
+{
+    <%=c_iter%>_stage_t *t = (<%=c_iter%>_stage_t*)arg;
+    size_t i, i1, len, c;
+    VALUE  x;
+    double beg, step;
+
+    for (i=i1=0; i1<t->n1 && i<t->n; i1++) {
+        x = t->ptr[i1];
+        if (rb_obj_is_kind_of(x, rb_cRange) || rb_obj_is_kind_of(x, cumo_na_cStep)) {
+            cumo_na_step_sequence(x,&len,&beg,&step);
+            for (c=0; c<len && i<t->n; c++,i++) {
+                t->host_z[i] = m_from_double(beg + step * c);
+            }
+        }
+        else if (TYPE(x) != T_ARRAY) {
+            t->host_z[i] = m_num_to_data(x);
+            i++;
+        }
+    }
+    t->i = i;
+
+    if (!t->idx1 && t->s1 == sizeof(dtype)) {
+        // optimization: Since p1 is contiguous, we skip creating another contiguous device memory
+        t->status = cudaMemcpyAsync(t->p1,t->host_z,sizeof(dtype)*i,cudaMemcpyHostToDevice,cumo_cuda_stream_current());
+    } else {
+        t->device_z = (dtype*)cumo_cuda_runtime_malloc(sizeof(dtype) * t->n);
+        t->status = cudaMemcpyAsync(t->device_z,t->host_z,sizeof(dtype)*i,cudaMemcpyHostToDevice,cumo_cuda_stream_current());
+        if (t->status == 0) {
+            if (t->idx1) {
+                <%="cumo_#{c_iter}_index_kernel_launch"%>(t->p1,t->idx1,t->device_z,i);
+            } else {
+                <%="cumo_#{c_iter}_stride_kernel_launch"%>(t->p1,t->s1,t->device_z,i);
+            }
+        }
+    }
+    return Qnil;
+}
+
+static VALUE
+<%=c_iter%>_stage_release(VALUE arg)
 {
-    xfree(data);
+    <%=c_iter%>_stage_t *t = (<%=c_iter%>_stage_t*)arg;
+
+    cumo_cuda_runtime_free_pinned((char*)t->host_z);
+    if (t->device_z) {
+        cumo_cuda_runtime_free((void*)t->device_z);
+    }
+    return Qnil;
 }
 //<% end %>
 
@@ -15,15 +78,11 @@ static void
 <%=c_iter%>(cumo_na_loop_t *const lp)
 {
     size_t i, n;
-    size_t i1, n1;
+    size_t n1;
     VALUE  v1, *ptr;
     char   *p1;
     size_t s1, *idx1;
-    VALUE  x;
-    double y;
     dtype  z;
-    size_t len, c;
-    double beg, step;
 
     CUMO_INIT_COUNTER(lp, n);
     CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
@@ -59,8 +118,11 @@ static void
 
     //<% if c_iter.include? 'robject' %>
     {
-        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("store_<%=name%>", "<%=type_name%>");
-        cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+        size_t i1, len, c;
+        VALUE  x;
+        double y, beg, step;
+
+        CUMO_SYNCHRONIZE_FIXME("store_<%=name%>", "<%=type_name%>");
 
         if (idx1) {
             for (i=i1=0; i1<n1 && i<n; i++,i1++) {
@@ -99,55 +161,20 @@ static void
     //<% else %>
     {
         // To copy ruby non-contiguous array values into cuda memory asynchronously, we do
-        // 1. copy to contiguous heap memory
+        // 1. copy to contiguous pinned host memory from the pool
         // 2. copy to contiguous device memory
         // 3. launch kernel to copy the contiguous device memory into strided (or indexed) narray cuda memory
         // 4. free the contiguous device memory
-        // 5. run callback to free the heap memory after kernel finishes
+        // 5. run callback to return the pinned memory to the pool after the copy finishes
         //
         // FYI: We may have to care of cuda stream callback serializes stream execution when we support stream.
         // https://devtalk.nvidia.com/default/topic/822942/why-does-cudastreamaddcallback-serialize-kernel-execution-and-break-concurrency-/
-        dtype* host_z = ALLOC_N(dtype, n);
-        for (i=i1=0; i1<n1 && i<n; i1++) {
-            x = ptr[i1];
-            if (rb_obj_is_kind_of(x, rb_cRange) || rb_obj_is_kind_of(x, cumo_na_cStep)) {
-                cumo_na_step_sequence(x,&len,&beg,&step);
-                for (c=0; c<len && i<n; c++,i++) {
-                    y = beg + step * c;
-                    host_z[i] = m_from_double(y);
-                }
-            }
-            else if (TYPE(x) != T_ARRAY) {
-                host_z[i] = m_num_to_data(x);
-                i++;
-            }
-        }
+        <%=c_iter%>_stage_t t = {ptr, n1, n, p1, s1, idx1, NULL, NULL, 0, cudaSuccess};
 
-        if (!idx1 && s1 == sizeof(dtype)) {
-            // optimization: Since p1 is contiguous, we skip creating another contiguous device memory
-            cudaError_t status = cudaMemcpyAsync(p1,host_z,sizeof(dtype)*i,cudaMemcpyHostToDevice,0);
-            if (status == 0) {
-                cumo_cuda_runtime_check_status(cudaStreamAddCallback(0,<%=c_iter%>_callback,host_z,0));
-            } else {
-                xfree(host_z);
-            }
-            cumo_cuda_runtime_check_status(status);
-        } else {
-            dtype* device_z = (dtype*)cumo_cuda_runtime_malloc(sizeof(dtype) * n);
-            cudaError_t status = cudaMemcpyAsync(device_z,host_z,sizeof(dtype)*i,cudaMemcpyHostToDevice,0);
-            if (status == 0) {
-                if (idx1) {
-                    <%="cumo_#{c_iter}_index_kernel_launch"%>(p1,idx1,device_z,i);
-                } else {
-                    <%="cumo_#{c_iter}_stride_kernel_launch"%>(p1,s1,device_z,i);
-                }
-                cumo_cuda_runtime_check_status(cudaStreamAddCallback(0,<%=c_iter%>_callback,host_z,0));
-            } else {
-                xfree(host_z);
-            }
-            cumo_cuda_runtime_free((void*)device_z);
-            cumo_cuda_runtime_check_status(status);
-        }
+        t.host_z = (dtype*)cumo_cuda_runtime_malloc_pinned(sizeof(dtype) * n);
+        rb_ensure(<%=c_iter%>_stage_copy, (VALUE)&t, <%=c_iter%>_stage_release, (VALUE)&t);
+        cumo_cuda_runtime_check_status(t.status);
+        i = t.i;
     }
     //<% end %>
 
@@ -176,12 +203,132 @@ static void
     //<% end %>
 }
 
+//<% unless c_iter.include? 'robject' %>
+typedef struct {
+    VALUE   rary;
+    int     ndim;
+    size_t *shape;
+    dtype  *host_z;
+    size_t  pos;
+    char   *p1;
+    cudaError_t status;
+} <%=c_iter%>_bulk_t;
+
+/*
+  Converts a rectangular nested Array whose shape matches shape[dim..ndim-1]
+  into host_z in row-major order. Returns 0 when the Array is ragged or has
+  Range, Step, NArray or nil elements, which are left to the ndloop path.
+*/
+static int
+<%=c_iter%>_bulk_fill(<%=c_iter%>_bulk_t *b, VALUE ary, int dim)
+{
+    long i, len;
+    VALUE x;
+
+    if (TYPE(ary) != T_ARRAY) {
+        return 0;
+    }
+    len = RARRAY_LEN(ary);
+    if ((size_t)len != b->shape[dim]) {
+        return 0;
+    }
+    if (dim < b->ndim-1) {
+        for (i=0; i<len; i++) {
+            if (!<%=c_iter%>_bulk_fill(b, RARRAY_AREF(ary,i), dim+1)) {
+                return 0;
+            }
+        }
+        return 1;
+    }
+    // m_num_to_data may call back into Ruby, so recheck the length.
+    for (i=0; i<len && i<RARRAY_LEN(ary); i++) {
+        x = RARRAY_AREF(ary,i);
+        //<% if is_float || is_complex %>
+        if (RB_FLOAT_TYPE_P(x)) {
+            b->host_z[b->pos++] = m_from_double(RFLOAT_VALUE(x));
+            continue;
+        }
+        if (FIXNUM_P(x)) {
+            b->host_z[b->pos++] = m_from_int64(FIX2LONG(x));
+            continue;
+        }
+        //<% else %>
+        if (FIXNUM_P(x) || RB_FLOAT_TYPE_P(x)) {
+            b->host_z[b->pos++] = m_num_to_data(x);
+            continue;
+        }
+        //<% end %>
+        if (NIL_P(x) || TYPE(x) == T_ARRAY || CumoIsNArray(x) ||
+            rb_obj_is_kind_of(x, rb_cRange) || rb_obj_is_kind_of(x, cumo_na_cStep)) {
+            return 0;
+        }
+        b->host_z[b->pos++] = m_num_to_data(x);
+    }
+    return i == len;
+}
+
+static VALUE
+<%=c_iter%>_bulk_copy(VALUE arg)
+{
+    <%=c_iter%>_bulk_t *b = (<%=c_iter%>_bulk_t*)arg;
+
+    if (!<%=c_iter%>_bulk_fill(b, b->rary, 0)) {
+        return Qfalse;
+    }
+    b->status = cudaMemcpyAsync(b->p1,b->host_z,sizeof(dtype)*b->pos,cudaMemcpyHostToDevice,cumo_cuda_stream_current());
+    return Qtrue;
+}
+
+static VALUE
+<%=c_iter%>_bulk_release(VALUE arg)
+{
+    <%=c_iter%>_bulk_t *b = (<%=c_iter%>_bulk_t*)arg;
+
+    cumo_cuda_runtime_free_pinned((char*)b->host_z);
+    return Qnil;
+}
+
+/*
+  Fast path for storing a rectangular nested Array into contiguous self:
+  the Array is walked once into a single pinned staging buffer, which is
+  then copied to the device in one transfer instead of one per row.
+*/
+static int
+<%=c_iter%>_store_bulk(VALUE self, VALUE rary)
+{
+    cumo_narray_t *na;
+    <%=c_iter%>_bulk_t b;
+
+    CumoGetNArray(self, na);
+    if (CUMO_NA_NDIM(na) == 0 || CUMO_NA_SIZE(na) == 0 || cumo_na_check_contiguous(self) != Qtrue) {
+        return 0;
+    }
+    b.rary = rary;
+    b.ndim = CUMO_NA_NDIM(na);
+    b.shape = CUMO_NA_SHAPE(na);
+    b.pos = 0;
+    b.p1 = cumo_na_get_pointer_for_write(self) + cumo_na_get_offset(self);
+    b.status = cudaSuccess;
+    b.host_z = (dtype*)cumo_cuda_runtime_malloc_pinned(sizeof(dtype) * CUMO_NA_SIZE(na));
+    if (!RTEST(rb_ensure(<%=c_iter%>_bulk_copy, (VALUE)&b, <%=c_iter%>_bulk_release, (VALUE)&b))) {
+        return 0;
+    }
+    cumo_cuda_runtime_check_status(b.status);
+    return 1;
+}
+//<% end %>
+
 static VALUE
 <%=c_func%>(VALUE self, VALUE rary)
 {
     cumo_ndfunc_arg_in_t ain[2] = {{CUMO_OVERWRITE,0},{rb_cArray,0}};
     cumo_ndfunc_t ndf = {<%=c_iter%>, CUMO_FULL_LOOP, 2, 0, ain, 0};
 
+    //<% unless c_iter.include? 'robject' %>
+    if (<%=c_iter%>_store_bulk(self, rary)) {
+        return self;
+    }
+    //<% end %>
     cumo_na_ndloop_store_rarray(&ndf, self, rary);
     return self;
 }
@@ -23,8 +23,7 @@ static void
     {
         CUMO_BIT_DIGIT x;
         dtype y;
-        CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+        CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
         if (idx2) {
             if (idx1) {
                 for (; i--;) {
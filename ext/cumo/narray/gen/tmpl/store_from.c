@@ -16,7 +16,7 @@ static void
     CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
     CUMO_INIT_PTR_IDX(lp, 1, p2, s2, idx2);
     //<% if c_iter.include? 'robject' %>
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+    CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
     {
         <%=dtype%> x;
         dtype y;
@@ -36,8 +36,13 @@ static VALUE
 {
     cumo_ndfunc_arg_in_t ain[3] = {{Qnil,0},{cumo_sym_loop_opt},{cumo_sym_option}};
     cumo_ndfunc_arg_out_t aout[1] = {{rb_cArray,0}}; // dummy?
+<% if is_object %>
     cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_FULL_LOOP_NIP, 3, 1, ain, aout };
+    CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+<% else %>
+    // one transfer to host instead of one per element
+    cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_FULL_LOOP_NIP|CUMO_NDF_HOST_COPY, 3, 1, ain, aout };
     CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+<% end %>
     return cumo_na_ndloop_cast_narray_to_rarray(&ndf, self, Qnil);
 }
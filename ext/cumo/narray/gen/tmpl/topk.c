@@ -0,0 +1,174 @@
+void <%="cumo_#{c_iter}_kernel_launch"%>(char *p1, char *p2, int64_t *p3, int64_t *scratch, uint64_t rows, uint64_t n, uint64_t k, int largest);
+
+// Rows per chunk of host threads is at least this many elements.
+#define <%=c_iter.upcase%>_GRAIN_SIZE 32768
+
+typedef struct {
+    char    *p1;
+    char    *p2;
+    int64_t *p3;
+    size_t   n;
+    size_t   k;
+    int      largest;
+    dtype   *hv; // heaps of values and indices, k for each thread
+    size_t  *hi;
+} <%=c_iter%>_host_t;
+
+#define <%=c_iter.upcase%>_PRECEDES(x,i,y,j)                            \
+    (largest ? CUMO_SELECT_PRECEDES(x,i,y,j) :                          \
+     (CUMO_SELECT_LT(x,y) || (!CUMO_SELECT_LT(y,x) && (i) < (j))))
+
+/*
+  Keeps the k first elements of each row in a heap whose root is the last
+  of them, then sorts the heap into the output row.
+*/
+static void
+<%=c_iter%>_host(size_t begin, size_t end, size_t tid, void *data)
+{
+    <%=c_iter%>_host_t *h = (<%=c_iter%>_host_t*)data;
+    size_t   r, i, j, c, m, k = h->k;
+    int      largest = h->largest;
+    dtype   *hv = h->hv + tid * k;
+    size_t  *hi = h->hi + tid * k;
+    dtype   *a, *v, x;
+    int64_t *ix;
+
+    for (r = begin; r < end; r++) {
+        a = (dtype*)(h->p1 + r * h->n * sizeof(dtype));
+        v = (dtype*)(h->p2 + r * k * sizeof(dtype));
+        ix = h->p3 + r * k;
+        m = 0;
+        for (i = 0; i < h->n; i++) {
+            x = a[i];
+            if (m < k) {
+                // sift up
+                for (j = m++; j > 0 && <%=c_iter.upcase%>_PRECEDES(hv[(j-1)/2], hi[(j-1)/2], x, i); j = (j-1)/2) {
+                    hv[j] = hv[(j-1)/2];
+                    hi[j] = hi[(j-1)/2];
+                }
+            } else if (<%=c_iter.upcase%>_PRECEDES(x, i, hv[0], hi[0])) {
+                // replace the root and sift down
+                for (j = 0; (c = 2*j+1) < k; j = c) {
+                    if (c+1 < k && <%=c_iter.upcase%>_PRECEDES(hv[c], hi[c], hv[c+1], hi[c+1])) {
+                        c++;
+                    }
+                    if (!<%=c_iter.upcase%>_PRECEDES(x, i, hv[c], hi[c])) {
+                        break;
+                    }
+                    hv[j] = hv[c];
+                    hi[j] = hi[c];
+                }
+            } else {
+                continue;
+            }
+            hv[j] = x;
+            hi[j] = i;
+        }
+        // pop the root, the last of the rest, to the end
+        for (m = k; m > 0; m--) {
+            v[m-1] = hv[0];
+            ix[m-1] = hi[0];
+            x = hv[m-1];
+            i = hi[m-1];
+            for (j = 0; (c = 2*j+1) < m-1; j = c) {
+                if (c+1 < m-1 && <%=c_iter.upcase%>_PRECEDES(hv[c], hi[c], hv[c+1], hi[c+1])) {
+                    c++;
+                }
+                if (!<%=c_iter.upcase%>_PRECEDES(x, i, hv[c], hi[c])) {
+                    break;
+                }
+                hv[j] = hv[c];
+                hi[j] = hi[c];
+            }
+            hv[j] = x;
+            hi[j] = i;
+        }
+    }
+}
+
+/*
+  Returns the k largest (or smallest) elements along axis and their indices,
+  sorted in descending (or ascending) order. NaN is larger than any number,
+  and equal elements are taken in the order of their positions.
+
+  Each block of the kernel selects from a row by radix select, one pass
+  over the row per 8 bits of the elements, then compacts the k elements
+  into scratch from the memory pool and sorts them by their ranks, so that
+  the selection is O(n) per row. In compatible mode, host threads keep a
+  heap of k elements for each row.
+
+  @overload <%=name%>(k, axis:nil, largest:true)
+  @param [Integer] k  Number of elements to return, at most the size of axis.
+  @param [Integer] axis (keyword) Axis to select along.
+    If nil, select from all elements.
+  @param [TrueClass] largest (keyword) If false, return the smallest ones
+    in ascending order.
+  @return [Array] [Cumo::<%=class_name%> values, Cumo::Int64 indices along axis],
+    whose sizes along axis are k.
+  @example
+    Cumo::<%=class_name%>[3, 1, 4, 1, 5, 9, 2, 6].<%=name%>(3)
+    => [Cumo::<%=class_name%>#shape=[3]
+        [9, 6, 5],
+        Cumo::Int64#shape=[3]
+        [5, 7, 4]]
+
+    Cumo::<%=class_name%>[[3, 1, 4], [1, 5, 9]].<%=name%>(1, axis: 1, largest: false)
+    => [Cumo::<%=class_name%>#shape=[2,1]
+        [[1],
+         [1]],
+        Cumo::Int64#shape=[2,1]
+        [[1],
+         [0]]]
+*/
+static VALUE
+<%=c_func(-1)%>(int argc, VALUE *argv, VALUE self)
+{
+    VALUE vk, kw=Qnil, rows, vals, idxs;
+    VALUE opts[2] = {Qundef, Qundef};
+    ID table[2] = {cumo_id_axis, cumo_id_largest};
+    cumo_narray_t *na;
+    size_t n, k, n_rows;
+    int ax, largest;
+
+    rb_scan_args(argc, argv, "1:", &vk, &kw);
+    rb_get_kwargs(kw, table, 0, 2, opts);
+    largest = (opts[1] == Qundef) ? 1 : RTEST(opts[1]);
+
+    rows = cumo_na_select_rows(self, (opts[0] == Qundef) ? Qnil : opts[0], &ax);
+    CumoGetNArray(rows, na);
+    n = na->shape[na->ndim - 1];
+    k = NUM2SIZET(vk);
+    if (k > n) {
+        rb_raise(rb_eArgError, "k must not be larger than the size of axis: %"SZF"u > %"SZF"u", k, n);
+    }
+    n_rows = (n > 0) ? na->size / n : 0;
+
+    vals = cumo_na_select_new(cT, rows, k);
+    idxs = cumo_na_select_new(cumo_cInt64, rows, k);
+    if (k > 0 && n_rows > 0) {
+        char *p1 = cumo_na_select_rows_pointer(rows);
+        char *p2 = cumo_na_get_pointer_for_write(vals);
+        int64_t *p3 = (int64_t*)cumo_na_get_pointer_for_write(idxs);
+
+        if (cumo_compatible_mode_enabled_p()) {
+            size_t num_threads = cumo_thread_pool_get_num_threads();
+            <%=c_iter%>_host_t h = {p1, p2, p3, n, k, largest, NULL, NULL};
+
+            CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+            h.hv = ALLOC_N(dtype, num_threads * k);
+            h.hi = ALLOC_N(size_t, num_threads * k);
+            cumo_thread_pool_parallel_for(n_rows, <%=c_iter.upcase%>_GRAIN_SIZE / n + 1, 0, num_threads, <%=c_iter%>_host, &h);
+            xfree(h.hv);
+            xfree(h.hi);
+        } else {
+            int64_t *scratch = (int64_t*)cumo_cuda_runtime_malloc(sizeof(int64_t) * n_rows * k);
+
+            <%="cumo_#{c_iter}_kernel_launch"%>(p1, p2, p3, scratch, n_rows, n, k, largest);
+            cumo_cuda_runtime_free((char*)scratch);
+        }
+    }
+    RB_GC_GUARD(rows);
+    return rb_assoc_new(cumo_na_select_restore(vals, ax), cumo_na_select_restore(idxs, ax));
+}
+#undef <%=c_iter.upcase%>_PRECEDES
+#undef <%=c_iter.upcase%>_GRAIN_SIZE
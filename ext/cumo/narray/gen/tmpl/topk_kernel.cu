@@ -0,0 +1,42 @@
+<% key_in = is_half ? "(float)a[i]" : "a[i]" %>
+// Block b selects from rows b, b+gridDim.x, ... of n elements, and compacts
+// the indices of the k selected into the k slots of scratch for the row,
+// which are sorted into the output by their ranks.
+__global__ void <%="cumo_#{c_iter}_kernel"%>(char *p1, char *p2, int64_t *p3, int64_t *scratch, uint64_t rows, uint64_t n, uint64_t k, bool largest)
+{
+    for (uint64_t row = blockIdx.x; row < rows; row += gridDim.x) {
+        int64_t *sel = scratch + row * k;
+        dtype *a = (dtype*)p1 + row * n;
+        dtype *v = (dtype*)p2 + row * k;
+        int64_t *ix = p3 + row * k;
+        typedef decltype(cumo_select_key(<%=key_in.sub("[i]","[0]")%>)) sel_key_t;
+        auto key_at = [=](uint64_t i) { sel_key_t x = cumo_select_key(<%=key_in%>); return largest ? x : (sel_key_t)~x; };
+        uint64_t take_eq;
+        sel_key_t t = cumo_select_radix<sel_key_t>(key_at, n, k, &take_eq);
+
+        cumo_select_compact<sel_key_t>(key_at, n, k, t, take_eq, false, [=](uint64_t i, uint64_t slot) { sel[slot] = i; });
+        __syncthreads();
+        for (uint64_t s = threadIdx.x; s < k; s += blockDim.x) {
+            int64_t i = sel[s];
+            sel_key_t x = key_at(i);
+            uint64_t r = 0;
+            for (uint64_t u = 0; u < k; u++) {
+                int64_t j = sel[u];
+                sel_key_t y = key_at(j);
+                if (y > x || (y == x && j < i)) {
+                    r++;
+                }
+            }
+            v[r] = a[i];
+            ix[r] = i;
+        }
+        // shared memory is overwritten for the next row
+        __syncthreads();
+    }
+}
+
+void <%="cumo_#{c_iter}_kernel_launch"%>(char *p1, char *p2, int64_t *p3, int64_t *scratch, uint64_t rows, uint64_t n, uint64_t k, int largest)
+{
+    size_t grid_dim = (rows < 65535) ? rows : 65535;
+    <%="cumo_#{c_iter}_kernel"%><<<grid_dim, CUMO_SELECT_BLOCK_DIM, 0, cumo_cuda_stream_current()>>>(p1,p2,p3,scratch,rows,n,k,largest);
+}
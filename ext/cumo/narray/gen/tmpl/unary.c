@@ -23,7 +23,7 @@ static void
     {
         size_t i;
         dtype x;
-        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+        CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
         if (idx1) {
             if (idx2) {
                 for (i=0; i<n; i++) {
@@ -126,7 +126,7 @@ static VALUE
     cumo_ndfunc_t ndf = {<%=c_iter%>, CUMO_FULL_LOOP, 1,1, ain,aout};
 
     <% if name == 'map' %>
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    cumo_synchronize_for_host("<%=name%>");
     <% end %>
     return cumo_na_ndloop(&ndf, 1, self);
 }
@@ -1,3 +1,10 @@
+<% unless type_name == 'robject' %>
+void <%="cumo_#{c_iter}_index_index_kernel_launch"%>(char *p1, char *p2, size_t *idx1, size_t *idx2, uint64_t n);
+void <%="cumo_#{c_iter}_index_stride_kernel_launch"%>(char *p1, char *p2, size_t *idx1, ssize_t s2, uint64_t n);
+void <%="cumo_#{c_iter}_stride_index_kernel_launch"%>(char *p1, char *p2, ssize_t s1, size_t *idx2, uint64_t n);
+void <%="cumo_#{c_iter}_stride_stride_kernel_launch"%>(char *p1, char *p2, ssize_t s1, ssize_t s2, uint64_t n);
+<% end %>
+
 static void
 <%=c_iter%>(cumo_na_loop_t *const lp)
 {
@@ -5,45 +12,61 @@ static void
     char   *p1, *p2;
     ssize_t s1, s2;
     size_t *idx1, *idx2;
-    dtype   x;
-    <%=dtype%> y;
     CUMO_INIT_COUNTER(lp, i);
     CUMO_INIT_PTR_IDX(lp, 0, p1, s1, idx1);
     CUMO_INIT_PTR_IDX(lp, 1, p2, s2, idx2);
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
-    if (idx1) {
-        if (idx2) {
-            for (; i--;) {
-                CUMO_GET_DATA_INDEX(p1,idx1,dtype,x);
-                y = m_<%=name%>(x);
-                CUMO_SET_DATA_INDEX(p2,idx2,<%=dtype%>,y);
+    <% if type_name == 'robject' %>
+    {
+        dtype   x;
+        <%=dtype%> y;
+        CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
+        if (idx1) {
+            if (idx2) {
+                for (; i--;) {
+                    CUMO_GET_DATA_INDEX(p1,idx1,dtype,x);
+                    y = m_<%=name%>(x);
+                    CUMO_SET_DATA_INDEX(p2,idx2,<%=dtype%>,y);
+                }
+            } else {
+                for (; i--;) {
+                    CUMO_GET_DATA_INDEX(p1,idx1,dtype,x);
+                    y = m_<%=name%>(x);
+                    CUMO_SET_DATA_STRIDE(p2,s2,<%=dtype%>,y);
+                }
             }
         } else {
-            for (; i--;) {
-                CUMO_GET_DATA_INDEX(p1,idx1,dtype,x);
-                y = m_<%=name%>(x);
-                CUMO_SET_DATA_STRIDE(p2,s2,<%=dtype%>,y);
+            if (idx2) {
+                for (; i--;) {
+                    CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
+                    y = m_<%=name%>(x);
+                    CUMO_SET_DATA_INDEX(p2,idx2,<%=dtype%>,y);
+                }
+            } else {
+                for (; i--;) {
+                    CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
+                    y = m_<%=name%>(x);
+                    CUMO_SET_DATA_STRIDE(p2,s2,<%=dtype%>,y);
+                }
             }
         }
+    }
+    <% else %>
+    if (idx1) {
+        if (idx2) {
+            <%="cumo_#{c_iter}_index_index_kernel_launch"%>(p1,p2,idx1,idx2,i);
+        } else {
+            <%="cumo_#{c_iter}_index_stride_kernel_launch"%>(p1,p2,idx1,s2,i);
+        }
     } else {
         if (idx2) {
-            for (; i--;) {
-                CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
-                y = m_<%=name%>(x);
-                CUMO_SET_DATA_INDEX(p2,idx2,<%=dtype%>,y);
-            }
+            <%="cumo_#{c_iter}_stride_index_kernel_launch"%>(p1,p2,s1,idx2,i);
         } else {
-            for (; i--;) {
-                CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
-                y = m_<%=name%>(x);
-                CUMO_SET_DATA_STRIDE(p2,s2,<%=dtype%>,y);
-            }
+            <%="cumo_#{c_iter}_stride_stride_kernel_launch"%>(p1,p2,s1,s2,i);
         }
     }
+    <% end %>
 }
 
-
 /*
   <%=name%> of self.
   @overload <%=name%>
@@ -9,7 +9,6 @@ static void
     CUMO_INIT_PTR(lp, 0, p1, s1);
     CUMO_INIT_PTR(lp, 1, p2, s2);
     CUMO_INIT_PTR(lp, 2, p3, s3);
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
     for (; i--;) {
         CUMO_GET_DATA_STRIDE(p1,s1,dtype,x);
         m_<%=name%>(x,y,z);
@@ -28,7 +27,8 @@ static VALUE
 {
     cumo_ndfunc_arg_in_t ain[1] = {{cT,0}};
     cumo_ndfunc_arg_out_t aout[2] = {{cT,0},{cT,0}};
-    cumo_ndfunc_t ndf = {<%=c_iter%>, CUMO_STRIDE_LOOP, 1,2, ain,aout};
+    cumo_ndfunc_t ndf = {<%=c_iter%>, CUMO_STRIDE_LOOP|CUMO_NDF_PARALLEL, 1,2, ain,aout};
 
+    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
     return cumo_na_ndloop(&ndf, 1, self);
 }
@@ -19,7 +19,7 @@ static void
     <% if type_name == 'robject' %>
     {
         dtype x;
-        CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
+        CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
         if (idx1) {
             if (idx2) {
                 for (; i--;) {
@@ -23,6 +23,25 @@ __global__ void <%="cumo_#{c_iter}_stride_kernel"%>(size_t p1, char* p2, CUMO_BI
     }
 }
 
+// Each thread counts whole words with popcount and adds its count once.
+__global__ void <%="cumo_#{c_iter}_word_kernel"%>(size_t p1, char* p2, CUMO_BIT_DIGIT *a1, uint64_t n, uint64_t n_words)
+{
+    int_t count = 0;
+    for (uint64_t k = blockIdx.x * blockDim.x + threadIdx.x; k < n_words; k += blockDim.x * gridDim.x) {
+        size_t e = k * CUMO_NB;
+        size_t len = (n - e < CUMO_NB) ? n - e : CUMO_NB;
+        CUMO_BIT_DIGIT x = cumo_bit_load_word(a1, p1 + e, len) & CUMO_SLB(len);
+<% if name =~ /false/ %>
+        count += len - __popc(x);
+<% else %>
+        count += __popc(x);
+<% end %>
+    }
+    if (count > 0) {
+        atomicAdd((int_t*)p2, count);
+    }
+}
+
 __global__ void <%="cumo_#{c_iter}_index_stride_kernel"%>(size_t p1, char* p2, CUMO_BIT_DIGIT *a1, size_t *idx1, ssize_t s2, uint64_t n)
 {
     for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
@@ -49,28 +68,35 @@ void <%="cumo_#{c_iter}_index_kernel_launch"%>(size_t p1, char *p2, CUMO_BIT_DIG
 {
     size_t grid_dim = cumo_get_grid_dim(n);
     size_t block_dim = cumo_get_block_dim(n);
-    <%="cumo_#{c_iter}_index_kernel"%><<<grid_dim, block_dim>>>(p1,p2,a1,idx1,n);
+    <%="cumo_#{c_iter}_index_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,p2,a1,idx1,n);
 }
 
 void <%="cumo_#{c_iter}_stride_kernel_launch"%>(size_t p1, char *p2, CUMO_BIT_DIGIT *a1, ssize_t s1, uint64_t n)
 {
-    size_t grid_dim = cumo_get_grid_dim(n);
-    size_t block_dim = cumo_get_block_dim(n);
-    <%="cumo_#{c_iter}_stride_kernel"%><<<grid_dim, block_dim>>>(p1,p2,a1,s1,n);
+    if (s1 == 1) {
+        uint64_t n_words = (n + CUMO_NB - 1) / CUMO_NB;
+        size_t grid_dim = cumo_get_grid_dim(n_words);
+        size_t block_dim = cumo_get_block_dim(n_words);
+        <%="cumo_#{c_iter}_word_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,p2,a1,n,n_words);
+    } else {
+        size_t grid_dim = cumo_get_grid_dim(n);
+        size_t block_dim = cumo_get_block_dim(n);
+        <%="cumo_#{c_iter}_stride_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,p2,a1,s1,n);
+    }
 }
 
 void <%="cumo_#{c_iter}_index_stride_kernel_launch"%>(size_t p1, char *p2, CUMO_BIT_DIGIT *a1, size_t *idx1, ssize_t s2, uint64_t n)
 {
     size_t grid_dim = cumo_get_grid_dim(n);
     size_t block_dim = cumo_get_block_dim(n);
-    <%="cumo_#{c_iter}_index_stride_kernel"%><<<grid_dim, block_dim>>>(p1,p2,a1,idx1,s2,n);
+    <%="cumo_#{c_iter}_index_stride_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,p2,a1,idx1,s2,n);
 }
 
 void <%="cumo_#{c_iter}_stride_stride_kernel_launch"%>(size_t p1, char *p2, CUMO_BIT_DIGIT *a1, ssize_t s1, ssize_t s2, uint64_t n)
 {
     size_t grid_dim = cumo_get_grid_dim(n);
     size_t block_dim = cumo_get_block_dim(n);
-    <%="cumo_#{c_iter}_stride_stride_kernel"%><<<grid_dim, block_dim>>>(p1,p2,a1,s1,s2,n);
+    <%="cumo_#{c_iter}_stride_stride_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,p2,a1,s1,s2,n);
 }
 
 #undef int_t
@@ -0,0 +1,40 @@
+// Thread k tests word k of the input, and stores the result bit only if
+// some bit of the word is not <%=init_bit%>.
+__global__ void <%="cumo_#{c_iter}_word_kernel"%>(const CUMO_BIT_DIGIT *a1, size_t p1, CUMO_BIT_DIGIT *a2, size_t p2, uint64_t n, uint64_t n_words)
+{
+    for (uint64_t k = blockIdx.x * blockDim.x + threadIdx.x; k < n_words; k += blockDim.x * gridDim.x) {
+        size_t e = k * CUMO_NB;
+        size_t len = (n - e < CUMO_NB) ? n - e : CUMO_NB;
+        CUMO_BIT_DIGIT x = cumo_bit_load_word(a1, p1 + e, len) & CUMO_SLB(len);
+        if (x != <%= init_bit == 0 ? "0" : "CUMO_SLB(len)" %>) {
+            CUMO_STORE_BIT(a2, p2, <%=1-init_bit%>u);
+        }
+    }
+}
+
+__global__ void <%="cumo_#{c_iter}_step_kernel"%>(const CUMO_BIT_DIGIT *a1, size_t p1, ssize_t s1, const size_t *idx1, CUMO_BIT_DIGIT *a2, size_t p2, ssize_t s2, const size_t *idx2, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        CUMO_BIT_DIGIT x = cumo_bit_load_step(a1, p1, s1, idx1, i);
+        if (x != <%=init_bit%>) {
+            cumo_bit_store_step(a2, p2, s2, idx2, i, x);
+        }
+    }
+}
+
+void <%="cumo_#{c_iter}_kernel_launch"%>(CUMO_BIT_DIGIT *a1, size_t p1, ssize_t s1, size_t *idx1, CUMO_BIT_DIGIT *a2, size_t p2, ssize_t s2, size_t *idx2, uint64_t n)
+{
+    if (n == 0) {
+        return;
+    }
+    if (s1 == 1 && !idx1 && s2 == 0 && !idx2) {
+        uint64_t n_words = (n + CUMO_NB - 1) / CUMO_NB;
+        size_t grid_dim = cumo_get_grid_dim(n_words);
+        size_t block_dim = cumo_get_block_dim(n_words);
+        <%="cumo_#{c_iter}_word_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(a1,p1,a2,p2,n,n_words);
+    } else {
+        size_t grid_dim = cumo_get_grid_dim(n);
+        size_t block_dim = cumo_get_block_dim(n);
+        <%="cumo_#{c_iter}_step_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(a1,p1,s1,idx1,a2,p2,s2,idx2,n);
+    }
+}
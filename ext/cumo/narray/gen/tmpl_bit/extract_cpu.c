@@ -18,8 +18,7 @@ static VALUE
         pos = cumo_na_get_offset(self);
         ptr = (CUMO_BIT_DIGIT*)cumo_na_get_pointer_for_read(self);
 
-        CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-        cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+        CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
 
         val = ((*((ptr)+(pos)/CUMO_NB)) >> ((pos)%CUMO_NB)) & 1u;
         cumo_na_release_lock(self);
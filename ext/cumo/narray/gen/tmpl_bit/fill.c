@@ -11,8 +11,7 @@ static void
     VALUE x = lp->option;
 
     // TODO(sonots): CUDA kernelize
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
 
     if (x==INT2FIX(0) || x==Qfalse) {
         y = 0;
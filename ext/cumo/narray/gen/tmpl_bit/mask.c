@@ -10,8 +10,7 @@ static void
     size_t  count;
     where_opt_t *g;
 
-    CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
 
     g = (where_opt_t*)(lp->opt_ptr);
     count = g->count;
@@ -72,14 +71,91 @@ static void
     g->idx1  = (char*)pidx;
 }
 
+void <%="cumo_#{type_name}_mask_offset_kernel_launch"%>(size_t *idx, uint64_t n, cumo_na_indexer_t *indexer, cumo_na_iarray_t *iarray);
+
+/*
+  Returns true if val has the shape of mask and is addressed by strides
+  only, so that flat indices of mask can be mapped to offsets of val on the
+  device. Broadcasted and index-array views are masked on the host.
+*/
+static int
+<%=c_iter%>_strided_p(VALUE mask, VALUE val, cumo_na_indexer_t *indexer, cumo_na_iarray_t *iarray)
+{
+    cumo_narray_t *na;
+    cumo_narray_view_t *nv;
+    ssize_t stride;
+    int i, ndim;
+
+    if (!CumoIsNArray(val)) {
+        return 0;
+    }
+    CumoGetNArray(val, na);
+    ndim = CUMO_NA_NDIM(na);
+    if (ndim != CUMO_RNARRAY_NDIM(mask) || ndim > CUMO_NA_MAX_DIMENSION) {
+        return 0;
+    }
+    for (i = 0; i < ndim; i++) {
+        if (CUMO_NA_SHAPE(na)[i] != CUMO_RNARRAY_SHAPE(mask)[i]) {
+            return 0;
+        }
+        indexer->shape[i] = CUMO_NA_SHAPE(na)[i];
+    }
+    indexer->ndim = ndim;
+    indexer->total_size = CUMO_NA_SIZE(na);
+
+    switch(CUMO_NA_TYPE(na)) {
+    case CUMO_NARRAY_DATA_T:
+        iarray->ptr = NULL;
+        stride = cumo_na_element_stride(val);
+        for (i = ndim; i-- > 0;) {
+            iarray->step[i] = stride;
+            stride *= indexer->shape[i];
+        }
+        return 1;
+    case CUMO_NARRAY_VIEW_T:
+        CumoGetNArrayView(val, nv);
+        for (i = 0; i < ndim; i++) {
+            if (CUMO_SDX_IS_INDEX(nv->stridx[i])) {
+                return 0;
+            }
+            iarray->step[i] = CUMO_SDX_GET_STRIDE(nv->stridx[i]);
+        }
+        iarray->ptr = (char*)nv->offset;
+        return 1;
+    }
+    return 0;
+}
+
 #if   SIZEOF_VOIDP == 8
 #define cIndex cumo_cInt64
 #elif SIZEOF_VOIDP == 4
 #define cIndex cumo_cInt32
 #endif
 
+typedef struct {
+    cumo_na_indexer_t *indexer;
+    cumo_na_iarray_t  *iarray;
+} <%=c_iter%>_offset_t;
+
+static VALUE
+<%=c_iter%>_compact(where_compact_t *c)
+{
+    <%=c_iter%>_offset_t *o = (<%=c_iter%>_offset_t*)c->data;
+    VALUE idx_1;
+    size_t *idx;
+
+    idx_1 = cumo_na_new(cIndex, 1, &c->n_1);
+    idx = (size_t*)cumo_na_get_pointer_for_write(idx_1);
+    <%=type_name%>_where_compact_scatter(c, (char*)idx, NULL, SIZEOF_VOIDP);
+    <%="cumo_#{type_name}_mask_offset_kernel_launch"%>(idx, c->n_1, o->indexer, o->iarray);
+    return idx_1;
+}
+
 /*
   Return subarray of argument masked with self bit array.
+  If array has the shape of self and is not indexed by an index array,
+  the view is computed on the device. Otherwise the mask is broadcasted
+  to array on the host.
   @overload <%=op_map%>(array)
   @param [Cumo::NArray] array  narray to be masked.
   @return [Cumo::NArray]  view of masked array.
@@ -95,17 +171,26 @@ static VALUE
     cumo_stridx_t stridx0;
     size_t n_1;
     where_opt_t g;
+    where_compact_t c;
+    cumo_na_indexer_t indexer;
+    cumo_na_iarray_t iarray;
     cumo_ndfunc_arg_in_t ain[2] = {{cT,0},{Qnil,0}};
     cumo_ndfunc_t ndf = {<%=c_iter%>, CUMO_FULL_LOOP, 2, 0, ain, 0};
 
-    // TODO(sonots): bit_count_true synchronizes with CPU. Avoid.
-    n_1 = NUM2SIZET(<%=find_tmpl("count_true_cpu").c_func%>(0, NULL, mask));
-    idx_1 = cumo_na_new(cIndex, 1, &n_1);
-    g.count = 0;
-    g.elmsz = SIZEOF_VOIDP;
-    g.idx1 = cumo_na_get_pointer_for_write(idx_1);
-    g.idx0 = NULL;
-    cumo_na_ndloop3(&ndf, &g, 2, mask, val);
+    if (<%=c_iter%>_strided_p(mask, val, &indexer, &iarray)) {
+        <%=c_iter%>_offset_t o = {&indexer, &iarray};
+
+        idx_1 = <%=type_name%>_where_compact(&c, mask, <%=c_iter%>_compact, &o);
+        n_1 = c.n_1;
+    } else {
+        n_1 = NUM2SIZET(<%=find_tmpl("count_true_cpu").c_func%>(0, NULL, mask));
+        idx_1 = cumo_na_new(cIndex, 1, &n_1);
+        g.count = 0;
+        g.elmsz = SIZEOF_VOIDP;
+        g.idx1 = cumo_na_get_pointer_for_write(idx_1);
+        g.idx0 = NULL;
+        cumo_na_ndloop3(&ndf, &g, 2, mask, val);
+    }
 
     view = cumo_na_s_allocate_view(rb_obj_class(val));
     CumoGetNArrayView(view, nv);
@@ -0,0 +1,36 @@
+#if defined(__cplusplus)
+#if 0
+{ /* satisfy cc-mode */
+#endif
+}  /* extern "C" { */
+#endif
+
+// Converts flat indices of the masked array into byte offsets of its data.
+__global__ void <%="cumo_#{type_name}_mask_offset_kernel"%>(size_t *idx, uint64_t n, cumo_na_indexer_t indexer, cumo_na_iarray_t iarray)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        uint64_t flat = idx[i];
+        ssize_t offset = (ssize_t)iarray.ptr;
+        for (int d = indexer.ndim; d-- > 0;) {
+            offset += (ssize_t)(flat % indexer.shape[d]) * iarray.step[d];
+            flat /= indexer.shape[d];
+        }
+        idx[i] = (size_t)offset;
+    }
+}
+
+#if defined(__cplusplus)
+extern "C" {
+#if 0
+} /* satisfy cc-mode */
+#endif
+#endif
+
+void <%="cumo_#{type_name}_mask_offset_kernel_launch"%>(size_t *idx, uint64_t n, cumo_na_indexer_t *indexer, cumo_na_iarray_t *iarray)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    if (n > 0) {
+        <%="cumo_#{type_name}_mask_offset_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(idx, n, *indexer, *iarray);
+    }
+}
@@ -0,0 +1,61 @@
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(size_t p1, CUMO_BIT_DIGIT *a1, size_t *idx1, uint64_t threshold, cumo_philox_state_t st, uint64_t n);
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(size_t p1, CUMO_BIT_DIGIT *a1, ssize_t s1, uint64_t threshold, cumo_philox_state_t st, uint64_t n);
+void <%="cumo_#{c_iter}_contiguous_kernel_launch"%>(size_t p1, CUMO_BIT_DIGIT *a1, uint64_t threshold, cumo_philox_state_t st, uint64_t n);
+
+static void
+<%=c_iter%>(cumo_na_loop_t *const lp)
+{
+    size_t  n;
+    size_t  p1;
+    ssize_t s1;
+    size_t *idx1;
+    CUMO_BIT_DIGIT *a1;
+    uint64_t threshold;
+    cumo_philox_state_t st;
+
+    CUMO_INIT_COUNTER(lp, n);
+    CUMO_INIT_PTR_BIT_IDX(lp, 0, a1, p1, s1, idx1);
+    threshold = *(uint64_t*)(lp->opt_ptr);
+    // 4 elements share a counter
+    st = cumo_na_rand_reserve((n + 3) / 4);
+
+    if (idx1) {
+        <%="cumo_#{c_iter}_index_kernel_launch"%>(p1,a1,idx1,threshold,st,n);
+    } else if (s1 != 1) {
+        <%="cumo_#{c_iter}_stride_kernel_launch"%>(p1,a1,s1,threshold,st,n);
+    } else {
+        <%="cumo_#{c_iter}_contiguous_kernel_launch"%>(p1,a1,threshold,st,n);
+    }
+}
+
+/*
+  Fills self with 1 (true) with probability p and 0 (false) otherwise,
+  e.g., to make dropout masks. A contiguous Bit array is filled a word
+  per thread without atomics.
+  The same seed gives the same values as rand_bernoulli of numeric types.
+  @overload rand_bernoulli([p])
+  @param [Numeric] p  probability of 1. (default=0.5)
+  @return [Cumo::Bit] self.
+  @example
+    Cumo::Bit.new(8).rand_bernoulli(0.9)
+    => Cumo::Bit#shape=[8]
+       [1, 1, 1, 0, 1, 1, 1, 1]
+*/
+static VALUE
+<%=c_func(-1)%>(int argc, VALUE *args, VALUE self)
+{
+    VALUE v1=Qnil;
+    double p;
+    uint64_t threshold;
+    cumo_ndfunc_arg_in_t ain[1] = {{CUMO_OVERWRITE,0}};
+    cumo_ndfunc_t ndf = {<%=c_iter%>, CUMO_FULL_LOOP, 1,0, ain,0};
+
+    rb_scan_args(argc, args, "01", &v1);
+    p = (v1 == Qnil) ? 0.5 : NUM2DBL(v1);
+    if (!(p >= 0 && p <= 1)) {
+        rb_raise(rb_eArgError, "p must be in [0,1]");
+    }
+    threshold = cumo_philox_bernoulli_threshold(p);
+    cumo_na_ndloop3(&ndf, &threshold, 1, self);
+    return self;
+}
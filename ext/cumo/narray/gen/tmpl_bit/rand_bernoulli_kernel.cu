@@ -0,0 +1,66 @@
+__global__ void <%="cumo_#{c_iter}_index_kernel"%>(size_t p1, CUMO_BIT_DIGIT *a1, size_t *idx1, uint64_t threshold, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        CUMO_BIT_DIGIT x = cumo_philox_bernoulli(st, i, threshold);
+        CUMO_STORE_BIT(a1, p1 + idx1[i], x);
+    }
+}
+
+__global__ void <%="cumo_#{c_iter}_stride_kernel"%>(size_t p1, CUMO_BIT_DIGIT *a1, ssize_t s1, uint64_t threshold, cumo_philox_state_t st, uint64_t n)
+{
+    for (uint64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+        CUMO_BIT_DIGIT x = cumo_philox_bernoulli(st, i, threshold);
+        CUMO_STORE_BIT(a1, p1 + i * s1, x);
+    }
+}
+
+// Thread d builds the d-th word from up to CUMO_NB elements. Only the thread
+// owning a word writes it, so partial words at both ends need no atomics.
+__global__ void <%="cumo_#{c_iter}_contiguous_kernel"%>(size_t p1, CUMO_BIT_DIGIT *a1, uint64_t threshold, cumo_philox_state_t st, uint64_t n_digits, uint64_t n)
+{
+    for (uint64_t d = blockIdx.x * blockDim.x + threadIdx.x; d < n_digits; d += blockDim.x * gridDim.x) {
+        CUMO_BIT_DIGIT y = 0;
+        CUMO_BIT_DIGIT mask = 0;
+        uint32_t w[4];
+        uint64_t counter = ~(uint64_t)0;
+        for (int b = 0; b < (int)CUMO_NB; ++b) {
+            int64_t j = (int64_t)(d * CUMO_NB + b) - (int64_t)p1;
+            if (j < 0 || (uint64_t)j >= n) continue;
+            if ((uint64_t)j / 4 != counter) {
+                counter = (uint64_t)j / 4;
+                cumo_philox_generate(st, counter, 0, w);
+            }
+            mask |= (CUMO_BIT_DIGIT)1 << b;
+            if ((uint64_t)w[j % 4] < threshold) {
+                y |= (CUMO_BIT_DIGIT)1 << b;
+            }
+        }
+        if (mask == CUMO_BALL) {
+            a1[d] = y;
+        } else {
+            a1[d] = (a1[d] & ~mask) | y;
+        }
+    }
+}
+
+void <%="cumo_#{c_iter}_index_kernel_launch"%>(size_t p1, CUMO_BIT_DIGIT *a1, size_t *idx1, uint64_t threshold, cumo_philox_state_t st, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_index_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,a1,idx1,threshold,st,n);
+}
+
+void <%="cumo_#{c_iter}_stride_kernel_launch"%>(size_t p1, CUMO_BIT_DIGIT *a1, ssize_t s1, uint64_t threshold, cumo_philox_state_t st, uint64_t n)
+{
+    size_t grid_dim = cumo_get_grid_dim(n);
+    size_t block_dim = cumo_get_block_dim(n);
+    <%="cumo_#{c_iter}_stride_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,a1,s1,threshold,st,n);
+}
+
+void <%="cumo_#{c_iter}_contiguous_kernel_launch"%>(size_t p1, CUMO_BIT_DIGIT *a1, uint64_t threshold, cumo_philox_state_t st, uint64_t n)
+{
+    uint64_t n_digits = (p1 + n + CUMO_NB - 1) / CUMO_NB;
+    size_t grid_dim = cumo_get_grid_dim(n_digits);
+    size_t block_dim = cumo_get_block_dim(n_digits);
+    <%="cumo_#{c_iter}_contiguous_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(p1,a1,threshold,st,n_digits,n);
+}
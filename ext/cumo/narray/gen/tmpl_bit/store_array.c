@@ -14,8 +14,7 @@ static void
     double beg, step;
 
     // TODO(sonots): CUDA kernelize
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    CUMO_SYNCHRONIZE_FIXME("<%=name%>", "<%=type_name%>");
 
     CUMO_INIT_COUNTER(lp, n);
     CUMO_INIT_PTR_BIT_IDX(lp, 0, a1, p1, s1, idx1);
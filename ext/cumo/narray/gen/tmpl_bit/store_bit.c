@@ -1,3 +1,62 @@
+typedef struct {
+    CUMO_BIT_DIGIT *a1, *a3;
+    size_t  p1, p3;
+} <%=c_iter%>_words_t;
+
+// Word-aligned host loop over elements [begin, end).
+static void
+<%=c_iter%>_words(size_t begin, size_t end, void *data)
+{
+    <%=c_iter%>_words_t *w = (<%=c_iter%>_words_t*)data;
+    size_t  n = end - begin;
+    size_t  p1 = w->p1 + begin;
+    size_t  p3 = w->p3 + begin;
+    int     o1, l1, r1, len;
+    CUMO_BIT_DIGIT *a1 = w->a1 + p1/CUMO_NB;
+    CUMO_BIT_DIGIT *a3 = w->a3 + p3/CUMO_NB;
+    CUMO_BIT_DIGIT  x;
+
+    p1 %= CUMO_NB;
+    p3 %= CUMO_NB;
+    o1 =  p1 % CUMO_NB;
+    o1 -= p3;
+    l1 =  CUMO_NB+o1;
+    r1 =  CUMO_NB-o1;
+    if (p3>0 || n<CUMO_NB) {
+        len = CUMO_NB - p3;
+        if ((int)n<len) len=n;
+        if (o1>=0) x = *a1>>o1;
+        else       x = *a1<<-o1;
+        if (p1+len>CUMO_NB)  x |= *(a1+1)<<r1;
+        a1++;
+        *a3 = (x & (CUMO_SLB(len)<<p3)) | (*a3 & ~(CUMO_SLB(len)<<p3));
+        a3++;
+        n -= len;
+    }
+    if (o1==0) {
+        for (; n>=CUMO_NB; n-=CUMO_NB) {
+            x = *(a1++);
+            *(a3++) = x;
+        }
+    } else {
+        for (; n>=CUMO_NB; n-=CUMO_NB) {
+            x = (o1>=0) ? *a1>>o1 : *a1<<-o1;
+            if (o1<0)  x |= *(a1-1)>>l1;
+            if (o1>0)  x |= *(a1+1)<<r1;
+            a1++;
+            *(a3++) = x;
+        }
+    }
+    if (n>0) {
+        x = (o1>=0) ? *a1>>o1 : *a1<<-o1;
+        if (o1<0)  x |= *(a1-1)>>l1;
+        if (o1>0 && (int)n>r1)  x |= *(a1+1)<<r1;
+        *a3 = (x & CUMO_SLB(n)) | (*a3 & CUMO_BALL<<n);
+    }
+}
+
+void <%="cumo_#{c_iter}_kernel_launch"%>(CUMO_BIT_DIGIT *a1, size_t p1, ssize_t s1, size_t *idx1, CUMO_BIT_DIGIT *a3, size_t p3, ssize_t s3, size_t *idx3, uint64_t n);
+
 static void
 <%=c_iter%>(cumo_na_loop_t *const lp)
 {
@@ -5,57 +64,27 @@ static void
     size_t  p1, p3;
     ssize_t s1, s3;
     size_t *idx1, *idx3;
-    int     o1, l1, r1, len;
     CUMO_BIT_DIGIT *a1, *a3;
     CUMO_BIT_DIGIT  x;
 
-    // TODO(sonots): CUDA kernelize
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
-
     CUMO_INIT_COUNTER(lp, n);
     CUMO_INIT_PTR_BIT_IDX(lp, 0, a3, p3, s3, idx3);
     CUMO_INIT_PTR_BIT_IDX(lp, 1, a1, p1, s1, idx1);
+
+    if (!cumo_compatible_mode_enabled_p()) {
+        <%="cumo_#{c_iter}_kernel_launch"%>(a1,p1,s1,idx1,a3,p3,s3,idx3,n);
+        return;
+    }
+
+    CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
     if (s1!=1 || s3!=1 || idx1 || idx3) {
         for (; n--;) {
             CUMO_LOAD_BIT_STEP(a1, p1, s1, idx1, x);
             CUMO_STORE_BIT_STEP(a3, p3, s3, idx3, x);
         }
     } else {
-        o1 =  p1 % CUMO_NB;
-        o1 -= p3;
-        l1 =  CUMO_NB+o1;
-        r1 =  CUMO_NB-o1;
-        if (p3>0 || n<CUMO_NB) {
-            len = CUMO_NB - p3;
-            if ((int)n<len) len=n;
-            if (o1>=0) x = *a1>>o1;
-            else       x = *a1<<-o1;
-            if (p1+len>CUMO_NB)  x |= *(a1+1)<<r1;
-            a1++;
-            *a3 = (x & (CUMO_SLB(len)<<p3)) | (*a3 & ~(CUMO_SLB(len)<<p3));
-            a3++;
-            n -= len;
-        }
-        if (o1==0) {
-            for (; n>=CUMO_NB; n-=CUMO_NB) {
-                x = *(a1++);
-                *(a3++) = x;
-            }
-        } else {
-            for (; n>=CUMO_NB; n-=CUMO_NB) {
-                x = *a1>>o1;
-                if (o1<0)  x |= *(a1-1)>>l1;
-                if (o1>0)  x |= *(a1+1)<<r1;
-                a1++;
-                *(a3++) = x;
-            }
-        }
-        if (n>0) {
-            x = *a1>>o1;
-            if (o1<0)  x |= *(a1-1)>>l1;
-            *a3 = (x & CUMO_SLB(n)) | (*a3 & CUMO_BALL<<n);
-        }
+        <%=c_iter%>_words_t w = {a1, a3, p1, p3};
+        cumo_bit_word_parallel(p3, n, <%=c_iter%>_words, &w);
     }
 }
 
@@ -0,0 +1,22 @@
+#if defined(__cplusplus)
+#if 0
+{ /* satisfy cc-mode */
+#endif
+}  /* extern "C" { */
+#endif
+
+struct <%="cumo_#{c_iter}_op"%> {
+    __device__ CUMO_BIT_DIGIT operator()(CUMO_BIT_DIGIT x, CUMO_BIT_DIGIT /*y*/) const { return m_copy(x); }
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#if 0
+} /* satisfy cc-mode */
+#endif
+#endif
+
+void <%="cumo_#{c_iter}_kernel_launch"%>(CUMO_BIT_DIGIT *a1, size_t p1, ssize_t s1, size_t *idx1, CUMO_BIT_DIGIT *a3, size_t p3, ssize_t s3, size_t *idx3, uint64_t n)
+{
+    cumo_bit_map_launch(<%="cumo_#{c_iter}_op"%>(), a1,p1,s1,idx1,NULL,0,0,NULL,a3,p3,s3,idx3,n);
+}
@@ -5,55 +5,103 @@ typedef struct {
     size_t elmsz;
 } where_opt_t;
 
-#define STORE_INT(ptr, esz, x) memcpy(ptr,&(x),esz)
+/*
+  Stream compaction of a bit array shared by where, where2 and mask.
+  Counts one-bits per word and scans the counts on the device. Reading the
+  last offset back is the only synchronization with the host.
+*/
+typedef struct where_compact where_compact_t;
+struct where_compact {
+    volatile VALUE bits;    // self, or its contiguous copy
+    CUMO_BIT_DIGIT *a;
+    size_t    size;
+    uint64_t *offsets;      // inclusive scan of one-bits per word
+    size_t    n_1;
+    VALUE   (*func)(where_compact_t *c); // allocates and scatters the result
+    void     *data;         // argument of func
+};
+
+void <%="cumo_#{type_name}_where_count_kernel_launch"%>(CUMO_BIT_DIGIT *a, uint64_t n, uint64_t *offsets);
+void <%="cumo_#{type_name}_where_scatter_kernel_launch"%>(CUMO_BIT_DIGIT *a, uint64_t n, const uint64_t *offsets, char *idx1, char *idx0, size_t elmsz);
+
+static VALUE
+<%=type_name%>_where_compact_body(VALUE arg)
+{
+    where_compact_t *c = (where_compact_t*)arg;
+    uint64_t n_1 = 0;
+    size_t nwords;
+
+    if (CUMO_RNARRAY_TYPE(c->bits) != CUMO_NARRAY_DATA_T) {
+        c->bits = <%=find_tmpl("copy").c_func%>(c->bits);
+    }
+    c->size = CUMO_RNARRAY_SIZE(c->bits);
+    c->a = (CUMO_BIT_DIGIT*)cumo_na_get_pointer_for_read(c->bits);
+    if (c->size > 0) {
+        nwords = (c->size + CUMO_NB - 1) / CUMO_NB;
+        c->offsets = (uint64_t*)cumo_cuda_runtime_malloc(sizeof(uint64_t)*nwords);
+        <%="cumo_#{type_name}_where_count_kernel_launch"%>(c->a, c->size, c->offsets);
+        cumo_cuda_runtime_check_status(cudaMemcpyAsync(&n_1,c->offsets+nwords-1,sizeof(uint64_t),cudaMemcpyDeviceToHost,cumo_cuda_stream_current()));
+        CUMO_SYNCHRONIZE("<%=name%>", "<%=type_name%>");
+    }
+    c->n_1 = n_1;
+    return c->func(c);
+}
+
+static VALUE
+<%=type_name%>_where_compact_release(VALUE arg)
+{
+    where_compact_t *c = (where_compact_t*)arg;
+
+    RB_GC_GUARD(c->bits);
+    if (c->offsets) {
+        cumo_cuda_runtime_free((char*)c->offsets);
+        c->offsets = NULL;
+    }
+    return Qnil;
+}
+
+/*
+  Counts one-bits of self and returns func(c), which allocates the result
+  for c->n_1 elements and calls where_compact_scatter. The offsets are
+  freed even if func raises.
+*/
+static VALUE
+<%=type_name%>_where_compact(where_compact_t *c, VALUE self, VALUE (*func)(where_compact_t *c), void *data)
+{
+    c->bits = self;
+    c->a = NULL;
+    c->size = 0;
+    c->offsets = NULL;
+    c->n_1 = 0;
+    c->func = func;
+    c->data = data;
+    return rb_ensure(<%=type_name%>_where_compact_body, (VALUE)c, <%=type_name%>_where_compact_release, (VALUE)c);
+}
 
 static void
-<%=c_iter%>(cumo_na_loop_t *const lp)
+<%=type_name%>_where_compact_scatter(where_compact_t *c, char *idx1, char *idx0, size_t elmsz)
 {
-    size_t  i;
-    CUMO_BIT_DIGIT *a;
-    size_t  p;
-    ssize_t s;
-    size_t *idx;
-    CUMO_BIT_DIGIT x=0;
-    char   *idx1;
-    size_t  count;
-    size_t  e;
-    where_opt_t *g;
+    if (c->size > 0) {
+        <%="cumo_#{type_name}_where_scatter_kernel_launch"%>(c->a, c->size, c->offsets, idx1, idx0, elmsz);
+    }
+}
 
-    // TODO(sonots): CUDA kernelize
-    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("<%=name%>", "<%=type_name%>");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+static VALUE
+<%=c_iter%>_compact(where_compact_t *c)
+{
+    volatile VALUE idx_1;
+    size_t elmsz;
 
-    g = (where_opt_t*)(lp->opt_ptr);
-    count = g->count;
-    idx1  = g->idx1;
-    e     = g->elmsz;
-    CUMO_INIT_COUNTER(lp, i);
-    CUMO_INIT_PTR_BIT_IDX(lp, 0, a, p, s, idx);
-    if (idx) {
-        for (; i--;) {
-            CUMO_LOAD_BIT(a, p+*idx, x);
-            idx++;
-            if (x!=0) {
-                STORE_INT(idx1,e,count);
-                idx1 += e;
-            }
-            count++;
-        }
+    if (c->size>4294967295ul) {
+        idx_1 = cumo_na_new(cumo_cInt64, 1, &c->n_1);
+        elmsz = 8;
     } else {
-        for (; i--;) {
-            CUMO_LOAD_BIT(a, p, x);
-            p+=s;
-            if (x!=0) {
-                STORE_INT(idx1,e,count);
-                idx1 += e;
-            }
-            count++;
-        }
+        idx_1 = cumo_na_new(cumo_cInt32, 1, &c->n_1);
+        elmsz = 4;
     }
-    g->count = count;
-    g->idx1  = idx1;
+    <%=type_name%>_where_compact_scatter(c, cumo_na_get_pointer_for_write(idx_1), NULL, elmsz);
+    cumo_na_release_lock(idx_1);
+    return idx_1;
 }
 
 /*
@@ -64,27 +112,7 @@ static void
 static VALUE
 <%=c_func(0)%>(VALUE self)
 {
-    volatile VALUE idx_1;
-    size_t size, n_1;
-    where_opt_t *g;
-
-    cumo_ndfunc_arg_in_t ain[1] = {{cT,0}};
-    cumo_ndfunc_t ndf = { <%=c_iter%>, CUMO_FULL_LOOP, 1, 0, ain, 0 };
+    where_compact_t c;
 
-    size = CUMO_RNARRAY_SIZE(self);
-    n_1 = NUM2SIZET(<%=find_tmpl("count_true_cpu").c_func%>(0, NULL, self));
-    g = ALLOCA_N(where_opt_t,1);
-    g->count = 0;
-    if (size>4294967295ul) {
-        idx_1 = cumo_na_new(cumo_cInt64, 1, &n_1);
-        g->elmsz = 8;
-    } else {
-        idx_1 = cumo_na_new(cumo_cInt32, 1, &n_1);
-        g->elmsz = 4;
-    }
-    g->idx1 = cumo_na_get_pointer_for_write(idx_1);
-    g->idx0 = NULL;
-    cumo_na_ndloop3(&ndf, g, 1, self);
-    cumo_na_release_lock(idx_1);
-    return idx_1;
+    return <%=type_name%>_where_compact(&c, self, <%=c_iter%>_compact, NULL);
 }
@@ -0,0 +1,76 @@
+#if defined(__cplusplus)
+#if 0
+{ /* satisfy cc-mode */
+#endif
+}  /* extern "C" { */
+#endif
+
+// Number of one-bits of each CUMO_BIT_DIGIT word, ignoring bits past n.
+__global__ void <%="cumo_#{type_name}_where_count_kernel"%>(CUMO_BIT_DIGIT *a, uint64_t n, uint64_t nwords, uint64_t *counts)
+{
+    for (uint64_t w = blockIdx.x * blockDim.x + threadIdx.x; w < nwords; w += blockDim.x * gridDim.x) {
+        CUMO_BIT_DIGIT x = a[w];
+        if ((w + 1) * CUMO_NB > n) {
+            x &= CUMO_SLB(n - w * CUMO_NB);
+        }
+        counts[w] = __popc(x);
+    }
+}
+
+// Each thread writes the positions of one word, starting at the number of
+// one-bits (or zero-bits) before the word.
+template <typename idx_t>
+__global__ void <%="cumo_#{type_name}_where_scatter_kernel"%>(CUMO_BIT_DIGIT *a, uint64_t n, uint64_t nwords, const uint64_t *offsets, idx_t *idx1, idx_t *idx0)
+{
+    for (uint64_t w = blockIdx.x * blockDim.x + threadIdx.x; w < nwords; w += blockDim.x * gridDim.x) {
+        uint64_t base = w * CUMO_NB;
+        CUMO_BIT_DIGIT valid = (base + CUMO_NB > n) ? CUMO_SLB(n - base) : ~(CUMO_BIT_DIGIT)0;
+        uint64_t ones = (w == 0) ? 0 : offsets[w - 1];
+        CUMO_BIT_DIGIT x;
+        uint64_t k;
+
+        if (idx1) {
+            x = a[w] & valid;
+            for (k = ones; x; x &= x - 1) {
+                idx1[k++] = (idx_t)(base + __ffs(x) - 1);
+            }
+        }
+        if (idx0) {
+            x = ~a[w] & valid;
+            for (k = base - ones; x; x &= x - 1) {
+                idx0[k++] = (idx_t)(base + __ffs(x) - 1);
+            }
+        }
+    }
+}
+
+#if defined(__cplusplus)
+extern "C" {
+#if 0
+} /* satisfy cc-mode */
+#endif
+#endif
+
+void <%="cumo_#{type_name}_where_count_kernel_launch"%>(CUMO_BIT_DIGIT *a, uint64_t n, uint64_t *offsets)
+{
+    uint64_t nwords = (n + CUMO_NB - 1) / CUMO_NB;
+    size_t grid_dim = cumo_get_grid_dim(nwords);
+    size_t block_dim = cumo_get_block_dim(nwords);
+    thrust::device_ptr<uint64_t> p = thrust::device_pointer_cast(offsets);
+
+    <%="cumo_#{type_name}_where_count_kernel"%><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(a, n, nwords, offsets);
+    thrust::inclusive_scan(thrust::cuda::par.on(cumo_cuda_stream_current()), p, p + nwords, p);
+}
+
+void <%="cumo_#{type_name}_where_scatter_kernel_launch"%>(CUMO_BIT_DIGIT *a, uint64_t n, const uint64_t *offsets, char *idx1, char *idx0, size_t elmsz)
+{
+    uint64_t nwords = (n + CUMO_NB - 1) / CUMO_NB;
+    size_t grid_dim = cumo_get_grid_dim(nwords);
+    size_t block_dim = cumo_get_block_dim(nwords);
+
+    if (elmsz == 4) {
+        <%="cumo_#{type_name}_where_scatter_kernel"%><int32_t><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(a, n, nwords, offsets, (int32_t*)idx1, (int32_t*)idx0);
+    } else {
+        <%="cumo_#{type_name}_where_scatter_kernel"%><int64_t><<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(a, n, nwords, offsets, (int64_t*)idx1, (int64_t*)idx0);
+    }
+}
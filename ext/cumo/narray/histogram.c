@@ -0,0 +1,87 @@
+#include <ruby.h>
+#include <string.h>
+#include "cumo/histogram.h"
+#include "cumo/thread_pool.h"
+
+// Privatized bins pay off only if each thread counts this many elements.
+#define CUMO_HISTOGRAM_MIN_SIZE_PER_THREAD 32768
+#define CUMO_HISTOGRAM_GRAIN_SIZE 4096
+
+typedef struct {
+    size_t length;
+    size_t num_threads;
+    int weighted;
+    char *bins; // num_threads sub-histograms of length
+    cumo_na_host_histogram_func_t func;
+    void *data;
+} host_histogram_t;
+
+static void
+host_histogram_count(size_t begin, size_t end, size_t tid, void *ptr)
+{
+    host_histogram_t *h = (host_histogram_t*)ptr;
+    h->func(begin, end, h->bins + tid * h->length * 8, h->data);
+}
+
+static void
+host_histogram_merge(size_t begin, size_t end, size_t tid, void *ptr)
+{
+    host_histogram_t *h = (host_histogram_t*)ptr;
+    size_t t, j;
+
+    if (h->weighted) {
+        double *b = (double*)h->bins;
+        for (t = 1; t < h->num_threads; t++) {
+            for (j = begin; j < end; j++) {
+                b[j] += b[t * h->length + j];
+            }
+        }
+    } else {
+        uint64_t *b = (uint64_t*)h->bins;
+        for (t = 1; t < h->num_threads; t++) {
+            for (j = begin; j < end; j++) {
+                b[j] += b[t * h->length + j];
+            }
+        }
+    }
+}
+
+/*
+  Counts n elements into length bins on host threads. Each thread counts
+  static ranges into its own sub-histogram, then the sub-histograms are
+  summed bin-wise in parallel. Returns the bins, uint64_t[length] or
+  double[length] if weighted, which the caller must xfree.
+  Called with the GVL.
+*/
+void*
+cumo_na_host_histogram(size_t n, size_t length, int weighted, cumo_na_host_histogram_func_t func, void *data)
+{
+    host_histogram_t h;
+    size_t num_threads = cumo_thread_pool_get_num_threads();
+
+    // limit threads so that sub-histograms are not larger than the input
+    if (num_threads > n / CUMO_HISTOGRAM_MIN_SIZE_PER_THREAD) {
+        num_threads = n / CUMO_HISTOGRAM_MIN_SIZE_PER_THREAD;
+    }
+    if (length > 0 && num_threads > n / length) {
+        num_threads = n / length;
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    h.length = length;
+    h.num_threads = num_threads;
+    h.weighted = weighted;
+    h.bins = (char*)ruby_xcalloc(num_threads * (length > 0 ? length : 1), 8);
+    h.func = func;
+    h.data = data;
+
+    if (n > 0) {
+        cumo_thread_pool_parallel_for(n, CUMO_HISTOGRAM_GRAIN_SIZE, 0, num_threads, host_histogram_count, &h);
+    }
+    if (num_threads > 1) {
+        cumo_thread_pool_parallel_for(length, CUMO_HISTOGRAM_GRAIN_SIZE, 0, num_threads, host_histogram_merge, &h);
+    }
+    return h.bins;
+}
@@ -0,0 +1,88 @@
+#include "cumo/histogram.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Host-only tests of bin assignment shared by histogram kernels and host threads.
+
+namespace cumo {
+namespace internal {
+
+class TestHistogram {
+public:
+    void Run() {
+        TestEdge();
+        TestBin();
+        TestOutOfRange();
+        TestAgreeWithEdges();
+    }
+
+    void TestEdge() {
+        assert(cumo_histogram_edge(0, 10, 2, 0) == 0);
+        assert(cumo_histogram_edge(0, 10, 2, 1) == 5);
+        assert(cumo_histogram_edge(0, 10, 2, 2) == 10);
+        assert(cumo_histogram_edge(-1, 0.3, 7, 7) == 0.3);
+    }
+
+    void TestBin() {
+        assert(cumo_histogram_bin(0, 0, 10, 2) == 0);
+        assert(cumo_histogram_bin(4.999, 0, 10, 2) == 0);
+        assert(cumo_histogram_bin(5, 0, 10, 2) == 1);
+        // the last bin includes the upper end
+        assert(cumo_histogram_bin(10, 0, 10, 2) == 1);
+        assert(cumo_histogram_bin(1, 1, 3, 3) == 0);
+        assert(cumo_histogram_bin(3, 1, 3, 3) == 2);
+    }
+
+    void TestOutOfRange() {
+        assert(cumo_histogram_bin(-0.001, 0, 10, 2) == -1);
+        assert(cumo_histogram_bin(10.001, 0, 10, 2) == -1);
+        assert(cumo_histogram_bin(std::numeric_limits<double>::quiet_NaN(), 0, 10, 2) == -1);
+        assert(cumo_histogram_bin(std::numeric_limits<double>::infinity(), 0, 10, 2) == -1);
+    }
+
+    // every x is in [edge(i), edge(i+1)) of its bin i, even where rounding
+    // of (x - lo) * nbins / (hi - lo) alone would disagree
+    void TestAgreeWithEdges() {
+        std::mt19937_64 engine{1};
+        std::uniform_real_distribution<double> dist{0.0, 1.0};
+        const double ranges[][2] = {{0, 1}, {-3.7, 2.1}, {0.1, 0.7}, {1e-8, 3e-8}, {-1e10, 1e10}};
+        const int64_t nbins_list[] = {1, 3, 7, 10, 1000, 12345};
+        for (const auto& r : ranges) {
+            for (int64_t nbins : nbins_list) {
+                double lo = r[0], hi = r[1];
+                std::vector<double> xs;
+                for (int64_t i = 0; i <= nbins; ++i) {
+                    double e = cumo_histogram_edge(lo, hi, nbins, i);
+                    xs.push_back(e);
+                    xs.push_back(std::nextafter(e, -INFINITY));
+                    xs.push_back(std::nextafter(e, INFINITY));
+                }
+                for (int k = 0; k < 1000; ++k) {
+                    xs.push_back(lo + (hi - lo) * dist(engine));
+                }
+                for (double x : xs) {
+                    int64_t i = cumo_histogram_bin(x, lo, hi, nbins);
+                    if (x < lo || x > hi) {
+                        assert(i == -1);
+                        continue;
+                    }
+                    assert(0 <= i && i < nbins);
+                    assert(cumo_histogram_edge(lo, hi, nbins, i) <= x);
+                    assert(x < cumo_histogram_edge(lo, hi, nbins, i + 1) || (i == nbins - 1 && x == hi));
+                }
+            }
+        }
+    }
+};
+
+} // namespace internal
+} // namespace cumo
+
+int main() {
+    cumo::internal::TestHistogram{}.Run();
+    return 0;
+}
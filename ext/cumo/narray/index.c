@@ -3,6 +3,7 @@
 #include "cumo.h"
 #include "cumo/narray.h"
 #include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
 #include "cumo/cuda/memory_pool.h"
 #include "cumo/template.h"
 
@@ -123,37 +124,173 @@ cumo_na_range_check(ssize_t pos, ssize_t size, int dim)
     return idx;
 }
 
-static void CUDART_CB
-cumo_na_parse_array_callback(cudaStream_t stream, cudaError_t status, void *data)
+typedef struct {
+    VALUE ary;
+    int orig_dim;
+    ssize_t size;
+    size_t *idx;        // pinned staging buffer on host
+    size_t *device_idx;
+    cudaError_t status;
+} cumo_na_copy_array_t;
+
+static VALUE
+cumo_na_copy_array_fill(VALUE arg)
+{
+    cumo_na_copy_array_t *c = (cumo_na_copy_array_t*)arg;
+    long k, n = RARRAY_LEN(c->ary);
+
+    for (k=0; k<n; k++) {
+        c->idx[k] = cumo_na_range_check(NUM2SSIZET(RARRAY_AREF(c->ary,k)), c->size, c->orig_dim);
+    }
+    c->status = cudaMemcpyAsync(c->device_idx,c->idx,sizeof(size_t)*n,cudaMemcpyHostToDevice,cumo_cuda_stream_current());
+    return Qnil;
+}
+
+static VALUE
+cumo_na_copy_array_release(VALUE arg)
+{
+    cumo_na_copy_array_t *c = (cumo_na_copy_array_t*)arg;
+
+    cumo_cuda_runtime_free_pinned((char*)c->idx);
+    return Qnil;
+}
+
+// copy ruby array to idx on device
+static void
+cumo_na_copy_array_to_device(VALUE ary, int orig_dim, ssize_t size, size_t *device_idx)
+{
+    cumo_na_copy_array_t c;
+
+    c.ary = ary;
+    c.orig_dim = orig_dim;
+    c.size = size;
+    c.device_idx = device_idx;
+    c.status = cudaSuccess;
+    // make a contiguous pinned memory on host => copy to device => return pinned memory to the pool after copy finished
+    // The pinned memory is released also if an element is not a valid index.
+    c.idx = (size_t*)cumo_cuda_runtime_malloc_pinned(sizeof(size_t)*RARRAY_LEN(ary));
+    rb_ensure(cumo_na_copy_array_fill, (VALUE)&c, cumo_na_copy_array_release, (VALUE)&c);
+    cumo_cuda_runtime_check_status(c.status);
+}
+
+// Cache of device-resident indices converted from frozen Arrays.
+//
+// Frozen Arrays can not be modified, so the converted and range-checked
+// index is reused by repeated fancy indexing with the same Array, e.g.,
+// permutations in a mini-batch loop. The cache holds Arrays as keys, so an
+// Array identity can not be reused by another object while it is cached.
+// Entries are evicted in least recently used order.
+#define CUMO_NA_INDEX_CACHE_MAX 64
+
+typedef struct {
+    size_t *idx;  // validated index on device
+    ssize_t size; // size of the dimension which idx is validated against
+} cumo_na_index_cache_entry_t;
+
+static VALUE cumo_na_index_cache; // Hash compared by identity: frozen Array => entry
+
+static void
+cumo_na_index_cache_entry_free(void *ptr)
+{
+    cumo_na_index_cache_entry_t *entry = (cumo_na_index_cache_entry_t*)ptr;
+    if (entry->idx) {
+        cumo_cuda_runtime_free((char*)entry->idx);
+    }
+    xfree(entry);
+}
+
+static size_t
+cumo_na_index_cache_entry_memsize(const void *ptr)
 {
-    cudaFreeHost(data);
+    return sizeof(cumo_na_index_cache_entry_t);
+}
+
+static const rb_data_type_t cumo_na_index_cache_entry_type = {
+    "Cumo::NArray/index_cache_entry",
+    {NULL, cumo_na_index_cache_entry_free, cumo_na_index_cache_entry_memsize,},
+    0, 0, RUBY_TYPED_FREE_IMMEDIATELY|RUBY_TYPED_WB_PROTECTED
+};
+
+static int
+cumo_na_index_cache_first_key(VALUE key, VALUE value, VALUE arg)
+{
+    *(VALUE*)arg = key;
+    return ST_STOP;
+}
+
+// Returns a device-resident index of ary validated against size.
+static size_t*
+cumo_na_index_cache_fetch(VALUE ary, int orig_dim, ssize_t size)
+{
+    VALUE v;
+    cumo_na_index_cache_entry_t *entry;
+
+    v = rb_hash_delete(cumo_na_index_cache, ary);
+    if (v != Qnil) {
+        TypedData_Get_Struct(v, cumo_na_index_cache_entry_t, &cumo_na_index_cache_entry_type, entry);
+        if (entry->size == size) {
+            // re-insert to mark as most recently used
+            rb_hash_aset(cumo_na_index_cache, ary, v);
+            return entry->idx;
+        }
+    }
+
+    entry = ALLOC(cumo_na_index_cache_entry_t);
+    entry->idx = NULL;
+    entry->size = size;
+    v = TypedData_Wrap_Struct(0, &cumo_na_index_cache_entry_type, (void*)entry);
+    entry->idx = (size_t*)cumo_cuda_runtime_malloc(sizeof(size_t)*RARRAY_LEN(ary));
+    cumo_na_copy_array_to_device(ary, orig_dim, size, entry->idx);
+
+    if (RHASH_SIZE(cumo_na_index_cache) >= CUMO_NA_INDEX_CACHE_MAX) {
+        VALUE oldest = Qnil;
+        rb_hash_foreach(cumo_na_index_cache, cumo_na_index_cache_first_key, (VALUE)&oldest);
+        rb_hash_delete(cumo_na_index_cache, oldest);
+    }
+    rb_hash_aset(cumo_na_index_cache, ary, v);
+    return entry->idx;
+}
+
+// Returns true if ary is a frozen Array of Integers which can be parsed as
+// an index without converting it to NArray.
+static int
+cumo_na_index_is_cacheable_array(VALUE ary)
+{
+    long i, n;
+
+    if (!OBJ_FROZEN(ary)) {
+        return 0;
+    }
+    if (rb_hash_lookup2(cumo_na_index_cache, ary, Qnil) != Qnil) {
+        return 1;
+    }
+    n = RARRAY_LEN(ary);
+    if (n == 0) {
+        return 0;
+    }
+    for (i=0; i<n; i++) {
+        VALUE x = RARRAY_AREF(ary,i);
+        if (!FIXNUM_P(x) && !RB_TYPE_P(x, T_BIGNUM)) {
+            return 0;
+        }
+    }
+    return 1;
 }
 
 // copy ruby array to idx
 static void
 cumo_na_parse_array(VALUE ary, int orig_dim, ssize_t size, cumo_na_index_arg_t *q)
 {
-    int k;
-    size_t* idx;
-    cudaError_t status;
     int n = RARRAY_LEN(ary);
-    //q->idx = ALLOC_N(size_t, n);
-    //for (k=0; k<n; k++) {
-    //    q->idx[k] = na_range_check(NUM2SSIZET(RARRAY_AREF(ary,k)), size, orig_dim);
-    //}
-    // make a contiguous pinned memory on host => copy to device => release pinned memory after copy finished on callback
+
     q->idx = (size_t*)cumo_cuda_runtime_malloc(sizeof(size_t)*n);
-    cudaHostAlloc((void**)&idx, sizeof(size_t)*n, cudaHostAllocDefault);
-    for (k=0; k<n; k++) {
-        idx[k] = cumo_na_range_check(NUM2SSIZET(RARRAY_AREF(ary,k)), size, orig_dim);
-    }
-    status = cudaMemcpyAsync(q->idx,idx,sizeof(size_t)*n,cudaMemcpyHostToDevice,0);
-    if (status == 0) {
-        cumo_cuda_runtime_check_status(cudaStreamAddCallback(0,cumo_na_parse_array_callback,idx,0));
+    if (OBJ_FROZEN(ary) && n > 0) {
+        // the index is modified in place to make a view, so copy the cached one
+        size_t *cached = cumo_na_index_cache_fetch(ary, orig_dim, size);
+        cumo_cuda_runtime_check_status(cudaMemcpyAsync(q->idx,cached,sizeof(size_t)*n,cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
     } else {
-        cudaFreeHost(idx);
+        cumo_na_copy_array_to_device(ary, orig_dim, size, q->idx);
     }
-    cumo_cuda_runtime_check_status(status);
 
     q->n    = n;
     q->beg  = 0;
@@ -187,7 +324,7 @@ cumo_na_parse_narray_index(VALUE a, int orig_dim, ssize_t size, cumo_na_index_ar
     //    q->idx[k] = na_range_check(nidxp[k], size, orig_dim);
     //}
     q->idx = (size_t*)cumo_cuda_runtime_malloc(sizeof(size_t)*n);
-    cumo_cuda_runtime_check_status(cudaMemcpyAsync(q->idx,nidxp,sizeof(size_t)*n,cudaMemcpyDeviceToDevice,0));
+    cumo_cuda_runtime_check_status(cudaMemcpyAsync(q->idx,nidxp,sizeof(size_t)*n,cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
 
     q->n    = n;
     q->beg  = 0;
@@ -665,7 +802,7 @@ cumo_na_aref_md(int argc, VALUE *argv, VALUE self, int keep_dim, int result_nd,
 
     if (argc == 1 && result_nd == 1) {
         idx = argv[0];
-        if (rb_obj_is_kind_of(idx, rb_cArray)) {
+        if (rb_obj_is_kind_of(idx, rb_cArray) && !cumo_na_index_is_cacheable_array(idx)) {
             idx = rb_apply(cumo_cNArray,cumo_id_bracket,idx);
         }
         if (rb_obj_is_kind_of(idx, cumo_cNArray)) {
@@ -896,4 +1033,8 @@ Init_cumo_na_index()
     cumo_id_bracket     = rb_intern("[]");
     cumo_id_shift_left  = rb_intern("<<");
     cumo_id_mask        = rb_intern("mask");
+
+    cumo_na_index_cache = rb_hash_new();
+    rb_funcall(cumo_na_index_cache, rb_intern("compare_by_identity"), 0);
+    rb_global_variable(&cumo_na_index_cache);
 }
@@ -46,35 +46,35 @@ void cumo_na_index_aref_nadata_index_stride_kernel_launch(size_t *idx, ssize_t s
 {
     size_t grid_dim = cumo_get_grid_dim(n);
     size_t block_dim = cumo_get_block_dim(n);
-    cumo_na_index_aref_nadata_index_stride_kernel<<<grid_dim, block_dim>>>(idx, s1, n);
+    cumo_na_index_aref_nadata_index_stride_kernel<<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(idx, s1, n);
 }
 
 void cumo_na_index_aref_naview_index_index_kernel_launch(size_t *idx, size_t *idx1, uint64_t n)
 {
     size_t grid_dim = cumo_get_grid_dim(n);
     size_t block_dim = cumo_get_block_dim(n);
-    cumo_na_index_aref_naview_index_index_kernel<<<grid_dim, block_dim>>>(idx, idx1, n);
+    cumo_na_index_aref_naview_index_index_kernel<<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(idx, idx1, n);
 }
 
 void cumo_na_index_aref_naview_index_stride_last_kernel_launch(size_t *idx, ssize_t s1, size_t last, uint64_t n)
 {
     size_t grid_dim = cumo_get_grid_dim(n);
     size_t block_dim = cumo_get_block_dim(n);
-    cumo_na_index_aref_naview_index_stride_last_kernel<<<grid_dim, block_dim>>>(idx, s1, last, n);
+    cumo_na_index_aref_naview_index_stride_last_kernel<<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(idx, s1, last, n);
 }
 
 void cumo_na_index_aref_naview_index_stride_kernel_launch(size_t *idx, ssize_t s1, uint64_t n)
 {
     size_t grid_dim = cumo_get_grid_dim(n);
     size_t block_dim = cumo_get_block_dim(n);
-    cumo_na_index_aref_naview_index_stride_kernel<<<grid_dim, block_dim>>>(idx, s1, n);
+    cumo_na_index_aref_naview_index_stride_kernel<<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(idx, s1, n);
 }
 
 void cumo_na_index_aref_naview_index_index_beg_step_kernel_launch(size_t *idx, size_t *idx1, size_t beg, ssize_t step, uint64_t n)
 {
     size_t grid_dim = cumo_get_grid_dim(n);
     size_t block_dim = cumo_get_block_dim(n);
-    cumo_na_index_aref_naview_index_index_beg_step_kernel<<<grid_dim, block_dim>>>(idx, idx1, beg, step, n);
+    cumo_na_index_aref_naview_index_index_beg_step_kernel<<<grid_dim, block_dim, 0, cumo_cuda_stream_current()>>>(idx, idx1, beg, step, n);
 }
 
 #if defined(__cplusplus)
@@ -0,0 +1,108 @@
+#include "cumo/kahan.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Host-only tests of compensated summation shared by kahan_sum kernels.
+// ParallelSum splits the input like a reduction does and serves as the
+// multi-threaded reference of the device results.
+
+namespace cumo {
+namespace internal {
+
+double SerialSum(const std::vector<double>& x) {
+    cumo_kahan_t a = cumo_kahan_new(0);
+    for (double v : x) cumo_kahan_add(&a, v);
+    return cumo_kahan_result(a);
+}
+
+// Each thread sums a strided subset, as threads of a reduction block do,
+// and partial sums are merged in a tree.
+double ParallelSum(const std::vector<double>& x, size_t num_threads) {
+    std::vector<cumo_kahan_t> partial(num_threads, cumo_kahan_new(0));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = t; i < x.size(); i += num_threads) {
+                cumo_kahan_add(&partial[t], x[i]);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    for (size_t stride = 1; stride < num_threads; stride *= 2) {
+        for (size_t t = 0; t + stride < num_threads; t += 2 * stride) {
+            cumo_kahan_merge(&partial[t], partial[t + stride]);
+        }
+    }
+    return cumo_kahan_result(partial[0]);
+}
+
+class TestKahan {
+public:
+    void Run() {
+        TestCancellation();
+        TestExactSum();
+        TestSpecialValues();
+    }
+
+    void TestCancellation() {
+        // naive and plain Kahan summation return 0
+        std::vector<double> x{1.0, 1e100, 1.0, -1e100};
+        assert(SerialSum(x) == 2.0);
+        for (size_t t : {1, 2, 3, 4}) {
+            assert(ParallelSum(x, t) == 2.0);
+        }
+    }
+
+    // Values are multiples of 2^-30 below 2^22, so partial sums of 2^20
+    // elements are exact in int64 but not in double after cancellation.
+    void TestExactSum() {
+        std::mt19937_64 engine{1};
+        std::uniform_int_distribution<int64_t> dist{-(int64_t{1} << 52), int64_t{1} << 52};
+        const size_t n = 1 << 20;
+        std::vector<double> x(n);
+        int64_t exact = 0;
+        for (size_t i = 0; i < n; ++i) {
+            int64_t k = dist(engine);
+            exact += k;
+            x[i] = std::ldexp(static_cast<double>(k), -30);
+        }
+        // large terms which cancel
+        x.push_back(1e20);
+        x.push_back(-1e20);
+        std::shuffle(x.begin(), x.end(), engine);
+
+        double expected = std::ldexp(static_cast<double>(exact), -30);
+        double naive = 0;
+        for (double v : x) naive += v;
+        assert(naive != expected);
+        assert(SerialSum(x) == expected);
+        for (size_t t : {2, 7, 16, 64}) {
+            assert(ParallelSum(x, t) == expected);
+        }
+    }
+
+    void TestSpecialValues() {
+        const double inf = std::numeric_limits<double>::infinity();
+        assert(SerialSum({1.0, inf, 2.0}) == inf);
+        assert(ParallelSum({1.0, inf, 2.0, -3.0}, 2) == inf);
+        assert(SerialSum({-inf, 1.0}) == -inf);
+        assert(std::isnan(SerialSum({inf, -inf})));
+        assert(std::isnan(ParallelSum({1.0, std::nan(""), 2.0}, 2)));
+        assert(SerialSum({}) == 0);
+    }
+};
+
+} // namespace internal
+} // namespace cumo
+
+int main() {
+    cumo::internal::TestKahan{}.Run();
+    return 0;
+}
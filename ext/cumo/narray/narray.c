@@ -5,6 +5,7 @@
 #include "cumo/narray.h"
 #include "cumo/cuda/memory_pool.h"
 #include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
 
 /* global variables within this module */
 VALUE cumo_cNArray;
@@ -914,7 +915,7 @@ cumo_na_make_view(VALUE self)
                 //     idx2[j] = idx1[j];
                 // }
                 idx2 = (size_t*)cumo_cuda_runtime_malloc(sizeof(size_t)*na1->base.shape[i]);
-                cumo_cuda_runtime_check_status(cudaMemcpyAsync(idx2,idx1,sizeof(size_t)*na1->base.shape[i],cudaMemcpyDeviceToDevice,0));
+                cumo_cuda_runtime_check_status(cudaMemcpyAsync(idx2,idx1,sizeof(size_t)*na1->base.shape[i],cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
                 CUMO_SDX_SET_INDEX(na2->stridx[i],idx2);
             } else {
                 na2->stridx[i] = na1->stridx[i];
@@ -1063,13 +1064,12 @@ cumo_na_reverse(int argc, VALUE *argv, VALUE self)
                 // }
                 idx2 = (size_t*)cumo_cuda_runtime_malloc(sizeof(size_t)*n);
                 if (cumo_na_test_reduce(reduce,i)) {
-                    CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE("cumo_na_reverse", "any");
-                    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+                    CUMO_SYNCHRONIZE("cumo_na_reverse", "any");
                     for (j=0; j<n; j++) {
                         idx2[n-1-j] = idx1[j];
                     }
                 } else {
-                    cumo_cuda_runtime_check_status(cudaMemcpyAsync(idx2,idx1,sizeof(size_t)*n,cudaMemcpyDeviceToDevice,0));
+                    cumo_cuda_runtime_check_status(cudaMemcpyAsync(idx2,idx1,sizeof(size_t)*n,cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
                 }
                 CUMO_SDX_SET_INDEX(na2->stridx[i],idx2);
             } else {
@@ -1297,8 +1297,7 @@ cumo_na_to_binary(VALUE self)
     VALUE str;
     cumo_narray_t *na;
 
-    CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE("cumo_na_to_binary", "any");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    CUMO_SYNCHRONIZE("cumo_na_to_binary", "any");
 
     CumoGetNArray(self,na);
     if (na->type == CUMO_NARRAY_VIEW_T) {
@@ -1325,8 +1324,7 @@ cumo_na_marshal_dump(VALUE self)
 {
     VALUE a;
 
-    CUMO_SHOW_SYNCHRONIZE_WARNING_ONCE("cumo_na_marshal_dump", "any");
-    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+    CUMO_SYNCHRONIZE("cumo_na_marshal_dump", "any");
 
     a = rb_ary_new();
     rb_ary_push(a, INT2FIX(1));     // version
@@ -3,6 +3,8 @@
 #include "cumo/narray.h"
 #include "cumo/cuda/memory_pool.h"
 #include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
+#include "cumo/thread_pool.h"
 
 #if 0
 #define DBG(x) x
@@ -579,8 +581,7 @@ ndloop_set_stepidx(cumo_na_md_loop_t *lp, int j, VALUE vna, int *dim_map, int rw
                 }
             } else if (n==1) {
                 if (CUMO_SDX_IS_INDEX(sdx)) {
-                    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("ndloop_set_stepidx", "any");
-                    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+                    CUMO_SYNCHRONIZE_FIXME("ndloop_set_stepidx", "any");
                     LITER(lp,0,j).pos += CUMO_SDX_GET_INDEX(sdx)[0];
                 }
             }
@@ -1185,7 +1186,7 @@ ndloop_copy_to_buffer(cumo_na_buffer_copy_t *lp)
         buf = lp->buf_ptr;
         if (cumo_cuda_runtime_is_device_memory(src) && cumo_cuda_runtime_is_device_memory(buf)) {
             DBG(printf("DtoD] ["));
-            cumo_cuda_runtime_check_status(cudaMemcpyAsync(buf,src,elmsz,cudaMemcpyDeviceToDevice,0));
+            cumo_cuda_runtime_check_status(cudaMemcpyAsync(buf,src,elmsz,cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
         } else {
             DBG(printf("HtoH] ["));
             memcpy(buf,src,elmsz);
@@ -1201,8 +1202,7 @@ ndloop_copy_to_buffer(cumo_na_buffer_copy_t *lp)
         // i-th dimension
         for (; i<nd; i++) {
             if (LITER_SRC(lp,i).idx) {
-                CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("ndloop_copy_to_buffer", "any");
-                cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+                CUMO_SYNCHRONIZE_FIXME("ndloop_copy_to_buffer", "any");
                 LITER_SRC(lp,i+1).pos = LITER_SRC(lp,i).pos + LITER_SRC(lp,i).idx[c[i]];
             } else {
                 LITER_SRC(lp,i+1).pos = LITER_SRC(lp,i).pos + LITER_SRC(lp,i).step*c[i];
@@ -1212,7 +1212,7 @@ ndloop_copy_to_buffer(cumo_na_buffer_copy_t *lp)
         buf = lp->buf_ptr + buf_pos;
         if (cumo_cuda_runtime_is_device_memory(src) && cumo_cuda_runtime_is_device_memory(buf)) {
             DBG(printf("DtoD] ["));
-            cumo_cuda_runtime_check_status(cudaMemcpyAsync(buf,src,elmsz,cudaMemcpyDeviceToDevice,0));
+            cumo_cuda_runtime_check_status(cudaMemcpyAsync(buf,src,elmsz,cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
         } else {
             DBG(printf("HtoH] ["));
             memcpy(buf,src,elmsz);
@@ -1251,7 +1251,7 @@ ndloop_copy_from_buffer(cumo_na_buffer_copy_t *lp)
         buf = lp->buf_ptr;
         if (cumo_cuda_runtime_is_device_memory(src) && cumo_cuda_runtime_is_device_memory(buf)) {
             DBG(printf("DtoD] ["));
-            cumo_cuda_runtime_check_status(cudaMemcpyAsync(src,buf,elmsz,cudaMemcpyDeviceToDevice,0));
+            cumo_cuda_runtime_check_status(cudaMemcpyAsync(src,buf,elmsz,cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
         } else {
             DBG(printf("HtoH] ["));
             memcpy(src,buf,elmsz);
@@ -1267,8 +1267,7 @@ ndloop_copy_from_buffer(cumo_na_buffer_copy_t *lp)
         // i-th dimension
         for (; i<nd; i++) {
             if (LITER_SRC(lp,i).idx) {
-                CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("ndloop_copy_from_buffer", "any");
-                cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+                CUMO_SYNCHRONIZE_FIXME("ndloop_copy_from_buffer", "any");
                 LITER_SRC(lp,i+1).pos = LITER_SRC(lp,i).pos + LITER_SRC(lp,i).idx[c[i]];
             } else {
                 LITER_SRC(lp,i+1).pos = LITER_SRC(lp,i).pos + LITER_SRC(lp,i).step*c[i];
@@ -1278,7 +1277,7 @@ ndloop_copy_from_buffer(cumo_na_buffer_copy_t *lp)
         buf = lp->buf_ptr + buf_pos;
         if (cumo_cuda_runtime_is_device_memory(src) && cumo_cuda_runtime_is_device_memory(buf)) {
             DBG(printf("DtoD] ["));
-            cumo_cuda_runtime_check_status(cudaMemcpyAsync(src,buf,elmsz,cudaMemcpyDeviceToDevice,0));
+            cumo_cuda_runtime_check_status(cudaMemcpyAsync(src,buf,elmsz,cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
         } else {
             DBG(printf("HtoH] ["));
             memcpy(src,buf,elmsz);
@@ -1454,6 +1453,171 @@ ndloop_run(VALUE vlp)
 }
 
 
+// ---------------------------------------------------------------------------
+
+/*
+  Parallel loop on host threads for iterators with CUMO_NDF_PARALLEL.
+
+  The outermost dimension is split across the thread pool without the GVL.
+  Each thread loops over its own copy of lp->user and of the iterators, so
+  the user function sees the same lp as in the serial loop. Loops with
+  index arrays cost unevenly and are scheduled with work stealing, others
+  with static ranges.
+*/
+
+// Minimum number of elements to run in parallel
+#define CUMO_PARALLEL_MIN_SIZE 32768
+// Elements per chunk of work stealing
+#define CUMO_PARALLEL_GRAIN_SIZE 4096
+
+typedef struct {
+    cumo_ndfunc_t *nf;
+    cumo_na_md_loop_t *lp;
+    cumo_na_loop_t *user;       // for each thread
+    cumo_na_loop_iter_t *iter;  // for each thread and argument
+    size_t *c;                  // loop counters for each thread
+} ndloop_parallel_t;
+
+static void
+ndloop_parallel_run(size_t begin, size_t end, size_t tid, void *data)
+{
+    ndloop_parallel_t *p = (ndloop_parallel_t*)data;
+    cumo_na_md_loop_t *lp = p->lp;
+    cumo_na_loop_t *user = &(p->user[tid]);
+    size_t *c = &(p->c[tid*(lp->ndim+1)]);
+    cumo_na_loop_iter_t *it;
+    int i, j;
+    int nd = lp->ndim;
+
+    c[0] = begin;
+    for (i=1; i<=nd; i++) c[i]=0;
+
+    for (i=0;;) {
+        for (; i<nd; i++) {
+            for (j=0; j<lp->narg; j++) {
+                it = user->args[j].iter - nd; // iterators of this thread from dimension 0
+                if (it[i].idx) {
+                    it[i+1].pos = it[i].pos + it[i].idx[c[i]];
+                } else {
+                    it[i+1].pos = it[i].pos + it[i].step*c[i];
+                }
+            }
+        }
+        (*(p->nf->func))(user);
+        if (RTEST(user->err_type)) {return;}
+
+        for (;;) {
+            if (i<=0) return;
+            i--;
+            if (++c[i] < ((i==0) ? end : lp->n[i])) break;
+            c[i] = 0;
+        }
+    }
+}
+
+// ndf->func => method name counted in Cumo.sync_stats. The name is copied
+// when the iterator first synchronizes, since the frame may have no method
+// or a dynamic symbol, and ndf itself is on the stack of the method.
+static st_table *ndloop_sync_names;
+
+static const char *
+ndloop_sync_name(cumo_ndfunc_t *nf)
+{
+    st_data_t key = (st_data_t)nf->func, value;
+    ID id;
+    const char *name = NULL;
+    char *copy;
+    size_t len;
+
+    if (st_lookup(ndloop_sync_names, key, &value)) {
+        return (const char*)value;
+    }
+    id = rb_frame_this_func();
+    if (id) {
+        name = rb_id2name(id);
+    }
+    if (!name) {
+        name = "ndloop";
+    }
+    len = strlen(name) + 1;
+    copy = ALLOC_N(char, len);
+    memcpy(copy, name, len);
+    st_insert(ndloop_sync_names, key, (st_data_t)copy);
+    return copy;
+}
+
+// Returns 0 if the loop should run serially.
+static int
+ndloop_parallel(cumo_ndfunc_t *nf, cumo_na_md_loop_t *lp)
+{
+    ndloop_parallel_t p;
+    size_t size, grain, nthreads, t;
+    int i, j, k, niter;
+    int nd = lp->ndim;
+    int work_stealing = 0;
+
+    nthreads = cumo_thread_pool_get_num_threads();
+    if (nthreads <= 1 || nd < 1 || lp->n[0] < 2) {
+        return 0;
+    }
+    size = 1;
+    for (i=0; i < nd + lp->user.ndim; i++) {
+        size *= lp->n[i];
+    }
+    if (size < CUMO_PARALLEL_MIN_SIZE) {
+        return 0;
+    }
+    for (j=0; j<lp->narg; j++) {
+        // buffered arguments share one buffer
+        if (LARG(lp,j).iter != &LITER(lp,nd,j)) {
+            return 0;
+        }
+        // threads must write to separate elements
+        if ((lp->xargs[j].flag & CUMO_NDL_WRITE) &&
+            (LITER(lp,0,j).idx || LITER(lp,0,j).step == 0)) {
+            return 0;
+        }
+        for (i=0; i<nd; i++) {
+            if (LITER(lp,i,j).idx) {
+                work_stealing = 1;
+            }
+        }
+    }
+
+    niter = nd + lp->user.ndim + 1;
+    p.nf = nf;
+    p.lp = lp;
+    p.user = ALLOCA_N(cumo_na_loop_t, nthreads);
+    p.iter = ALLOCA_N(cumo_na_loop_iter_t, nthreads*lp->narg*niter);
+    p.c = ALLOCA_N(size_t, nthreads*(nd+1));
+    for (t=0; t<nthreads; t++) {
+        p.user[t] = lp->user;
+        p.user[t].args = ALLOCA_N(cumo_na_loop_args_t, lp->narg);
+        for (j=0; j<lp->narg; j++) {
+            cumo_na_loop_iter_t *it = &(p.iter[(t*lp->narg+j)*niter]);
+            for (k=0; k<niter; k++) {
+                it[k] = LITER(lp,k,j);
+            }
+            p.user[t].args[j] = LARG(lp,j);
+            p.user[t].args[j].iter = &(it[nd]);
+        }
+    }
+
+    // at least a grain per thread also with static ranges
+    grain = CUMO_PARALLEL_GRAIN_SIZE / (size / lp->n[0]);
+    if (grain == 0) {
+        grain = 1;
+    }
+    cumo_thread_pool_parallel_for(lp->n[0], grain, work_stealing, nthreads, ndloop_parallel_run, &p);
+
+    for (t=0; t<nthreads; t++) {
+        if (RTEST(p.user[t].err_type)) {
+            lp->user.err_type = p.user[t].err_type;
+        }
+    }
+    return 1;
+}
+
 // ---------------------------------------------------------------------------
 
 static void
@@ -1467,6 +1631,14 @@ loop_narray(cumo_ndfunc_t *nf, cumo_na_md_loop_t *lp)
         rb_bug("bug? lp->ndim = %d\n", lp->ndim);
     }
 
+    if (CUMO_NDF_TEST(nf,CUMO_NDF_PARALLEL)) {
+        // the iterator reads device memory on host and must not call Ruby
+        cumo_synchronize_for_host(ndloop_sync_name(nf));
+        if (ndloop_parallel(nf, lp)) {
+            return;
+        }
+    }
+
     if (nd==0 || CUMO_NDF_TEST(nf,CUMO_NDF_INDEXER_LOOP)) {
         for (j=0; j<lp->nin; j++) {
             if (lp->xargs[j].bufcp) {
@@ -1496,8 +1668,7 @@ loop_narray(cumo_ndfunc_t *nf, cumo_na_md_loop_t *lp)
             // j-th argument
             for (j=0; j<lp->narg; j++) {
                 if (LITER(lp,i,j).idx) {
-                    CUMO_SHOW_SYNCHRONIZE_FIXME_WARNING_ONCE("loop_narrayx", "any");
-                    cumo_cuda_runtime_check_status(cudaDeviceSynchronize());
+                    CUMO_SYNCHRONIZE_FIXME("loop_narrayx", "any");
                     LITER(lp,i+1,j).pos = LITER(lp,i,j).pos + LITER(lp,i,j).idx[c[i]];
                 } else {
                     LITER(lp,i+1,j).pos = LITER(lp,i,j).pos + LITER(lp,i,j).step*c[i];
@@ -1656,6 +1827,58 @@ cumo_na_info_str(VALUE ary)
 }
 
 
+//----------------------------------------------------------------------
+
+/*
+  Text output reads elements one by one on host. With CUMO_NDF_HOST_COPY,
+  the input is first copied to a pinned host buffer with one transfer and
+  one synchronization instead of faulting in device memory element by
+  element. The input must be contiguous with no offset.
+*/
+typedef struct {
+    char *ptr;     // pinned host copy of the input
+    size_t *shape; // shape of the array to inspect, or NULL
+} ndloop_host_copy_t;
+
+static VALUE
+ndloop_prepare_host_copy(VALUE nary)
+{
+    if (cumo_na_check_contiguous(nary) != Qtrue || cumo_na_get_offset(nary) != 0) {
+        return cumo_na_copy(nary);
+    }
+    return nary;
+}
+
+static void
+ndloop_read_from_host_copy(cumo_na_md_loop_t *lp, const char *func_name)
+{
+    ndloop_host_copy_t *hc = (ndloop_host_copy_t*)(lp->user.opt_ptr);
+    VALUE v = LARG(lp,0).value;
+    cumo_narray_t *na;
+    size_t size;
+
+    CumoGetNArray(v,na);
+    size = na->size * LARG(lp,0).elmsz;
+    hc->ptr = cumo_cuda_runtime_malloc_pinned(size);
+    cumo_cuda_runtime_check_status(
+            cudaMemcpyAsync(hc->ptr, cumo_na_get_pointer_for_read(v), size, cudaMemcpyDeviceToHost, cumo_cuda_stream_current()));
+    cumo_synchronize_for_host(func_name);
+    LARG(lp,0).ptr = hc->ptr;
+}
+
+static VALUE
+ndloop_release_host_copy(VALUE vlp)
+{
+    cumo_na_md_loop_t *lp = (cumo_na_md_loop_t*)(vlp);
+    ndloop_host_copy_t *hc = (ndloop_host_copy_t*)(lp->user.opt_ptr);
+
+    if (hc->ptr) {
+        cumo_cuda_runtime_free_pinned(hc->ptr);
+    }
+    return ndloop_release(vlp);
+}
+
+
 //----------------------------------------------------------------------
 
 extern int cumo_na_inspect_cols_;
@@ -1667,7 +1890,7 @@ static void
 loop_inspect(cumo_ndfunc_t *nf, cumo_na_md_loop_t *lp)
 {
     int nd, i, ii;
-    size_t *c;
+    size_t *c, *n;
     int col=0, row=0;
     long len;
     VALUE str;
@@ -1679,13 +1902,23 @@ loop_inspect(cumo_ndfunc_t *nf, cumo_na_md_loop_t *lp)
     //opt = *(VALUE*)(lp->user.opt_ptr);
     opt = lp->user.option;
 
+    // the host copy holds only visible elements but shows the original shape
+    n = lp->n;
+    if (lp->user.opt_ptr) {
+        n = ((ndloop_host_copy_t*)(lp->user.opt_ptr))->shape;
+    }
+
     for (i=0; i<nd; i++) {
-        if (lp->n[i] == 0) {
+        if (n[i] == 0) {
             rb_str_cat(buf,"[]",2);
             return;
         }
     }
 
+    if (lp->user.opt_ptr) {
+        ndloop_read_from_host_copy(lp, "inspect");
+    }
+
     rb_str_cat(buf,"\n",1);
 
     c = ALLOCA_N(size_t, nd+1);
@@ -1715,7 +1948,7 @@ loop_inspect(cumo_ndfunc_t *nf, cumo_na_md_loop_t *lp)
         len = RSTRING_LEN(str) + 2;
         if (ncol>0 && col+len > ncol-3) {
             rb_str_cat(buf,"...",3);
-            c[i-1] = lp->n[i-1];
+            c[i-1] = n[i-1];
         } else {
             rb_str_append(buf, str);
             col += len;
@@ -1723,7 +1956,7 @@ loop_inspect(cumo_ndfunc_t *nf, cumo_na_md_loop_t *lp)
         for (;;) {
             if (i==0) goto loop_end;
             i--;
-            if (++c[i] < lp->n[i]) break;
+            if (++c[i] < n[i]) break;
             rb_str_cat(buf,"]",1);
             c[i] = 0;
         }
@@ -1744,12 +1977,46 @@ loop_inspect(cumo_ndfunc_t *nf, cumo_na_md_loop_t *lp)
 }
 
 
-VALUE
-cumo_na_ndloop_inspect(VALUE nary, cumo_na_text_func_t func, VALUE opt)
+/*
+  Returns the leading part of nary which loop_inspect may print: at most
+  nrow+1 indices in leading dimensions (one row each), and as many in the
+  last dimension as fit into ncol with at least 3 columns per element.
+*/
+static VALUE
+ndloop_inspect_visible(VALUE nary)
 {
-    volatile VALUE args;
+    cumo_narray_t *na;
+    int i, nd, truncated=0;
+    size_t n;
+    VALUE *ranges;
+
+    CumoGetNArray(nary,na);
+    nd = na->ndim;
+    ranges = ALLOCA_N(VALUE, nd);
+    for (i=0; i<nd; i++) {
+        n = na->shape[i];
+        if (i<nd-1) {
+            if (nrow>0 && n > (size_t)nrow+1) n = nrow+1;
+        } else {
+            if (ncol>0 && n > (size_t)ncol/3+2) n = ncol/3+2;
+        }
+        if (n < na->shape[i]) truncated = 1;
+        ranges[i] = rb_range_new(INT2FIX(0), SIZET2NUM(n), 1);
+    }
+    if (!truncated) {
+        return nary;
+    }
+    return rb_funcall2(nary, rb_intern("[]"), nd, ranges);
+}
+
+static VALUE
+ndloop_inspect(VALUE nary, cumo_na_text_func_t func, VALUE opt, int host_copy)
+{
+    volatile VALUE args, vvisible;
     cumo_na_md_loop_t lp;
     VALUE buf;
+    cumo_narray_t *na;
+    ndloop_host_copy_t hc = {NULL, NULL};
     cumo_ndfunc_arg_in_t ain[3] = {{Qnil,0},{cumo_sym_loop_opt},{cumo_sym_option}};
     cumo_ndfunc_t nf = { (cumo_na_iter_func_t)func, CUMO_NO_LOOP, 3, 0, ain, 0 };
     //nf = cumo_ndfunc_alloc(NULL, CUMO_NO_LOOP, 1, 0, Qnil);
@@ -1760,22 +2027,50 @@ cumo_na_ndloop_inspect(VALUE nary, cumo_na_text_func_t func, VALUE opt)
         return rb_str_cat(buf,"(empty)",7);
     }
 
+    CumoGetNArray(nary,na);
+    if (!host_copy || na->size == 0) {
+        args = rb_ary_new3(3,nary,buf,opt);
+        ndloop_alloc(&lp, &nf, args, NULL, 0, loop_inspect);
+        rb_ensure(ndloop_run, (VALUE)&lp, ndloop_release, (VALUE)&lp);
+        return buf;
+    }
+
+    // copy only elements to print
+    hc.shape = na->shape;
+    vvisible = ndloop_prepare_host_copy(ndloop_inspect_visible(nary));
+
     //rb_p(args);
     //if (cumo_na_debug_flag) print_ndfunc(&nf);
 
-    args = rb_ary_new3(3,nary,buf,opt);
+    args = rb_ary_new3(3,vvisible,buf,opt);
 
     // cast arguments to NArray
     //ndloop_cast_args(nf, args);
 
     // allocate ndloop struct
-    ndloop_alloc(&lp, &nf, args, NULL, 0, loop_inspect);
+    ndloop_alloc(&lp, &nf, args, &hc, 0, loop_inspect);
 
-    rb_ensure(ndloop_run, (VALUE)&lp, ndloop_release, (VALUE)&lp);
+    rb_ensure(ndloop_run, (VALUE)&lp, ndloop_release_host_copy, (VALUE)&lp);
 
     return buf;
 }
 
+VALUE
+cumo_na_ndloop_inspect(VALUE nary, cumo_na_text_func_t func, VALUE opt)
+{
+    return ndloop_inspect(nary, func, opt, 0);
+}
+
+/*
+  Same as cumo_na_ndloop_inspect, but func reads elements from a host copy
+  of only the elements to print. Elements must be plain bytes on device.
+*/
+VALUE
+cumo_na_ndloop_inspect_host_copy(VALUE nary, cumo_na_text_func_t func, VALUE opt)
+{
+    return ndloop_inspect(nary, func, opt, 1);
+}
+
 
 //----------------------------------------------------------------------
 
@@ -1965,6 +2260,10 @@ loop_narray_to_rarray(cumo_ndfunc_t *nf, cumo_na_md_loop_t *lp)
     a = ALLOCA_N(VALUE, nd+1);
     a[0] = a0 = lp->loop_opt;
 
+    if (lp->user.opt_ptr) {
+        ndloop_read_from_host_copy(lp, "to_a");
+    }
+
     // loop body
     for (i=0;;) {
         for (; i<nd; i++) {
@@ -1999,10 +2298,19 @@ cumo_na_ndloop_cast_narray_to_rarray(cumo_ndfunc_t *nf, VALUE nary, VALUE fmt)
 {
     cumo_na_md_loop_t lp;
     VALUE args, a0;
+    cumo_narray_t *na;
+    int host_copy;
+    ndloop_host_copy_t hc = {NULL, NULL};
 
     //rb_p(args);
     if (cumo_na_debug_flag) print_ndfunc(nf);
 
+    CumoGetNArray(nary,na);
+    host_copy = CUMO_NDF_TEST(nf,CUMO_NDF_HOST_COPY) && na->size > 0;
+    if (host_copy) {
+        nary = ndloop_prepare_host_copy(nary);
+    }
+
     a0 = rb_ary_new();
     args = rb_ary_new3(3,nary,a0,fmt);
 
@@ -2010,9 +2318,14 @@ cumo_na_ndloop_cast_narray_to_rarray(cumo_ndfunc_t *nf, VALUE nary, VALUE fmt)
     //ndloop_cast_args(nf, args);
 
     // allocate ndloop struct
-    ndloop_alloc(&lp, nf, args, NULL, 0, loop_narray_to_rarray);
-
-    rb_ensure(ndloop_run, (VALUE)&lp, ndloop_release, (VALUE)&lp);
+    if (host_copy) {
+        ndloop_alloc(&lp, nf, args, &hc, 0, loop_narray_to_rarray);
+        rb_ensure(ndloop_run, (VALUE)&lp, ndloop_release_host_copy, (VALUE)&lp);
+    } else {
+        ndloop_alloc(&lp, nf, args, NULL, 0, loop_narray_to_rarray);
+        rb_ensure(ndloop_run, (VALUE)&lp, ndloop_release, (VALUE)&lp);
+    }
+    RB_GC_GUARD(nary);
     return RARRAY_AREF(a0,0);
 }
 
@@ -2113,4 +2426,5 @@ Init_cumo_na_ndloop()
 {
     cumo_id_cast    = rb_intern("cast");
     cumo_id_extract = rb_intern("extract");
+    ndloop_sync_names = st_init_numtable();
 }
@@ -0,0 +1,190 @@
+#include "cumo/philox.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+// Host-only tests for the Philox4x32-10 engine shared by rand kernels.
+
+namespace cumo {
+namespace internal {
+
+class TestPhilox {
+public:
+    void Run() {
+        TestKnownAnswer();
+        TestPartitionIndependent();
+        TestSubstream();
+        TestToFloat();
+        TestExponential();
+        TestGamma();
+        TestPoisson();
+        TestBernoulli();
+        TestSearchCdf();
+    }
+
+    // Known answer tests from Random123 (kat_vectors)
+    void TestKnownAnswer() {
+        {
+            uint32_t ctr[4] = {0, 0, 0, 0};
+            uint32_t key[2] = {0, 0};
+            uint32_t out[4];
+            cumo_philox4x32_10(ctr, key, out);
+            assert(out[0] == 0x6627e8d5U);
+            assert(out[1] == 0xe169c58dU);
+            assert(out[2] == 0xbc57ac4cU);
+            assert(out[3] == 0x9b00dbd8U);
+        }
+        {
+            uint32_t ctr[4] = {0xffffffffU, 0xffffffffU, 0xffffffffU, 0xffffffffU};
+            uint32_t key[2] = {0xffffffffU, 0xffffffffU};
+            uint32_t out[4];
+            cumo_philox4x32_10(ctr, key, out);
+            assert(out[0] == 0x408f276dU);
+            assert(out[1] == 0x41c83b0eU);
+            assert(out[2] == 0xa20bc7c6U);
+            assert(out[3] == 0x6d5451fdU);
+        }
+        {
+            uint32_t ctr[4] = {0x243f6a88U, 0x85a308d3U, 0x13198a2eU, 0x03707344U};
+            uint32_t key[2] = {0xa4093822U, 0x299f31d0U};
+            uint32_t out[4];
+            cumo_philox4x32_10(ctr, key, out);
+            assert(out[0] == 0xd16cfe09U);
+            assert(out[1] == 0x94fdccebU);
+            assert(out[2] == 0x5001e420U);
+            assert(out[3] == 0x24126ea1U);
+        }
+    }
+
+    // Results must not depend on how elements are split across workers.
+    void TestPartitionIndependent() {
+        const size_t n = 10007;
+        cumo_philox_state_t st = {12345, 678, 0};
+
+        std::vector<uint32_t> serial(n);
+        Fill(st, 0, n, serial.data());
+
+        for (size_t n_threads : {2, 3, 8}) {
+            std::vector<uint32_t> parallel(n);
+            std::vector<std::thread> threads;
+            size_t chunk = (n + n_threads - 1) / n_threads;
+            for (size_t t = 0; t < n_threads; ++t) {
+                size_t beg = std::min(n, t * chunk);
+                size_t end = std::min(n, beg + chunk);
+                threads.emplace_back([&, beg, end] { Fill(st, beg, end, parallel.data()); });
+            }
+            for (auto& th : threads) th.join();
+            assert(serial == parallel);
+        }
+
+        // Drawing [0,n) once equals drawing [0,k) and then [k,n) with an advanced offset.
+        std::vector<uint32_t> split(n);
+        size_t k = 4321;
+        Fill(st, 0, k, split.data());
+        cumo_philox_state_t st2 = st;
+        st2.offset += k;
+        Fill(st2, 0, n - k, split.data() + k);
+        assert(serial == split);
+    }
+
+    void TestSubstream() {
+        cumo_philox_state_t st0 = {1, 0, 0};
+        cumo_philox_state_t st1 = {1, 0, 1};
+        uint32_t a[4], b[4];
+        cumo_philox_generate(st0, 0, 0, a);
+        cumo_philox_generate(st1, 0, 0, b);
+        assert(a[0] != b[0] || a[1] != b[1] || a[2] != b[2] || a[3] != b[3]);
+    }
+
+    void TestToFloat() {
+        assert(cumo_philox_to_float(0) == 0.0f);
+        assert(cumo_philox_to_float(0xffffffffU) < 1.0f);
+        assert(cumo_philox_to_double(0, 0) == 0.0);
+        assert(cumo_philox_to_double(0xffffffffU, 0xffffffffU) < 1.0);
+    }
+
+    void TestExponential() {
+        cumo_philox_state_t st = {7, 0, 0};
+        CheckMoments([&](uint64_t i) { return cumo_philox_exponential(st, i); }, 1.0, 1.0);
+    }
+
+    void TestGamma() {
+        cumo_philox_state_t st = {7, 0, 0};
+        for (double shape : {0.5, 1.0, 3.0, 20.0}) {
+            CheckMoments([&](uint64_t i) { return cumo_philox_gamma(st, i, shape); }, shape, shape);
+        }
+    }
+
+    void TestPoisson() {
+        cumo_philox_state_t st = {7, 0, 0};
+        // both the multiplication and the PTRS branch
+        for (double lam : {0.5, 3.0, 10.0, 50.0, 1000.0}) {
+            CheckMoments([&](uint64_t i) {
+                double x = cumo_philox_poisson(st, i, lam);
+                assert(x >= 0 && x == std::floor(x));
+                return x;
+            }, lam, lam);
+        }
+        assert(cumo_philox_poisson(st, 0, 0.0) == 0.0);
+    }
+
+    void TestBernoulli() {
+        cumo_philox_state_t st = {7, 0, 0};
+        assert(cumo_philox_bernoulli_threshold(0.0) == 0);
+        assert(cumo_philox_bernoulli_threshold(1.0) == (uint64_t)1 << 32);
+        uint64_t t0 = cumo_philox_bernoulli_threshold(0.0);
+        uint64_t t1 = cumo_philox_bernoulli_threshold(1.0);
+        for (uint64_t i = 0; i < 1000; ++i) {
+            assert(!cumo_philox_bernoulli(st, i, t0));
+            assert(cumo_philox_bernoulli(st, i, t1));
+        }
+        uint64_t t = cumo_philox_bernoulli_threshold(0.3);
+        CheckMoments([&](uint64_t i) { return (double)cumo_philox_bernoulli(st, i, t); }, 0.3, 0.21);
+    }
+
+    void TestSearchCdf() {
+        const double cdf[4] = {1.0, 1.0, 3.0, 4.0};  // probs = {1, 0, 2, 1}
+        assert(cumo_philox_search_cdf(cdf, 4, 0.0) == 0);
+        assert(cumo_philox_search_cdf(cdf, 4, 0.2) == 0);
+        assert(cumo_philox_search_cdf(cdf, 4, 0.25) == 2);
+        assert(cumo_philox_search_cdf(cdf, 4, 0.74) == 2);
+        assert(cumo_philox_search_cdf(cdf, 4, 0.75) == 3);
+        assert(cumo_philox_search_cdf(cdf, 4, 0.999) == 3);
+    }
+
+private:
+    static void Fill(cumo_philox_state_t st, size_t beg, size_t end, uint32_t* out) {
+        uint32_t w[4];
+        for (size_t i = beg; i < end; ++i) {
+            cumo_philox_generate(st, i, 0, w);
+            out[i] = w[0];
+        }
+    }
+
+    // Checks sample mean and variance within 5 standard errors.
+    template <typename F>
+    static void CheckMoments(F sample, double mean, double var) {
+        const uint64_t n = 200000;
+        double s = 0, s2 = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            double x = sample(i);
+            s += x;
+            s2 += x * x;
+        }
+        double m = s / n;
+        double v = s2 / n - m * m;
+        assert(std::fabs(m - mean) < 5 * std::sqrt(var / n));
+        assert(std::fabs(v - var) < 0.05 * var);
+    }
+};
+
+}  // namespace internal
+}  // namespace cumo
+
+int main() {
+    cumo::internal::TestPhilox{}.Run();
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include "ruby.h"
 #include "cumo/narray.h"
-#include "SFMT.h"
+#include "cumo/philox.h"
+#include "cumo/cuda/memory_pool.h"
+#include "cumo/cuda/runtime.h"
 
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
@@ -10,6 +12,10 @@
 #include <sys/time.h>
 #endif
 
+// Philox is counter-based. Each draw reserves a range of counters so that
+// every element gets its own counter independently of thread/block counts.
+static cumo_philox_state_t cumo_rand_state;
+
 static u_int64_t
 random_seed()
 {
@@ -20,20 +26,79 @@ random_seed()
     return tv.tv_sec ^ tv.tv_usec ^ getpid() ^ n++;
 }
 
+/*
+  Reserves counters for n elements and returns the state to draw them.
+  Called from rand iterators with the GVL held.
+*/
+cumo_philox_state_t
+cumo_na_rand_reserve(uint64_t n)
+{
+    cumo_philox_state_t st = cumo_rand_state;
+    cumo_rand_state.offset += n;
+    return st;
+}
+
+void cumo_na_rand_cdf_kernel_launch(double *cdf, const double *probs, uint64_t k);
+
+/*
+  Builds an unnormalized cdf of probs on the device for categorical samplers.
+  Negative probabilities are treated as 0.
+  Returns a pointer allocated by cumo_cuda_runtime_malloc, which the caller must free.
+*/
+double*
+cumo_na_rand_make_cdf(VALUE probs, uint64_t *k)
+{
+    cumo_narray_t *na;
+    double *cdf;
+
+    probs = rb_funcall(cumo_cDFloat, rb_intern("cast"), 1, probs);
+    CumoGetNArray(probs, na);
+    if (CUMO_NA_NDIM(na) != 1) {
+        rb_raise(cumo_na_eShapeError, "probs must be 1-dimensional");
+    }
+    if (CUMO_NA_SIZE(na) == 0) {
+        rb_raise(rb_eArgError, "probs must not be empty");
+    }
+    if (cumo_na_check_contiguous(probs) != Qtrue) {
+        probs = rb_funcall(probs, rb_intern("dup"), 0);
+    }
+    *k = CUMO_NA_SIZE(na);
+    cdf = (double*)cumo_cuda_runtime_malloc(sizeof(double) * (*k));
+    cumo_na_rand_cdf_kernel_launch(cdf, (double*)(cumo_na_get_pointer_for_read(probs) + cumo_na_get_offset(probs)), *k);
+    RB_GC_GUARD(probs);
+    return cdf;
+}
+
+/*
+  Set random seed and substream, and reset the counter.
+  @overload srand([seed,[substream]])
+  @param [Integer] seed  random seed. (default: derived from time and pid)
+  @param [Integer] substream  id of an independent stream with the same seed,
+    e.g., rank of a data-parallel worker. (default=0)
+  @return [nil]
+  @example
+    Cumo::NArray.srand(42, rank)
+*/
 static VALUE
 cumo_na_s_srand(int argc, VALUE *argv, VALUE obj)
 {
-    VALUE vseed;
+    VALUE vseed, vsubstream;
     u_int64_t seed;
+    u_int32_t substream = 0;
 
     //rb_secure(4);
-    if (rb_scan_args(argc, argv, "01", &vseed) == 0) {
+    if (rb_scan_args(argc, argv, "02", &vseed, &vsubstream) == 0) {
         seed = random_seed();
     }
     else {
         seed = NUM2UINT64(vseed);
     }
-    init_gen_rand(seed);
+    if (vsubstream != Qnil) {
+        substream = NUM2UINT32(vsubstream);
+    }
+    cumo_rand_state.seed = seed;
+    cumo_rand_state.substream = substream;
+    cumo_rand_state.offset = 0;
 
     return Qnil;
 }
@@ -41,5 +106,7 @@ cumo_na_s_srand(int argc, VALUE *argv, VALUE obj)
 void
 Init_cumo_na_rand() {
     rb_define_singleton_method(cNArray, "srand", cumo_na_s_srand, -1);
-    init_gen_rand(0);
+    cumo_rand_state.seed = random_seed();
+    cumo_rand_state.substream = 0;
+    cumo_rand_state.offset = 0;
 }
@@ -0,0 +1,32 @@
+#include "cumo/narray_kernel.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#if 0
+} /* satisfy cc-mode */
+#endif
+#endif
+
+// Probabilities are usually short, so a single thread builds the cdf.
+// This avoids a round trip to the host and stays ordered with the sampling kernel.
+__global__ void cumo_na_rand_cdf_kernel(double *cdf, const double *probs, uint64_t k)
+{
+    double sum = 0;
+    for (uint64_t i = 0; i < k; ++i) {
+        double p = probs[i];
+        if (p > 0) sum += p;
+        cdf[i] = sum;
+    }
+}
+
+void cumo_na_rand_cdf_kernel_launch(double *cdf, const double *probs, uint64_t k)
+{
+    cumo_na_rand_cdf_kernel<<<1, 1, 0, cumo_cuda_stream_current()>>>(cdf, probs, k);
+}
+
+#if defined(__cplusplus)
+#if 0
+{ /* satisfy cc-mode */
+#endif
+}  /* extern "C" { */
+#endif
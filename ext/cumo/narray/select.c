@@ -0,0 +1,164 @@
+#include <ruby.h>
+#include "cumo.h"
+#include "cumo/narray.h"
+#include "cumo/template.h"
+#include "cumo/select.h"
+
+/*
+  Returns self arranged as rows for selection along axis. The last axis of
+  the rows is axis, or the only axis if axis is nil, and the rows are
+  contiguous. Sets *ax to axis normalized to non-negative, or -1 if axis
+  is nil.
+*/
+VALUE
+cumo_na_select_rows(VALUE self, VALUE axis, int *ax)
+{
+    int nd;
+    cumo_narray_t *na;
+
+    CumoGetNArray(self,na);
+    nd = na->ndim;
+    if (nd == 0) {
+        rb_raise(cumo_na_eDimensionError,"zero dimensional narray");
+    }
+    if (NIL_P(axis)) {
+        *ax = -1;
+        if (nd > 1) {
+            self = cumo_na_flatten(self);
+        }
+    } else {
+        *ax = NUM2INT(axis);
+        if (*ax < -nd || *ax >= nd) {
+            rb_raise(cumo_na_eDimensionError,"invalid axis (%d for %d-dimension)",
+                     *ax, nd);
+        }
+        if (*ax < 0) {
+            *ax += nd;
+        }
+        if (*ax != nd-1) {
+            self = rb_funcall(self, rb_intern("swapaxes"), 2, INT2FIX(*ax), INT2FIX(-1));
+        }
+    }
+    if (cumo_na_check_contiguous(self) == Qfalse) {
+        self = cumo_na_copy(self);
+    }
+    return self;
+}
+
+/*
+  Returns the pointer to the first element of rows.
+*/
+char*
+cumo_na_select_rows_pointer(VALUE rows)
+{
+    return cumo_na_get_pointer_for_read(rows) + cumo_na_get_offset(rows);
+}
+
+/*
+  Returns a new array of type, whose shape is that of rows except that the
+  last axis has k elements.
+*/
+VALUE
+cumo_na_select_new(VALUE type, VALUE rows, size_t k)
+{
+    int i;
+    size_t *shape;
+    cumo_narray_t *na;
+
+    CumoGetNArray(rows,na);
+    shape = ALLOCA_N(size_t, na->ndim);
+    for (i = 0; i < na->ndim - 1; i++) {
+        shape[i] = na->shape[i];
+    }
+    shape[na->ndim - 1] = k;
+    return cumo_na_new(type, na->ndim, shape);
+}
+
+/*
+  Moves the last axis of result, which has the shape of rows, back to ax.
+*/
+VALUE
+cumo_na_select_restore(VALUE result, int ax)
+{
+    cumo_narray_t *na;
+
+    CumoGetNArray(result,na);
+    if (ax < 0 || ax == na->ndim - 1) {
+        return result;
+    }
+    return rb_funcall(result, rb_intern("swapaxes"), 2, INT2FIX(ax), INT2FIX(-1));
+}
+
+/*
+  Returns self arranged as rows for reduction over the dimensions flagged
+  in reduce, which are moved to the last, so that the elements of each row
+  are contiguous. Sets *n to the number of elements of a row, and *ndim and
+  shape to those of the result, in which reduced dimensions are left with
+  size one if keepdims. shape has room for the dimensions of self.
+*/
+VALUE
+cumo_na_select_reduce_rows(VALUE self, VALUE reduce, int keepdims, size_t *n, int *ndim, size_t *shape)
+{
+    int i, j, nd;
+    int *map;
+    VALUE *argv;
+    cumo_narray_t *na;
+
+    CumoGetNArray(self,na);
+    nd = na->ndim;
+    map = ALLOCA_N(int, nd);
+    *n = 1;
+    *ndim = 0;
+    for (i = j = 0; i < nd; i++) {
+        if (cumo_na_test_reduce(reduce, i)) {
+            *n *= na->shape[i];
+            if (keepdims) {
+                shape[(*ndim)++] = 1;
+            }
+        } else {
+            map[j++] = i;
+            shape[(*ndim)++] = na->shape[i];
+        }
+    }
+    for (i = 0; i < nd; i++) {
+        if (cumo_na_test_reduce(reduce, i)) {
+            map[j++] = i;
+        }
+    }
+    for (i = 0; i < nd && map[i] == i; i++);
+    if (i < nd) {
+        argv = ALLOCA_N(VALUE, nd);
+        for (i = 0; i < nd; i++) {
+            argv[i] = INT2FIX(map[i]);
+        }
+        self = rb_funcallv(self, rb_intern("transpose"), nd, argv);
+    }
+    if (cumo_na_check_contiguous(self) == Qfalse) {
+        self = cumo_na_copy(self);
+    }
+    return self;
+}
+
+/*
+  Returns the interpolation of quantiles named by interp, a Symbol or String
+  of linear, lower, higher, midpoint or nearest.
+*/
+int
+cumo_na_select_interpolation(VALUE interp)
+{
+    ID id = rb_to_id(interp);
+
+    if (id == rb_intern("linear")) {
+        return CUMO_SELECT_LINEAR;
+    } else if (id == rb_intern("lower")) {
+        return CUMO_SELECT_LOWER;
+    } else if (id == rb_intern("higher")) {
+        return CUMO_SELECT_HIGHER;
+    } else if (id == rb_intern("midpoint")) {
+        return CUMO_SELECT_MIDPOINT;
+    } else if (id == rb_intern("nearest")) {
+        return CUMO_SELECT_NEAREST;
+    }
+    rb_raise(rb_eArgError, "unknown interpolation: %"PRIsVALUE, interp);
+    return -1;
+}
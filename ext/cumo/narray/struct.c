@@ -3,6 +3,7 @@
 #include "cumo/template.h"
 #include "cumo/cuda/memory_pool.h"
 #include "cumo/cuda/runtime.h"
+#include "cumo/cuda/stream.h"
 
 #define cT cumo_cStruct
 VALUE cT;
@@ -152,7 +153,7 @@ cumo_na_make_view_struct(VALUE self, VALUE dtype, VALUE offset)
                 //     idx2[i] = idx1[i];
                 // }
                 idx2 = (size_t*)cumo_cuda_runtime_malloc(sizeof(size_t)*n);
-                cumo_cuda_runtime_check_status(cudaMemcpyAsync(idx2,idx1,sizeof(size_t)*n,cudaMemcpyDeviceToDevice,0));
+                cumo_cuda_runtime_check_status(cudaMemcpyAsync(idx2,idx1,sizeof(size_t)*n,cudaMemcpyDeviceToDevice,cumo_cuda_stream_current()));
                 CUMO_SDX_SET_INDEX(na2->stridx[j],idx2);
             } else {
                 na2->stridx[j] = na1->stridx[j];
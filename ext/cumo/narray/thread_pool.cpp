@@ -0,0 +1,136 @@
+#include <ruby.h>
+#include <ruby/thread.h>
+#include "thread_pool_impl.hpp"
+#include "cumo/thread_pool.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(__cplusplus)
+extern "C" {
+#if 0
+} /* satisfy cc-mode */
+#endif
+#endif
+
+// Workers are created on the first parallel loop. num_threads is changed
+// only with the GVL.
+static size_t num_threads = 1;
+static std::mutex pool_mutex;
+static std::unique_ptr<cumo::internal::ThreadPool> pool;
+static pid_t pool_pid;
+
+size_t
+cumo_thread_pool_get_num_threads(void)
+{
+    return num_threads;
+}
+
+struct parallel_for_param {
+    size_t n;
+    size_t grain;
+    cumo::internal::Schedule schedule;
+    size_t max_threads;
+    cumo_thread_pool_func_t func;
+    void *data;
+    std::atomic<bool> cancel;
+};
+
+static void*
+parallel_for_without_gvl_cb(void *ptr)
+{
+    struct parallel_for_param *p = static_cast<struct parallel_for_param*>(ptr);
+
+    // one loop at a time, so that the pool is not replaced while in use
+    std::lock_guard<std::mutex> lock{pool_mutex};
+    if (pool && pool_pid != getpid()) {
+        // workers do not survive fork, and joining them would hang
+        pool.release();
+    }
+    if (!pool || pool->GetNumThreads() != num_threads) {
+        pool.reset(new cumo::internal::ThreadPool(num_threads));
+        pool_pid = getpid();
+    }
+    pool->ParallelFor(p->n, p->grain, p->schedule, p->max_threads, p->func, p->data, &p->cancel);
+    return NULL;
+}
+
+// Called when the Ruby thread is interrupted, e.g., by Ctrl-C. Chunks not
+// started yet are skipped, and the interrupt is raised after the loop returns.
+static void
+parallel_for_ubf(void *ptr)
+{
+    struct parallel_for_param *p = static_cast<struct parallel_for_param*>(ptr);
+    p->cancel = true;
+}
+
+void
+cumo_thread_pool_parallel_for(size_t n, size_t grain, int work_stealing, size_t max_threads, cumo_thread_pool_func_t func, void *data)
+{
+    struct parallel_for_param param = {
+        n, grain, work_stealing ? cumo::internal::Schedule::kWorkStealing : cumo::internal::Schedule::kStatic, max_threads, func, data, {false}};
+
+    if (num_threads <= 1 || max_threads <= 1) {
+        func(0, n, 0, data);
+        return;
+    }
+    rb_thread_call_without_gvl(parallel_for_without_gvl_cb, &param, parallel_for_ubf, &param);
+}
+
+/*
+  Returns the number of host threads to run host loops, such as sort and
+  cumsum, in parallel. The default is the number of CPU cores, or
+  CUMO_HOST_THREADS environment variable.
+
+  @return [Integer] number of threads
+*/
+static VALUE
+rb_host_threads(VALUE self)
+{
+    return SIZET2NUM(num_threads);
+}
+
+/*
+  Sets the number of host threads. 1 runs host loops serially.
+
+  @param [Integer] n number of threads
+  @return [Integer] n
+*/
+static VALUE
+rb_set_host_threads(VALUE self, VALUE n)
+{
+    long value = NUM2LONG(n);
+    if (value < 1) {
+        rb_raise(rb_eArgError, "host_threads must be positive: %ld", value);
+    }
+    num_threads = (size_t)value;
+    return n;
+}
+
+void
+Init_cumo_na_thread_pool()
+{
+    VALUE mCumo = rb_define_module("Cumo");
+
+    rb_define_singleton_method(mCumo, "host_threads", RUBY_METHOD_FUNC(rb_host_threads), 0);
+    rb_define_singleton_method(mCumo, "host_threads=", RUBY_METHOD_FUNC(rb_set_host_threads), 1);
+
+    const char* env = std::getenv("CUMO_HOST_THREADS");
+    if (env != nullptr && std::atol(env) > 0) {
+        num_threads = std::atol(env);
+    } else {
+        num_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+}
+
+#if defined(__cplusplus)
+#if 0
+{ /* satisfy cc-mode */
+#endif
+}  /* extern "C" { */
+#endif
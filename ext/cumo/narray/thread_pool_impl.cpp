@@ -0,0 +1,143 @@
+#include "thread_pool_impl.hpp"
+
+#include <algorithm>
+
+namespace cumo {
+namespace internal {
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : num_threads_(std::max<size_t>(num_threads, 1)),
+      ranges_(new Range[std::max<size_t>(num_threads, 1)]) {
+    // the caller of ParallelFor is thread 0
+    for (size_t tid = 1; tid < num_threads_; ++tid) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this, tid);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::WorkerLoop(size_t tid) {
+    uint64_t generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != generation; });
+            if (stop_) {
+                return;
+            }
+            generation = generation_;
+        }
+        Run(tid);
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (--pending_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(size_t n, size_t grain, Schedule schedule, size_t max_threads, ThreadPoolFunc func, void* data, const std::atomic<bool>* cancel) {
+    if (n == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    size_t num_used = std::min(std::min(num_threads_, std::max<size_t>(max_threads, 1)), (n + grain - 1) / grain);
+    if (num_used <= 1) {
+        func(0, n, 0, data);
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock{run_mutex_};
+    grain_ = grain;
+    num_used_ = num_used;
+    schedule_ = schedule;
+    func_ = func;
+    data_ = data;
+    cancel_ = cancel;
+    for (size_t tid = 0; tid < num_used; ++tid) {
+        std::lock_guard<std::mutex> lock{ranges_[tid].mutex};
+        ranges_[tid].begin = GetStaticBegin(n, num_used, tid);
+        ranges_[tid].end = GetStaticBegin(n, num_used, tid + 1);
+    }
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        pending_ = workers_.size();
+        ++generation_;
+    }
+    start_cv_.notify_all();
+
+    Run(0);
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    done_cv_.wait(lock, [&] { return pending_ == 0; });
+    cancel_ = nullptr;
+}
+
+void ThreadPool::Run(size_t tid) {
+    if (tid >= num_used_ || Cancelled()) {
+        return;
+    }
+    size_t begin, end;
+    if (schedule_ == Schedule::kStatic) {
+        begin = ranges_[tid].begin;
+        end = ranges_[tid].end;
+        if (begin < end) {
+            func_(begin, end, tid, data_);
+        }
+        return;
+    }
+    for (;;) {
+        while (!Cancelled() && Take(tid, &begin, &end)) {
+            func_(begin, end, tid, data_);
+        }
+        if (Cancelled() || !Steal(tid, &begin, &end)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock{ranges_[tid].mutex};
+        ranges_[tid].begin = begin;
+        ranges_[tid].end = end;
+    }
+}
+
+bool ThreadPool::Take(size_t tid, size_t* begin, size_t* end) {
+    Range& range = ranges_[tid];
+    std::lock_guard<std::mutex> lock{range.mutex};
+    if (range.begin >= range.end) {
+        return false;
+    }
+    *begin = range.begin;
+    *end = std::min(range.begin + grain_, range.end);
+    range.begin = *end;
+    return true;
+}
+
+bool ThreadPool::Steal(size_t tid, size_t* begin, size_t* end) {
+    for (size_t i = 1; i < num_used_; ++i) {
+        Range& victim = ranges_[(tid + i) % num_used_];
+        std::lock_guard<std::mutex> lock{victim.mutex};
+        if (victim.begin >= victim.end) {
+            continue;
+        }
+        size_t remaining = victim.end - victim.begin;
+        // leave the front half, which the victim works on next
+        size_t mid = remaining <= grain_ ? victim.begin : victim.begin + remaining / 2;
+        *begin = mid;
+        *end = victim.end;
+        victim.end = mid;
+        return true;
+    }
+    return false;
+}
+
+} // namespace internal
+} // namespace cumo
@@ -0,0 +1,99 @@
+#ifndef CUMO_NARRAY_THREAD_POOL_IMPL_H
+#define CUMO_NARRAY_THREAD_POOL_IMPL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Host thread pool to split loops of host iterators.
+//
+// This header does not depend on Ruby so that the scheduling can be tested
+// on host only.
+
+namespace cumo {
+namespace internal {
+
+enum class Schedule {
+    // Thread t runs [t*n/T, (t+1)*n/T) at once. For loops whose iterations
+    // cost the same.
+    kStatic,
+    // Threads start with the static ranges, take grain iterations at a time
+    // from the front of their own range, and steal the back half of another
+    // range when theirs is empty. For loops with uneven iterations.
+    kWorkStealing,
+};
+
+// Calls func(begin, end, tid, data) for chunks of [begin, end).
+typedef void (*ThreadPoolFunc)(size_t begin, size_t end, size_t tid, void* data);
+
+// Thread pool of num_threads threads including the caller of ParallelFor.
+//
+// - One ParallelFor runs at a time. Others wait for it.
+// - Workers are created at construction and sleep between loops.
+class ThreadPool {
+private:
+    struct Range {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    size_t num_threads_;
+    std::vector<std::thread> workers_;
+    std::unique_ptr<Range[]> ranges_;
+
+    std::mutex run_mutex_; // held during a ParallelFor
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    size_t pending_ = 0;
+    bool stop_ = false;
+
+    // current loop
+    size_t grain_ = 1;
+    size_t num_used_ = 0;
+    Schedule schedule_ = Schedule::kStatic;
+    ThreadPoolFunc func_ = nullptr;
+    void* data_ = nullptr;
+    const std::atomic<bool>* cancel_ = nullptr;
+
+    void WorkerLoop(size_t tid);
+
+    void Run(size_t tid);
+
+    bool Cancelled() const { return cancel_ != nullptr && *cancel_; }
+
+    bool Take(size_t tid, size_t* begin, size_t* end);
+
+    bool Steal(size_t tid, size_t* begin, size_t* end);
+
+public:
+    explicit ThreadPool(size_t num_threads);
+
+    ~ThreadPool();
+
+    size_t GetNumThreads() const { return num_threads_; }
+
+    // Runs func over [0, n) with at most max_threads threads (tid < max_threads),
+    // using fewer if there are less than grain iterations per thread.
+    // Returns after all iterations finish, or after running chunks finish
+    // once *cancel becomes true, leaving the other iterations undone.
+    void ParallelFor(size_t n, size_t grain, Schedule schedule, size_t max_threads, ThreadPoolFunc func, void* data, const std::atomic<bool>* cancel = nullptr);
+
+// private:
+
+    static size_t GetStaticBegin(size_t n, size_t num_threads, size_t tid) {
+        return n / num_threads * tid + (tid < n % num_threads ? tid : n % num_threads);
+    }
+};
+
+} // namespace internal
+} // namespace cumo
+
+#endif /* ifndef CUMO_NARRAY_THREAD_POOL_IMPL_H */
@@ -0,0 +1,227 @@
+#include "thread_pool_impl.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+
+// Host-only tests of ThreadPool scheduling.
+
+namespace cumo {
+namespace internal {
+
+struct Visit {
+    std::vector<std::atomic<int>> count;
+    std::vector<std::atomic<int>> tid_of;
+    std::atomic<size_t> calls{0};
+    std::atomic<size_t> max_chunk{0};
+    size_t max_tid = 0;
+
+    explicit Visit(size_t n) : count(n), tid_of(n) {
+        for (size_t i = 0; i < n; ++i) {
+            count[i] = 0;
+            tid_of[i] = -1;
+        }
+    }
+
+    static void Func(size_t begin, size_t end, size_t tid, void* data) {
+        Visit* v = static_cast<Visit*>(data);
+        assert(begin < end);
+        assert(tid < v->max_tid);
+        for (size_t i = begin; i < end; ++i) {
+            ++v->count[i];
+            v->tid_of[i] = static_cast<int>(tid);
+        }
+        ++v->calls;
+        size_t chunk = end - begin;
+        size_t prev = v->max_chunk;
+        while (chunk > prev && !v->max_chunk.compare_exchange_weak(prev, chunk)) {
+        }
+    }
+
+    bool AllOnce() const {
+        for (const auto& c : count) {
+            if (c != 1) return false;
+        }
+        return true;
+    }
+};
+
+class TestThreadPool {
+public:
+    void Run() {
+        TestStaticBegin();
+        TestSingleThread();
+        TestStatic();
+        TestWorkStealing();
+        TestMaxThreads();
+        TestSmallLoop();
+        TestStealFromSlowThread();
+        TestRepeat();
+        TestCancel();
+    }
+
+    void TestStaticBegin() {
+        // 10 over 4 threads: 3, 3, 2, 2
+        assert(ThreadPool::GetStaticBegin(10, 4, 0) == 0);
+        assert(ThreadPool::GetStaticBegin(10, 4, 1) == 3);
+        assert(ThreadPool::GetStaticBegin(10, 4, 2) == 6);
+        assert(ThreadPool::GetStaticBegin(10, 4, 3) == 8);
+        assert(ThreadPool::GetStaticBegin(10, 4, 4) == 10);
+        assert(ThreadPool::GetStaticBegin(2, 4, 3) == 2);
+    }
+
+    void TestSingleThread() {
+        ThreadPool pool{1};
+        assert(pool.GetNumThreads() == 1);
+        Visit v{100};
+        v.max_tid = 1;
+        pool.ParallelFor(100, 1, Schedule::kStatic, 8, Visit::Func, &v);
+        assert(v.AllOnce());
+        assert(v.calls == 1);
+    }
+
+    void TestStatic() {
+        ThreadPool pool{4};
+        Visit v{1000};
+        v.max_tid = 4;
+        pool.ParallelFor(1000, 1, Schedule::kStatic, 4, Visit::Func, &v);
+        assert(v.AllOnce());
+        assert(v.calls == 4);
+        // contiguous ranges in order of tid
+        for (size_t i = 0; i < 1000; ++i) {
+            assert(v.tid_of[i] == static_cast<int>(i / 250));
+        }
+    }
+
+    void TestWorkStealing() {
+        ThreadPool pool{4};
+        Visit v{1001};
+        v.max_tid = 4;
+        pool.ParallelFor(1001, 10, Schedule::kWorkStealing, 4, Visit::Func, &v);
+        assert(v.AllOnce());
+        assert(v.max_chunk <= 10);
+    }
+
+    void TestMaxThreads() {
+        ThreadPool pool{8};
+        Visit v{1000};
+        v.max_tid = 2;
+        pool.ParallelFor(1000, 1, Schedule::kWorkStealing, 2, Visit::Func, &v);
+        assert(v.AllOnce());
+    }
+
+    void TestSmallLoop() {
+        ThreadPool pool{4};
+        Visit v{5};
+        v.max_tid = 4;
+        // less than a grain per thread runs on the caller
+        pool.ParallelFor(5, 10, Schedule::kStatic, 4, Visit::Func, &v);
+        assert(v.AllOnce());
+        assert(v.calls == 1);
+        assert(v.tid_of[0] == 0);
+        pool.ParallelFor(0, 1, Schedule::kStatic, 4, Visit::Func, &v);
+        assert(v.calls == 1);
+    }
+
+    struct Slow {
+        std::vector<std::atomic<int>> count;
+        std::atomic<size_t> done_by_others{0};
+
+        explicit Slow(size_t n) : count(n) {
+            for (auto& c : count) c = 0;
+        }
+
+        // iterations in the first quarter are slow
+        static void Func(size_t begin, size_t end, size_t tid, void* data) {
+            Slow* s = static_cast<Slow*>(data);
+            for (size_t i = begin; i < end; ++i) {
+                if (i < s->count.size() / 4) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    if (tid != 0) ++s->done_by_others;
+                }
+                ++s->count[i];
+            }
+        }
+    };
+
+    void TestStealFromSlowThread() {
+        ThreadPool pool{4};
+        Slow s{400};
+        pool.ParallelFor(400, 1, Schedule::kWorkStealing, 4, Slow::Func, &s);
+        for (auto& c : s.count) {
+            assert(c == 1);
+        }
+        // others finish their ranges fast and steal from thread 0
+        assert(s.done_by_others > 0);
+    }
+
+    void TestRepeat() {
+        ThreadPool pool{3};
+        for (int k = 0; k < 200; ++k) {
+            Visit v{97};
+            v.max_tid = 3;
+            pool.ParallelFor(97, 1 + k % 7, (k & 1) ? Schedule::kStatic : Schedule::kWorkStealing, 3, Visit::Func, &v);
+            assert(v.AllOnce());
+        }
+        // concurrent callers run one loop at a time
+        std::vector<std::thread> callers;
+        for (int k = 0; k < 4; ++k) {
+            callers.emplace_back([&pool] {
+                for (int r = 0; r < 50; ++r) {
+                    Visit v{64};
+                    v.max_tid = 3;
+                    pool.ParallelFor(64, 4, Schedule::kWorkStealing, 3, Visit::Func, &v);
+                    assert(v.AllOnce());
+                }
+            });
+        }
+        for (auto& t : callers) t.join();
+    }
+
+    struct Cancel {
+        std::vector<std::atomic<int>> count;
+        std::atomic<bool> cancel{false};
+
+        explicit Cancel(size_t n) : count(n) {
+            for (auto& c : count) c = 0;
+        }
+
+        // cancels the loop after the first chunk
+        static void Func(size_t begin, size_t end, size_t tid, void* data) {
+            Cancel* c = static_cast<Cancel*>(data);
+            for (size_t i = begin; i < end; ++i) {
+                ++c->count[i];
+            }
+            c->cancel = true;
+        }
+    };
+
+    void TestCancel() {
+        ThreadPool pool{4};
+        Cancel c{10000};
+        pool.ParallelFor(10000, 1, Schedule::kWorkStealing, 4, Cancel::Func, &c, &c.cancel);
+        size_t done = 0;
+        for (auto& n : c.count) {
+            assert(n <= 1);
+            done += n;
+        }
+        // each thread finishes at most the chunk it runs
+        assert(done > 0 && done <= 4);
+        // the next loop is not cancelled
+        Visit v{100};
+        v.max_tid = 4;
+        pool.ParallelFor(100, 1, Schedule::kWorkStealing, 4, Visit::Func, &v);
+        assert(v.AllOnce());
+    }
+};
+
+} // namespace internal
+} // namespace cumo
+
+int main() {
+    cumo::internal::TestThreadPool{}.Run();
+    return 0;
+}
@@ -1,3 +1,6 @@
 require_relative File.join(__dir__, '../ext/cumo/cumo')
 require_relative 'cumo/cuda'
 require_relative 'cumo/narray/extra'
+require_relative 'cumo/elementwise_kernel'
+require_relative 'cumo/reduction_kernel'
+require_relative 'cumo/lazy_array'
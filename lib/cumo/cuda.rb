@@ -6,6 +6,11 @@ end
 require_relative 'cuda/compile_error'
 require_relative 'cuda/compiler'
 require_relative 'cuda/device'
+require_relative 'cuda/function'
+require_relative 'cuda/jit'
+require_relative 'cuda/jit_source'
+require_relative 'cuda/kernel_source'
 require_relative 'cuda/module'
 require_relative 'cuda/link_state'
 require_relative 'cuda/nvrtc_program'
+require_relative 'cuda/stream'
@@ -0,0 +1,15 @@
+require_relative '../cuda'
+
+module Cumo::CUDA
+  # CUDA kernel function.
+  # Launchers for user-defined kernels are defined in ext/cumo/cuda/function.c.
+  class Function
+    attr_reader :module, :name, :ptr
+
+    def initialize(mod, name)
+      @module = mod # keeps the module alive while the function is used
+      @name = name
+      @ptr = Driver.cuModuleGetFunction(mod.ptr, name)
+    end
+  end
+end
@@ -0,0 +1,34 @@
+require_relative '../cuda'
+
+module Cumo::CUDA
+  # Compilation of kernels of generated NArray methods left out of the
+  # extension library by the allowlist of JITSource.
+  # Called by ext/cumo/cuda/function.c on the first launch of each kernel.
+  module JIT
+    # [name, device id] => Module, which keeps loaded modules of compiled
+    # kernels. Modules are loaded into the context of each device.
+    @modules = {}
+
+    module_function
+
+    # Compiles the kernel of binary op for type_name specialized for ndim.
+    # @param [String] type_name  NArray type name such as "dfloat".
+    # @param [String] op  operator such as "add".
+    # @param [Integer] ndim  number of dimensions.
+    # @return [Integer,nil] CUfunction handle on the current device, or nil
+    #   if JIT is disabled by CUMO_JIT=0 or NVRTC failed to compile the
+    #   kernel, in which case the kernel for any ndim is used.
+    def binary(type_name, op, ndim)
+      return nil if ENV['CUMO_JIT'] == '0'
+      name = JITSource.binary_name(type_name, op, ndim)
+      source = JITSource.binary(type_name, op, ndim)
+      mod = @modules[[name, Runtime.cudaGetDevice]] ||= begin
+        Compiler.new.compile_with_cache(source)
+      rescue CompileError => e
+        warn "cumo: failed to compile #{name}, falling back to the kernel for any ndim: #{e.message}"
+        return nil
+      end
+      mod.get_function(name).ptr
+    end
+  end
+end
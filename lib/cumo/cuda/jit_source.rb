@@ -0,0 +1,125 @@
+require_relative 'kernel_source'
+
+module Cumo::CUDA
+  # Split of kernels of generated NArray methods into ones compiled ahead of
+  # time into the extension library and the long tail compiled by NVRTC on
+  # first use (Cumo::CUDA::JIT), and source generation of the latter.
+  #
+  # ext/cumo/narray/gen/cogen_kernel.rb uses this module at build time, so
+  # it does not touch the device nor require nvcc.
+  #
+  # Only the specializations of binary operators for ndim in
+  # 0..CUMO_NA_INDEXER_OPTIMIZED_NDIM are split. The kernel for any ndim is
+  # always compiled ahead of time, and used if JIT is not available.
+  module JITSource
+    # Binary operators whose kernels can be compiled by NVRTC, as the
+    # expression of operands x and y. These must match m_<op> in
+    # cumo/types/float_macro_kernel.h and cumo/types/xint_macro_kernel.h.
+    FLOAT_BINARY_OPS = {
+      'add'      => '(x)+(y)',
+      'sub'      => '(x)-(y)',
+      'mul'      => '(x)*(y)',
+      'div'      => '(x)/(y)',
+      'mod'      => 'fmod(x,y)',
+      'copysign' => 'copysign(x,y)',
+    }
+
+    INT_BINARY_OPS = {
+      'add'         => '(x)+(y)',
+      'sub'         => '(x)-(y)',
+      'mul'         => '(x)*(y)',
+      'div'         => '(x)/(y)',
+      'mod'         => '(x)%(y)',
+      'bit_and'     => '(x)&(y)',
+      'bit_or'      => '(x)|(y)',
+      'bit_xor'     => '(x)^(y)',
+      'left_shift'  => '(x)<<(y)',
+      'right_shift' => '(x)>>(y)',
+    }
+
+    FLOAT_TYPES = %w[float64 float32]
+
+    # A line of the allowlist, "type_name op [ndim,...]", in which "*"
+    # matches any type_name or op, and ndims of nil matches any ndim.
+    Rule = Struct.new(:type_name, :op, :ndims) do
+      def match?(type_name, op, ndim)
+        (self.type_name == '*' || self.type_name == type_name) &&
+          (self.op == '*' || self.op == op) &&
+          (ndims.nil? || ndims.include?(ndim))
+      end
+    end
+
+    module_function
+
+    # Parses the allowlist of kernels compiled ahead of time into an Array
+    # of Rule. "#" starts a comment.
+    def parse_allowlist(text)
+      text.each_line.with_index(1).map do |line, lineno|
+        tokens = line.sub(/#.*/, '').split
+        next if tokens.empty?
+        unless (2..3).cover?(tokens.size) && (tokens[2].nil? || /\A\d+(,\d+)*\z/.match?(tokens[2]))
+          raise ArgumentError, "invalid allowlist line #{lineno}: #{line.strip.inspect}"
+        end
+        Rule.new(tokens[0], tokens[1], tokens[2]&.split(',')&.map(&:to_i))
+      end.compact
+    end
+
+    def load_allowlist(path)
+      parse_allowlist(File.read(path))
+    end
+
+    # KernelSource type name of an NArray type name such as "dfloat", or
+    # nil if it is not supported.
+    def type_of(type_name)
+      type, _ = KernelSource::TYPES.find { |_, v| v[0].downcase == type_name }
+      type
+    end
+
+    def binary_ops(type_name)
+      type = type_of(type_name)
+      return {} unless type
+      FLOAT_TYPES.include?(type) ? FLOAT_BINARY_OPS : INT_BINARY_OPS
+    end
+
+    # Whether the kernel of op for type_name can be compiled by NVRTC.
+    def jit?(type_name, op)
+      binary_ops(type_name).key?(op)
+    end
+
+    # Whether the kernel of op for type_name specialized for ndim is
+    # compiled ahead of time, i.e., it cannot be compiled by NVRTC or it is
+    # matched by one of rules.
+    def aot?(rules, type_name, op, ndim)
+      !jit?(type_name, op) || rules.any? { |rule| rule.match?(type_name, op, ndim) }
+    end
+
+    def binary_name(type_name, op, ndim)
+      "cumo_#{type_name}_#{op}_jit_dim#{ndim}"
+    end
+
+    # Generates the kernel of binary op for type_name specialized for ndim.
+    # The parameters are those of cumo_<type_name>_<op>_kernel_dim<ndim> in
+    # ext/cumo/narray/gen/tmpl/binary_kernel.cu.
+    def binary(type_name, op, ndim)
+      expr = binary_ops(type_name).fetch(op) do
+        raise ArgumentError, "#{op} of #{type_name} is not compiled by NVRTC"
+      end
+      name = binary_name(type_name, op, ndim)
+      index = KernelSource.index_code('_j', 'indexer', ndim, '_k').map { |l| "        #{l}\n" }.join
+      <<-EOS
+#{KernelSource::INDEXER_PREAMBLE}
+typedef #{KernelSource.ctype(type_of(type_name))} dtype;
+
+extern "C" __global__ void #{name}(cumo_na_iarray_t a1, cumo_na_iarray_t a2, cumo_na_iarray_t a3, cumo_na_indexer_t indexer)
+{
+    for (unsigned long long _i = (unsigned long long)blockIdx.x * blockDim.x + threadIdx.x; _i < indexer.total_size; _i += (unsigned long long)blockDim.x * gridDim.x) {
+        unsigned long long _j = _i;
+#{index}        const dtype x = *(const dtype*)(#{KernelSource.offset_expr('a1', ndim, '_k')});
+        const dtype y = *(const dtype*)(#{KernelSource.offset_expr('a2', ndim, '_k')});
+        *(dtype*)(#{KernelSource.offset_expr('a3', ndim, '_k')}) = #{expr};
+    }
+}
+      EOS
+    end
+  end
+end
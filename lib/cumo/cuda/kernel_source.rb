@@ -0,0 +1,250 @@
+module Cumo
+  module CUDA
+  end
+end
+
+module Cumo::CUDA
+  # Source generation of user-defined kernels (Cumo::ElementwiseKernel and
+  # Cumo::ReductionKernel).
+  #
+  # This module does not touch the device so that generated sources can be
+  # tested without CUDA.
+  module KernelSource
+    # CUMO_NA_MAX_DIMENSION in cumo/narray.h
+    MAX_DIMENSION = 12
+    # CUMO_FUNCTION_REDUCTION_BLOCK_DIM in ext/cumo/cuda/function.c
+    REDUCTION_BLOCK_SIZE = 512
+
+    # type name => [NArray class name, C type, byte size]
+    TYPES = {
+      'float64' => ['DFloat', 'double', 8],
+      'float32' => ['SFloat', 'float', 4],
+      'int64'   => ['Int64', 'long long', 8],
+      'int32'   => ['Int32', 'int', 4],
+      'int16'   => ['Int16', 'short', 2],
+      'int8'    => ['Int8', 'signed char', 1],
+      'uint64'  => ['UInt64', 'unsigned long long', 8],
+      'uint32'  => ['UInt32', 'unsigned int', 4],
+      'uint16'  => ['UInt16', 'unsigned short', 2],
+      'uint8'   => ['UInt8', 'unsigned char', 1],
+    }
+
+    VALID_NAME = /\A[a-zA-Z][a-zA-Z_0-9]*\z/
+    RESERVED_NAMES = %w[i]
+
+    # Kernel parameter such as "T x" or "float32 y".
+    # A type which is not a type name of TYPES is a placeholder bound at call.
+    Param = Struct.new(:type, :name) do
+      def placeholder?
+        !TYPES.key?(type)
+      end
+    end
+
+    # Structures passed by value from ext/cumo/cuda/function.c.
+    # Layouts must match cumo/indexer.h.
+    INDEXER_PREAMBLE = <<-EOS
+typedef struct {
+    unsigned char ndim;
+    unsigned long long total_size;
+    unsigned long long shape[#{MAX_DIMENSION}];
+    unsigned long long index[#{MAX_DIMENSION}];
+    unsigned long long raw_index;
+} cumo_na_indexer_t;
+
+typedef struct {
+    char* ptr;
+    long long step[#{MAX_DIMENSION}];
+} cumo_na_iarray_t;
+
+typedef struct {
+    cumo_na_iarray_t in;
+    cumo_na_iarray_t out;
+    cumo_na_indexer_t in_indexer;
+    cumo_na_indexer_t out_indexer;
+} cumo_na_reduction_arg_t;
+    EOS
+
+    module_function
+
+    # Parses "T x, float32 y" into an Array of Param.
+    def parse_params(params)
+      params.split(',').map do |param|
+        tokens = param.split
+        unless tokens.size == 2
+          raise ArgumentError, "invalid kernel parameter: #{param.strip.inspect}"
+        end
+        type, name = tokens
+        unless VALID_NAME.match?(type) && VALID_NAME.match?(name)
+          raise ArgumentError, "invalid kernel parameter: #{param.strip.inspect}"
+        end
+        if RESERVED_NAMES.include?(name)
+          raise ArgumentError, "#{name} is reserved and cannot be used as a parameter name"
+        end
+        Param.new(type, name)
+      end
+    end
+
+    # Checks that parameter names are unique.
+    def check_param_names(params)
+      dup = params.map(&:name).group_by(&:itself).find { |_, v| v.size > 1 }
+      raise ArgumentError, "duplicated parameter name: #{dup[0]}" if dup
+    end
+
+    # Binds placeholders to type names.
+    # types is an Array of type names of arguments, or nil for unknown
+    # (e.g., Ruby scalars), in the order of params.
+    # Returns a Hash of placeholder => type name.
+    def bind_types(params, types)
+      bound = {}
+      params.zip(types).each do |param, type|
+        next if type.nil? || !param.placeholder?
+        if bound.key?(param.type) && bound[param.type] != type
+          raise TypeError, "type mismatch of #{param.type}: #{bound[param.type]} and #{type}"
+        end
+        bound[param.type] = type
+      end
+      bound
+    end
+
+    # Resolves the type name of param with bound placeholders.
+    def resolve_type(param, bound)
+      return param.type unless param.placeholder?
+      bound.fetch(param.type) do
+        raise TypeError, "cannot determine type of #{param.type}"
+      end
+    end
+
+    def ctype(type)
+      TYPES.fetch(type) { raise TypeError, "unsupported type: #{type}" }[1]
+    end
+
+    def byte_size(type)
+      TYPES.fetch(type) { raise TypeError, "unsupported type: #{type}" }[2]
+    end
+
+    def type_of_class_name(class_name)
+      type, _ = TYPES.find { |_, v| v[0] == class_name }
+      raise TypeError, "unsupported dtype: #{class_name}" unless type
+      type
+    end
+
+    def typedefs(bound)
+      bound.sort.map { |placeholder, type| "typedef #{ctype(type)} #{placeholder};\n" }.join
+    end
+
+    # Code to decompose a flat index into per-dimension indices k0, k1, ...
+    def index_code(var, indexer, ndim, prefix)
+      code = []
+      code << "unsigned long long #{(0...ndim).map { |d| "#{prefix}#{d}" }.join(', ')};" if ndim > 0
+      (ndim - 1).downto(1) do |d|
+        code << "#{prefix}#{d} = #{var} % #{indexer}.shape[#{d}]; #{var} /= #{indexer}.shape[#{d}];"
+      end
+      code << "#{prefix}0 = #{var};" if ndim > 0
+      code
+    end
+
+    def offset_expr(iarray, ndim, prefix)
+      (["#{iarray}.ptr"] + (0...ndim).map { |d| "#{iarray}.step[#{d}] * #{prefix}#{d}" }).join(' + ')
+    end
+
+    def param_ctype(param)
+      param.placeholder? ? param.type : ctype(param.type)
+    end
+
+    # Generates an elementwise kernel specialized for ndim.
+    # Inputs are bound to const values and outputs to references, and the
+    # flat index is available as i.
+    def elementwise(name, in_params, out_params, operation, preamble, bound, ndim)
+      params = in_params + out_params
+      args = ['cumo_na_indexer_t _indexer'] + params.map { |p| "cumo_na_iarray_t _#{p.name}" }
+      body = index_code('_j', '_indexer', ndim, '_k').map { |l| "        #{l}\n" }.join
+      in_params.each do |p|
+        t = param_ctype(p)
+        body << "        const #{t} #{p.name} = *(const #{t}*)(#{offset_expr("_#{p.name}", ndim, '_k')});\n"
+      end
+      out_params.each do |p|
+        t = param_ctype(p)
+        body << "        #{t} &#{p.name} = *(#{t}*)(#{offset_expr("_#{p.name}", ndim, '_k')});\n"
+      end
+      <<-EOS
+#{INDEXER_PREAMBLE}
+#{typedefs(bound)}
+#{preamble}
+
+extern "C" __global__ void #{name}(#{args.join(', ')})
+{
+    for (unsigned long long _i = (unsigned long long)blockIdx.x * blockDim.x + threadIdx.x; _i < _indexer.total_size; _i += (unsigned long long)blockDim.x * gridDim.x) {
+        const unsigned long long i = _i;
+        unsigned long long _j = _i;
+#{body}        #{operation};
+    }
+}
+      EOS
+    end
+
+    # Generates a reduction kernel specialized for in_ndim and out_ndim.
+    # The partitioning follows cumo_reduce in cumo/reduce_kernel.h.
+    def reduction(name, in_param, out_param, map_expr, reduce_expr, post_map_expr, identity, reduce_type, preamble, bound, in_ndim, out_ndim)
+      half = REDUCTION_BLOCK_SIZE / 2
+      in_t = param_ctype(in_param)
+      out_t = param_ctype(out_param)
+      in_index = index_code('_j', '_arg.in_indexer', in_ndim, '_k').map { |l| "                #{l}\n" }.join
+      out_index = index_code('_j', '_arg.out_indexer', out_ndim, '_k').map { |l| "            #{l}\n" }.join
+      <<-EOS
+#{INDEXER_PREAMBLE}
+#{typedefs(bound)}
+typedef #{reduce_type} _type_reduce;
+#define REDUCE(a, b) (#{reduce_expr})
+#define POST_MAP(a) (#{post_map_expr})
+#{preamble}
+
+extern "C" __global__ void #{name}(cumo_na_reduction_arg_t _arg, int _out_block_size, int _reduce_block_size)
+{
+    extern __shared__ __align__(8) char _sdata_raw[];
+    _type_reduce *_sdata = (_type_reduce*)_sdata_raw;
+    const unsigned int _tid = threadIdx.x;
+    const long long _out_total = _arg.out_indexer.total_size;
+    const long long _reduce_total = _arg.in_indexer.total_size / _out_total;
+    const long long _reduce_offset = _tid / _out_block_size;
+    const long long _out_offset = _tid % _out_block_size;
+
+    // All threads of a block run the same number of iterations to reach __syncthreads.
+    for (long long _out_base = (long long)blockIdx.x * _out_block_size; _out_base < _out_total; _out_base += (long long)gridDim.x * _out_block_size) {
+        const long long _i_out = _out_base + _out_offset;
+        _type_reduce _acc = _type_reduce(#{identity});
+        if (_i_out < _out_total) {
+            long long _i_in = _i_out * _reduce_total + _reduce_offset;
+            for (long long _i_reduce = _reduce_offset; _i_reduce < _reduce_total; _i_reduce += _reduce_block_size, _i_in += _reduce_block_size) {
+                unsigned long long _j = _i_in;
+#{in_index}                const #{in_t} #{in_param.name} = *(const #{in_t}*)(#{offset_expr('_arg.in', in_ndim, '_k')});
+                _type_reduce _a = _acc, _b = (_type_reduce)(#{map_expr});
+                _acc = REDUCE(_a, _b);
+            }
+        }
+        if (_out_block_size <= #{half}) {
+            _sdata[_tid] = _acc;
+            __syncthreads();
+            for (int _stride = #{half}; _stride > 0; _stride >>= 1) {
+                if (_out_block_size <= _stride) {
+                    if (_tid < _stride) {
+                        _type_reduce _a = _sdata[_tid], _b = _sdata[_tid + _stride];
+                        _sdata[_tid] = REDUCE(_a, _b);
+                    }
+                    __syncthreads();
+                }
+            }
+            _acc = _sdata[_tid];
+            __syncthreads();
+        }
+        if (_reduce_offset == 0 && _i_out < _out_total) {
+            unsigned long long _j = _i_out;
+#{out_index}            #{out_t} &#{out_param.name} = *(#{out_t}*)(#{offset_expr('_arg.out', out_ndim, '_k')});
+            _type_reduce a = _acc;
+            POST_MAP(a);
+        }
+    }
+}
+      EOS
+    end
+  end
+end
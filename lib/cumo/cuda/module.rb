@@ -3,6 +3,8 @@ require_relative '../cuda'
 module Cumo::CUDA
   # CUDA kernel module.
   class Module
+    attr_reader :ptr
+
     def initialize
       @ptr = nil
       if block_given?
@@ -33,7 +35,7 @@ module Cumo::CUDA
     end
 
     def get_function(name)
-      # Function(name)
+      Function.new(self, name)
     end
   end
 end
@@ -0,0 +1,69 @@
+module Cumo
+  module CUDA
+  end
+end
+
+module Cumo::CUDA
+  # Stack of streams selected by Cumo::CUDA.with_stream, kept per thread
+  # (and per fiber) so that independent pipelines do not see each other's
+  # stream.
+  #
+  # The pointer of the innermost stream is stored in the thread local
+  # variable CURRENT_KEY, which cumo_cuda_stream_current in
+  # ext/cumo/cuda/stream.c reads for kernel launches, cuBLAS calls and
+  # memory pool allocations. Streams only need to respond to #ptr.
+  module StreamScope
+    STACK_KEY = :__cumo_cuda_stream_stack__
+    CURRENT_KEY = :__cumo_cuda_current_stream__
+
+    module_function
+
+    def stack
+      Thread.current[STACK_KEY] ||= []
+    end
+
+    # Innermost stream selected on this thread, or nil for the default stream.
+    def current
+      stack.last
+    end
+
+    def with(stream)
+      raise ArgumentError, 'stream must respond to ptr' unless stream.respond_to?(:ptr)
+      stack.push(stream)
+      begin
+        Thread.current[CURRENT_KEY] = stream.ptr
+        yield stream
+      ensure
+        stack.pop
+        Thread.current[CURRENT_KEY] = stack.empty? ? nil : stack.last.ptr
+      end
+    end
+  end
+
+  # Runs the block with stream as the current stream of this thread.
+  # Kernel launches, cuBLAS calls and memory pool allocations in the block
+  # are queued on stream, so work on different streams may overlap.
+  # @param [Cumo::CUDA::Stream] stream
+  # @return the result of the block
+  # @example
+  #   stream = Cumo::CUDA::Stream.new(non_blocking: true)
+  #   y = Cumo::CUDA.with_stream(stream) { x.dot(w) + b }
+  #   stream.synchronize
+  def self.with_stream(stream, &block)
+    StreamScope.with(stream, &block)
+  end
+
+  # CUDA stream. Creation and synchronization are defined in ext/cumo/cuda/stream.c.
+  class Stream
+    # @return [Cumo::CUDA::Stream] the current stream of this thread.
+    def self.current
+      StreamScope.current || self::NULL
+    end
+
+    # Runs the block with self as the current stream.
+    # @see Cumo::CUDA.with_stream
+    def with(&block)
+      StreamScope.with(self, &block)
+    end
+  end
+end
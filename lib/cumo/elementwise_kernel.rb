@@ -0,0 +1,120 @@
+require_relative 'cuda/kernel_source'
+
+module Cumo
+  # User-defined elementwise kernel.
+  #
+  # @example
+  #   squared_diff = Cumo::ElementwiseKernel.new(
+  #     'T x, T y', 'T z', 'z = (x - y) * (x - y)', 'squared_diff')
+  #   squared_diff.call(Cumo::DFloat[1,2,3], Cumo::DFloat[[0],[1]])
+  #   # => Cumo::DFloat#shape=[2,3]
+  #   #    [[1, 4, 9],
+  #   #     [0, 1, 4]]
+  #
+  # Arguments are broadcast by ndloop, and the kernel is compiled with NVRTC
+  # for each combination of types and number of dimensions on first use.
+  class ElementwiseKernel
+    attr_reader :in_params, :out_params, :operation, :name, :preamble, :options
+
+    # @param [String] in_params  input parameters such as "T x, float32 y".
+    # @param [String] out_params  output parameters such as "T z".
+    # @param [String] operation  CUDA code executed for each element.
+    # @param [String] name  name of the kernel function.
+    # @param [String] preamble  CUDA code inserted before the kernel function.
+    # @param [Array<String>] options  NVRTC compile options.
+    def initialize(in_params, out_params, operation, name = 'kernel', preamble: '', options: [])
+      @in_params = CUDA::KernelSource.parse_params(in_params)
+      @out_params = CUDA::KernelSource.parse_params(out_params)
+      raise ArgumentError, 'out_params must not be empty' if @out_params.empty?
+      CUDA::KernelSource.check_param_names(@in_params + @out_params)
+      raise ArgumentError, "invalid kernel name: #{name}" unless CUDA::KernelSource::VALID_NAME.match?(name)
+      @operation = operation
+      @name = name
+      @preamble = preamble
+      @options = options
+      @functions = {}
+    end
+
+    # Launch the kernel.
+    # @overload call(*inputs, *outputs)
+    # @param [Cumo::NArray,Numeric] inputs  arrays or scalars for in_params.
+    # @param [Cumo::NArray] outputs  arrays for out_params. Allocated with the broadcast shape if omitted.
+    # @return [Cumo::NArray,Array<Cumo::NArray>] outputs.
+    def call(*args)
+      nin = @in_params.size
+      nout = @out_params.size
+      unless args.size == nin || args.size == nin + nout
+        raise ArgumentError, "wrong number of arguments (given #{args.size}, expected #{nin} or #{nin + nout})"
+      end
+      inputs = args[0...nin]
+      outputs = args[nin..-1]
+
+      array_types = args.map { |a| a.is_a?(Cumo::NArray) ? CUDA::KernelSource.type_of_class_name(a.class.name.split('::').last) : nil }
+      bound = CUDA::KernelSource.bind_types(@in_params + @out_params, array_types)
+      # Placeholders only used by scalars follow the Ruby class of the scalar.
+      @in_params.zip(inputs).each do |param, arg|
+        next if !param.placeholder? || bound.key?(param.type) || arg.is_a?(Cumo::NArray)
+        bound[param.type] = arg.is_a?(Integer) ? 'int64' : 'float64'
+      end
+
+      inputs = @in_params.zip(inputs).map do |param, arg|
+        klass = narray_class(CUDA::KernelSource.resolve_type(param, bound))
+        arg.is_a?(klass) ? arg : klass.cast(arg)
+      end
+      if outputs.empty?
+        shape = broadcast_shape(inputs.map(&:shape))
+        outputs = @out_params.map do |param|
+          narray_class(CUDA::KernelSource.resolve_type(param, bound)).new(*shape)
+        end
+      else
+        @out_params.zip(outputs).each do |param, arg|
+          klass = narray_class(CUDA::KernelSource.resolve_type(param, bound))
+          raise TypeError, "output #{param.name} must be #{klass}" unless arg.instance_of?(klass)
+        end
+      end
+
+      CUDA::Function.launch_elementwise(inputs + outputs, nin) do |ndim|
+        function(bound, ndim).ptr
+      end
+      outputs.size == 1 ? outputs[0] : outputs
+    end
+
+    # CUDA source specialized for bound placeholder types and ndim.
+    # @param [Hash{String=>String}] bound  placeholder => type name, e.g., {"T" => "float32"}.
+    # @param [Integer] ndim  number of dimensions.
+    # @return [String]
+    def source(bound, ndim)
+      CUDA::KernelSource.elementwise(@name, @in_params, @out_params, @operation, @preamble, bound, ndim)
+    end
+
+    private
+
+    def narray_class(type)
+      Cumo.const_get(CUDA::KernelSource::TYPES.fetch(type)[0])
+    end
+
+    def broadcast_shape(shapes)
+      ndim = shapes.map(&:size).max || 0
+      shapes.each_with_object(Array.new(ndim, 1)) do |shape, result|
+        shape.each_with_index do |n, k|
+          d = ndim - shape.size + k
+          if result[d] == 1
+            result[d] = n
+          elsif n != 1 && n != result[d]
+            raise Cumo::NArray::ShapeError, "shape mismatch: #{shapes.map(&:inspect).join(', ')}"
+          end
+        end
+      end
+    end
+
+    # Compiled functions are cached by types, ndim and device here, since
+    # modules are loaded into the context of each device, and cubins are
+    # cached by the hash of the source by Compiler#compile_with_cache.
+    def function(bound, ndim)
+      @functions[[bound, ndim, CUDA::Runtime.cudaGetDevice]] ||= begin
+        mod = CUDA::Compiler.new.compile_with_cache(source(bound, ndim), options: @options)
+        mod.get_function(@name)
+      end
+    end
+  end
+end
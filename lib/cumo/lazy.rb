@@ -0,0 +1,220 @@
+require_relative 'cuda/kernel_source'
+
+module Cumo
+  # Expression graph of lazily evaluated elementwise operations.
+  #
+  # Operations on Cumo::LazyArray record nodes instead of launching kernels,
+  # and chains of them are fused into one ElementwiseKernel when the value
+  # is needed. This module only builds graphs and plans fusion, so it can be
+  # tested without a device.
+  module Lazy
+    # Kernel parameters are limited to 4KB. Each cumo_na_iarray_t takes 104
+    # bytes besides the 216 bytes of cumo_na_indexer_t.
+    MAX_FUSED_INPUTS = 32
+
+    BINARY_OPS = {
+      add: '+',
+      sub: '-',
+      mul: '*',
+      div: '/',
+    }
+
+    MATH_FUNCS = %w[
+      sqrt cbrt log log2 log10 exp exp2 exp10 sin cos tan asin acos atan
+      sinh cosh tanh asinh acosh atanh erf erfc log1p expm1
+    ]
+
+    FLOAT_TYPES = %w[float64 float32]
+
+    # A node of the expression graph.
+    #
+    # Input nodes hold a materialized value: an NArray, or a Ruby scalar
+    # converted to dtype. Operation nodes hold an op and operands.
+    # Operation nodes turn into input nodes once materialized.
+    class Node
+      attr_reader :op, :operands, :dtype, :value, :shape
+
+      def initialize(op, operands, dtype, shape, value = nil)
+        @op = op
+        @operands = operands
+        @dtype = dtype
+        @shape = shape
+        @value = value
+      end
+
+      def input?
+        @op == :input
+      end
+
+      def materialize!(value)
+        @op = :input
+        @operands = []
+        @value = value
+      end
+    end
+
+    module_function
+
+    # Input node of an array whose type name is dtype.
+    def input(value, dtype, shape)
+      Node.new(:input, [], dtype, shape, value)
+    end
+
+    # Whether node can be computed inside a fused kernel.
+    # Operands must have types supported by kernels. Integer division and
+    # power are left to NArray, which checks zero division and computes
+    # exact powers.
+    def fusable?(node)
+      types = [node.dtype] + node.operands.map(&:dtype)
+      return false unless types.all? { |t| CUDA::KernelSource::TYPES.key?(t) }
+      return true if FLOAT_TYPES.include?(node.dtype)
+      [:add, :sub, :mul, :neg].include?(node.op)
+    end
+
+    # Result type name of a binary op of two nodes, or of a node and a Ruby scalar.
+    # promote is called with two type names of arrays and follows UPCAST.
+    def result_type(lhs, rhs, promote)
+      lt = lhs.is_a?(Node) ? lhs.dtype : nil
+      rt = rhs.is_a?(Node) ? rhs.dtype : nil
+      return promote.call(lt, rt) if lt && rt
+      type = lt || rt
+      scalar = lt ? rhs : lhs
+      # a Float scalar makes integer arrays DFloat as Integer#to_f does
+      if scalar.is_a?(Float) && !FLOAT_TYPES.include?(type)
+        'float64'
+      else
+        type
+      end
+    end
+
+    def binary(op, lhs, rhs, promote)
+      dtype = result_type(lhs, rhs, promote)
+      operands = [lhs, rhs].map { |x| x.is_a?(Node) ? x : input(x, dtype, []) }
+      Node.new(op, operands, dtype, broadcast_shape(operands.map(&:shape)))
+    end
+
+    def unary(op, x)
+      Node.new(op, [x], x.dtype, x.shape)
+    end
+
+    # Math functions of integer arrays result in float64 as Cumo::NMath.
+    def math(func, x)
+      dtype = FLOAT_TYPES.include?(x.dtype) ? x.dtype : 'float64'
+      Node.new(func.to_sym, [x], dtype, x.shape)
+    end
+
+    def broadcast_shape(shapes)
+      ndim = shapes.map(&:size).max || 0
+      shapes.each_with_object(Array.new(ndim, 1)) do |shape, result|
+        shape.each_with_index do |n, k|
+          d = ndim - shape.size + k
+          if result[d] == 1
+            result[d] = n
+          elsif n != 1 && n != result[d]
+            raise ArgumentError, "shape mismatch: #{shapes.map(&:inspect).join(', ')}"
+          end
+        end
+      end
+    end
+
+    # Returns operation nodes to materialize in order, each of which becomes
+    # one fused kernel with at most max_inputs inputs. The last one is root.
+    # An operand is cut out of its consumer when the consumer would otherwise
+    # need too many inputs. Subgraphs shared by several consumers are computed
+    # only once in a kernel through temporaries.
+    def partition(root, max_inputs = MAX_FUSED_INPUTS)
+      return [] if root.input?
+      cuts = {}.compare_by_identity
+      inputs_of = {}.compare_by_identity
+      single = lambda { |node| { node => true }.compare_by_identity }
+      visit = lambda do |node|
+        return inputs_of[node] if inputs_of.key?(node)
+        return inputs_of[node] = single.call(node) if node.input?
+        node.operands.each { |x| visit.call(x) }
+        loop do
+          merged = {}.compare_by_identity
+          node.operands.each { |x| merged.update(cuts[x] ? single.call(x) : inputs_of[x]) }
+          break inputs_of[node] = merged if merged.size <= max_inputs
+          # cut the operand needing the most inputs
+          child = node.operands.reject { |x| x.input? || cuts[x] }.max_by { |x| inputs_of[x].size }
+          raise ArgumentError, 'too many inputs to fuse' unless child
+          cuts[child] = true
+        end
+      end
+      visit.call(root)
+
+      # post-order, so that cuts are materialized before their consumers
+      order = []
+      seen = {}.compare_by_identity
+      post = lambda do |node|
+        next if node.input? || seen[node]
+        seen[node] = true
+        node.operands.each { |x| post.call(x) }
+        order << node if cuts[node]
+      end
+      post.call(root)
+      order << root
+    end
+
+    # Fused kernel computing root from its input nodes.
+    # Operands cut by Lazy.partition must be materialized beforehand.
+    class Plan
+      attr_reader :inputs, :dtype, :operation
+
+      def initialize(root)
+        @dtype = root.dtype
+        @inputs = []
+        @names = {}.compare_by_identity
+        @lines = []
+        @ntemps = 0
+        result = emit(root)
+        @lines << "out = #{result}"
+        @operation = @lines.join(";\n")
+      end
+
+      def in_params
+        @inputs.each_with_index.map { |x, i| "#{x.dtype} a#{i}" }.join(', ')
+      end
+
+      def out_params
+        "#{@dtype} out"
+      end
+
+      # Kernels are shared by plans with the same key.
+      def key
+        [in_params, out_params, @operation]
+      end
+
+      private
+
+      def emit(node)
+        return @names[node] if @names.key?(node)
+        if node.input?
+          @names[node] = "a#{@inputs.size}"
+          @inputs << node
+          return @names[node]
+        end
+        args = node.operands.map { |x| cast(emit(x), x.dtype, node.dtype) }
+        expr =
+          if (sym = BINARY_OPS[node.op])
+            "#{args[0]} #{sym} #{args[1]}"
+          elsif node.op == :neg
+            "-#{args[0]}"
+          elsif node.op == :pow
+            "pow(#{args[0]}, #{args[1]})"
+          else
+            "#{node.op}(#{args[0]})"
+          end
+        name = "v#{@ntemps}"
+        @ntemps += 1
+        @lines << "const #{CUDA::KernelSource.ctype(node.dtype)} #{name} = #{expr}"
+        @names[node] = name
+      end
+
+      # math of integers is computed in double since the node is float64
+      def cast(name, from, to)
+        from == to ? name : "(#{CUDA::KernelSource.ctype(to)})#{name}"
+      end
+    end
+  end
+end
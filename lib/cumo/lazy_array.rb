@@ -0,0 +1,242 @@
+require_relative 'lazy'
+require_relative 'elementwise_kernel'
+
+module Cumo
+  # Lazily evaluated result of elementwise operations.
+  #
+  # Arithmetic operators and math functions on a LazyArray record a graph of
+  # Cumo::Lazy nodes instead of launching kernels. The graph is fused into as
+  # few ElementwiseKernels as possible when the value is needed, i.e., by
+  # reductions, indexing or reads to the host, which are delegated to the
+  # materialized NArray. Operations which cannot be fused (e.g., integer
+  # division) are evaluated eagerly.
+  #
+  # @example
+  #   y = Cumo.lazy(x, w, b) { |x, w, b| (x * w + b).tanh }  # one kernel
+  #   s = ((x.lazy - 1) ** 2).sum                            # one kernel and sum
+  class LazyArray
+    @kernels = {}
+
+    class << self
+      # Used by binary operators of NArray through UPCAST, so that
+      # NArray op LazyArray is lazily evaluated as well.
+      def cast(obj)
+        obj.is_a?(LazyArray) ? obj : new(obj)
+      end
+
+      # Fused kernels are shared by plans with the same structure.
+      def kernel(plan)
+        @kernels[plan.key] ||= ElementwiseKernel.new(plan.in_params, plan.out_params, plan.operation, 'cumo_fused')
+      end
+
+      def dtype_of(klass)
+        name = klass.name.split('::').last
+        type, _ = CUDA::KernelSource::TYPES.find { |_, v| v[0] == name }
+        type || klass.name
+      end
+
+      def class_of(dtype)
+        if CUDA::KernelSource::TYPES.key?(dtype)
+          Cumo.const_get(CUDA::KernelSource::TYPES[dtype][0])
+        else
+          Object.const_get(dtype)
+        end
+      end
+    end
+
+    PROMOTE = lambda do |a, b|
+      dtype_of(class_of(a).upcast(class_of(b)))
+    end
+
+    attr_reader :node
+
+    # @param [Cumo::NArray,Cumo::Lazy::Node] obj
+    def initialize(obj)
+      @node =
+        if obj.is_a?(Lazy::Node)
+          obj
+        elsif obj.is_a?(NArray)
+          Lazy.input(obj, LazyArray.dtype_of(obj.class), obj.shape)
+        else
+          raise TypeError, "cannot make LazyArray of #{obj.class}"
+        end
+    end
+
+    def shape
+      @node.shape
+    end
+
+    def ndim
+      @node.shape.size
+    end
+
+    def size
+      @node.shape.inject(1, :*)
+    end
+
+    def lazy
+      self
+    end
+
+    # Materializes the value by launching fused kernels.
+    # @return [Cumo::NArray]
+    def force
+      Lazy.partition(@node).each do |node|
+        plan = Lazy::Plan.new(node)
+        result = LazyArray.kernel(plan).call(*plan.inputs.map(&:value))
+        node.materialize!(result)
+      end
+      @node.value
+    end
+
+    def +(other)
+      binary(:add, :+, @node, other)
+    end
+
+    def -(other)
+      binary(:sub, :-, @node, other)
+    end
+
+    def *(other)
+      binary(:mul, :*, @node, other)
+    end
+
+    def /(other)
+      binary(:div, :/, @node, other)
+    end
+
+    def **(other)
+      binary(:pow, :**, @node, other)
+    end
+
+    def -@
+      node = Lazy.unary(:neg, @node)
+      Lazy.fusable?(node) ? LazyArray.new(node) : LazyArray.new(-force)
+    end
+
+    Lazy::MATH_FUNCS.each do |func|
+      define_method(func) do
+        node = Lazy.math(func, @node)
+        Lazy.fusable?(node) ? LazyArray.new(node) : LazyArray.new(NMath.send(func, force))
+      end
+    end
+
+    # Numeric op LazyArray
+    def coerce(other)
+      [Coerced.new(other), self]
+    end
+
+    def ==(other)
+      force == (other.is_a?(LazyArray) ? other.force : other)
+    end
+
+    def to_s
+      force.to_s
+    end
+
+    def inspect
+      force.inspect
+    end
+
+    def method_missing(name, *args, &block)
+      if LazyArray.class_of(@node.dtype).public_method_defined?(name)
+        force.public_send(name, *args, &block)
+      else
+        super
+      end
+    end
+
+    def respond_to_missing?(name, include_private = false)
+      LazyArray.class_of(@node.dtype).public_method_defined?(name) || super
+    end
+
+    # Records op of lhs and rhs, or evaluates it eagerly if it cannot be fused.
+    # @private
+    def binary(op, method, lhs, rhs)
+      l = operand(lhs)
+      r = operand(rhs)
+      if l && r
+        node = Lazy.binary(op, l, r, PROMOTE)
+        return LazyArray.new(node) if Lazy.fusable?(node)
+      end
+      LazyArray.new(value_of(lhs).public_send(method, value_of(rhs)))
+    end
+
+    private
+
+    # Node or Ruby scalar to record, or nil if x cannot be recorded.
+    def operand(x)
+      if x.is_a?(Lazy::Node)
+        x
+      elsif x.is_a?(LazyArray)
+        x.node
+      elsif x.is_a?(NArray)
+        LazyArray.new(x).node
+      elsif x.is_a?(Integer) || x.is_a?(Float)
+        x
+      end
+    end
+
+    def value_of(x)
+      if x.is_a?(Lazy::Node)
+        LazyArray.new(x).force
+      elsif x.is_a?(LazyArray)
+        x.force
+      else
+        x
+      end
+    end
+
+    # Scalar on the left of LazyArray.
+    class Coerced
+      def initialize(value)
+        @value = value
+      end
+
+      { :+ => :add, :- => :sub, :* => :mul, :/ => :div, :** => :pow }.each do |method, op|
+        define_method(method) do |other|
+          other.binary(op, method, @value, other.node)
+        end
+      end
+    end
+    private_constant :Coerced
+  end
+
+  class NArray
+    # Returns a Cumo::LazyArray of self to fuse the following elementwise operations.
+    # @return [Cumo::LazyArray]
+    def lazy
+      LazyArray.new(self)
+    end
+  end
+
+  # Elementwise operations of arrays in the block are lazily evaluated and
+  # fused into as few kernels as possible.
+  # @param [Array<Cumo::NArray>] arrays  arrays yielded as Cumo::LazyArray.
+  # @return [Cumo::NArray,Array<Cumo::NArray>] materialized result(s) of the block.
+  # @example
+  #   y = Cumo.lazy(x, w, b) { |x, w, b| (x * w + b).tanh }
+  def self.lazy(*arrays)
+    result = yield(*arrays.map { |a| a.is_a?(NArray) ? a.lazy : a })
+    force = ->(r) { r.is_a?(LazyArray) ? r.force : r }
+    result.is_a?(Array) ? result.map(&force) : force.call(result)
+  end
+
+  CUDA::KernelSource::TYPES.each_value do |class_name, _|
+    Cumo.const_get(class_name)::UPCAST[LazyArray] = LazyArray
+  end
+
+  module NMath
+    # Cumo::NMath.tanh(lazy) records the function as LazyArray#tanh.
+    module LazyDispatch
+      def method_missing(name, *args)
+        if args.size == 1 && args[0].is_a?(LazyArray) && Lazy::MATH_FUNCS.include?(name.to_s)
+          args[0].public_send(name)
+        else
+          super
+        end
+      end
+    end
+    singleton_class.prepend(LazyDispatch)
+  end
+end
@@ -1078,39 +1078,45 @@ module Cumo
 
     @@warn_slow_dot = false
 
+    # Types with gemm, i.e., cuBLAS for floating point types and a tiled
+    # kernel for integer types.
+    GEMM_TYPES = [SFloat, DFloat, SComplex, DComplex, HFloat, BFloat16,
+                  Int64, Int32, Int16, Int8, UInt64, UInt32, UInt16, UInt8]
+
     # Dot product of two arrays.
     # @param b [Cumo::NArray]
     # @return [Cumo::NArray]  return dot product
 
     def dot(b)
       t = self.class::UPCAST[b.class]
-      if [SFloat, DFloat, SComplex, DComplex].include?(t)
-        b = self.class.asarray(b)
-        case self.ndim
+      b = self.class.asarray(b)
+      # a scalar operand is multiplied elementwise
+      return self * b if ndim == 0 || b.ndim == 0
+      if GEMM_TYPES.include?(t)
+        a = self.class == t ? self : t.cast(self)
+        b = t.cast(b) unless b.class == t
+        case a.ndim
         when 1
           case b.ndim
           when 1
-            self.mulsum(b, axis:-1)
+            a.mulsum(b, axis:-1)
           else
-            self[:new, false].gemm(b).flatten
+            a[:new, false].gemm(b)[false, 0, true]
           end
         else
           case b.ndim
           when 1
-            self.gemm(b[false, :new]).flatten
+            a.gemm(b[false, :new])[false, 0]
           else
-            self.gemm(b)
+            a.gemm(b)
           end
         end
       else
-        b = self.class.asarray(b)
         case b.ndim
         when 1
           mulsum(b, axis:-1)
         else
           case ndim
-          when 0
-            b.mulsum(self, axis:-2)
           when 1
             self[true,:new].mulsum(b, axis:-2)
           else
@@ -1122,7 +1128,7 @@ module Cumo
               if am > nx && an > nx && bm > nx && bn > nx &&
                   size > ns && b.size > ns
                 @@warn_slow_dot = true
-                warn "\nwarning: matrix dot for #{t} is slow. Consider SFloat, DFloat, SComplex, or DComplex to use cuBLAS.\n\n"
+                warn "\nwarning: matrix dot for #{t} is slow. Consider SFloat, DFloat, SComplex, DComplex or integer types to use gemm.\n\n"
               end
             end
             self[false,:new].mulsum(b[false,:new,true,true], axis:-2)
@@ -0,0 +1,104 @@
+require_relative 'cuda/kernel_source'
+
+module Cumo
+  # User-defined reduction kernel.
+  #
+  # @example
+  #   l2norm = Cumo::ReductionKernel.new(
+  #     'T x', 'T y', 'x * x', 'a + b', 'y = sqrt(a)', '0', 'l2norm')
+  #   l2norm.call(Cumo::DFloat[[3,4],[5,12]], axis: 1)
+  #   # => Cumo::DFloat#shape=[2]
+  #   #    [5, 13]
+  #
+  # Only one input and one output are supported, following
+  # cumo_na_reduction_arg_t.
+  class ReductionKernel
+    attr_reader :in_params, :out_params, :map_expr, :reduce_expr, :post_map_expr,
+                :identity, :name, :reduce_type, :preamble, :options
+
+    # @param [String] in_params  input parameter such as "T x".
+    # @param [String] out_params  output parameter such as "T y".
+    # @param [String] map_expr  expression mapping each input element.
+    # @param [String] reduce_expr  expression reducing two mapped values a and b.
+    # @param [String] post_map_expr  statement storing the reduced value a to the output.
+    # @param [String] identity  identity value of reduce_expr.
+    # @param [String] name  name of the kernel function.
+    # @param [String] reduce_type  type of mapped values. Type of the input by default.
+    # @param [String] preamble  CUDA code inserted before the kernel function.
+    # @param [Array<String>] options  NVRTC compile options.
+    def initialize(in_params, out_params, map_expr, reduce_expr, post_map_expr, identity,
+                   name = 'reduce_kernel', reduce_type: nil, preamble: '', options: [])
+      @in_params = CUDA::KernelSource.parse_params(in_params)
+      @out_params = CUDA::KernelSource.parse_params(out_params)
+      unless @in_params.size == 1 && @out_params.size == 1
+        raise ArgumentError, 'ReductionKernel supports exactly one input and one output'
+      end
+      CUDA::KernelSource.check_param_names(@in_params + @out_params)
+      raise ArgumentError, "invalid kernel name: #{name}" unless CUDA::KernelSource::VALID_NAME.match?(name)
+      @map_expr = map_expr
+      @reduce_expr = reduce_expr
+      @post_map_expr = post_map_expr
+      @identity = identity
+      @name = name
+      @reduce_type = reduce_type || @in_params[0].type
+      @preamble = preamble
+      @options = options
+      @functions = {}
+    end
+
+    # Launch the kernel.
+    # @param [Cumo::NArray,Numeric] x  input.
+    # @param [Numeric,Array,Range] axis  Affected dimensions. All dimensions by default.
+    # @param [TrueClass] keepdims  If true, the reduced axes are left in the result array as dimensions with size one.
+    # @return [Cumo::NArray] result of reduction.
+    def call(x, axis: nil, keepdims: false)
+      in_param = @in_params[0]
+      out_param = @out_params[0]
+      if x.is_a?(Cumo::NArray)
+        bound = CUDA::KernelSource.bind_types(@in_params, [CUDA::KernelSource.type_of_class_name(x.class.name.split('::').last)])
+      else
+        bound = in_param.placeholder? ? { in_param.type => x.is_a?(Integer) ? 'int64' : 'float64' } : {}
+      end
+      in_class = narray_class(CUDA::KernelSource.resolve_type(in_param, bound))
+      x = in_class.cast(x) unless x.is_a?(in_class)
+      out_class = narray_class(CUDA::KernelSource.resolve_type(out_param, bound))
+      reduce_size = CUDA::KernelSource.byte_size(reduce_type_name(bound))
+
+      opts = {}
+      opts[:axis] = axis unless axis.nil?
+      opts[:keepdims] = true if keepdims
+      CUDA::Function.launch_reduction(x, out_class, reduce_size, **opts) do |in_ndim, out_ndim|
+        function(bound, in_ndim, out_ndim).ptr
+      end
+    end
+
+    # CUDA source specialized for bound placeholder types and ndims.
+    # @param [Hash{String=>String}] bound  placeholder => type name, e.g., {"T" => "float32"}.
+    # @param [Integer] in_ndim  number of dimensions of the input indexer.
+    # @param [Integer] out_ndim  number of dimensions of the output indexer.
+    # @return [String]
+    def source(bound, in_ndim, out_ndim)
+      CUDA::KernelSource.reduction(@name, @in_params[0], @out_params[0], @map_expr, @reduce_expr, @post_map_expr,
+                                   @identity, CUDA::KernelSource.ctype(reduce_type_name(bound)), @preamble,
+                                   bound, in_ndim, out_ndim)
+    end
+
+    private
+
+    def reduce_type_name(bound)
+      CUDA::KernelSource.resolve_type(CUDA::KernelSource::Param.new(@reduce_type, '_'), bound)
+    end
+
+    def narray_class(type)
+      Cumo.const_get(CUDA::KernelSource::TYPES.fetch(type)[0])
+    end
+
+    # See ElementwiseKernel#function
+    def function(bound, in_ndim, out_ndim)
+      @functions[[bound, in_ndim, out_ndim, CUDA::Runtime.cudaGetDevice]] ||= begin
+        mod = CUDA::Compiler.new.compile_with_cache(source(bound, in_ndim, out_ndim), options: @options)
+        mod.get_function(@name)
+      end
+    end
+  end
+end
@@ -32,8 +32,7 @@ class BitTest < Test::Unit::TestCase
       assert { a.count_false == 4 }
       assert { a.where == [1,2,4,7] }
       assert { a.where2 == [[1,2,4,7], [0,3,5,6]] }
-      # TODO(sonots): FIX ME
-      # assert { a.mask(Cumo::DFloat[1,2,3,4,5,6,7,8]) == [2,3,5,8] }
+      assert { a.mask(Cumo::DFloat[1,2,3,4,5,6,7,8]).to_a == [2,3,5,8] }
       assert { !a.all? }
       assert { a.any? }
       assert { !a.none? }
@@ -66,8 +65,7 @@ class BitTest < Test::Unit::TestCase
       assert { a.count_false == 4 }
       assert { a.where == [1,2,4,7] }
       assert { a.where2 == [[1,2,4,7],[0,3,5,6]] }
-      # TODO(sonots): FIX ME
-      # assert { a.mask(Cumo::DFloat[[1,2,3,4],[5,6,7,8]]) == [2,3,5,8] }
+      assert { a.mask(Cumo::DFloat[[1,2,3,4],[5,6,7,8]]).to_a == [2,3,5,8] }
       assert { !a.all? }
       assert { a.any? }
       assert { !a.none? }
@@ -138,4 +136,99 @@ class BitTest < Test::Unit::TestCase
       assert { a[:*,1] == dtype.cast([0,1]) }
     end
   end
+
+  [false, true].each do |compatible|
+    test "#{dtype},logical ops at misaligned offsets#{compatible ? ',compatible' : ''}" do
+      orig = Cumo.compatible_mode_enabled?
+      compatible ? Cumo.enable_compatible_mode : Cumo.disable_compatible_mode
+      begin
+        n = 300
+        src1 = (0...n + 7).map {|i| (i * 7 + i / 5) % 3 == 0 ? 1 : 0 }
+        src2 = (0...n + 13).map {|i| (i * 5 + i / 3) % 2 }
+        a = dtype[*src1][5...5 + n]
+        b = dtype[*src2][13..-1]
+        x = src1[5, n]
+        y = src2[13, n]
+
+        assert { (a & b).to_a == x.zip(y).map {|u, v| u & v } }
+        assert { (a | b).to_a == x.zip(y).map {|u, v| u | v } }
+        assert { (a ^ b).to_a == x.zip(y).map {|u, v| u ^ v } }
+        assert { a.eq(b).to_a == x.zip(y).map {|u, v| u == v ? 1 : 0 } }
+        assert { (~a).to_a == x.map {|u| 1 - u } }
+        assert { (a & 1).to_a == x }
+
+        c = dtype.new(n + 40).fill(1)
+        c[3...3 + n] = a
+        assert { c[0...3].to_a == [1] * 3 }
+        assert { c[3...3 + n].to_a == x }
+        assert { c[3 + n..-1].to_a == [1] * 37 }
+
+        assert { a.count_true == x.count(1) }
+        assert { a.count_false == x.count(0) }
+        assert { a.any? && !a.all? }
+        assert { dtype.new(n).fill(1)[1..-1].all? }
+        assert { !dtype.new(n).fill(0)[1..-1].any? }
+      ensure
+        orig ? Cumo.enable_compatible_mode : Cumo.disable_compatible_mode
+      end
+    end
+  end
+
+  test "#{dtype},all? and any? along axis" do
+    a = dtype[[1,1,1],[0,1,0]]
+    assert { a.all?(axis: 1).to_a == [1, 0] }
+    assert { a.any?(axis: 1).to_a == [1, 1] }
+    assert { a.all?(axis: 0).to_a == [0, 1, 0] }
+    assert { a.any?(axis: 0).to_a == [1, 1, 1] }
+    assert { a.count_true(axis: 1).to_a == [3, 1] }
+  end
+
+  test "#{dtype},where and mask across words" do
+    n = 1000
+    src = (0...n).map {|i| (i % 3 == 0 || i % 7 == 0) ? 1 : 0 }
+    ones = (0...n).select {|i| src[i] == 1 }
+    zeros = (0...n).select {|i| src[i] == 0 }
+    a = dtype[*src]
+    assert { a.where.to_a == ones }
+    assert { a.where2.map(&:to_a) == [ones, zeros] }
+    assert { dtype.zeros(n).where.size == 0 }
+
+    # a strided view is compacted from a contiguous copy
+    b = dtype.new(2 * n).fill(0)
+    b[(0..-1) % 2] = a
+    assert { b[(0..-1) % 2].where.to_a == ones }
+
+    x = Cumo::Int32.new(n).seq
+    assert { a.mask(x).to_a == ones }
+    # view with an offset and strides
+    y = Cumo::Int32.new(2, n).seq
+    assert { a.mask(y[1, true]).to_a == ones.map {|i| i + n } }
+    assert { a.mask(Cumo::Int32.new(2 * n).seq[(0..-1) % 2]).to_a == ones.map {|i| i * 2 } }
+    # a view by an index array is masked on the host
+    z = Cumo::Int32.new(n).seq[(0...n).to_a.reverse]
+    assert { a.mask(z).to_a == ones.map {|i| n - 1 - i } }
+  end
+
+  test "#{dtype},rand_bernoulli" do
+    Cumo::NArray.srand(1)
+    a = dtype.new(100000).rand_bernoulli(0.3)
+    assert { (a.count_true / 100000.0 - 0.3).abs < 0.01 }
+    assert { dtype.new(100).rand_bernoulli(0).count_true == 0 }
+    assert { dtype.new(100).rand_bernoulli(1).count_true == 100 }
+
+    # partial words at both ends must keep the other bits
+    b = dtype.new(100).fill(1)
+    b[3...70].rand_bernoulli(0)
+    assert { b[0...3].count_true == 3 }
+    assert { b[3...70].count_true == 0 }
+    assert { b[70..-1].count_true == 30 }
+
+    # contiguous and strided writes draw the same values
+    Cumo::NArray.srand(1)
+    c = dtype.new(64).rand_bernoulli
+    d = dtype.new(128).fill(0)
+    Cumo::NArray.srand(1)
+    d[(0..-1) % 2].rand_bernoulli
+    assert { d[(0..-1) % 2] == c }
+  end
 end
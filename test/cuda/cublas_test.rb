@@ -0,0 +1,50 @@
+require_relative "../test_helper"
+
+module Cumo::CUDA
+  class CublasTest < Test::Unit::TestCase
+    def setup
+      @math_mode = Cublas.math_mode
+      @workspace_size = Cublas.workspace_size
+    end
+
+    def teardown
+      Cublas.math_mode = @math_mode
+      Cublas.workspace_size = @workspace_size
+    end
+
+    def test_handle_per_stream
+      a = Cumo::SFloat.ones(4, 4)
+      a.dot(a)
+      count = Cublas.handle_count
+      s1 = Stream.new
+      s2 = Stream.new
+      c1 = s1.with { a.dot(a) }
+      c2 = s2.with { a.dot(a) }
+      assert { Cublas.handle_count == count + 2 }
+      s1.with { a.dot(a) }
+      assert { Cublas.handle_count == count + 2 }
+      s1.synchronize
+      s2.synchronize
+      assert { c1 == Cumo::SFloat.new(4, 4).fill(4) }
+      assert { c2 == Cumo::SFloat.new(4, 4).fill(4) }
+    end
+
+    def test_math_mode
+      assert { Cublas.math_mode == :default }
+      Cublas.math_mode = :tensor_op
+      assert { Cublas.math_mode == :tensor_op }
+      a = Cumo::DFloat.ones(8, 8)
+      assert { a.dot(a) == Cumo::DFloat.new(8, 8).fill(8) }
+      assert_raise(ArgumentError) { Cublas.math_mode = :unknown }
+    end
+
+    def test_workspace_size
+      Cublas.workspace_size = 1024 * 1024
+      assert { Cublas.workspace_size == 1024 * 1024 }
+      a = Cumo::SFloat.ones(8, 8)
+      assert { a.dot(a) == Cumo::SFloat.new(8, 8).fill(8) }
+      Cublas.workspace_size = 0
+      assert { a.dot(a) == Cumo::SFloat.new(8, 8).fill(8) }
+    end
+  end
+end
@@ -0,0 +1,84 @@
+require "test/unit"
+# The split and source generation do not require a device nor nvcc.
+require_relative "../../lib/cumo/cuda/jit_source"
+
+module Cumo::CUDA
+  class JITSourceTest < Test::Unit::TestCase
+    GEN_DIR = File.expand_path("../../ext/cumo/narray/gen", __dir__)
+    TYPES_DIR = File.expand_path("../../ext/cumo/include/cumo/types", __dir__)
+
+    sub_test_case "parse_allowlist" do
+      def test_valid
+        rules = JITSource.parse_allowlist(<<-EOS)
+# comment
+* * 1
+
+dfloat add   # all ndims
+int16 mod 0,2
+        EOS
+        assert_equal([["*", "*", [1]], ["dfloat", "add", nil], ["int16", "mod", [0, 2]]], rules.map(&:to_a))
+      end
+
+      def test_invalid
+        assert_raise(ArgumentError) { JITSource.parse_allowlist("dfloat") }
+        assert_raise(ArgumentError) { JITSource.parse_allowlist("dfloat add 1 2") }
+        assert_raise(ArgumentError) { JITSource.parse_allowlist("dfloat add x") }
+      end
+
+      def test_shipped
+        rules = JITSource.load_allowlist(File.join(GEN_DIR, "aot_kernels.txt"))
+        assert_true(JITSource.aot?(rules, "dfloat", "add", 3))
+        assert_true(JITSource.aot?(rules, "int16", "mod", 1))
+        assert_false(JITSource.aot?(rules, "int16", "mod", 2))
+      end
+    end
+
+    sub_test_case "aot?" do
+      def test_match
+        rules = JITSource.parse_allowlist("dfloat add\n* mul 0,1\n")
+        assert_true(JITSource.aot?(rules, "dfloat", "add", 4))
+        assert_true(JITSource.aot?(rules, "int8", "mul", 1))
+        assert_false(JITSource.aot?(rules, "int8", "mul", 2))
+        assert_false(JITSource.aot?(rules, "sfloat", "add", 0))
+      end
+
+      # types and ops without source generation are always compiled ahead of time
+      def test_not_jit
+        assert_true(JITSource.aot?([], "dcomplex", "add", 2))
+        assert_true(JITSource.aot?([], "hfloat", "add", 2))
+        assert_true(JITSource.aot?([], "dfloat", "bit_and", 2))
+        assert_false(JITSource.aot?([], "uint8", "bit_and", 2))
+      end
+    end
+
+    sub_test_case "binary" do
+      def test_signature
+        src = JITSource.binary("int16", "mod", 2)
+        assert_match(/typedef short dtype;/, src)
+        assert_match(/extern "C" __global__ void cumo_int16_mod_jit_dim2\(cumo_na_iarray_t a1, cumo_na_iarray_t a2, cumo_na_iarray_t a3, cumo_na_indexer_t indexer\)/, src)
+        assert_match(/const dtype x = \*\(const dtype\*\)\(a1\.ptr \+ a1\.step\[0\] \* _k0 \+ a1\.step\[1\] \* _k1\);/, src)
+        assert_match(/\*\(dtype\*\)\(a3\.ptr \+ a3\.step\[0\] \* _k0 \+ a3\.step\[1\] \* _k1\) = \(x\)%\(y\);/, src)
+      end
+
+      def test_ndim
+        assert_not_match(/_k0/, JITSource.binary("dfloat", "copysign", 0))
+        assert_match(/_k3 = _j % indexer\.shape\[3\]/, JITSource.binary("sfloat", "mod", 4))
+      end
+
+      def test_not_jit
+        assert_raise(ArgumentError) { JITSource.binary("dcomplex", "add", 2) }
+      end
+
+      # Results must not differ from the kernels compiled ahead of time.
+      def test_macros
+        [["float_macro_kernel.h", JITSource::FLOAT_BINARY_OPS],
+         ["xint_macro_kernel.h", JITSource::INT_BINARY_OPS]].each do |header, ops|
+          macros = File.read(File.join(TYPES_DIR, header)).scan(/^#define m_(\w+)\(x,y\)\s+(.*?)\s*$/).to_h
+          ops.each do |op, expr|
+            assert_include([expr, "(#{expr})"], macros[op], "m_#{op} of #{header}")
+          end
+        end
+      end
+    end
+  end
+end
@@ -0,0 +1,17 @@
+require_relative "../test_helper"
+
+module Cumo::CUDA
+  class JITTest < Test::Unit::TestCase
+    def test_binary
+      assert_kind_of(Integer, JIT.binary("int16", "mod", 2))
+    end
+
+    # int16 mod is not in aot_kernels.txt except for ndim 1
+    def test_launch
+      a = Cumo::Int16.new(2, 3, 4).seq(1)
+      b = Cumo::Int16.new(2, 1, 4).fill(3)
+      assert_equal(a.to_a.flatten.map { |x| x % 3 }, (a % b).to_a.flatten)
+      assert_equal([[1, 2], [1, 2]], (a[true, 0, 0..1] % b[true, 0, 0..1]).to_a)
+    end
+  end
+end
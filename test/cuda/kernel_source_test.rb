@@ -0,0 +1,109 @@
+require "test/unit"
+# Source generation does not require a device nor the extension library.
+require_relative "../../lib/cumo/cuda/kernel_source"
+
+module Cumo::CUDA
+  class KernelSourceTest < Test::Unit::TestCase
+    sub_test_case "parse_params" do
+      def test_valid
+        params = KernelSource.parse_params("T x, float32 y")
+        assert_equal([["T", "x"], ["float32", "y"]], params.map(&:to_a))
+        assert_true(params[0].placeholder?)
+        assert_false(params[1].placeholder?)
+      end
+
+      def test_empty
+        assert_equal([], KernelSource.parse_params(""))
+      end
+
+      def test_invalid
+        assert_raise(ArgumentError) { KernelSource.parse_params("T") }
+        assert_raise(ArgumentError) { KernelSource.parse_params("T x y") }
+        assert_raise(ArgumentError) { KernelSource.parse_params("T _x") }
+        assert_raise(ArgumentError) { KernelSource.parse_params("T i") }
+      end
+
+      def test_duplicated
+        params = KernelSource.parse_params("T x, T x")
+        assert_raise(ArgumentError) { KernelSource.check_param_names(params) }
+      end
+    end
+
+    sub_test_case "bind_types" do
+      def test_bind
+        params = KernelSource.parse_params("T x, U y, float32 z")
+        bound = KernelSource.bind_types(params, ["float64", "int32", "float64"])
+        assert_equal({"T" => "float64", "U" => "int32"}, bound)
+        assert_equal("float32", KernelSource.resolve_type(params[2], bound))
+      end
+
+      def test_scalar
+        params = KernelSource.parse_params("T x, T y")
+        assert_equal({"T" => "int16"}, KernelSource.bind_types(params, [nil, "int16"]))
+        assert_raise(TypeError) { KernelSource.resolve_type(params[0], {}) }
+      end
+
+      def test_mismatch
+        params = KernelSource.parse_params("T x, T y")
+        assert_raise(TypeError) { KernelSource.bind_types(params, ["float64", "float32"]) }
+      end
+    end
+
+    sub_test_case "elementwise" do
+      def source(bound, ndim)
+        in_params = KernelSource.parse_params("T x, float32 y")
+        out_params = KernelSource.parse_params("T z")
+        KernelSource.elementwise("axpy", in_params, out_params, "z = 2 * x + y", "", bound, ndim)
+      end
+
+      def test_signature
+        src = source({"T" => "float64"}, 2)
+        assert_match(/typedef double T;/, src)
+        assert_match(/extern "C" __global__ void axpy\(cumo_na_indexer_t _indexer, cumo_na_iarray_t _x, cumo_na_iarray_t _y, cumo_na_iarray_t _z\)/, src)
+        assert_match(/const T x = \*\(const T\*\)\(_x\.ptr \+ _x\.step\[0\] \* _k0 \+ _x\.step\[1\] \* _k1\);/, src)
+        assert_match(/const float y = /, src)
+        assert_match(/T &z = \*\(T\*\)\(_z\.ptr/, src)
+        assert_match(/z = 2 \* x \+ y;/, src)
+      end
+
+      def test_ndim
+        assert_not_match(/_k0/, source({"T" => "float64"}, 0))
+        assert_not_match(/_k1/, source({"T" => "float64"}, 1))
+        assert_match(/_k3 = _j % _indexer\.shape\[3\]/, source({"T" => "float64"}, 4))
+      end
+
+      # cubins are cached by the hash of source
+      def test_cache_key
+        assert_equal(source({"T" => "float64"}, 2), source({"T" => "float64"}, 2))
+        assert_not_equal(source({"T" => "float64"}, 2), source({"T" => "float32"}, 2))
+        assert_not_equal(source({"T" => "float64"}, 2), source({"T" => "float64"}, 3))
+      end
+    end
+
+    sub_test_case "reduction" do
+      def source(in_ndim, out_ndim)
+        x, = KernelSource.parse_params("T x")
+        y, = KernelSource.parse_params("T y")
+        KernelSource.reduction("l2norm", x, y, "x * x", "a + b", "y = sqrt(a)", "0", "double", "",
+                               {"T" => "float32"}, in_ndim, out_ndim)
+      end
+
+      def test_signature
+        src = source(2, 1)
+        assert_match(/typedef float T;/, src)
+        assert_match(/typedef double _type_reduce;/, src)
+        assert_match(/#define REDUCE\(a, b\) \(a \+ b\)/, src)
+        assert_match(/#define POST_MAP\(a\) \(y = sqrt\(a\)\)/, src)
+        assert_match(/extern "C" __global__ void l2norm\(cumo_na_reduction_arg_t _arg, int _out_block_size, int _reduce_block_size\)/, src)
+        assert_match(/const T x = \*\(const T\*\)\(_arg\.in\.ptr \+ _arg\.in\.step\[0\] \* _k0 \+ _arg\.in\.step\[1\] \* _k1\);/, src)
+        assert_match(/T &y = \*\(T\*\)\(_arg\.out\.ptr \+ _arg\.out\.step\[0\] \* _k0\);/, src)
+        assert_match(/_stride = #{KernelSource::REDUCTION_BLOCK_SIZE / 2}/, src)
+      end
+
+      def test_cache_key
+        assert_equal(source(2, 1), source(2, 1))
+        assert_not_equal(source(2, 1), source(2, 0))
+      end
+    end
+  end
+end
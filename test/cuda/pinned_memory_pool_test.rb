@@ -0,0 +1,29 @@
+require_relative "../test_helper"
+
+module Cumo::CUDA
+  class PinnedMemoryPoolTest < Test::Unit::TestCase
+    def test_reuse_after_copy
+      Cumo::DFloat[1, 2, 3]
+      Runtime.cudaDeviceSynchronize
+      n_free_blocks = PinnedMemoryPool.n_free_blocks
+      assert { n_free_blocks > 0 }
+      assert { PinnedMemoryPool.used_bytes == 0 }
+      a = Cumo::DFloat[4, 5, 6]
+      Runtime.cudaDeviceSynchronize
+      assert { PinnedMemoryPool.n_free_blocks == n_free_blocks }
+      assert { a == [4, 5, 6] }
+    end
+
+    def test_free_all_blocks
+      Cumo::Int32[1, 2, 3]
+      Runtime.cudaDeviceSynchronize
+      PinnedMemoryPool.free_all_blocks
+      assert { PinnedMemoryPool.n_free_blocks == 0 }
+      assert { PinnedMemoryPool.free_bytes == 0 }
+    end
+
+    def test_total_bytes
+      assert { PinnedMemoryPool.total_bytes == PinnedMemoryPool.used_bytes + PinnedMemoryPool.free_bytes }
+    end
+  end
+end
@@ -0,0 +1,60 @@
+require "test/unit"
+# Scope bookkeeping is pure Ruby and does not require a device nor the extension library.
+require_relative "../../lib/cumo/cuda/stream"
+
+module Cumo::CUDA
+  class StreamScopeTest < Test::Unit::TestCase
+    FakeStream = Struct.new(:ptr)
+
+    def current_ptr
+      Thread.current[StreamScope::CURRENT_KEY]
+    end
+
+    def test_default
+      assert_nil(StreamScope.current)
+      assert_nil(current_ptr)
+    end
+
+    def test_nested
+      s1 = FakeStream.new(100)
+      s2 = FakeStream.new(200)
+      Cumo::CUDA.with_stream(s1) do
+        assert_same(s1, StreamScope.current)
+        assert_equal(100, current_ptr)
+        Cumo::CUDA.with_stream(s2) do
+          assert_same(s2, StreamScope.current)
+          assert_equal(200, current_ptr)
+        end
+        assert_same(s1, StreamScope.current)
+        assert_equal(100, current_ptr)
+      end
+      assert_nil(StreamScope.current)
+      assert_nil(current_ptr)
+    end
+
+    def test_returns_block_value
+      assert_equal(3, Cumo::CUDA.with_stream(FakeStream.new(1)) { 1 + 2 })
+    end
+
+    def test_restored_on_exception
+      assert_raise(RuntimeError) do
+        Cumo::CUDA.with_stream(FakeStream.new(1)) { raise "error" }
+      end
+      assert_nil(StreamScope.current)
+      assert_nil(current_ptr)
+    end
+
+    def test_thread_local
+      ptr_in_thread = :unset
+      Cumo::CUDA.with_stream(FakeStream.new(1)) do
+        Thread.new { ptr_in_thread = current_ptr }.join
+      end
+      assert_nil(ptr_in_thread)
+    end
+
+    def test_invalid_stream
+      assert_raise(ArgumentError) { Cumo::CUDA.with_stream(Object.new) {} }
+      assert_nil(StreamScope.current)
+    end
+  end
+end
@@ -0,0 +1,46 @@
+require_relative "../test_helper"
+
+module Cumo::CUDA
+  class StreamTest < Test::Unit::TestCase
+    def test_null
+      assert { Stream::NULL.ptr == 0 }
+      assert { Stream.current.equal?(Stream::NULL) }
+    end
+
+    def test_new
+      stream = Stream.new
+      assert { stream.ptr != 0 }
+      assert { Stream.new(non_blocking: true).ptr != 0 }
+    end
+
+    def test_with_stream
+      stream = Stream.new(non_blocking: true)
+      a = Cumo::DFloat.new(1000).seq
+      b = Cumo::CUDA.with_stream(stream) do
+        assert { Stream.current.equal?(stream) }
+        (a * 2 + 1).sum
+      end
+      stream.synchronize
+      assert { stream.done? }
+      assert { b == 1000 * 999 + 1000 }
+      assert { Stream.current.equal?(Stream::NULL) }
+    end
+
+    def test_with
+      stream = Stream.new
+      c = stream.with { Cumo::SFloat.ones(4, 4).dot(Cumo::SFloat.ones(4, 4)) }
+      stream.synchronize
+      assert { c == Cumo::SFloat.new(4, 4).fill(4) }
+    end
+
+    def test_wait
+      s1 = Stream.new(non_blocking: true)
+      s2 = Stream.new(non_blocking: true)
+      a = s1.with { Cumo::DFloat.new(100).seq }
+      s2.wait(s1)
+      b = s2.with { a + 1 }
+      s2.synchronize
+      assert { b == Cumo::DFloat.new(100).seq + 1 }
+    end
+  end
+end
@@ -19,6 +19,47 @@ class CumoTest < Test::Unit::TestCase
     assert { !Cumo.compatible_mode_enabled? }
   end
 
+  def test_sync_stats
+    a = Cumo::DFloat[3, -1, 2]
+    Cumo.clear_sync_stats
+    a.sort
+    assert { Cumo.sync_stats["sort"] >= 1 }
+    a.abs
+    a.clip(0, 1)
+    assert { !Cumo.sync_stats.key?("abs") }
+    assert { !Cumo.sync_stats.key?("clip") }
+    Cumo.clear_sync_stats
+    assert { Cumo.sync_stats.empty? }
+  end
+
+  def test_host_threads
+    n = Cumo.host_threads
+    assert { n >= 1 }
+    begin
+      Cumo.host_threads = 2
+      assert { Cumo.host_threads == 2 }
+      assert_raise(ArgumentError) { Cumo.host_threads = 0 }
+    ensure
+      Cumo.host_threads = n
+    end
+  end
+
+  def test_host_threads_results
+    n = Cumo.host_threads
+    a = Cumo::DFloat.new(64, 4096).rand - 0.5
+    begin
+      Cumo.host_threads = 1
+      expected = [a.sort, a.cumsum(axis: 1), *a.minmax(axis: 1)].map(&:to_a)
+      Cumo.host_threads = 4
+      Cumo.clear_sync_stats
+      actual = [a.sort, a.cumsum(axis: 1), *a.minmax(axis: 1)].map(&:to_a)
+      assert { Cumo.sync_stats["sort"] >= 1 }
+    ensure
+      Cumo.host_threads = n
+    end
+    assert { actual == expected }
+  end
+
   def test_version
     assert_nothing_raised { Cumo::VERSION }
   end
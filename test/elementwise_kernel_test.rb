@@ -0,0 +1,50 @@
+require_relative "test_helper"
+
+class ElementwiseKernelTest < Test::Unit::TestCase
+  def setup
+    @squared_diff = Cumo::ElementwiseKernel.new('T x, T y', 'T z', 'z = (x - y) * (x - y)', 'squared_diff')
+  end
+
+  test "call" do
+    a = Cumo::DFloat[1, 2, 3]
+    b = Cumo::DFloat[3, 2, 1]
+    assert { @squared_diff.call(a, b) == [4, 0, 4] }
+    assert { @squared_diff.call(Cumo::Int32[1, 2], Cumo::Int32[0, 0]).is_a?(Cumo::Int32) }
+  end
+
+  test "broadcast" do
+    a = Cumo::DFloat[1, 2, 3]
+    b = Cumo::DFloat[[0], [1]]
+    c = @squared_diff.call(a, b)
+    assert { c.shape == [2, 3] }
+    assert { c == [[1, 4, 9], [0, 1, 4]] }
+    assert { @squared_diff.call(a, 1) == [0, 1, 4] }
+    assert_raise(Cumo::NArray::ShapeError) { @squared_diff.call(a, Cumo::DFloat[1, 2]) }
+  end
+
+  test "non-contiguous" do
+    a = Cumo::DFloat.new(4, 6).seq
+    b = a[true, 0..2]
+    assert { @squared_diff.call(b, b) == Cumo::DFloat.zeros(4, 3) }
+    assert { @squared_diff.call(a[[0, 2], true], 0) == a[[0, 2], true] ** 2 }
+  end
+
+  test "output" do
+    a = Cumo::SFloat[1, 2, 3]
+    z = Cumo::SFloat.zeros(3)
+    @squared_diff.call(a, 0, z)
+    assert { z == [1, 4, 9] }
+    assert_raise(TypeError) { @squared_diff.call(a, 0, Cumo::DFloat.zeros(3)) }
+  end
+
+  test "type mismatch" do
+    assert_raise(TypeError) { @squared_diff.call(Cumo::DFloat[1], Cumo::SFloat[1]) }
+  end
+
+  test "multiple outputs and index" do
+    kernel = Cumo::ElementwiseKernel.new('T x', 'T y, int64 j', 'y = -x; j = i', 'neg_index')
+    y, j = kernel.call(Cumo::DFloat[[1, 2], [3, 4]])
+    assert { y == [[-1, -2], [-3, -4]] }
+    assert { j == [[0, 1], [2, 3]] }
+  end
+end
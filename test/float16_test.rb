@@ -0,0 +1,94 @@
+require_relative "test_helper"
+
+class Float16Test < Test::Unit::TestCase
+  types = [
+    Cumo::HFloat,
+    Cumo::BFloat16,
+  ]
+
+  test "alias" do
+    assert { Cumo::Float16 == Cumo::HFloat }
+  end
+
+  types.each do |dtype|
+    test dtype do
+      assert { dtype < Cumo::NArray }
+      assert { dtype.new(3).byte_size == 6 }
+    end
+
+    test "#{dtype},store and extract" do
+      a = dtype[1, 2.5, -3, 0.5]
+      assert { a.to_a == [1, 2.5, -3, 0.5] }
+      assert { a[1] == 2.5 }
+      assert { Cumo::SFloat.cast(a) == Cumo::SFloat[1, 2.5, -3, 0.5] }
+      assert { dtype.cast(Cumo::Int32[1, 2, 3]) == dtype[1, 2, 3] }
+      assert { dtype[Float::NAN].isnan.to_a == [1] }
+    end
+
+    test "#{dtype},upcast" do
+      other = dtype == Cumo::HFloat ? Cumo::BFloat16 : Cumo::HFloat
+      a = dtype[1, 2, 3]
+      assert { (a + a).class == dtype }
+      assert { (a + 1.5).class == dtype }
+      assert { (a + Cumo::Int32[1, 2, 3]).class == dtype }
+      assert { (a + Cumo::SFloat[1, 2, 3]).class == Cumo::SFloat }
+      assert { (a + Cumo::DFloat[1, 2, 3]).class == Cumo::DFloat }
+      assert { (a + other[1, 2, 3]).class == Cumo::SFloat }
+      assert { (Cumo::Int8[1, 2, 3] * a).class == dtype }
+      assert { (a + Cumo::SFloat[1, 2, 3]) == Cumo::SFloat[2, 4, 6] }
+    end
+
+    test "#{dtype},arithmetic" do
+      a = dtype[1, 2, 3, 4]
+      assert { a * 2 == dtype[2, 4, 6, 8] }
+      assert { a / 2 == dtype[0.5, 1, 1.5, 2] }
+      assert { -a == dtype[-1, -2, -3, -4] }
+      assert { Cumo::NMath.sqrt(dtype[4, 9]) == dtype[2, 3] }
+      assert { a.max == 4 }
+      assert { a.min == 1 }
+    end
+
+    # 16-bit accumulators would stop at 2048 (HFloat) or 256 (BFloat16)
+    test "#{dtype},accumulate in float" do
+      a = dtype.ones(4096)
+      assert { a.sum == 4096 }
+      assert { a.mean == 1 }
+      assert { a.dot(a) == 4096 }
+      assert { dtype.ones(2, 4096).sum(axis: 1) == dtype[4096, 4096] }
+      assert { a.var == 0 }
+    end
+
+    test "#{dtype},rand is below max" do
+      # about 2**-12 of the float draws round up to max in 16 bits
+      assert { (dtype.new(1 << 20).rand(3) < 3).all? }
+      assert { (dtype.new(1 << 20).rand(-3) > -3).all? }
+    end
+
+    test "#{dtype},gemm" do
+      a = dtype.ones(64, 300)
+      b = dtype.ones(300, 32)
+      assert { a.dot(b) == dtype.new(64, 32).fill(300) }
+      c = dtype.ones(3, 4, 5).gemm(dtype.ones(5, 2), alpha: 2)
+      assert { c == dtype.new(3, 4, 2).fill(10) }
+    end
+  end
+
+  test "HFloat,rounding" do
+    # round to nearest even
+    assert { Cumo::HFloat[1 + 2.0**-11].to_a == [1] }
+    assert { Cumo::HFloat[1 + 3 * 2.0**-11].to_a == [1 + 2.0**-9] }
+    # no double rounding through float
+    assert { Cumo::HFloat[1 + 2.0**-11 + 2.0**-40].to_a == [1 + 2.0**-10] }
+    assert { Cumo::HFloat.cast(Cumo::DFloat[1 + 2.0**-11 + 2.0**-40]).to_a == [1 + 2.0**-10] }
+    assert { Cumo::HFloat[65504, 65520].to_a == [65504, Float::INFINITY] }
+    assert { Cumo::HFloat[2.0**-24, 2.0**-26].to_a == [2.0**-24, 0] }
+  end
+
+  test "BFloat16,rounding" do
+    assert { Cumo::BFloat16[1 + 2.0**-8].to_a == [1] }
+    assert { Cumo::BFloat16[1 + 2.0**-8 + 2.0**-40].to_a == [1 + 2.0**-7] }
+    assert { Cumo::BFloat16.cast(Cumo::DFloat[1 + 2.0**-8 + 2.0**-40]).to_a == [1 + 2.0**-7] }
+    assert { Cumo::BFloat16[3.4e38].to_a == [Float::INFINITY] }
+    assert { (Cumo::BFloat16[1e30].to_a[0] / 1e30 - 1).abs < 2.0**-8 }
+  end
+end
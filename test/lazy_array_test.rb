@@ -0,0 +1,58 @@
+require_relative "test_helper"
+
+class LazyArrayTest < Test::Unit::TestCase
+  def setup
+    @x = Cumo::SFloat.new(3, 4).seq / 10
+    @w = Cumo::SFloat.new(4).seq / 4
+    @b = Cumo::SFloat[0.5]
+  end
+
+  test "fused result equals eager evaluation" do
+    y = Cumo.lazy(@x, @w, @b) { |x, w, b| (x * w + b).tanh }
+    assert { y.is_a?(Cumo::SFloat) }
+    assert { (y - Cumo::NMath.tanh(@x * @w + @b)).abs.max < 1e-6 }
+  end
+
+  test "shape without materialization" do
+    y = @x.lazy * @w + 1
+    assert { y.is_a?(Cumo::LazyArray) }
+    assert { y.shape == [3, 4] }
+    assert { y.node.input? == false }
+  end
+
+  test "scalars and NArray on the left" do
+    x = Cumo::DFloat[1, 2, 3]
+    assert { (1 - x.lazy) == [0, -1, -2] }
+    assert { (2 ** x.lazy) == [2, 4, 8] }
+    assert { (x + x.lazy).is_a?(Cumo::LazyArray) }
+    assert { (x + x.lazy) == [2, 4, 6] }
+    assert { (-x.lazy) == [-1, -2, -3] }
+  end
+
+  test "NMath" do
+    x = Cumo::DFloat[0, 1]
+    y = Cumo::NMath.exp(x.lazy)
+    assert { y.is_a?(Cumo::LazyArray) }
+    assert { (y - Cumo::NMath.exp(x)).abs.max < 1e-12 }
+  end
+
+  test "materialized by reduction and indexing" do
+    y = (@x.lazy - 1) ** 2
+    assert { (y.sum - ((@x - 1) ** 2).sum).abs < 1e-4 }
+    assert { y[1, true] == ((@x - 1) ** 2)[1, true] }
+    assert { y.to_a == ((@x - 1) ** 2).to_a }
+  end
+
+  test "integer division is eager" do
+    x = Cumo::Int32[7, 8, 9]
+    assert { (x.lazy * 2 / 3) == [4, 5, 6] }
+    assert { (x.lazy * 2.5) == [17.5, 20, 22.5] }
+  end
+
+  test "partition of many inputs" do
+    xs = Array.new(Cumo::Lazy::MAX_FUSED_INPUTS + 8) { |i| Cumo::DFloat[i, i + 1] }
+    y = xs.map(&:lazy).inject(:+)
+    sum = xs.inject(:+)
+    assert { y == sum }
+  end
+end
@@ -0,0 +1,112 @@
+require "test/unit"
+# Graph building and fusion planning do not require a device nor the extension library.
+require_relative "../lib/cumo/lazy"
+
+module Cumo
+  class LazyTest < Test::Unit::TestCase
+    RANK = %w[int8 uint8 int16 uint16 int32 uint32 int64 uint64 float32 float64]
+    PROMOTE = ->(a, b) { RANK.index(a) > RANK.index(b) ? a : b }
+
+    def input(dtype, shape = [4])
+      Lazy.input(Object.new, dtype, shape)
+    end
+
+    sub_test_case "binary" do
+      def test_dtype
+        assert_equal("float64", Lazy.binary(:add, input("float32"), input("float64"), PROMOTE).dtype)
+        assert_equal("int32", Lazy.binary(:add, input("int32"), 2, PROMOTE).dtype)
+        assert_equal("float64", Lazy.binary(:mul, 2.5, input("int32"), PROMOTE).dtype)
+        assert_equal("float32", Lazy.binary(:mul, input("float32"), 2.5, PROMOTE).dtype)
+      end
+
+      def test_scalar_operand
+        node = Lazy.binary(:sub, 1, input("float32"), PROMOTE)
+        assert_true(node.operands[0].input?)
+        assert_equal(1, node.operands[0].value)
+        assert_equal("float32", node.operands[0].dtype)
+      end
+
+      def test_broadcast_shape
+        node = Lazy.binary(:add, input("float64", [3, 1]), input("float64", [4]), PROMOTE)
+        assert_equal([3, 4], node.shape)
+        assert_equal([3], Lazy.binary(:add, input("float64", [3]), 1, PROMOTE).shape)
+        assert_raise(ArgumentError) { Lazy.binary(:add, input("float64", [3]), input("float64", [4]), PROMOTE) }
+      end
+    end
+
+    def test_math_dtype
+      assert_equal("float32", Lazy.math(:exp, input("float32")).dtype)
+      assert_equal("float64", Lazy.math(:exp, input("int16")).dtype)
+    end
+
+    def test_fusable
+      assert_true(Lazy.fusable?(Lazy.binary(:div, input("float32"), input("float32"), PROMOTE)))
+      assert_true(Lazy.fusable?(Lazy.binary(:mul, input("int32"), 3, PROMOTE)))
+      assert_false(Lazy.fusable?(Lazy.binary(:div, input("int32"), 3, PROMOTE)))
+      assert_false(Lazy.fusable?(Lazy.binary(:pow, input("int32"), 3, PROMOTE)))
+      assert_false(Lazy.fusable?(Lazy.unary(:neg, input("Cumo::DComplex"))))
+    end
+
+    sub_test_case "Plan" do
+      def test_operation
+        x, w, b = input("float32"), input("float32"), input("float32")
+        y = Lazy.math(:tanh, Lazy.binary(:add, Lazy.binary(:mul, x, w, PROMOTE), b, PROMOTE))
+        plan = Lazy::Plan.new(y)
+        assert_equal([x, w, b], plan.inputs)
+        assert_equal("float32 a0, float32 a1, float32 a2", plan.in_params)
+        assert_equal("float32 out", plan.out_params)
+        assert_equal(<<-EOS.chomp, plan.operation)
+const float v0 = a0 * a1;
+const float v1 = v0 + a2;
+const float v2 = tanh(v1);
+out = v2
+        EOS
+      end
+
+      def test_shared_subexpression
+        x = input("float64")
+        d = Lazy.binary(:sub, x, 1, PROMOTE)
+        plan = Lazy::Plan.new(Lazy.binary(:mul, d, d, PROMOTE))
+        assert_equal(2, plan.inputs.size)
+        assert_equal("const double v0 = a0 - a1;\nconst double v1 = v0 * v0;\nout = v1", plan.operation)
+      end
+
+      def test_cast
+        plan = Lazy::Plan.new(Lazy.math(:sqrt, input("int32")))
+        assert_equal("const double v0 = sqrt((double)a0);\nout = v0", plan.operation)
+      end
+
+      def test_key
+        a = Lazy::Plan.new(Lazy.binary(:add, input("float64"), input("float64"), PROMOTE))
+        b = Lazy::Plan.new(Lazy.binary(:add, input("float64"), input("float64"), PROMOTE))
+        c = Lazy::Plan.new(Lazy.binary(:add, input("float64"), input("float32"), PROMOTE))
+        assert_equal(a.key, b.key)
+        assert_not_equal(a.key, c.key)
+      end
+    end
+
+    sub_test_case "partition" do
+      def test_input
+        assert_equal([], Lazy.partition(input("float64")))
+      end
+
+      def test_single_kernel
+        y = Lazy.binary(:add, Lazy.binary(:mul, input("float64"), input("float64"), PROMOTE), input("float64"), PROMOTE)
+        assert_equal([y], Lazy.partition(y))
+      end
+
+      def test_cut
+        xs = Array.new(6) { input("float64") }
+        l = Lazy.binary(:add, Lazy.binary(:add, xs[0], xs[1], PROMOTE), xs[2], PROMOTE)
+        r = Lazy.binary(:add, Lazy.binary(:add, xs[3], xs[4], PROMOTE), xs[5], PROMOTE)
+        y = Lazy.binary(:mul, l, r, PROMOTE)
+        nodes = Lazy.partition(y, 4)
+        assert_equal(y, nodes.last)
+        assert_true(nodes.size >= 2)
+        # every kernel fits max_inputs once its cut operands are materialized
+        nodes.each { |node| node.materialize!(Object.new) unless node.equal?(y) }
+        assert_true(Lazy::Plan.new(y).inputs.size <= 4)
+      end
+    end
+  end
+end
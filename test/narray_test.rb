@@ -107,6 +107,10 @@ class NArrayTest < Test::Unit::TestCase
           assert { dtype.minimum(a, 12 - a) == [1,2,3,5,5,1] }
           assert { dtype.maximum(a, 5) == [5,5,5,5,7,11] }
           assert { dtype.minimum(a, 5) == [1,2,3,5,5,5] }
+          assert { a.clip(2,7) == [2,2,3,5,7,7] }
+          assert { a.clip(nil,3) == [1,2,3,3,3,3] }
+          assert { a.clip(dtype[3,3,3,3,3,3],nil) == [3,3,3,5,7,11] }
+          assert { a[[5,0,2]].abs == [11,1,3] }
         end
       end
     end
@@ -330,6 +334,21 @@ class NArrayTest < Test::Unit::TestCase
           assert { a.mulsum(b, nan: true) == (0 + 2*3 + 3*4) }
         end
       end
+
+      test "broadcasted mulsum(axis:)" do
+        a = dtype[[1,2,3],[4,5,6]]
+        b = dtype[1,0,2]
+        assert { a.mulsum(b) == 23 }
+        assert { a.mulsum(b, axis: 1).to_a == [7, 16] }
+        assert { a.mulsum(b, axis: 1, keepdims: true).to_a == [[7], [16]] }
+        assert { a.mulsum(dtype[[1],[2]], axis: 0).to_a == [9, 12, 15] }
+        assert { a.mulsum(b, axis: 0).to_a == [5, 0, 18] }
+        assert { dtype.ones(2,3,4).mulsum(dtype.ones(3,4), axis: [1,2]).to_a == [12, 12] }
+        assert { a.transpose.mulsum(dtype[1,1], axis: 1).to_a == [5, 7, 9] }
+        assert { a[true,[2,0]].mulsum(b[[0,1]], axis: 1).to_a == [3, 6] }
+        assert { dtype[[1,2],[3,4]].dot(dtype[[5,6],[7,8]]).to_a == [[19,22],[43,50]] }
+        assert { dtype[[1,2],[3,4]].inner(dtype[1,1]).to_a == [3, 7] }
+      end
     end
 
     sub_test_case "#{dtype}, #dot" do
@@ -420,11 +439,32 @@ class NArrayTest < Test::Unit::TestCase
                    [[178, 196],
                     [232, 256]]] }
       end
+      test "dot with scalar" do
+        a = dtype[1..6].reshape(3,2)
+        b = dtype[1..3]
+        assert { a.dot(dtype.cast(2)) == a * 2 }
+        assert { b.dot(dtype.cast(2)) == [2, 4, 6] }
+        assert { dtype.cast(2).dot(b) == [2, 4, 6] }
+        assert { b.dot(2) == [2, 4, 6] }
+      end
       test "matrix.dot(matrix) with incorrect shape" do
         a = dtype[1..6].reshape(3,2)
         b = dtype[1..9].reshape(3,3)
         assert_raise(Cumo::NArray::ShapeError) { a.dot(b) }
       end
+      test "matrix.dot(matrix) broadcasting batch dimensions" do
+        a = dtype[1..6*2].reshape(2,1,3,2)
+        b = dtype[1..6*3].reshape(3,2,3)
+        c = a.dot(b)
+        assert { c.shape == [2,3,3,3] }
+        2.times do |i|
+          3.times do |j|
+            assert { c[i,j,true,true] == a[i,0,true,true].dot(b[j,true,true]) }
+          end
+        end
+        assert { a.dot(b[0,true,true]) == a.dot(b[0..0,true,true]) }
+        assert_raise(Cumo::NArray::ShapeError) { a[true,0,true,true].dot(dtype[1..6*4].reshape(4,2,3)) }
+      end
     end
 
     if [Cumo::DComplex, Cumo::SComplex, Cumo::DFloat, Cumo::SFloat].include?(dtype)
@@ -438,6 +478,33 @@ class NArrayTest < Test::Unit::TestCase
       end
     end
 
+    if [Cumo::Int64, Cumo::Int32, Cumo::Int16, Cumo::Int8, Cumo::UInt64, Cumo::UInt32].include?(dtype)
+      sub_test_case "#{dtype}, #gemm" do
+        test "matrix.gemm(matrix) with alpha and beta" do
+          a = dtype[1..6].reshape(2,3)
+          b = dtype[1..6].reshape(3,2)
+          c = dtype.ones(2,2)
+          assert { a.gemm(b, c, alpha: 2, beta: 3) == a.dot(b) * 2 + 3 }
+        end
+        test "matrix.gemm(matrix) larger than a tile" do
+          a = dtype.new(33,40).seq % 2
+          b = dtype.new(40,17).seq % 2
+          expected = dtype.cast(Cumo::DFloat.cast(a).dot(Cumo::DFloat.cast(b)))
+          assert { a.gemm(b) == expected }
+        end
+      end
+    end
+
+    if [Cumo::Int16, Cumo::Int8].include?(dtype)
+      test "#{dtype}#gemm accumulates into Int32" do
+        a = dtype.new(2,64).fill(100)
+        b = dtype.new(64,3).fill(100)
+        c = a.gemm(b, Cumo::Int32.zeros(2,3))
+        assert { c.class == Cumo::Int32 }
+        assert { c == Cumo::Int32.new(2,3).fill(640000) }
+      end
+    end
+
     test "#{dtype},eye" do
       assert { dtype.new(3, 3).eye(1) == [[1,0,0],[0,1,0],[0,0,1]] }
       assert { dtype.new(3, 3).eye(2) == [[2,0,0],[0,2,0],[0,0,2]] }
@@ -451,6 +518,149 @@ class NArrayTest < Test::Unit::TestCase
       assert { dtype.eye(1, 3) == [[1,0,0]] }
     end
 
+    test "#{dtype},rand" do
+      Cumo::NArray.srand(1)
+      a = dtype.new(1000).rand(10)
+      b = dtype.new(1000).rand(10)
+      Cumo::NArray.srand(1)
+      c = dtype.new(2000).rand(10)
+      assert { c[0...1000] == a }
+      assert { c[1000...2000] == b }
+      Cumo::NArray.srand(1, 1)
+      d = dtype.new(1000).rand(10)
+      assert { d != a }
+      unless [Cumo::DComplex, Cumo::SComplex].include?(dtype)
+        assert { (a >= 0).all? }
+        assert { (a < 10).all? }
+      end
+      if [Cumo::DFloat, Cumo::SFloat].include?(dtype)
+        Cumo::NArray.srand(1)
+        x = dtype.new(100000).rand_norm(2, 3)
+        assert { (x.mean - 2).abs < 0.1 }
+        assert { (x.stddev - 3).abs < 0.1 }
+      end
+    end
+
+    unless [Cumo::DComplex, Cumo::SComplex].include?(dtype)
+      test "#{dtype},rand_bernoulli,rand_poisson" do
+        Cumo::NArray.srand(1)
+        a = dtype.new(100000).rand_bernoulli(0.3)
+        assert { ((a.eq 0) | (a.eq 1)).all? }
+        assert { (Cumo::DFloat.cast(a).mean - 0.3).abs < 0.01 }
+        Cumo::NArray.srand(1)
+        b = Cumo::Bit.new(100000).rand_bernoulli(0.3)
+        assert { a.eq(1) == b }
+        assert { dtype.new(100).rand_bernoulli(0).eq(0).all? }
+        assert { dtype.new(100).rand_bernoulli(1).eq(1).all? }
+
+        Cumo::NArray.srand(1)
+        x = dtype.new(100000).rand_poisson(4)
+        assert { (x >= 0).all? }
+        assert { (Cumo::DFloat.cast(x).mean - 4).abs < 0.05 }
+        assert { (Cumo::DFloat.cast(x).var - 4).abs < 0.2 }
+        x = dtype.new(100000).rand_poisson(50)
+        assert { (Cumo::DFloat.cast(x).mean - 50).abs < 0.2 }
+      end
+    end
+
+    if [Cumo::DFloat, Cumo::SFloat].include?(dtype)
+      test "#{dtype},rand_exponential,rand_gamma,rand_trunc_norm" do
+        Cumo::NArray.srand(1)
+        x = dtype.new(100000).rand_exponential(2)
+        assert { (x >= 0).all? }
+        assert { (x.mean - 2).abs < 0.05 }
+        [[0.5, 1], [3, 2]].each do |k, theta|
+          x = dtype.new(100000).rand_gamma(k, theta)
+          assert { (x >= 0).all? }
+          assert { (x.mean - k * theta).abs < 0.05 * k * theta }
+          assert { (x.var - k * theta**2).abs < 0.1 * k * theta**2 }
+        end
+        x = dtype.new(100000).rand_trunc_norm(-1, 2)
+        assert { (x >= -1).all? }
+        assert { (x <= 2).all? }
+        x = dtype.new(10000).rand_trunc_norm(5, 6, 0, 1)
+        assert { (x >= 5).all? }
+        assert { (x <= 6).all? }
+        assert { (x.mean - 5.18).abs < 0.02 }
+      end
+    end
+
+    if dtype.method_defined?(:rand_categorical)
+      test "#{dtype},rand_categorical" do
+        Cumo::NArray.srand(1)
+        a = dtype.new(100000).rand_categorical([1, 0, 3])
+        assert { (a.eq 1).count_true == 0 }
+        assert { ((a.eq 2).count_true / 100000.0 - 0.75).abs < 0.01 }
+        assert { ((a.eq 0) | (a.eq 2)).all? }
+      end
+    end
+
+    if dtype.method_defined?(:rand_multinomial)
+      test "#{dtype},rand_multinomial" do
+        Cumo::NArray.srand(1)
+        a = dtype.new(1000, 3).rand_multinomial(20, [0.2, 0.3, 0.5])
+        assert { a.sum(axis: 1) == dtype.new(1000).fill(20) }
+        assert { (Cumo::DFloat.cast(a[true, 2]).mean - 10).abs < 0.5 }
+        b = dtype.new(3, 4).seq
+        b[true, 1..3].rand_multinomial(5, [1, 1, 1])
+        assert { b[true, 0] == [0, 4, 8] }
+        assert { b[true, 1..3].sum(axis: 1) == [5, 5, 5] }
+      end
+    end
+
+    if dtype.method_defined?(:bincount)
+      test "#{dtype},bincount" do
+        x = dtype[0, 1, 1, 3, 2, 1, 7]
+        assert { x.bincount == [1, 3, 1, 1, 0, 0, 0, 1] }
+        assert { x.bincount(minlength: 10).size == 10 }
+        w = Cumo::DFloat[0.5, 1, 1, 1, 1, 1, 2]
+        assert { x.bincount(w) == [0.5, 3, 1, 1, 0, 0, 0, 2] }
+        assert { x.bincount(Cumo::SFloat.cast(w)).is_a?(Cumo::SFloat) }
+        # more bins than fit in shared memory
+        y = dtype.new(100).seq(0, 1) * (dtype::MAX < 20000 ? 1 : 200)
+        assert { y.bincount.sum == 100 }
+        assert { y.bincount[y].eq(1).all? }
+        # same counts on host threads
+        z = (Cumo::DFloat.new(100000).rand * 100).cast_to(dtype)
+        c = z.bincount
+        begin
+          Cumo.enable_compatible_mode
+          assert { z.bincount == c }
+          assert { x.bincount(w) == [0.5, 3, 1, 1, 0, 0, 0, 2] }
+        ensure
+          Cumo.disable_compatible_mode
+        end
+      end
+    end
+
+    if dtype.method_defined?(:histogram)
+      test "#{dtype},histogram" do
+        hist, edges = dtype[1, 2, 2, 3, 3, 3].histogram(bins: 3)
+        assert { hist == [1, 2, 3] }
+        assert { hist.is_a?(Cumo::Int64) }
+        assert { edges.size == 4 }
+        assert { edges[0] == 1 && edges[3] == 3 }
+        hist, edges = dtype[0, 5, 9, 10, 11].histogram(bins: 2, range: [0, 10])
+        assert { hist == [1, 3] }
+        assert { edges == [0, 5, 10] }
+        assert { dtype[[1, 2], [3, 4]].histogram(bins: 4)[0] == [1, 1, 1, 1] }
+        assert { dtype[7, 7].histogram(bins: 1)[0] == [2] }
+        assert_raise(ArgumentError) { dtype[1].histogram(bins: 0) }
+        assert_raise(ArgumentError) { dtype[1].histogram(range: [1, 0]) }
+        z = (Cumo::DFloat.new(100000).rand * 100).cast_to(dtype)
+        [10, 10000].each do |bins|
+          hist, = z.histogram(bins: bins, range: [0, 100])
+          assert { hist.sum == 100000 }
+          begin
+            Cumo.enable_compatible_mode
+            assert { z.histogram(bins: bins, range: [0, 100])[0] == hist }
+          ensure
+            Cumo.disable_compatible_mode
+          end
+        end
+      end
+    end
+
     test "#{dtype},element-wise" do
       x = dtype[[1,2,3],[5,7,11]]
       assert { x + x == [[2,4,6],[10,14,22]] }
@@ -483,6 +693,219 @@ class NArrayTest < Test::Unit::TestCase
       end
     end
 
+    if dtype.method_defined?(:var)
+      test "#{dtype},mean,var,stddev,rms" do
+        x = dtype[[1,2,3,4],[2,4,6,8],[5,5,5,5]]
+        assert { x.mean(axis: 1) == [2.5, 5, 5] }
+        assert { x.mean(axis: 0, keepdims: true) == [[8.0/3, 11.0/3, 14.0/3, 17.0/3]] }
+        assert { ((x.var(axis: 1) - [5.0/3, 20.0/3, 0]).abs < 1e-5).all? }
+        assert { ((x.stddev(axis: 1) - Cumo::DFloat[5.0/3, 20.0/3, 0].sqrt).abs < 1e-5).all? }
+        assert { ((x.rms(axis: 1) - Cumo::DFloat[7.5, 30, 25].sqrt).abs < 1e-5).all? }
+        assert { ((x.var - x.flatten.var).abs < 1e-5).all? }
+        # rows longer than a block, and many rows in one launch
+        y = dtype.new(1000, 3000).rand
+        assert { ((y.mean(axis: 1) - y.sum(axis: 1) / 3000).abs < 1e-3).all? }
+        assert { ((y.var(axis: 1)[0] - y[0, true].var).abs < 1e-3).all? }
+        assert { ((y[true, (0..-1).step(7)].mean(axis: 0) - y[true, (0..-1).step(7)].dup.mean(axis: 0)).abs < 1e-5).all? }
+      end
+    end
+
+    if dtype.method_defined?(:kahan_sum)
+      test "#{dtype},kahan_sum" do
+        assert { dtype[1, 1e100, 1, -1e100].kahan_sum == 2 }
+        # partial sums of many threads are merged with their compensations
+        y = dtype.ones(4, 5000)
+        y[true, 0] = 1e100
+        y[true, -1] = -1e100
+        assert { (y.kahan_sum(axis: 1) == [4998] * 4).all? }
+        y[1, 2] = Float::NAN
+        assert { (y.kahan_sum(axis: 1, nan: true) == [4998, 4997, 4998, 4998]).all? }
+        assert { y.kahan_sum(axis: 1).isnan.to_a == [0, 1, 0, 0] }
+      end
+    end
+
+    if [Cumo::DFloat, Cumo::SFloat].include?(dtype)
+      test "#{dtype},reduction with nan" do
+        nan = Float::NAN
+        x = dtype[[1, nan, 3, 4], [-5, -2, nan, -3], [nan, nan, nan, nan]]
+        assert { (x.sum(axis: 1, nan: true) == [8, -10, 0]).all? }
+        assert { (x.prod(axis: 1, nan: true) == [12, -30, 1]).all? }
+        assert { ((x.mean(axis: 1, nan: true)[0..1] - [8.0 / 3, -10.0 / 3]).abs < 1e-5).all? }
+        assert { ((x.rms(axis: 1, nan: true)[0..1] - Cumo::DFloat[26.0 / 3, 38.0 / 3].sqrt).abs < 1e-5).all? }
+        assert { ((x.var(axis: 1, nan: true)[0..1] - [7.0 / 3, 7.0 / 3]).abs < 1e-5).all? }
+        assert { x.mean(axis: 1, nan: true).isnan.to_a == [0, 0, 1] }
+        assert { x.sum(axis: 1).isnan.to_a == [1, 1, 1] }
+        # NaN is skipped by default, and returned with nan: true
+        assert { x.min(axis: 1)[0..1].to_a == [1, -5] }
+        assert { x.max(axis: 1)[0..1].to_a == [4, -2] }
+        assert { x.ptp(axis: 1)[0..1].to_a == [3, 3] }
+        assert { x.max(axis: 1).isnan.to_a == [0, 0, 1] }
+        assert { x.min(axis: 1, nan: true).isnan.to_a == [1, 1, 1] }
+        assert { x.max(axis: 1, nan: true).isnan.to_a == [1, 1, 1] }
+        assert { x.ptp(axis: 1, nan: true).isnan.to_a == [1, 1, 1] }
+        assert { x.min_index(axis: 1).to_a == [0, 4, 8] }
+        assert { x.max_index(axis: 1).to_a == [3, 5, 8] }
+        assert { x.min_index(axis: 1, nan: true).to_a == [1, 6, 8] }
+        assert { x.max_index(axis: 1, nan: true).to_a == [1, 6, 8] }
+        # all elements are negative
+        y = dtype[-3, -1, -2]
+        assert { y.max == -1 }
+        assert { y.max_index == 1 }
+        assert { y.ptp == 2 }
+      end
+    end
+
+    if dtype.method_defined?(:argmax)
+      test "#{dtype},argmax,argmin" do
+        x = dtype[[3, 4, 1, 4], [2, 0, 5, 0]]
+        [false, true].each do |compatible|
+          begin
+            Cumo.enable_compatible_mode if compatible
+            assert { x.argmax(axis: 1).to_a == [1, 2] }
+            assert { x.argmin(axis: 1).to_a == [2, 1] }
+            assert { x.argmax(axis: 0).to_a == [0, 0, 1, 0] }
+            assert { x.argmin(axis: 0).to_a == [1, 1, 0, 1] }
+            assert { x.argmax == 6 }
+            assert { x[true, 1..2].argmin(axis: 1).to_a == [1, 0] }
+            assert { dtype.ones(2, 3, 4).argmax(axis: [0, 2]).to_a == [0, 0, 0] }
+            if [Cumo::DFloat, Cumo::SFloat].include?(dtype)
+              nan = Float::NAN
+              y = dtype[[1, nan, 3, 4], [-5, -2, nan, -3], [nan, nan, nan, nan]]
+              assert { y.argmax(axis: 1).to_a == [3, 1, 0] }
+              assert { y.argmin(axis: 1).to_a == [0, 0, 0] }
+              assert { y.argmax(axis: 1, nan: true).to_a == [1, 2, 0] }
+              assert { y.argmin(axis: 1, nan: true).to_a == [1, 2, 0] }
+            end
+          ensure
+            Cumo.disable_compatible_mode if compatible
+          end
+        end
+      end
+    end
+
+    if dtype.method_defined?(:max_k)
+      test "#{dtype},max_k" do
+        x = dtype[3, 1, 4, 1, 5, 9, 2, 6]
+        assert { x.max_k(3).to_a == [9, 6, 5] }
+        assert { x.max_k(0).size == 0 }
+        assert_raise(ArgumentError) { x.max_k(9) }
+        y = dtype[[3, 1, 4], [1, 5, 9]]
+        assert { y.max_k(2, axis: 0).to_a == [[3, 5, 9], [1, 1, 4]] }
+        assert { y.max_k(2, axis: -1).to_a == [[4, 3], [9, 5]] }
+        assert { y.max_k(6).to_a == [9, 5, 4, 3, 1, 1] }
+        # rows longer than a block
+        z = (Cumo::DFloat.new(7, 1000).rand * 100).cast_to(dtype)
+        m = z.max_k(10, axis: 1)
+        assert { m[true, 0].to_a == z.max(axis: 1).to_a }
+        begin
+          Cumo.enable_compatible_mode
+          assert { z.max_k(10, axis: 1).to_a == m.to_a }
+          assert { y.max_k(2, axis: 0).to_a == [[3, 5, 9], [1, 1, 4]] }
+        ensure
+          Cumo.disable_compatible_mode
+        end
+        if [Cumo::DFloat, Cumo::SFloat].include?(dtype)
+          w = dtype[1, Float::NAN, 3]
+          assert { w.max_k(2)[0].nan? }
+          assert { w.max_k(2)[1] == 3 }
+        end
+      end
+    end
+
+    if dtype.method_defined?(:topk)
+      test "#{dtype},topk,partition" do
+        x = dtype[3, 1, 4, 1, 5, 9, 2, 6]
+        y = dtype[[3, 1, 4], [1, 5, 9]]
+        z = (Cumo::DFloat.new(5, 3000).rand * 100).cast_to(dtype)
+        sorted = z.to_a.map(&:sort)
+        [false, true].each do |compatible|
+          begin
+            Cumo.enable_compatible_mode if compatible
+            v, i = x.topk(3)
+            assert { v.to_a == [9, 6, 5] }
+            assert { i.to_a == [5, 7, 4] }
+            assert { i.is_a?(Cumo::Int64) }
+            v, i = x.topk(2, largest: false)
+            assert { v.to_a == [1, 1] }
+            assert { i.to_a == [1, 3] }
+            v, i = y.topk(1, axis: 0)
+            assert { v.to_a == [[3, 5, 9]] }
+            assert { i.to_a == [[0, 1, 1]] }
+            assert_raise(ArgumentError) { x.topk(9) }
+            # rows longer than a block
+            v, i = z.topk(20, axis: 1)
+            assert { v.to_a == sorted.map {|r| r.last(20).reverse } }
+            assert { z.to_a.zip(i.to_a, v.to_a).all? {|r, ri, rv| ri.map {|j| r[j] } == rv } }
+            v, = z.topk(20, axis: 1, largest: false)
+            assert { v.to_a == sorted.map {|r| r.first(20) } }
+
+            p = x.partition(3)
+            assert { p[3] == 3 }
+            assert { p[0...3].to_a.all? {|e| e <= 3 } }
+            assert { p[4..-1].to_a.all? {|e| e >= 3 } }
+            assert { p.to_a.sort == x.to_a.sort }
+            assert { x.partition(-1)[-1] == 9 }
+            assert { y.partition(0, axis: 0).to_a == [[1, 1, 4], [3, 5, 9]] }
+            assert_raise(IndexError) { x.partition(8) }
+            p = z.partition(1500, axis: 1)
+            assert { p[true, 1500].to_a == sorted.map {|r| r[1500] } }
+            assert { (p[true, 0...1500].max(axis: 1) <= p[true, 1500]).all? }
+            assert { (p[true, 1501..-1].min(axis: 1) >= p[true, 1500]).all? }
+          ensure
+            Cumo.disable_compatible_mode if compatible
+          end
+        end
+        if [Cumo::DFloat, Cumo::SFloat].include?(dtype)
+          w = dtype[1, Float::NAN, 3, -0.0, 0.0]
+          v, i = w.topk(2)
+          assert { v[0].nan? && i.to_a == [1, 2] }
+          assert { w.topk(2, largest: false)[1].to_a == [3, 4] }
+          assert { w.partition(4)[4].nan? }
+        end
+      end
+
+      test "#{dtype},median,quantile,percentile" do
+        x = dtype[[10, 7, 4], [3, 2, 1]]
+        z = dtype.new(2, 3, 4).seq
+        r = (Cumo::DFloat.new(4, 1001).rand * 100).cast_to(dtype)
+        [false, true].each do |compatible|
+          begin
+            Cumo.enable_compatible_mode if compatible
+            assert { x.median(axis: 1) == [7, 2] }
+            assert { x.quantile(0.5, axis: 1) == [7, 2] }
+            assert { x.quantile([0, 1], axis: 1) == [[4, 1], [10, 3]] }
+            assert { x.quantile(0.25, axis: 1, interpolation: :lower) == [4, 1] }
+            assert { x.quantile(0.25, axis: 1, interpolation: :higher) == [7, 2] }
+            assert { x.quantile(0.25, axis: 1, interpolation: :nearest) == [4, 1] }
+            assert { x.quantile(0.5, axis: 1, keepdims: true).shape == [2, 1] }
+            assert { x.percentile(100, axis: 0) == [10, 7, 4] }
+            assert { x.quantile(1) == 10 }
+            # reduced axes which are not the last
+            assert { z.median(axis: [0, 2]) == z.transpose(1, 0, 2).reshape(3, 8).median(axis: 1) }
+            assert { r.median(axis: 1).to_a == r.to_a.map {|s| s.sort[500] } }
+            if [Cumo::DFloat, Cumo::SFloat].include?(dtype)
+              assert { x.quantile(0.25, axis: 1) == [5.5, 1.5] }
+              assert { z.median(axis: [0, 2]) == [7.5, 11.5, 15.5] }
+            else
+              assert { z.median(axis: [0, 2]) == [7, 11, 15] }
+            end
+            assert_raise(ArgumentError) { x.quantile(1.5) }
+            assert_raise(ArgumentError) { x.percentile(-1) }
+            assert_raise(ArgumentError) { x.quantile(0.5, interpolation: :foo) }
+          ensure
+            Cumo.disable_compatible_mode if compatible
+          end
+        end
+        if [Cumo::DFloat, Cumo::SFloat].include?(dtype)
+          w = dtype[1, Float::NAN, 3, 2]
+          assert { w.median == 2 }
+          assert { w.median(nan: true).nan? }
+          assert { w.quantile(1) == 3 }
+          assert { dtype[Float::NAN, Float::NAN].median.nan? }
+        end
+      end
+    end
+
     test "#{dtype},advanced indexing" do
       a = dtype[[1,2,3],[4,5,6]]
       assert { a[[0,1],[0,1]].dup == [[1,2],[4,5]] }
@@ -492,5 +915,62 @@ class NArrayTest < Test::Unit::TestCase
       diag.inplace - 1
       assert { diag == [0, 4] }
     end
+
+    test "#{dtype},advanced indexing with frozen Array" do
+      a = dtype[[1,2,3],[4,5,6]]
+      idx = [2,0,-1].freeze
+      3.times do
+        assert { a[true, idx] == [[3,1,3],[6,4,6]] }
+      end
+      assert { a.flatten[idx] == [3,1,6] }
+      assert { a[1, idx] == [6,4,6] }
+      # validated again against another size
+      assert_raise(IndexError) { a[idx, true] }
+      assert_raise(IndexError) { dtype[1,2][idx] }
+      b = a.dup
+      b[true, idx] = 0
+      assert { b == [[0,2,0],[0,5,0]] }
+    end
+
+    test "#{dtype},cast from nested Array" do
+      # rectangular arrays are copied in bulk
+      a = dtype.cast([[1,2,3],[4.0,5.0,6.0]])
+      assert { a.shape == [2,3] }
+      assert { a == [[1,2,3],[4,5,6]] }
+      b = dtype.zeros(2,3)
+      b[1,true] = [7,8,9]
+      assert { b == [[0,0,0],[7,8,9]] }
+      # ragged arrays, ranges and NArray elements take the ndloop path
+      assert { dtype.cast([[1,2],[3]]) == [[1,2],[3,0]] }
+      assert { dtype.cast([[1],[2,3]]) == [[1,0],[2,3]] }
+      assert { dtype.cast([[1..3],[4,5,6]]) == [[1,2,3],[4,5,6]] }
+      assert { dtype.cast([dtype[1,2],[3,4]]) == [[1,2],[3,4]] }
+    end
+
+    test "#{dtype},to_a of views" do
+      a = dtype.new(4,5).seq
+      src = a.to_a
+      assert { a.transpose.to_a == src.transpose }
+      assert { a[1..2, (0..-1).step(2)].to_a == src[1..2].map {|r| r.values_at(0,2,4) } }
+      assert { a[true, 1].format_to_a == a.format_to_a.map {|r| r[1] } }
+      Cumo.clear_sync_stats
+      a.to_a
+      assert { Cumo.sync_stats["to_a"] == 1 }
+    end
+
+    test "#{dtype},inspect large array" do
+      # only printed elements are copied to host
+      a = dtype.new(100,1000).seq
+      lines = a.inspect.lines
+      assert { lines.size == Cumo::NArray.inspect_rows + 2 }
+      assert { lines[1].start_with?("[[") && lines[1].include?("...") }
+      assert { lines[-1].strip == "..." }
+      if dtype.to_s.include?("Int")
+        # same as reading all elements
+        [a, a.transpose, a[(0..-1).step(3), 1..-1]].each do |b|
+          assert { b.inspect.lines[1..-1] == Cumo::RObject.cast(b).inspect.lines[1..-1] }
+        end
+      end
+    end
   end
 end
@@ -0,0 +1,33 @@
+require_relative "test_helper"
+
+class ReductionKernelTest < Test::Unit::TestCase
+  def setup
+    @l2norm = Cumo::ReductionKernel.new('T x', 'T y', 'x * x', 'a + b', 'y = sqrt(a)', '0', 'l2norm')
+  end
+
+  test "all" do
+    assert { @l2norm.call(Cumo::DFloat[3, 4]) == 5 }
+    assert { @l2norm.call(Cumo::DFloat[[3, 4], [0, 0]]) == 5 }
+  end
+
+  test "axis" do
+    a = Cumo::DFloat[[3, 4], [5, 12]]
+    assert { @l2norm.call(a, axis: 1) == [5, 13] }
+    assert { @l2norm.call(a, axis: 0).shape == [2] }
+    assert { @l2norm.call(a, axis: 1, keepdims: true).shape == [2, 1] }
+  end
+
+  test "large" do
+    a = Cumo::SFloat.ones(1000, 3000)
+    assert { @l2norm.call(a, axis: 1) == Cumo::SFloat.new(1000).fill(Math.sqrt(3000)) }
+  end
+
+  test "reduce_type" do
+    sum = Cumo::ReductionKernel.new('int8 x', 'int64 y', 'x', 'a + b', 'y = a', '0', 'sum_int8', reduce_type: 'int64')
+    assert { sum.call(Cumo::Int8.new(1000).fill(100)) == 100000 }
+  end
+
+  test "invalid" do
+    assert_raise(ArgumentError) { Cumo::ReductionKernel.new('T x, T y', 'T z', 'x', 'a + b', 'z = a', '0') }
+  end
+end